@@ -29,7 +29,10 @@
 #include "qt/core/browser/oxide_qt_browser_platform_integration.h"
 #include "qt/core/browser/oxide_qt_browser_startup.h"
 #include "qt/core/common/oxide_version.h"
+#include "shared/browser/oxide_browser_context_destroyer.h"
 #include "shared/browser/oxide_browser_process_main.h"
+#include "shared/browser/renderer_process_pool.h"
+#include "shared/browser/tracing_manager.h"
 #include "shared/common/chrome_version.h"
 
 using namespace oxide::qt;
@@ -48,6 +51,12 @@ void RunShutdownCallback(OxideShutdownCallback callback) {
   callback();
 }
 
+void RunTracingStoppedCallback(const OxideTracingStoppedCallback& callback) {
+  if (callback) {
+    callback();
+  }
+}
+
 }
 
 void oxideAddShutdownCallback(OxideShutdownCallback callback) {
@@ -224,6 +233,235 @@ void oxideSetMaxRendererProcessCount(size_t count) {
   content::RenderProcessHost::SetMaxRendererProcessCount(count);
 }
 
+/*!
+\relates <oxideqglobal.h>
+\since OxideQt 1.23
+
+Return the maximum number of web content processes that Oxide will run for each
+web context. A value of 0 means that there is no per web context limit, which is
+the default.
+
+\sa oxideSetMaxRendererProcessCountPerContext
+*/
+
+size_t oxideGetMaxRendererProcessCountPerContext() {
+  return oxide::RendererProcessPool::GetMaxProcessCountPerContext();
+}
+
+/*!
+\relates <oxideqglobal.h>
+\since OxideQt 1.23
+
+Set the maximum number of web content processes to run for each web context.
+Setting this to 0 removes the limit, which is the default.
+
+Once a web context has reached this limit, new pages are placed in one of its
+existing web content processes. A process that is already hosting the same site
+is preferred. Otherwise, the process that was least recently used by a visible
+web view is chosen.
+
+As with oxideSetMaxRendererProcessCount, this is not a hard limit - a new
+process is still created if none of the existing processes are suitable for
+the page. The limit set by oxideSetMaxRendererProcessCount continues to apply
+across all web contexts. This has no effect in single process mode.
+
+This can be called at any time, and affects pages loaded after it is called.
+The sites assigned to each web content process are reported by
+WebContext::requestMemoryReport.
+
+\sa oxideGetMaxRendererProcessCountPerContext
+*/
+
+void oxideSetMaxRendererProcessCountPerContext(size_t count) {
+  oxide::RendererProcessPool::SetMaxProcessCountPerContext(count);
+}
+
+/*!
+\relates <oxideqglobal.h>
+\since OxideQt 1.23
+
+Start Oxide now, rather than when the first web context or web view is
+created. Applications can call this from main() after creating their
+QGuiApplication, so that the time taken to start Oxide isn't added to the time
+taken to display the first web view.
+
+Oxide's browser components must be initialized on the application's main
+thread, so this function blocks until the main components are initialized.
+Work that can run in the background (such as starting Oxide's internal
+threads, and launching spare web content processes if
+oxideSetSpareRendererEnabled has been called) continues after it returns.
+
+\sa oxideSetSpareRendererEnabled
+*/
+
+void oxidePrewarm() {
+  BrowserStartup::GetInstance()->Prewarm();
+}
+
+/*!
+\relates <oxideqglobal.h>
+\since OxideQt 1.23
+
+Returns whether Oxide keeps a spare web content process ready for each web
+context. The default is false.
+
+\sa oxideSetSpareRendererEnabled
+*/
+
+bool oxideGetSpareRendererEnabled() {
+  return BrowserStartup::GetInstance()->GetSpareRendererEnabled();
+}
+
+/*!
+\relates <oxideqglobal.h>
+\since OxideQt 1.23
+
+Set whether Oxide should keep a spare web content process ready for each web
+context. When enabled, a web content process is launched in the background
+when a web context is created, and is claimed by the next web view created in
+that context. A replacement is launched shortly afterwards.
+
+This reduces the time taken for a new web view to display its first page, at
+the cost of keeping an extra process running. It has no effect in single
+process mode, or if the limit set by oxideSetMaxRendererProcessCount has been
+reached.
+
+\sa oxideGetSpareRendererEnabled, oxidePrewarm
+*/
+
+void oxideSetSpareRendererEnabled(bool enabled) {
+  BrowserStartup::GetInstance()->SetSpareRendererEnabled(enabled);
+}
+
+/*!
+\relates <oxideqglobal.h>
+\since OxideQt 1.23
+
+Return the time in milliseconds that web content processes are given to exit
+after the web context they belong to has been deleted. A value of 0 means that
+Oxide waits for them indefinitely, which is the default.
+
+\sa oxideSetRendererShutdownGracePeriod
+*/
+
+int oxideGetRendererShutdownGracePeriod() {
+  return static_cast<int>(
+      oxide::BrowserContextDestroyer::GetRendererGracePeriod()
+          .InMilliseconds());
+}
+
+/*!
+\relates <oxideqglobal.h>
+\since OxideQt 1.23
+
+Set the time in milliseconds that web content processes are given to exit after
+the web context they belong to has been deleted. Any processes that are still
+running after this time are killed, so that the resources held by the web
+context can be released. Setting this to 0 restores the default behaviour of
+waiting indefinitely.
+
+Data belonging to a deleted web context (such as cookies) starts being written
+to disk as soon as the web context is deleted, regardless of this setting.
+
+This affects web contexts that are deleted after it is called.
+
+\sa oxideGetRendererShutdownGracePeriod
+*/
+
+void oxideSetRendererShutdownGracePeriod(int msecs) {
+  if (msecs < 0) {
+    qWarning() << "Invalid renderer shutdown grace period";
+    return;
+  }
+
+  oxide::BrowserContextDestroyer::SetRendererGracePeriod(
+      base::TimeDelta::FromMilliseconds(msecs));
+}
+
+/*!
+\relates <oxideqglobal.h>
+\since OxideQt 1.23
+
+Start recording a performance trace from the browser, web content and GPU
+processes. \a categories is a comma-separated list of trace categories to
+record, which may contain wildcards, and categories prefixed with \e{-} are
+excluded (eg, \e{"oxide.*,cc,gpu"}). An empty string records the default set of
+categories.
+
+As well as Chromium's own categories, Oxide records events in the following
+categories:
+
+\list
+  \li oxide.delegate_worker - Calls to WebContextDelegateWorker instances
+  \li oxide.frame_delivery - Compositor frames being delivered to the
+  application's scene graph
+  \li oxide.script_messages - Script messages sent between web content and the
+  application
+  \li oxide.user_scripts - User script injection in to web content
+\endlist
+
+Oxide must be running before this is called. Returns false if Oxide isn't
+running or if a trace is already being recorded.
+
+\sa oxideStopTracing, oxideIsTracing
+*/
+
+bool oxideStartTracing(const QString& categories) {
+  if (!oxide::BrowserProcessMain::GetInstance()->IsRunning()) {
+    qWarning() << "Cannot start tracing before Oxide is running";
+    return false;
+  }
+
+  return oxide::TracingManager::GetInstance()->StartTracing(
+      categories.toStdString());
+}
+
+/*!
+\relates <oxideqglobal.h>
+\since OxideQt 1.23
+
+Stop recording the current performance trace, and write it to the file at
+\a path in the JSON trace format understood by Chrome's \e{about:tracing}.
+The file is written asynchronously, and oxideIsTracing will return true until
+it has been written.
+
+Returns false if a trace isn't being recorded.
+
+\sa oxideStartTracing
+*/
+
+bool oxideStopTracing(const QString& path) {
+  return oxideStopTracingWithCallback(path, OxideTracingStoppedCallback());
+}
+
+bool oxideStopTracingWithCallback(const QString& path,
+                                  const OxideTracingStoppedCallback& callback) {
+  if (!oxide::BrowserProcessMain::GetInstance()->IsRunning()) {
+    return false;
+  }
+
+  return oxide::TracingManager::GetInstance()->StopTracing(
+      base::FilePath(path.toStdString()),
+      base::Bind(&RunTracingStoppedCallback, callback));
+}
+
+/*!
+\relates <oxideqglobal.h>
+\since OxideQt 1.23
+
+Returns whether a performance trace is being recorded or written out.
+
+\sa oxideStartTracing, oxideStopTracing
+*/
+
+bool oxideIsTracing() {
+  if (!oxide::BrowserProcessMain::GetInstance()->IsRunning()) {
+    return false;
+  }
+
+  return oxide::TracingManager::GetInstance()->IsTracing();
+}
+
 /*!
 \relates <oxideqglobal.h>
 \since OxideQt 1.15
@@ -57,6 +57,22 @@ OXIDE_QTCORE_EXPORT void oxideSetProcessModel(OxideProcessModel model);
 OXIDE_QTCORE_EXPORT size_t oxideGetMaxRendererProcessCount();
 OXIDE_QTCORE_EXPORT void oxideSetMaxRendererProcessCount(size_t count);
 
+OXIDE_QTCORE_EXPORT size_t oxideGetMaxRendererProcessCountPerContext();
+OXIDE_QTCORE_EXPORT void oxideSetMaxRendererProcessCountPerContext(
+    size_t count);
+
+OXIDE_QTCORE_EXPORT void oxidePrewarm();
+
+OXIDE_QTCORE_EXPORT bool oxideGetSpareRendererEnabled();
+OXIDE_QTCORE_EXPORT void oxideSetSpareRendererEnabled(bool enabled);
+
+OXIDE_QTCORE_EXPORT int oxideGetRendererShutdownGracePeriod();
+OXIDE_QTCORE_EXPORT void oxideSetRendererShutdownGracePeriod(int msecs);
+
+OXIDE_QTCORE_EXPORT bool oxideStartTracing(const QString& categories);
+OXIDE_QTCORE_EXPORT bool oxideStopTracing(const QString& path);
+OXIDE_QTCORE_EXPORT bool oxideIsTracing();
+
 OXIDE_QTCORE_EXPORT QString oxideGetChromeVersion();
 OXIDE_QTCORE_EXPORT QString oxideGetVersion();
 
@@ -21,6 +21,8 @@
 #include <QtDebug>
 #include <QtGlobal>
 
+#include <functional>
+
 #include "qt/core/api/oxideqglobal.h"
 
 #define WARN_DEPRECATED_API_USAGE() \
@@ -33,5 +35,12 @@
 typedef void (*OxideShutdownCallback)();
 
 OXIDE_QTCORE_EXPORT void oxideAddShutdownCallback(OxideShutdownCallback callback);
+
+typedef std::function<void()> OxideTracingStoppedCallback;
+
+// Like oxideStopTracing, but runs |callback| once the trace has been written
+OXIDE_QTCORE_EXPORT bool oxideStopTracingWithCallback(
+    const QString& path,
+    const OxideTracingStoppedCallback& callback);
       
 #endif // _OXIDE_QT_CORE_API_GLOBAL_P_H_
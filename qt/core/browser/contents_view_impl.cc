@@ -34,6 +34,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/ref_counted_memory.h"
 #include "base/memory/scoped_vector.h"
+#include "base/trace_event/trace_event.h"
 #include "content/common/cursors/webcursor.h"
 #include "content/public/browser/native_web_keyboard_event.h"
 #include "content/public/common/drop_data.h"
@@ -256,6 +257,9 @@ float ContentsViewImpl::GetTopContentOffset() const {
 }
 
 QSharedPointer<CompositorFrameHandle> ContentsViewImpl::compositorFrameHandle() {
+  TRACE_EVENT0("oxide.frame_delivery",
+               "oxide::qt::ContentsViewImpl::compositorFrameHandle");
+
   if (!compositor_frame_) {
     compositor_frame_ =
         QSharedPointer<CompositorFrameHandle>(
@@ -267,6 +271,8 @@ QSharedPointer<CompositorFrameHandle> ContentsViewImpl::compositorFrameHandle()
 }
 
 void ContentsViewImpl::didCommitCompositorFrame() {
+  TRACE_EVENT_ASYNC_END0("oxide.frame_delivery",
+                         "oxide::qt::ContentsViewImpl:frame_delivery", this);
   view()->DidCommitCompositorFrame();
 }
 
@@ -297,6 +303,7 @@ void ContentsViewImpl::windowChanged() {
   view()->ScreenChanged();
   view()->ScreenRectsChanged();
   view()->WasResized();
+  view()->TopLevelWindowChanged();
   view()->TopLevelWindowBoundsChanged();
 }
 
@@ -468,7 +475,14 @@ gfx::Rect ContentsViewImpl::GetTopLevelWindowBounds() const {
                                              GetScreen());
 }
 
+const void* ContentsViewImpl::GetTopLevelWindowKey() const {
+  return window_.data();
+}
+
 void ContentsViewImpl::SwapCompositorFrame() {
+  // Ends when the toolkit has committed the frame to its scene graph
+  TRACE_EVENT_ASYNC_BEGIN0("oxide.frame_delivery",
+                           "oxide::qt::ContentsViewImpl:frame_delivery", this);
   compositor_frame_.reset();
   client_->ScheduleUpdate();
 }
@@ -606,7 +620,15 @@ content::WebContents* ContentsViewImpl::GetWebContents() const {
 }
 
 display::Display ContentsViewImpl::GetDisplay() const {
-  return Screen::GetInstance()->DisplayFromQScreen(GetScreen());
+  display::Display display =
+      Screen::GetInstance()->DisplayFromQScreen(GetScreen());
+
+  float scale = client_->GetDeviceScaleFactorOverride();
+  if (scale > 0.f) {
+    display.set_device_scale_factor(scale);
+  }
+
+  return display;
 }
 
 QScreen* ContentsViewImpl::GetScreen() const {
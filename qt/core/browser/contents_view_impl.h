@@ -105,6 +105,7 @@ class ContentsViewImpl : public QObject,
   bool HasFocus() const override;
   gfx::RectF GetBounds() const override;
   gfx::Rect GetTopLevelWindowBounds() const override;
+  const void* GetTopLevelWindowKey() const override;
   void SwapCompositorFrame() override;
   void EvictCurrentFrame() override;
   void UpdateCursor(const content::WebCursor& cursor) override;
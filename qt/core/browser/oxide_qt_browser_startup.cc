@@ -35,6 +35,7 @@
 
 #include "qt/core/app/oxide_qt_platform_delegate.h"
 #include "qt/core/gpu/oxide_qt_gl_context_dependent.h"
+#include "shared/browser/spare_renderer_manager.h"
 
 #include "oxide_qt_dpi_utils.h"
 #include "oxide_qt_screen_utils.h"
@@ -67,7 +68,8 @@ void ShutdownChromium() {
 }
 
 BrowserStartup::BrowserStartup()
-    : process_model_(oxide::PROCESS_MODEL_UNDEFINED) {}
+    : process_model_(oxide::PROCESS_MODEL_UNDEFINED),
+      spare_renderer_enabled_(false) {}
 
 // static
 BrowserStartup* BrowserStartup::GetInstance() {
@@ -120,6 +122,20 @@ void BrowserStartup::SetProcessModel(oxide::ProcessModel model) {
   process_model_ = model;
 }
 
+bool BrowserStartup::GetSpareRendererEnabled() const {
+  return spare_renderer_enabled_;
+}
+
+void BrowserStartup::SetSpareRendererEnabled(bool enabled) {
+  spare_renderer_enabled_ = enabled;
+
+  if (!BrowserProcessMain::GetInstance()->IsRunning()) {
+    return;
+  }
+
+  oxide::SpareRendererManager::SetEnabled(enabled);
+}
+
 #if QT_VERSION < QT_VERSION_CHECK(5, 3, 0)
 void BrowserStartup::SetSharedGLContext(GLContextDependent* context) {
   DCHECK(!BrowserProcessMain::GetInstance()->IsRunning());
@@ -156,7 +172,13 @@ void BrowserStartup::EnsureChromiumStarted() {
     params.gl_implementation = shared_gl_context_->implementation();
   } else {
     QString platform = QGuiApplication::platformName();
-    if (QGuiApplication::platformNativeInterface()) {
+    if (platform == QLatin1String("offscreen") ||
+        platform == QLatin1String("minimal")) {
+      // These platforms have no display server. Web views are rendered with
+      // the software compositor, and headless views capture frames from it
+      // directly
+      params.gl_implementation = gl::kGLImplementationNone;
+    } else if (QGuiApplication::platformNativeInterface()) {
       if (platform == QLatin1String("xcb")) {
         params.gl_implementation = gl::kGLImplementationDesktopGL;
       } else if (platform.startsWith("ubuntu") ||
@@ -185,6 +207,17 @@ void BrowserStartup::EnsureChromiumStarted() {
   oxide::BrowserProcessMain::GetInstance()->Start(std::move(params));
 
   qAddPostRoutine(ShutdownChromium);
+
+  oxide::SpareRendererManager::SetEnabled(spare_renderer_enabled_);
+}
+
+void BrowserStartup::Prewarm() {
+#if QT_VERSION < QT_VERSION_CHECK(5, 3, 0)
+  // We can't obtain the shared GL context from here
+  qWarning() << "Prewarming Oxide is not supported with this version of Qt";
+#else
+  EnsureChromiumStarted();
+#endif
 }
 
 // static
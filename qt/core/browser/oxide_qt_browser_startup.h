@@ -52,8 +52,15 @@ class BrowserStartup final {
   void SetSharedGLContext(GLContextDependent* context);
 #endif
 
+  bool GetSpareRendererEnabled() const;
+  void SetSpareRendererEnabled(bool enabled);
+
   void EnsureChromiumStarted();
 
+  // Starts Chromium if it isn't already running, so that the cost of
+  // starting it isn't paid by the first WebContext or WebView
+  void Prewarm();
+
   static void AddShutdownCallback(const base::Closure& callback);
 
  private:
@@ -63,6 +70,8 @@ class BrowserStartup final {
 
   oxide::ProcessModel process_model_;
 
+  bool spare_renderer_enabled_;
+
   scoped_refptr<GLContextDependent> shared_gl_context_;
 
   DISALLOW_COPY_AND_ASSIGN(BrowserStartup);
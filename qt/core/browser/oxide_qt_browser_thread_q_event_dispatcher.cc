@@ -25,6 +25,8 @@
 #include <QThread>
 #include <QTimerEvent>
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/callback.h"
 #include "base/logging.h"
@@ -34,6 +36,20 @@
 namespace oxide {
 namespace qt {
 
+namespace {
+
+// The number of invalid entries that |timer_queue_| may contain before it is
+// compacted, in addition to one per registered timer
+const size_t kMaxInvalidTimerQueueEntries = 32;
+
+template <typename T>
+bool TimerQueueEntryCompare(const T& a, const T& b) {
+  // std::push_heap and friends maintain a max-heap, so invert the comparison
+  return a.deadline > b.deadline;
+}
+
+}
+
 void BrowserThreadQEventDispatcher::IOWatcher::OnFileCanReadWithoutBlocking(
     int fd) {
   DCHECK_EQ(notifier_->socket(), fd);
@@ -58,14 +74,11 @@ BrowserThreadQEventDispatcher::IOWatcher::IOWatcher(
 
 BrowserThreadQEventDispatcher::IOWatcher::~IOWatcher() {}
 
-BrowserThreadQEventDispatcher::TimerInstance::TimerInstance() {}
-BrowserThreadQEventDispatcher::TimerInstance::~TimerInstance() {}
-
 BrowserThreadQEventDispatcher::TimerData::TimerData()
     : interval(0),
       type(Qt::PreciseTimer),
       object(nullptr),
-      instance(nullptr) {}
+      sequence(0) {}
 BrowserThreadQEventDispatcher::TimerData::~TimerData() {}
 
 BrowserThreadQEventDispatcher::SocketNotifierData::SocketNotifierData()
@@ -100,28 +113,35 @@ void BrowserThreadQEventDispatcher::RunPostedTasks() {
   QCoreApplication::sendPostedEvents();
 }
 
-void BrowserThreadQEventDispatcher::OnTimerExpired(
-    TimerInstance* timer_instance) {
+void BrowserThreadQEventDispatcher::OnTimerExpired() {
   CHECK(CalledOnValidThread());
 
-  std::set<int> ids = timer_instance->ids;
+  base::TimeTicks now = base::TimeTicks::Now();
 
-  {
-    std::list<linked_ptr<TimerInstance> >::iterator it =
-        std::find(timers_.begin(), timers_.end(), timer_instance);
-    linked_ptr<TimerInstance> inst = *it;
-    timers_.erase(it);
+  // Collect every timer that is due. Timers that aren't quite due yet are
+  // also collected if they're within their accuracy, so that coarse timers
+  // with similar deadlines fire together
+  std::vector<int> ids;
+  while (!timer_queue_.empty()) {
+    const TimerQueueEntry& entry = timer_queue_.front();
+    if (IsTimerQueueEntryValid(entry)) {
+      const TimerData& info = timer_infos_[entry.timer_id];
+      if (info.deadline - info.accuracy > now) {
+        break;
+      }
+      ids.push_back(entry.timer_id);
+    }
 
-    for (std::set<int>::iterator it = ids.begin(); it != ids.end(); ++it) {
-      int id = *it;
+    std::pop_heap(timer_queue_.begin(), timer_queue_.end(),
+                  TimerQueueEntryCompare<TimerQueueEntry>);
+    timer_queue_.pop_back();
+  }
 
-      timer_infos_[id].instance = nullptr;
-      ScheduleTimer(id);
-    }
+  for (int id : ids) {
+    ScheduleTimer(id);
   }
 
-  for (std::set<int>::iterator it = ids.begin(); it != ids.end(); ++it) {
-    int id = *it;
+  for (int id : ids) {
     if (timer_infos_.find(id) == timer_infos_.end()) {
       // A previous timer could have removed it
       continue;
@@ -130,6 +150,8 @@ void BrowserThreadQEventDispatcher::OnTimerExpired(
     QTimerEvent ev(id);
     QCoreApplication::sendEvent(timer_infos_[id].object, &ev);
   }
+
+  ArmTimer();
 }
 
 void BrowserThreadQEventDispatcher::ScheduleTimer(int timer_id) {
@@ -138,7 +160,6 @@ void BrowserThreadQEventDispatcher::ScheduleTimer(int timer_id) {
   DCHECK(timer_infos_.find(timer_id) != timer_infos_.end());
 
   TimerData& info = timer_infos_[timer_id];
-  DCHECK(!info.instance);
 
   int interval = info.interval;
   Qt::TimerType type = info.type;
@@ -164,76 +185,72 @@ void BrowserThreadQEventDispatcher::ScheduleTimer(int timer_id) {
       break;
   }
 
-  base::TimeTicks expected =
+  info.deadline =
       base::TimeTicks::Now() + base::TimeDelta::FromMilliseconds(interval);
+  info.accuracy = accuracy;
+  info.sequence = next_timer_sequence_++;
 
-  linked_ptr<TimerInstance> timer_instance;
+  TimerQueueEntry entry;
+  entry.deadline = info.deadline;
+  entry.timer_id = timer_id;
+  entry.sequence = info.sequence;
 
-  // For CoarseTimer / VeryCoarseTimer, try to find an existing timer
-  // instance to reuse
-  if (accuracy > base::TimeDelta()) {
-    base::TimeDelta last_difference = base::TimeDelta::Max();
+  timer_queue_.push_back(entry);
+  std::push_heap(timer_queue_.begin(), timer_queue_.end(),
+                 TimerQueueEntryCompare<TimerQueueEntry>);
+}
 
-    for (std::list<linked_ptr<TimerInstance> >::iterator it = timers_.begin();
-         it != timers_.end(); ++it) {
-      const linked_ptr<TimerInstance>& inst = *it;
-      base::TimeTicks run_time = inst->timer->desired_run_time();
+bool BrowserThreadQEventDispatcher::IsTimerQueueEntryValid(
+    const TimerQueueEntry& entry) const {
+  auto it = timer_infos_.find(entry.timer_id);
+  return it != timer_infos_.end() && it->second.sequence == entry.sequence;
+}
 
-      if (run_time == expected) {
-        // An exact match
-        timer_instance = *it;
-        break;
-      }
+void BrowserThreadQEventDispatcher::MaybeCompactTimerQueue() {
+  if (timer_queue_.size() <=
+      timer_infos_.size() + kMaxInvalidTimerQueueEntries) {
+    return;
+  }
 
-      base::TimeDelta difference;
-      if (run_time > expected) {
-        difference = run_time - expected;
-      } else {
-        difference = expected - run_time;
-      }
+  timer_queue_.erase(
+      std::remove_if(timer_queue_.begin(), timer_queue_.end(),
+                     [this](const TimerQueueEntry& entry) {
+        return !IsTimerQueueEntryValid(entry);
+      }),
+      timer_queue_.end());
+  std::make_heap(timer_queue_.begin(), timer_queue_.end(),
+                 TimerQueueEntryCompare<TimerQueueEntry>);
+}
 
-      if (difference > last_difference) {
-        break;
-      }
-      last_difference = difference;
+void BrowserThreadQEventDispatcher::ArmTimer() {
+  MaybeCompactTimerQueue();
 
-      if (difference <= accuracy) {
-        // This is a good enough match
-        timer_instance = inst;
-        break;
-      }
-    }
+  while (!timer_queue_.empty() &&
+         !IsTimerQueueEntryValid(timer_queue_.front())) {
+    std::pop_heap(timer_queue_.begin(), timer_queue_.end(),
+                  TimerQueueEntryCompare<TimerQueueEntry>);
+    timer_queue_.pop_back();
   }
 
-  if (!timer_instance.get()) {
-    // Create a new timer instance and insert it in to the list in order
-    timer_instance = linked_ptr<TimerInstance>(new TimerInstance());
-    timer_instance->timer.reset(new base::Timer(false, false));
-    // As |this| owns the timer instance (via |timers_|), |this| is guaranteed
-    // to be alive if timer callback runs
-    timer_instance->timer->Start(
-        FROM_HERE,
-        base::TimeDelta::FromMilliseconds(interval),
-        base::Bind(&BrowserThreadQEventDispatcher::OnTimerExpired,
-                   // The callback cannot run after |this| is deleted, as it
-                   // owns the timer instance via |timers_|
-                   base::Unretained(this),
-                   // The callback cannot run after |timer_instance| is
-                   // deleted, as it owns the Timer via its |timer| member
-                   base::Unretained(timer_instance.get())));
-
-    std::list<linked_ptr<TimerInstance> >::iterator it = timers_.begin();
-    while (it != timers_.end() &&
-           (*it)->timer->desired_run_time() <
-               timer_instance->timer->desired_run_time()) {
-      ++it;
-    }
+  if (timer_queue_.empty()) {
+    timer_.Stop();
+    return;
+  }
 
-    timers_.insert(it, timer_instance);
+  base::TimeTicks deadline = timer_queue_.front().deadline;
+  if (timer_.IsRunning() && timer_.desired_run_time() == deadline) {
+    return;
   }
 
-  timer_instance->ids.insert(timer_id);
-  info.instance = timer_instance.get();
+  base::TimeDelta delay =
+      std::max(deadline - base::TimeTicks::Now(), base::TimeDelta());
+
+  timer_.Start(FROM_HERE,
+               delay,
+               // The callback cannot run after |this| is deleted, as it
+               // owns |timer_|
+               base::Bind(&BrowserThreadQEventDispatcher::OnTimerExpired,
+                          base::Unretained(this)));
 }
 
 bool BrowserThreadQEventDispatcher::processEvents(
@@ -362,6 +379,7 @@ void BrowserThreadQEventDispatcher::registerTimer(int timer_id,
   timer_infos_[timer_id] = info;
 
   ScheduleTimer(timer_id);
+  ArmTimer();
 }
 
 bool BrowserThreadQEventDispatcher::unregisterTimer(int timer_id) {
@@ -375,19 +393,10 @@ bool BrowserThreadQEventDispatcher::unregisterTimer(int timer_id) {
     return false;
   }
 
-  TimerInstance* timer_instance = timer_infos_[timer_id].instance;
-  DCHECK(timer_instance);
-
+  // The entry in |timer_queue_| becomes invalid, and is discarded when it
+  // reaches the front or when the queue is compacted
   timer_infos_.erase(timer_id);
-  timer_instance->ids.erase(timer_id);
-
-  if (timer_instance->ids.size() == 0) {
-    std::list<linked_ptr<TimerInstance> >::iterator it =
-        std::find(timers_.begin(), timers_.end(), timer_instance);
-    if (it != timers_.end()) {
-      timers_.erase(it);
-    }
-  }
+  MaybeCompactTimerQueue();
 
   return true;
 }
@@ -449,11 +458,8 @@ int BrowserThreadQEventDispatcher::remainingTime(int timer_id) {
     return -1;
   }
 
-  TimerInstance* timer_instance = timer_infos_[timer_id].instance;
-  DCHECK(timer_instance);
-
   base::TimeDelta remaining =
-      timer_instance->timer->desired_run_time() - base::TimeTicks::Now();
+      timer_infos_[timer_id].deadline - base::TimeTicks::Now();
   return remaining.InMilliseconds();
 }
 
@@ -488,7 +494,9 @@ void BrowserThreadQEventDispatcher::flush() {}
 BrowserThreadQEventDispatcher::BrowserThreadQEventDispatcher(
     const scoped_refptr<base::SingleThreadTaskRunner>& task_runner)
     : task_runner_(task_runner),
-      wakeup_task_posted_(false) {
+      wakeup_task_posted_(false),
+      next_timer_sequence_(1),
+      timer_(false, false) {
   DCHECK(task_runner_.get());
 }
 
@@ -18,10 +18,10 @@
 #ifndef _OXIDE_QT_CORE_BROWSER_BROWSER_THREAD_Q_EVENT_DISPATCHER_H_
 #define _OXIDE_QT_CORE_BROWSER_BROWSER_THREAD_Q_EVENT_DISPATCHER_H_
 
-#include <list>
+#include <stdint.h>
 #include <map>
 #include <memory>
-#include <set>
+#include <vector>
 
 #include <QAbstractEventDispatcher>
 #include <Qt>
@@ -32,10 +32,11 @@
 #include "base/memory/ref_counted.h"
 #include "base/message_loop/message_loop.h"
 #include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 
 namespace base {
 class SingleThreadTaskRunner;
-class Timer;
 }
 
 namespace oxide {
@@ -51,13 +52,24 @@ class BrowserThreadQEventDispatcher final : public QAbstractEventDispatcher {
   bool CalledOnValidThread() const;
 
   struct TimerData;
-  struct TimerInstance;
+  struct TimerQueueEntry;
 
   void RunPostedTasks();
-  void OnTimerExpired(TimerInstance* timer_instance);
+  void OnTimerExpired();
 
+  // Calculate the next deadline for |timer_id| and add it to |timer_queue_|
   void ScheduleTimer(int timer_id);
 
+  // Whether |entry| refers to the current deadline of a registered timer
+  bool IsTimerQueueEntryValid(const TimerQueueEntry& entry) const;
+
+  // Remove invalid entries from |timer_queue_| if there are too many
+  void MaybeCompactTimerQueue();
+
+  // Start |timer_| for the earliest deadline in |timer_queue_|, if it's not
+  // already running for that time
+  void ArmTimer();
+
   // QAbstractEventDispatcher implementation
   bool processEvents(QEventLoop::ProcessEventsFlags flags) final;
   bool hasPendingEvents() final;
@@ -84,14 +96,6 @@ class BrowserThreadQEventDispatcher final : public QAbstractEventDispatcher {
   base::Lock lock_;
   bool wakeup_task_posted_;
 
-  struct TimerInstance {
-    TimerInstance();
-    ~TimerInstance();
-
-    std::unique_ptr<base::Timer> timer;
-    std::set<int> ids;
-  };
-
   struct TimerData {
     TimerData();
     ~TimerData();
@@ -99,11 +103,33 @@ class BrowserThreadQEventDispatcher final : public QAbstractEventDispatcher {
     int interval;
     Qt::TimerType type;
     QObject* object;
-    TimerInstance* instance;
+
+    // The time that this timer is next due to fire, and how early it may
+    // fire in order to be coalesced with other timers
+    base::TimeTicks deadline;
+    base::TimeDelta accuracy;
+
+    // Identifies the entry in |timer_queue_| for |deadline|
+    uint64_t sequence;
+  };
+
+  struct TimerQueueEntry {
+    base::TimeTicks deadline;
+    int timer_id;
+    uint64_t sequence;
   };
 
   std::map<int, TimerData> timer_infos_;
-  std::list<linked_ptr<TimerInstance> > timers_;
+
+  // Min-heap of timer deadlines, ordered by |deadline|. Entries aren't
+  // removed when a timer is unregistered or rescheduled - instead, they are
+  // ignored if they don't match the corresponding TimerData
+  std::vector<TimerQueueEntry> timer_queue_;
+  uint64_t next_timer_sequence_;
+
+  // A single Chromium timer, armed for the earliest deadline in
+  // |timer_queue_|
+  base::Timer timer_;
 
   class IOWatcher : public base::MessageLoopForIO::Watcher {
    public:
@@ -19,7 +19,8 @@
 
 #include "base/logging.h"
 
-#include "shared/browser/oxide_script_message_impl_browser.h"
+#include "shared/browser/oxide_web_frame.h"
+#include "shared/common/oxide_script_message.h"
 #include "shared/common/oxide_script_message_params.h"
 
 #include "oxide_qt_variant_value_converter.h"
@@ -29,7 +30,7 @@ namespace oxide {
 namespace qt {
 
 QObject* ScriptMessage::frame() const {
-  WebFrame* frame = WebFrame::FromSharedWebFrame(impl_->source_frame());
+  WebFrame* frame = WebFrame::FromSharedWebFrame(source_frame_.get());
   if (!frame) {
     return nullptr;
   }
@@ -58,9 +59,19 @@ void ScriptMessage::error(const QVariant& payload) {
                VariantValueConverter::FromVariantValue(payload));
 }
 
-ScriptMessage::ScriptMessage(oxide::ScriptMessage* message)
-    : impl_(static_cast<oxide::ScriptMessageImplBrowser*>(message)),
-      payload_(VariantValueConverter::ToVariantValue(message->payload())) {}
+void ScriptMessage::uncaughtException(const QVariant& payload) {
+  impl_->Error(oxide::ScriptMessageParams::ERROR_UNCAUGHT_EXCEPTION,
+               VariantValueConverter::FromVariantValue(payload));
+}
+
+ScriptMessage::ScriptMessage(oxide::ScriptMessage* message,
+                             oxide::WebFrame* source_frame)
+    : impl_(message),
+      payload_(VariantValueConverter::ToVariantValue(message->payload())) {
+  if (source_frame) {
+    source_frame_ = source_frame->GetWeakPtr();
+  }
+}
 
 ScriptMessage::~ScriptMessage() {}
 
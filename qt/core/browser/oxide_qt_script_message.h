@@ -22,6 +22,7 @@
 
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
 #include "url/gurl.h"
 
 #include "qt/core/glue/oxide_qt_script_message_proxy.h"
@@ -29,13 +30,15 @@
 namespace oxide {
 
 class ScriptMessage;
-class ScriptMessageImplBrowser;
+class WebFrame;
 
 namespace qt {
 
 class ScriptMessage : public ScriptMessageProxy {
  public:
-  ScriptMessage(oxide::ScriptMessage* message);
+  // |source_frame| is the frame that sent |message|. It is null for messages
+  // delivered to a worker handler, which can be used off the UI thread
+  ScriptMessage(oxide::ScriptMessage* message, oxide::WebFrame* source_frame);
   ~ScriptMessage() override;
 
  private:
@@ -46,8 +49,10 @@ class ScriptMessage : public ScriptMessageProxy {
   QVariant payload() const override;
   void reply(const QVariant& payload) override;
   void error(const QVariant& payload) override;
+  void uncaughtException(const QVariant& payload) override;
 
-  scoped_refptr<oxide::ScriptMessageImplBrowser> impl_;
+  scoped_refptr<oxide::ScriptMessage> impl_;
+  base::WeakPtr<oxide::WebFrame> source_frame_;
   QVariant payload_;
 
   DISALLOW_COPY_AND_ASSIGN(ScriptMessage);
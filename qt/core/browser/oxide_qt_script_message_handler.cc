@@ -22,10 +22,13 @@
 #include <QUrl>
 
 #include "base/bind.h"
+#include "base/synchronization/lock.h"
 #include "base/values.h"
 
 #include "qt/core/glue/oxide_qt_script_message_handler_proxy_client.h"
+#include "shared/browser/oxide_script_message_impl_browser.h"
 #include "shared/common/oxide_script_message.h"
+#include "shared/common/oxide_script_message_worker.h"
 
 #include "oxide_qt_script_message.h"
 #include "oxide_qt_variant_value_converter.h"
@@ -33,10 +36,50 @@
 namespace oxide {
 namespace qt {
 
+// Forwards messages from any thread to a ScriptMessageHandlerProxyClient,
+// until it is detached
+class ScriptMessageWorkerImpl : public oxide::ScriptMessageWorker {
+ public:
+  ScriptMessageWorkerImpl(ScriptMessageHandlerProxyClient* client)
+      : client_(client) {}
+
+  // Called on the UI thread. After this returns, |client_| won't be called
+  // again
+  void Detach() {
+    base::AutoLock lock(lock_);
+    client_ = nullptr;
+  }
+
+ private:
+  ~ScriptMessageWorkerImpl() override {}
+
+  // oxide::ScriptMessageWorker implementation
+  void OnReceiveMessage(scoped_refptr<oxide::ScriptMessage> message) override {
+    base::AutoLock lock(lock_);
+    if (!client_) {
+      // Dropping |message| sends an error to the sender
+      return;
+    }
+
+    client_->ReceiveWorkerMessage(new ScriptMessage(message.get(), nullptr));
+  }
+
+  base::Lock lock_;
+  ScriptMessageHandlerProxyClient* client_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScriptMessageWorkerImpl);
+};
+
 bool ScriptMessageHandler::ReceiveMessageCallback(
     oxide::ScriptMessage* message,
     std::unique_ptr<base::Value>* error_payload) {
-  std::unique_ptr<ScriptMessage> m(new ScriptMessage(message));
+  // Messages for worker handlers never come through here, so this is always
+  // a ScriptMessageImplBrowser
+  std::unique_ptr<ScriptMessage> m(
+      new ScriptMessage(
+          message,
+          static_cast<oxide::ScriptMessageImplBrowser*>(message)
+              ->source_frame()));
 
   QVariant error;
   bool success = client_->ReceiveMessage(m.release(), &error);
@@ -79,6 +122,7 @@ void ScriptMessageHandler::setContexts(const QList<QUrl>& contexts) {
 }
 
 void ScriptMessageHandler::attachHandler() {
+  detachHandler();
   handler_.SetCallback(
       base::Bind(&ScriptMessageHandler::ReceiveMessageCallback,
                  // The callback cannot run after |this| is deleted, as it
@@ -86,8 +130,20 @@ void ScriptMessageHandler::attachHandler() {
                  base::Unretained(this)));
 }
 
+void ScriptMessageHandler::attachWorkerHandler() {
+  detachHandler();
+  worker_ = new ScriptMessageWorkerImpl(client_);
+  handler_.SetWorker(worker_);
+}
+
 void ScriptMessageHandler::detachHandler() {
   handler_.SetCallback(oxide::ScriptMessageHandler::HandlerCallback());
+  handler_.SetWorker(nullptr);
+
+  if (worker_) {
+    worker_->Detach();
+    worker_ = nullptr;
+  }
 }
 
 ScriptMessageHandler::ScriptMessageHandler(
@@ -100,7 +156,9 @@ ScriptMessageHandler::ScriptMessageHandler(
   setHandle(handle);
 }
 
-ScriptMessageHandler::~ScriptMessageHandler() {}
+ScriptMessageHandler::~ScriptMessageHandler() {
+  detachHandler();
+}
 
 } // namespace qt
 } // namespace oxide
@@ -22,6 +22,7 @@
 #include <string>
 
 #include "base/macros.h"
+#include "base/memory/ref_counted.h"
 
 #include "qt/core/glue/oxide_qt_script_message_handler_proxy.h"
 #include "shared/common/oxide_script_message_handler.h"
@@ -37,6 +38,7 @@ class ScriptMessage;
 namespace qt {
 
 class ScriptMessageHandlerProxyClient;
+class ScriptMessageWorkerImpl;
 
 class ScriptMessageHandler : public ScriptMessageHandlerProxy {
  public:
@@ -56,11 +58,17 @@ class ScriptMessageHandler : public ScriptMessageHandlerProxy {
   QList<QUrl> contexts() const override;
   void setContexts(const QList<QUrl>& contexts) override;
   void attachHandler() override;
+  void attachWorkerHandler() override;
   void detachHandler() override;
 
   ScriptMessageHandlerProxyClient* client_;
   oxide::ScriptMessageHandler handler_;
 
+  // The worker that |handler_| delivers messages to when attached with
+  // attachWorkerHandler(). This can outlive us, as the IO thread might hold
+  // a reference to it
+  scoped_refptr<ScriptMessageWorkerImpl> worker_;
+
   DISALLOW_COPY_AND_ASSIGN(ScriptMessageHandler);
 };
 
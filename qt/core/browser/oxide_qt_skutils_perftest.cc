@@ -0,0 +1,93 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <string>
+
+#include <QImage>
+
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkImageInfo.h"
+
+#include "oxide_qt_skutils.h"
+
+namespace oxide {
+namespace qt {
+
+namespace {
+
+const int kIterations = 20;
+
+struct SkUtilsPerfTestRow {
+  SkUtilsPerfTestRow(int width,
+                     int height,
+                     SkColorType color_type,
+                     const char* name)
+      : width(width),
+        height(height),
+        color_type(color_type),
+        name(name) {}
+
+  int width;
+  int height;
+  SkColorType color_type;
+  const char* name;
+};
+
+}
+
+class SkUtilsPerfTest : public testing::TestWithParam<SkUtilsPerfTestRow> {};
+
+INSTANTIATE_TEST_CASE_P(
+    Bitmaps,
+    SkUtilsPerfTest,
+    testing::Values(
+        SkUtilsPerfTestRow(16, 16, kRGBA_8888_SkColorType, "rgba"),
+        SkUtilsPerfTestRow(16, 16, kBGRA_8888_SkColorType, "bgra"),
+        SkUtilsPerfTestRow(256, 256, kRGBA_8888_SkColorType, "rgba"),
+        SkUtilsPerfTestRow(256, 256, kBGRA_8888_SkColorType, "bgra"),
+        SkUtilsPerfTestRow(1920, 1080, kRGBA_8888_SkColorType, "rgba"),
+        SkUtilsPerfTestRow(1920, 1080, kBGRA_8888_SkColorType, "bgra")));
+
+TEST_P(SkUtilsPerfTest, QImageFromSkBitmap) {
+  const auto& params = GetParam();
+
+  SkBitmap bitmap;
+  ASSERT_TRUE(bitmap.tryAllocPixels(
+      SkImageInfo::Make(params.width, params.height,
+                        params.color_type, kPremul_SkAlphaType)));
+  bitmap.eraseARGB(0x80, 0x10, 0x20, 0x30);
+
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    QImage image = QImageFromSkBitmap(bitmap);
+    ASSERT_FALSE(image.isNull());
+  }
+  base::TimeDelta elapsed = timer.Elapsed();
+
+  perf_test::PrintResult(
+      "qimage_from_skbitmap",
+      base::StringPrintf("_%s", params.name),
+      base::StringPrintf("%dx%d", params.width, params.height),
+      elapsed.InMicrosecondsF() / kIterations, "us/image", true);
+}
+
+} // namespace qt
+} // namespace oxide
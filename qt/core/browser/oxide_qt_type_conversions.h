@@ -24,6 +24,8 @@
 #include <QRectF>
 #include <QSize>
 #include <QSizeF>
+#include <QString>
+#include <QUrl>
 
 #include "ui/gfx/geometry/point.h"
 #include "ui/gfx/geometry/point_f.h"
@@ -32,6 +34,9 @@
 #include "ui/gfx/geometry/size.h"
 #include "ui/gfx/geometry/size_f.h"
 
+#include "qt/core/glue/memory_usage.h"
+#include "shared/browser/memory_reporter.h"
+
 namespace oxide {
 namespace qt {
 
@@ -85,6 +90,44 @@ inline gfx::SizeF ToChromium(const QSizeF& size) {
   return gfx::SizeF(size.width(), size.height());
 }
 
+// oxide::RendererMemoryUsage -> RendererMemoryUsage
+inline RendererMemoryUsage ToQt(const oxide::RendererMemoryUsage& usage) {
+  RendererMemoryUsage rv;
+  rv.processId = static_cast<int>(usage.pid);
+  rv.privateBytes = static_cast<qint64>(usage.private_bytes);
+  rv.sharedBytes = static_cast<qint64>(usage.shared_bytes);
+  for (const auto& site : usage.sites) {
+    rv.sites.append(QUrl(QString::fromStdString(site.spec())));
+  }
+  return rv;
+}
+
+// oxide::WebViewMemoryUsage -> WebViewMemoryUsage
+inline WebViewMemoryUsage ToQt(const oxide::WebViewMemoryUsage& usage) {
+  WebViewMemoryUsage rv;
+  rv.renderer = ToQt(usage.renderer);
+  rv.compositorFrameCount = static_cast<int>(usage.compositor_frame_count);
+  rv.compositorFrameBytes = static_cast<qint64>(usage.compositor_frame_bytes);
+  rv.navigationEntryCount = usage.navigation_entry_count;
+  return rv;
+}
+
+// oxide::BrowserContextMemoryUsage -> WebContextMemoryUsage
+inline WebContextMemoryUsage ToQt(
+    const oxide::BrowserContextMemoryUsage& usage) {
+  WebContextMemoryUsage rv;
+  for (const auto& renderer : usage.renderers) {
+    rv.renderers.append(ToQt(renderer));
+  }
+  rv.webViewCount = static_cast<int>(usage.web_view_count);
+  rv.compositorFrameCount = static_cast<int>(usage.compositor_frame_count);
+  rv.compositorFrameBytes = static_cast<qint64>(usage.compositor_frame_bytes);
+  rv.navigationEntryCount = usage.navigation_entry_count;
+  rv.httpCacheBytes = static_cast<qint64>(usage.http_cache_bytes);
+  rv.faviconCacheBytes = static_cast<qint64>(usage.favicon_cache_bytes);
+  return rv;
+}
+
 } // namespace qt
 } // namespace oxide
 
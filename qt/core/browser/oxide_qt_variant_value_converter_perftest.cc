@@ -0,0 +1,130 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <memory>
+#include <string>
+
+#include <QString>
+#include <QVariant>
+#include <QVariantList>
+#include <QVariantMap>
+
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+#include "oxide_qt_variant_value_converter.h"
+
+namespace oxide {
+namespace qt {
+
+namespace {
+
+const int kIterations = 100;
+
+struct VariantValueConverterPerfTestRow {
+  VariantValueConverterPerfTestRow(int width, int depth)
+      : width(width),
+        depth(depth) {}
+
+  // The number of entries in each map and list
+  int width;
+
+  // The number of levels of nesting
+  int depth;
+};
+
+// Builds a payload similar to what a script message carries - a tree of maps
+// and lists with scalar leaves
+QVariant MakeVariant(int width, int depth) {
+  if (depth == 0) {
+    QVariantMap leaf;
+    leaf["string"] = QString("The quick brown fox");
+    leaf["int"] = 42;
+    leaf["double"] = 3.14;
+    leaf["bool"] = true;
+    return leaf;
+  }
+
+  QVariantMap map;
+  QVariantList list;
+  for (int i = 0; i < width; ++i) {
+    map[QString("key%1").arg(i)] = MakeVariant(width, depth - 1);
+    list.append(i);
+  }
+  map["list"] = list;
+
+  return map;
+}
+
+}
+
+class VariantValueConverterPerfTest
+    : public testing::TestWithParam<VariantValueConverterPerfTestRow> {
+ protected:
+  std::string modifier() const {
+    return base::StringPrintf("_%d_width_%d_depth",
+                              GetParam().width, GetParam().depth);
+  }
+};
+
+INSTANTIATE_TEST_CASE_P(
+    Payloads,
+    VariantValueConverterPerfTest,
+    testing::Values(
+        VariantValueConverterPerfTestRow(1, 0),
+        VariantValueConverterPerfTestRow(10, 1),
+        VariantValueConverterPerfTestRow(10, 2),
+        VariantValueConverterPerfTestRow(100, 1),
+        VariantValueConverterPerfTestRow(5, 4)));
+
+TEST_P(VariantValueConverterPerfTest, FromVariantValue) {
+  QVariant variant = MakeVariant(GetParam().width, GetParam().depth);
+
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    std::unique_ptr<base::Value> value =
+        VariantValueConverter::FromVariantValue(variant);
+    ASSERT_TRUE(value);
+  }
+
+  perf_test::PrintResult(
+      "variant_value_converter", modifier(), "from_variant",
+      timer.Elapsed().InMicrosecondsF() / kIterations, "us/conversion", true);
+}
+
+TEST_P(VariantValueConverterPerfTest, ToVariantValue) {
+  std::unique_ptr<base::Value> value =
+      VariantValueConverter::FromVariantValue(
+          MakeVariant(GetParam().width, GetParam().depth));
+  ASSERT_TRUE(value);
+
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    QVariant variant = VariantValueConverter::ToVariantValue(value.get());
+    ASSERT_TRUE(variant.isValid());
+  }
+
+  perf_test::PrintResult(
+      "variant_value_converter", modifier(), "to_variant",
+      timer.Elapsed().InMicrosecondsF() / kIterations, "us/conversion", true);
+}
+
+} // namespace qt
+} // namespace oxide
@@ -17,6 +17,8 @@
 
 #include "oxide_qt_web_context.h"
 
+#include <map>
+#include <utility>
 #include <vector>
 
 #include <QDateTime>
@@ -29,11 +31,14 @@
 #include <QUrl>
 
 #include "base/auto_reset.h"
+#include "base/bind.h"
 #include "base/files/file_path.h"
 #include "base/logging.h"
+#include "base/memory/ptr_util.h"
 #include "base/strings/string_util.h"
 #include "base/synchronization/lock.h"
 #include "base/threading/thread_task_runner_handle.h"
+#include "base/trace_event/trace_event.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/cookie_store_factory.h"
 #include "content/public/browser/resource_request_info.h"
@@ -43,6 +48,7 @@
 #include "net/cookies/canonical_cookie.h"
 #include "net/cookies/cookie_constants.h"
 #include "net/cookies/cookie_store.h"
+#include "net/http/http_request_headers.h"
 #include "net/http/http_response_headers.h"
 #include "net/url_request/url_request.h"
 #include "url/gurl.h"
@@ -53,14 +59,19 @@
 #include "qt/core/browser/oxide_qt_user_script.h"
 #include "qt/core/glue/oxide_qt_web_context_proxy_client.h"
 #include "shared/browser/media/oxide_media_capture_devices_context.h"
+#include "shared/browser/memory_reporter.h"
+#include "shared/browser/net/oxide_cookie_store_proxy.h"
+#include "shared/browser/net/oxide_packed_archive.h"
 #include "shared/browser/oxide_browser_context_delegate.h"
 #include "shared/browser/oxide_browser_process_main.h"
 #include "shared/browser/oxide_devtools_manager.h"
+#include "shared/browser/oxide_url_request_delegated_job_factory.h"
 #include "shared/browser/oxide_user_agent_settings.h"
 #include "shared/browser/oxide_user_script_master.h"
 #include "shared/browser/permissions/oxide_temporary_saved_permission_context.h"
 
 #include "oxide_qt_browser_startup.h"
+#include "oxide_qt_type_conversions.h"
 
 namespace oxide {
 namespace qt {
@@ -75,7 +86,12 @@ namespace {
 
 const unsigned kDefaultDevtoolsPort = 8484;
 
-int GetNextCookieRequestId() {
+// The number of cookies converted to QNetworkCookie per UI thread task when
+// retrieving the whole cookie jar. This only bounds the length of each task -
+// the cookies are still delivered to the client in a single response
+const size_t kGetAllCookiesChunkSize = 500;
+
+int GetNextRequestId() {
   static int id = 0;
   if (id == std::numeric_limits<int>::max()) {
     int i = id;
@@ -85,6 +101,69 @@ int GetNextCookieRequestId() {
   return id++;
 }
 
+QNetworkCookie ToQNetworkCookie(const net::CanonicalCookie& cookie) {
+  QNetworkCookie rv;
+
+  rv.setName(cookie.Name().c_str());
+  rv.setValue(cookie.Value().c_str());
+  rv.setDomain(cookie.Domain().c_str());
+  rv.setPath(cookie.Path().c_str());
+  if (!cookie.ExpiryDate().is_null()) {
+    rv.setExpirationDate(QDateTime::fromMSecsSinceEpoch(
+        cookie.ExpiryDate().ToJsTime()));
+  }
+  rv.setSecure(cookie.IsSecure());
+  rv.setHttpOnly(cookie.IsHttpOnly());
+
+  return rv;
+}
+
+void OpenPackedArchiveOnBlockingPool(
+    const base::FilePath& path,
+    scoped_refptr<oxide::PackedArchive>* archive) {
+  *archive = oxide::PackedArchive::Open(path);
+}
+
+// Network callback events are handled by the client on its own thread.
+// The result is posted back to the IO thread, which the event is deleted on
+void PostToIOThread(const base::Closure& task) {
+  content::BrowserThread::PostTask(content::BrowserThread::IO,
+                                   FROM_HERE, task);
+}
+
+void DidHandleBeforeURLRequest(
+    const oxide::BrowserContextDelegate::BeforeURLRequestCallback& callback,
+    std::unique_ptr<OxideQBeforeURLRequestEvent> event) {
+  OxideQBeforeURLRequestEventPrivate* eventp =
+      OxideQBeforeURLRequestEventPrivate::get(event.get());
+  callback.Run(eventp->request_cancelled ? net::ERR_ABORTED : net::OK,
+               GURL(eventp->new_url.toString().toStdString()));
+}
+
+struct BeforeSendHeadersData {
+  std::unique_ptr<OxideQBeforeSendHeadersEvent> event;
+
+  // The client modifies a copy of the request headers, as the originals
+  // belong to the request and aren't safe to access from the client's thread
+  net::HttpRequestHeaders headers;
+};
+
+void DidHandleBeforeSendHeaders(
+    const oxide::BrowserContextDelegate::BeforeSendHeadersCallback& callback,
+    std::unique_ptr<BeforeSendHeadersData> data) {
+  OxideQBeforeSendHeadersEventPrivate* eventp =
+      OxideQBeforeSendHeadersEventPrivate::get(data->event.get());
+  callback.Run(eventp->request_cancelled ? net::ERR_ABORTED : net::OK,
+               data->headers);
+}
+
+void DidHandleBeforeRedirect(const net::CompletionCallback& callback,
+                             std::unique_ptr<OxideQBeforeRedirectEvent> event) {
+  OxideQBeforeRedirectEventPrivate* eventp =
+      OxideQBeforeRedirectEventPrivate::get(event.get());
+  callback.Run(eventp->request_cancelled ? net::ERR_ABORTED : net::OK);
+}
+
 }
 
 class WebContext::BrowserContextDelegate
@@ -104,13 +183,16 @@ class WebContext::BrowserContextDelegate
 
   // oxide::BrowserContextDelegate implementation
   int OnBeforeURLRequest(net::URLRequest* request,
-                         const net::CompletionCallback& callback,
+                         const BeforeURLRequestCallback& callback,
                          GURL* new_url) override;
   int OnBeforeSendHeaders(net::URLRequest* request,
-                          const net::CompletionCallback& callback,
+                          const BeforeSendHeadersCallback& callback,
                           net::HttpRequestHeaders* headers) override;
   int OnBeforeRedirect(net::URLRequest* request,
-                       const GURL& new_location) override;
+                       const GURL& new_location,
+                       const net::CompletionCallback& callback) override;
+  base::TimeDelta GetNetworkCallbackTimeout() override;
+  int GetNetworkCallbackTimeoutResult() override;
   std::string GetUserAgentOverride(const GURL& url) override;
   bool IsCustomProtocolHandlerRegistered(
       const std::string& scheme) const override;
@@ -138,7 +220,9 @@ struct WebContext::ConstructProperties {
         devtools_enabled(false),
         devtools_port(-1),
         legacy_user_agent_override_enabled(false),
-        do_not_track(false) {}
+        do_not_track(false),
+        persistent_permissions(false),
+        permission_lifetime(0) {}
 
   std::string product;
   std::string user_agent;
@@ -158,19 +242,36 @@ struct WebContext::ConstructProperties {
   std::vector<UserAgentSettings::UserAgentOverride> user_agent_overrides;
   bool legacy_user_agent_override_enabled;
   bool do_not_track;
+  bool persistent_permissions;
+  int permission_lifetime;
+  std::map<std::string, base::FilePath> packed_archives;
 };
 
 class SetCookiesContext : public base::RefCounted<SetCookiesContext> {
  public:
   SetCookiesContext(int request_id)
-      : request_id(request_id),
-        remaining(0) {}
+      : request_id(request_id) {}
 
   int request_id;
-  int remaining;
+
+  // The cookies submitted to the cookie store, in the same order as the
+  // batch. Used to map failed indices back to the original cookies
+  QList<QNetworkCookie> submitted;
   QList<QNetworkCookie> failed;
 };
 
+// Accumulates the chunks of a getAllCookies request. CookieManager's API
+// delivers one response per request, so the result is only passed to the
+// client once the last chunk has arrived
+class GetAllCookiesContext : public base::RefCounted<GetAllCookiesContext> {
+ public:
+  GetAllCookiesContext(int request_id)
+      : request_id(request_id) {}
+
+  int request_id;
+  QList<QNetworkCookie> cookies;
+};
+
 QSharedPointer<WebContextProxyClient::IOClient>
 WebContext::BrowserContextDelegate::GetIOClient() {
   DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
@@ -180,7 +281,7 @@ WebContext::BrowserContextDelegate::GetIOClient() {
 
 int WebContext::BrowserContextDelegate::OnBeforeURLRequest(
     net::URLRequest* request,
-    const net::CompletionCallback& callback,
+    const BeforeURLRequestCallback& callback,
     GURL* new_url) {
   QSharedPointer<WebContextProxyClient::IOClient> io_client = GetIOClient();
   if (!io_client) {
@@ -195,24 +296,30 @@ int WebContext::BrowserContextDelegate::OnBeforeURLRequest(
     return net::OK;
   }
 
-  OxideQBeforeURLRequestEvent event(
+  OxideQBeforeURLRequestEvent* event = new OxideQBeforeURLRequestEvent(
       QUrl(QString::fromStdString(request->url().spec())),
       QString::fromStdString(request->method()),
       QString::fromStdString(request->referrer()),
       info->IsMainFrame());
 
-  io_client->OnBeforeURLRequest(&event);
-
-  OxideQBeforeURLRequestEventPrivate* eventp =
-      OxideQBeforeURLRequestEventPrivate::get(&event);
-  *new_url = GURL(eventp->new_url.toString().toStdString());
+  // The client handles the event on its own thread, so that a slow handler
+  // doesn't block the IO thread
+  bool accepted = io_client->OnBeforeURLRequest(event, [event, callback]() {
+    PostToIOThread(base::Bind(&DidHandleBeforeURLRequest,
+                              callback,
+                              base::Passed(base::WrapUnique(event))));
+  });
+  if (!accepted) {
+    delete event;
+    return net::OK;
+  }
 
-  return eventp->request_cancelled ? net::ERR_ABORTED : net::OK;
+  return net::ERR_IO_PENDING;
 }
 
 int WebContext::BrowserContextDelegate::OnBeforeSendHeaders(
     net::URLRequest* request,
-    const net::CompletionCallback& callback,
+    const BeforeSendHeadersCallback& callback,
     net::HttpRequestHeaders* headers) {
   QSharedPointer<WebContextProxyClient::IOClient> io_client = GetIOClient();
   if (!io_client) {
@@ -227,24 +334,35 @@ int WebContext::BrowserContextDelegate::OnBeforeSendHeaders(
     return net::OK;
   }
 
-  OxideQBeforeSendHeadersEvent event(
+  BeforeSendHeadersData* data = new BeforeSendHeadersData();
+  data->event.reset(new OxideQBeforeSendHeadersEvent(
       QUrl(QString::fromStdString(request->url().spec())),
       QString::fromStdString(request->method()),
       QString::fromStdString(request->referrer()),
-      info->IsMainFrame());
-
-  OxideQBeforeSendHeadersEventPrivate* eventp =
-      OxideQBeforeSendHeadersEventPrivate::get(&event);
-  eventp->headers = headers;
-
-  io_client->OnBeforeSendHeaders(&event);
+      info->IsMainFrame()));
+  data->headers.CopyFrom(*headers);
+
+  OxideQBeforeSendHeadersEventPrivate::get(data->event.get())->headers =
+      &data->headers;
+
+  bool accepted =
+      io_client->OnBeforeSendHeaders(data->event.get(), [data, callback]() {
+    PostToIOThread(base::Bind(&DidHandleBeforeSendHeaders,
+                              callback,
+                              base::Passed(base::WrapUnique(data))));
+  });
+  if (!accepted) {
+    delete data;
+    return net::OK;
+  }
 
-  return eventp->request_cancelled ? net::ERR_ABORTED : net::OK;
+  return net::ERR_IO_PENDING;
 }
 
 int WebContext::BrowserContextDelegate::OnBeforeRedirect(
     net::URLRequest* request,
-    const GURL& new_location) {
+    const GURL& new_location,
+    const net::CompletionCallback& callback) {
   QSharedPointer<WebContextProxyClient::IOClient> io_client = GetIOClient();
   if (!io_client) {
     return net::OK;
@@ -258,23 +376,53 @@ int WebContext::BrowserContextDelegate::OnBeforeRedirect(
     return net::OK;
   }
 
-  OxideQBeforeRedirectEvent event(
+  OxideQBeforeRedirectEvent* event = new OxideQBeforeRedirectEvent(
       QUrl(QString::fromStdString(new_location.spec())),
       QString::fromStdString(request->method()),
       QString::fromStdString(request->referrer()),
       info->IsMainFrame(),
       QUrl(QString::fromStdString(request->original_url().spec())));
 
-  io_client->OnBeforeRedirect(&event);
+  bool accepted = io_client->OnBeforeRedirect(event, [event, callback]() {
+    PostToIOThread(base::Bind(&DidHandleBeforeRedirect,
+                              callback,
+                              base::Passed(base::WrapUnique(event))));
+  });
+  if (!accepted) {
+    delete event;
+    return net::OK;
+  }
+
+  return net::ERR_IO_PENDING;
+}
 
-  OxideQBeforeRedirectEventPrivate* eventp =
-      OxideQBeforeRedirectEventPrivate::get(&event);
+base::TimeDelta
+WebContext::BrowserContextDelegate::GetNetworkCallbackTimeout() {
+  QSharedPointer<WebContextProxyClient::IOClient> io_client = GetIOClient();
+  if (!io_client) {
+    return base::TimeDelta();
+  }
+
+  return base::TimeDelta::FromMilliseconds(
+      io_client->GetNetworkCallbackTimeout());
+}
+
+int WebContext::BrowserContextDelegate::GetNetworkCallbackTimeoutResult() {
+  QSharedPointer<WebContextProxyClient::IOClient> io_client = GetIOClient();
+  if (!io_client) {
+    return net::OK;
+  }
 
-  return eventp->request_cancelled ? net::ERR_ABORTED : net::OK;
+  return io_client->CancelRequestOnNetworkCallbackTimeout() ?
+      net::ERR_ABORTED : net::OK;
 }
 
 std::string WebContext::BrowserContextDelegate::GetUserAgentOverride(
     const GURL& url) {
+  TRACE_EVENT0("oxide.delegate_worker",
+               "oxide::qt::WebContext::BrowserContextDelegate::"
+               "GetUserAgentOverride");
+
   QSharedPointer<WebContextProxyClient::IOClient> io_client = GetIOClient();
   if (!io_client) {
     return std::string();
@@ -354,17 +502,12 @@ void WebContext::UpdateUserScripts() {
       ->SerializeUserScriptsAndSendUpdates(scripts);
 }
 
-void WebContext::SetCookieCallback(scoped_refptr<SetCookiesContext> ctxt,
-                                   const QNetworkCookie& cookie,
-                                   bool success) {
-  DCHECK_GT(ctxt->remaining, 0);
-
-  if (!success) {
-    ctxt->failed.push_back(cookie);
-  }
-
-  if (--ctxt->remaining > 0) {
-    return;
+void WebContext::SetCookiesBatchCallback(
+    scoped_refptr<SetCookiesContext> ctxt,
+    const std::vector<size_t>& failed) {
+  for (size_t index : failed) {
+    DCHECK_LT(index, static_cast<size_t>(ctxt->submitted.size()));
+    ctxt->failed.push_back(ctxt->submitted.at(static_cast<int>(index)));
   }
 
   DeliverSetCookiesResponse(ctxt);
@@ -378,35 +521,110 @@ void WebContext::DeliverSetCookiesResponse(
 void WebContext::GetCookiesCallback(int request_id,
                                     const net::CookieList& cookies) {
   QList<QNetworkCookie> qcookies;
-  for (net::CookieList::const_iterator iter = cookies.begin();
-       iter != cookies.end(); ++iter) {
-    QNetworkCookie cookie;
-
-    cookie.setName(iter->Name().c_str());
-    cookie.setValue(iter->Value().c_str());
-    cookie.setDomain(iter->Domain().c_str());
-    cookie.setPath(iter->Path().c_str());
-    if (!iter->ExpiryDate().is_null()) {
-      cookie.setExpirationDate(QDateTime::fromMSecsSinceEpoch(
-          iter->ExpiryDate().ToJsTime()));
-    }
-    cookie.setSecure(iter->IsSecure());
-    cookie.setHttpOnly(iter->IsHttpOnly());
-
-    qcookies.append(cookie);
+  qcookies.reserve(static_cast<int>(cookies.size()));
+  for (const auto& cookie : cookies) {
+    qcookies.append(ToQNetworkCookie(cookie));
   }
 
   client_->CookiesRetrieved(request_id, qcookies);
 }
 
+void WebContext::GetAllCookiesChunkCallback(
+    scoped_refptr<GetAllCookiesContext> ctxt,
+    const net::CookieList& cookies,
+    bool last) {
+  for (const auto& cookie : cookies) {
+    ctxt->cookies.append(ToQNetworkCookie(cookie));
+  }
+
+  if (!last) {
+    return;
+  }
+
+  client_->CookiesRetrieved(ctxt->request_id, ctxt->cookies);
+}
+
 void WebContext::DeleteCookiesCallback(int request_id, int num_deleted) {
   client_->CookiesDeleted(request_id, num_deleted);
 }
 
+void WebContext::OnMemoryUsageSampled(
+    const oxide::BrowserContextMemoryUsage& usage) {
+  client_->MemoryUsageAvailable(ToQt(usage));
+}
+
+void WebContext::OnUrlsPrefetched(
+    int request_id,
+    const oxide::HttpCacheController::PrefetchResult& result) {
+  client_->UrlsPrefetched(request_id,
+                          static_cast<int>(result.succeeded),
+                          static_cast<int>(result.failed));
+}
+
+void WebContext::OnCacheEntryInfoRetrieved(
+    int request_id,
+    const oxide::HttpCacheController::EntryInfo& info) {
+  client_->CacheEntryInfoRetrieved(request_id, info.cached, info.size);
+}
+
+void WebContext::OnCacheEntriesEvicted(int request_id, int num_evicted) {
+  client_->CacheEntriesEvicted(request_id, num_evicted);
+}
+
+void WebContext::OnCacheStatsRetrieved(
+    int request_id,
+    const oxide::HttpCacheController::Stats& stats) {
+  HttpCacheStats rv;
+  rv.hits = static_cast<int>(stats.hits);
+  rv.misses = static_cast<int>(stats.misses);
+  rv.prefetchesSucceeded = static_cast<int>(stats.prefetches_succeeded);
+  rv.prefetchesFailed = static_cast<int>(stats.prefetches_failed);
+  rv.prefetchesPending = static_cast<int>(stats.prefetches_pending);
+
+  client_->CacheStatsRetrieved(request_id, rv);
+}
+
+void WebContext::OpenPackedArchive(const std::string& scheme,
+                                   const base::FilePath& path) {
+  DCHECK(IsInitialized());
+
+  int request_id = ++next_packed_archive_request_id_;
+  packed_archive_requests_[scheme] = request_id;
+
+  scoped_refptr<oxide::PackedArchive>* archive =
+      new scoped_refptr<oxide::PackedArchive>();
+  content::BrowserThread::PostBlockingPoolTaskAndReply(
+      FROM_HERE,
+      base::Bind(&OpenPackedArchiveOnBlockingPool, path, archive),
+      base::Bind(&WebContext::OnPackedArchiveOpened,
+                 weak_factory_.GetWeakPtr(),
+                 scheme, request_id, base::Owned(archive)));
+}
+
+void WebContext::OnPackedArchiveOpened(
+    const std::string& scheme,
+    int request_id,
+    const scoped_refptr<oxide::PackedArchive>* archive) {
+  auto it = packed_archive_requests_.find(scheme);
+  if (it == packed_archive_requests_.end() || it->second != request_id) {
+    return;
+  }
+
+  packed_archive_requests_.erase(it);
+
+  if (archive->get()) {
+    context_->SetPackedArchive(scheme, *archive);
+  }
+
+  client_->PackedArchiveAdded(QString::fromStdString(scheme),
+                              archive->get() != nullptr);
+}
+
 WebContext::WebContext(WebContextProxyClient* client,
                        QObject* handle)
     : client_(client),
       construct_props_(new ConstructProperties()),
+      next_packed_archive_request_id_(0),
       weak_factory_(this) {
   DCHECK(client);
   DCHECK(handle);
@@ -446,6 +664,27 @@ WebContext::WebContext(WebContextProxyClient* client,
         content::CookieStoreConfig::RESTORED_SESSION_COOKIES),
       "SessionCookieMode and net::CookieStoreConfig::SessionCookieMode values "
       "don't match: SessionCookieModeRestored");
+
+  static_assert(
+      PermissionTypeGeolocation == static_cast<PermissionType>(
+        TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION),
+      "PermissionType and TemporarySavedPermissionType values don't match: "
+      "PermissionTypeGeolocation");
+  static_assert(
+      PermissionTypeMicrophone == static_cast<PermissionType>(
+        TEMPORARY_SAVED_PERMISSION_TYPE_MEDIA_DEVICE_MIC),
+      "PermissionType and TemporarySavedPermissionType values don't match: "
+      "PermissionTypeMicrophone");
+  static_assert(
+      PermissionTypeCamera == static_cast<PermissionType>(
+        TEMPORARY_SAVED_PERMISSION_TYPE_MEDIA_DEVICE_CAMERA),
+      "PermissionType and TemporarySavedPermissionType values don't match: "
+      "PermissionTypeCamera");
+  static_assert(
+      PermissionTypeNotifications == static_cast<PermissionType>(
+        TEMPORARY_SAVED_PERMISSION_TYPE_NOTIFICATIONS),
+      "PermissionType and TemporarySavedPermissionType values don't match: "
+      "PermissionTypeNotifications");
 }
 
 WebContext::~WebContext() {
@@ -479,6 +718,9 @@ BrowserContext* WebContext::GetContext() {
       construct_props_->max_cache_size_hint,
       construct_props_->session_cookie_mode);
   params.host_mapping_rules = construct_props_->host_mapping_rules;
+  params.persistent_permissions = construct_props_->persistent_permissions;
+  params.permission_lifetime =
+      base::TimeDelta::FromSeconds(construct_props_->permission_lifetime);
 
   context_ = BrowserContext::Create(params);
 
@@ -531,8 +773,15 @@ BrowserContext* WebContext::GetContext() {
 
   context_->SetDelegate(delegate_.get());
 
+  std::map<std::string, base::FilePath> packed_archives;
+  std::swap(packed_archives, construct_props_->packed_archives);
+
   construct_props_.reset();
 
+  for (const auto& packed_archive : packed_archives) {
+    OpenPackedArchive(packed_archive.first, packed_archive.second);
+  }
+
   UpdateUserScripts();
 
   return context_.get();
@@ -756,11 +1005,15 @@ void WebContext::setDevtoolsBindIp(const QString& ip) {
 
 int WebContext::setCookies(const QUrl& url,
                            const QList<QNetworkCookie>& cookies) {
-  int request_id = GetNextCookieRequestId();
+  int request_id = GetNextRequestId();
 
-  net::CookieStore* cookie_store = context_->GetCookieStore();
   scoped_refptr<SetCookiesContext> ctxt = new SetCookiesContext(request_id);
-  
+
+  GURL gurl(url.toString().toStdString());
+
+  oxide::CookieStoreProxy::CookieDetailsList batch;
+  batch.reserve(cookies.size());
+
   for (int i = 0; i < cookies.size(); ++i) {
     const QNetworkCookie& cookie = cookies.at(i);
 
@@ -769,42 +1022,41 @@ int WebContext::setCookies(const QUrl& url,
       continue;
     }
 
-    base::Time expiry;
+    oxide::CookieStoreProxy::CookieDetails details;
+    details.url = gurl;
+    details.name = std::string(cookie.name().constData());
+    details.value = std::string(cookie.value().constData());
+    details.domain = std::string(cookie.domain().toUtf8().constData());
+    details.path = std::string(cookie.path().toUtf8().constData());
     if (cookie.expirationDate().isValid()) {
-      expiry = base::Time::FromJsTime(cookie.expirationDate().toMSecsSinceEpoch());
+      details.expiration_time =
+          base::Time::FromJsTime(cookie.expirationDate().toMSecsSinceEpoch());
     }
+    details.secure = cookie.isSecure();
+    details.http_only = cookie.isHttpOnly();
+
+    batch.push_back(details);
+    ctxt->submitted.push_back(cookie);
+  }
 
-    ctxt->remaining++;
-
-    cookie_store->SetCookieWithDetailsAsync(
-        GURL(url.toString().toStdString()),
-        std::string(cookie.name().constData()),
-        std::string(cookie.value().constData()),
-        std::string(cookie.domain().toUtf8().constData()),
-        std::string(cookie.path().toUtf8().constData()),
-        base::Time(),
-        expiry,
-        base::Time(),
-        cookie.isSecure(),
-        cookie.isHttpOnly(),
-        net::CookieSameSite::DEFAULT_MODE,
-        net::COOKIE_PRIORITY_DEFAULT,
-        base::Bind(&WebContext::SetCookieCallback,
-                   weak_factory_.GetWeakPtr(), ctxt, cookie));
-  }
-
-  if (ctxt->remaining == 0) {
+  if (batch.empty()) {
     base::ThreadTaskRunnerHandle::Get()->PostTask(
         FROM_HERE,
         base::Bind(&WebContext::DeliverSetCookiesResponse,
                    weak_factory_.GetWeakPtr(), ctxt));
+    return request_id;
   }
 
+  context_->GetCookieStoreProxy()->SetCookiesWithDetailsBatchAsync(
+      batch,
+      base::Bind(&WebContext::SetCookiesBatchCallback,
+                 weak_factory_.GetWeakPtr(), ctxt));
+
   return request_id;
 }
 
 int WebContext::getCookies(const QUrl& url) {
-  int request_id = GetNextCookieRequestId();
+  int request_id = GetNextRequestId();
 
   context_->GetCookieStore()->GetAllCookiesForURLAsync(
       GURL(url.toString().toStdString()),
@@ -815,17 +1067,19 @@ int WebContext::getCookies(const QUrl& url) {
 }
 
 int WebContext::getAllCookies() {
-  int request_id = GetNextCookieRequestId();
+  int request_id = GetNextRequestId();
 
-  context_->GetCookieStore()->GetAllCookiesAsync(
-      base::Bind(&WebContext::GetCookiesCallback,
-                 weak_factory_.GetWeakPtr(), request_id));
+  context_->GetCookieStoreProxy()->GetAllCookiesChunkedAsync(
+      kGetAllCookiesChunkSize,
+      base::Bind(&WebContext::GetAllCookiesChunkCallback,
+                 weak_factory_.GetWeakPtr(),
+                 make_scoped_refptr(new GetAllCookiesContext(request_id))));
 
   return request_id;
 }
 
 int WebContext::deleteAllCookies() {
-  int request_id = GetNextCookieRequestId();
+  int request_id = GetNextRequestId();
 
   context_->GetCookieStore()->DeleteAllAsync(
       base::Bind(&WebContext::DeleteCookiesCallback,
@@ -981,6 +1235,39 @@ void WebContext::clearTemporarySavedPermissionStatuses() {
       ->Clear();
 }
 
+void WebContext::clearTemporarySavedPermissionStatusesForType(
+    PermissionType type) {
+  DCHECK(IsInitialized());
+
+  TemporarySavedPermissionType t =
+      static_cast<TemporarySavedPermissionType>(type);
+
+  context_->GetTemporarySavedPermissionContext()->ClearForType(t);
+  if (!context_->HasOffTheRecordContext()) {
+    return;
+  }
+
+  context_->GetOffTheRecordContext()
+      ->GetTemporarySavedPermissionContext()
+      ->ClearForType(t);
+}
+
+void WebContext::clearTemporarySavedPermissionStatusesForOrigin(
+    const QUrl& origin) {
+  DCHECK(IsInitialized());
+
+  GURL url(origin.toString().toStdString());
+
+  context_->GetTemporarySavedPermissionContext()->ClearForOrigin(url);
+  if (!context_->HasOffTheRecordContext()) {
+    return;
+  }
+
+  context_->GetOffTheRecordContext()
+      ->GetTemporarySavedPermissionContext()
+      ->ClearForOrigin(url);
+}
+
 void WebContext::setLegacyUserAgentOverrideEnabled(bool enabled) {
   if (IsInitialized()) {
     UserAgentSettings::Get(context_.get())->SetLegacyUserAgentOverrideEnabled(
@@ -1014,5 +1301,138 @@ void WebContext::setDoNotTrack(bool dnt) {
   }
 }
 
+bool WebContext::persistentPermissions() const {
+  if (IsInitialized()) {
+    return context_->ShouldPersistPermissions();
+  }
+
+  return construct_props_->persistent_permissions;
+}
+
+void WebContext::setPersistentPermissions(bool persistent) {
+  DCHECK(!IsInitialized());
+  construct_props_->persistent_permissions = persistent;
+}
+
+int WebContext::permissionLifetime() const {
+  if (IsInitialized()) {
+    return context_->GetPermissionLifetime().InSeconds();
+  }
+
+  return construct_props_->permission_lifetime;
+}
+
+void WebContext::setPermissionLifetime(int lifetime) {
+  DCHECK(!IsInitialized());
+  construct_props_->permission_lifetime = lifetime;
+}
+
+void WebContext::requestMemoryUsage() {
+  if (!IsInitialized()) {
+    // Nothing has been created yet, so report an empty sample
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE,
+        base::Bind(&WebContext::OnMemoryUsageSampled,
+                   weak_factory_.GetWeakPtr(),
+                   oxide::BrowserContextMemoryUsage()));
+    return;
+  }
+
+  oxide::MemoryReporter::SampleBrowserContext(
+      context_.get(),
+      base::Bind(&WebContext::OnMemoryUsageSampled,
+                 weak_factory_.GetWeakPtr()));
+}
+
+bool WebContext::addPackedArchive(const QString& scheme, const QUrl& path) {
+  DCHECK(path.isLocalFile());
+
+  std::string lscheme = base::ToLowerASCII(scheme.toStdString());
+  if (lscheme.empty() ||
+      !oxide::URLRequestDelegatedJobFactory::CanDelegateProtocol(lscheme)) {
+    return false;
+  }
+
+  base::FilePath file_path(path.toLocalFile().toStdString());
+
+  if (!IsInitialized()) {
+    construct_props_->packed_archives[lscheme] = file_path;
+    return true;
+  }
+
+  OpenPackedArchive(lscheme, file_path);
+  return true;
+}
+
+void WebContext::removePackedArchive(const QString& scheme) {
+  std::string lscheme = base::ToLowerASCII(scheme.toStdString());
+
+  if (!IsInitialized()) {
+    construct_props_->packed_archives.erase(lscheme);
+    return;
+  }
+
+  packed_archive_requests_.erase(lscheme);
+  if (oxide::URLRequestDelegatedJobFactory::CanDelegateProtocol(lscheme)) {
+    context_->SetPackedArchive(lscheme, nullptr);
+  }
+}
+
+int WebContext::prefetchUrls(const QList<QUrl>& urls) {
+  DCHECK(IsInitialized());
+
+  int request_id = GetNextRequestId();
+
+  std::vector<GURL> gurls;
+  for (const QUrl& url : urls) {
+    gurls.push_back(GURL(url.toString().toStdString()));
+  }
+
+  context_->PrefetchURLs(
+      gurls,
+      base::Bind(&WebContext::OnUrlsPrefetched,
+                 weak_factory_.GetWeakPtr(), request_id));
+
+  return request_id;
+}
+
+int WebContext::getCacheEntryInfo(const QUrl& url) {
+  DCHECK(IsInitialized());
+
+  int request_id = GetNextRequestId();
+
+  context_->GetHttpCacheEntryInfo(
+      GURL(url.toString().toStdString()),
+      base::Bind(&WebContext::OnCacheEntryInfoRetrieved,
+                 weak_factory_.GetWeakPtr(), request_id));
+
+  return request_id;
+}
+
+int WebContext::evictCacheEntries(const QString& url_prefix) {
+  DCHECK(IsInitialized());
+
+  int request_id = GetNextRequestId();
+
+  context_->EvictHttpCacheEntries(
+      url_prefix.toStdString(),
+      base::Bind(&WebContext::OnCacheEntriesEvicted,
+                 weak_factory_.GetWeakPtr(), request_id));
+
+  return request_id;
+}
+
+int WebContext::getCacheStats() {
+  DCHECK(IsInitialized());
+
+  int request_id = GetNextRequestId();
+
+  context_->GetHttpCacheStats(
+      base::Bind(&WebContext::OnCacheStatsRetrieved,
+                 weak_factory_.GetWeakPtr(), request_id));
+
+  return request_id;
+}
+
 } // namespace qt
 } // namespace oxide
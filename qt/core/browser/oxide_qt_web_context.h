@@ -18,6 +18,7 @@
 #ifndef _OXIDE_QT_CORE_BROWSER_WEB_CONTEXT_H_
 #define _OXIDE_QT_CORE_BROWSER_WEB_CONTEXT_H_
 
+#include <map>
 #include <memory>
 #include <QList>
 #include <QtGlobal>
@@ -25,6 +26,7 @@
 #include <QWeakPointer>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
@@ -44,8 +46,13 @@ class CookieStore;
 }
 
 namespace oxide {
+
+struct BrowserContextMemoryUsage;
+class PackedArchive;
+
 namespace qt {
 
+class GetAllCookiesContext;
 class SetCookiesContext;
 class WebContextProxyClient;
 
@@ -83,16 +90,37 @@ class WebContext : public WebContextProxy,
 
   void UpdateUserScripts();
 
-  void SetCookieCallback(scoped_refptr<SetCookiesContext> ctxt,
-                         const QNetworkCookie& cookie,
-                         bool success);
+  void SetCookiesBatchCallback(scoped_refptr<SetCookiesContext> ctxt,
+                               const std::vector<size_t>& failed);
   void DeliverSetCookiesResponse(scoped_refptr<SetCookiesContext> ctxt);
   void GetCookiesCallback(int request_id,
                           const net::CookieList& cookies);
+  void GetAllCookiesChunkCallback(scoped_refptr<GetAllCookiesContext> ctxt,
+                                  const net::CookieList& cookies,
+                                  bool last);
   void DeleteCookiesCallback(int request_id, int num_deleted);
 
   void SetAllowedExtraURLSchemes(const std::set<std::string>& schemes);
 
+  void OnMemoryUsageSampled(const oxide::BrowserContextMemoryUsage& usage);
+
+  void OnUrlsPrefetched(
+      int request_id,
+      const oxide::HttpCacheController::PrefetchResult& result);
+  void OnCacheEntryInfoRetrieved(
+      int request_id,
+      const oxide::HttpCacheController::EntryInfo& info);
+  void OnCacheEntriesEvicted(int request_id, int num_evicted);
+  void OnCacheStatsRetrieved(int request_id,
+                             const oxide::HttpCacheController::Stats& stats);
+
+  void OpenPackedArchive(const std::string& scheme,
+                         const base::FilePath& path);
+  void OnPackedArchiveOpened(
+      const std::string& scheme,
+      int request_id,
+      const scoped_refptr<oxide::PackedArchive>* archive);
+
   // WebContextProxy implementation
   void init(
       const QWeakPointer<WebContextProxyClient::IOClient>& io_client) override;
@@ -139,10 +167,25 @@ class WebContext : public WebContextProxy,
   void setUserAgentOverrides(
       const QList<UserAgentOverride>& overrides) override;
   void clearTemporarySavedPermissionStatuses() override;
+  void clearTemporarySavedPermissionStatusesForType(
+      PermissionType type) override;
+  void clearTemporarySavedPermissionStatusesForOrigin(
+      const QUrl& origin) override;
   void setLegacyUserAgentOverrideEnabled(bool enabled) override;
 
   bool doNotTrack() const override;
   void setDoNotTrack(bool dnt) override;
+  bool persistentPermissions() const override;
+  void setPersistentPermissions(bool persistent) override;
+  int permissionLifetime() const override;
+  void setPermissionLifetime(int lifetime) override;
+  void requestMemoryUsage() override;
+  bool addPackedArchive(const QString& scheme, const QUrl& path) override;
+  void removePackedArchive(const QString& scheme) override;
+  int prefetchUrls(const QList<QUrl>& urls) override;
+  int getCacheEntryInfo(const QUrl& url) override;
+  int evictCacheEntries(const QString& url_prefix) override;
+  int getCacheStats() override;
 
   // oxide::MediaCaptureDevicesContextClient implementation
   void DefaultAudioDeviceChanged() override;
@@ -160,6 +203,11 @@ class WebContext : public WebContextProxy,
 
   QList<QObject*> user_scripts_;
 
+  // The most recent open request for each scheme, so that results for
+  // superseded or removed archives are dropped
+  std::map<std::string, int> packed_archive_requests_;
+  int next_packed_archive_request_id_;
+
   base::WeakPtrFactory<WebContext> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(WebContext);
@@ -31,6 +31,7 @@
 
 #include "shared/browser/oxide_script_message_request_impl_browser.h"
 #include "shared/browser/oxide_web_frame.h"
+#include "shared/common/oxide_script_message_handler.h"
 
 #include "oxide_qt_script_message_handler.h"
 #include "oxide_qt_script_message_request.h"
@@ -127,10 +128,24 @@ void WebFrame::sendMessageNoReply(const QUrl& context,
       VariantValueConverter::FromVariantValue(payload));
 }
 
-QList<QObject*>& WebFrame::messageHandlers() {
+const QList<QObject*>& WebFrame::messageHandlers() const {
   return message_handlers_;
 }
 
+void WebFrame::addMessageHandler(QObject* handler) {
+  message_handlers_.removeOne(handler);
+  message_handlers_.append(handler);
+  oxide::ScriptMessageHandler::ConfigurationChanged();
+}
+
+void WebFrame::removeMessageHandler(QObject* handler) {
+  if (!message_handlers_.removeOne(handler)) {
+    return;
+  }
+
+  oxide::ScriptMessageHandler::ConfigurationChanged();
+}
+
 WebFrame::WebFrame(oxide::WebFrame* frame)
     : frame_(frame),
       client_(nullptr) {
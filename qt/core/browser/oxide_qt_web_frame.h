@@ -70,7 +70,9 @@ class WebFrame : public WebFrameProxy,
   void sendMessageNoReply(const QUrl& context,
                           const QString& msg_id,
                           const QVariant& payload) override;
-  QList<QObject*>& messageHandlers() override;
+  const QList<QObject*>& messageHandlers() const override;
+  void addMessageHandler(QObject* handler) override;
+  void removeMessageHandler(QObject* handler) override;
 
   oxide::WebFrame* frame_; // This is owned in shared/
 
@@ -77,6 +77,7 @@
 #include "qt/core/glue/touch_editing_menu.h"
 #include "qt/core/glue/web_context_menu.h"
 #include "qt/core/glue/web_context_menu_params.h"
+#include "shared/browser/memory_reporter.h"
 #include "shared/browser/oxide_browser_process_main.h"
 #include "shared/browser/oxide_content_types.h"
 #include "shared/browser/oxide_fullscreen_helper.h"
@@ -91,6 +92,7 @@
 #include "shared/browser/ssl/oxide_certificate_error_dispatcher.h"
 #include "shared/browser/web_contents_helper.h"
 #include "shared/common/oxide_enum_flags.h"
+#include "shared/common/oxide_script_message_handler.h"
 
 #include "contents_view_impl.h"
 #include "javascript_dialog_host.h"
@@ -371,7 +373,8 @@ WebView::WebView(WebViewProxyClient* client,
     : contents_view_(new ContentsViewImpl(view_client, handle)),
       client_(client),
       aux_ui_factory_(aux_ui_factory),
-      frame_tree_torn_down_(false) {
+      frame_tree_torn_down_(false),
+      weak_factory_(this) {
   DCHECK(client);
   DCHECK(handle);
 
@@ -417,6 +420,10 @@ void WebView::OnWebProcessStatusChanged() {
   client_->WebProcessStatusChanged();
 }
 
+void WebView::OnMemoryUsageSampled(const oxide::WebViewMemoryUsage& usage) {
+  client_->MemoryUsageAvailable(ToQt(usage));
+}
+
 void WebView::URLChanged() {
   client_->URLChanged();
 }
@@ -975,10 +982,24 @@ void WebView::loadHtml(const QString& html, const QUrl& base_url) {
                   GURL(base_url.toString().toStdString()));
 }
 
-QList<QObject*>& WebView::messageHandlers() {
+const QList<QObject*>& WebView::messageHandlers() const {
   return message_handlers_;
 }
 
+void WebView::addMessageHandler(QObject* handler) {
+  message_handlers_.removeOne(handler);
+  message_handlers_.append(handler);
+  oxide::ScriptMessageHandler::ConfigurationChanged();
+}
+
+void WebView::removeMessageHandler(QObject* handler) {
+  if (!message_handlers_.removeOne(handler)) {
+    return;
+  }
+
+  oxide::ScriptMessageHandler::ConfigurationChanged();
+}
+
 QByteArray WebView::currentState() const {
   // XXX(chrisccoulson): Move the pickling in to oxide::WebView
   std::vector<sessions::SerializedNavigationEntry> entries = web_view_->GetState();
@@ -1179,6 +1200,13 @@ void WebView::teardownFrameTree() {
   frame_tree_torn_down_ = true;
 }
 
+void WebView::requestMemoryUsage() {
+  oxide::MemoryReporter::SampleWebView(
+      web_view_.get(),
+      base::Bind(&WebView::OnMemoryUsageSampled,
+                 weak_factory_.GetWeakPtr()));
+}
+
 WebView::WebView(WebViewProxyClient* client,
                  ContentsViewClient* view_client,
                  AuxiliaryUIFactory* aux_ui_factory,
@@ -26,6 +26,7 @@
 #include <QtGlobal>
 
 #include "base/macros.h"
+#include "base/memory/weak_ptr.h"
 #include "content/public/browser/host_zoom_map.h"
 
 #include "qt/core/glue/oxide_qt_web_view_proxy.h"
@@ -50,6 +51,7 @@ class OxideQWebPreferences;
 namespace oxide {
 
 class WebView;
+struct WebViewMemoryUsage;
 
 namespace qt {
 
@@ -100,6 +102,8 @@ class WebView : public oxide::WebViewClient,
 
   void OnWebProcessStatusChanged();
 
+  void OnMemoryUsageSampled(const oxide::WebViewMemoryUsage& usage);
+
   // oxide::WebViewClient implementation
   void URLChanged() override;
   void TitleChanged() override;
@@ -228,7 +232,9 @@ class WebView : public oxide::WebViewClient,
 
   void loadHtml(const QString& html, const QUrl& base_url) override;
 
-  QList<QObject*>& messageHandlers() override;
+  const QList<QObject*>& messageHandlers() const override;
+  void addMessageHandler(QObject* handler) override;
+  void removeMessageHandler(QObject* handler) override;
 
   QByteArray currentState() const override;
 
@@ -262,6 +268,7 @@ class WebView : public oxide::WebViewClient,
   void setZoomFactor(qreal factor) override;
 
   void teardownFrameTree() override;
+  void requestMemoryUsage() override;
 
   std::unique_ptr<ContentsViewImpl> contents_view_;
 
@@ -280,6 +287,8 @@ class WebView : public oxide::WebViewClient,
   std::unique_ptr<oxide::WebProcessStatusMonitor::Subscription>
       web_process_status_subscription_;
 
+  base::WeakPtrFactory<WebView> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(WebView);
 };
 
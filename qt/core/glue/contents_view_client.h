@@ -58,6 +58,10 @@ class OXIDE_QTCORE_EXPORT ContentsViewClient {
 
   virtual QRect GetBounds() const = 0;
 
+  // Returns a device scale factor that replaces the one derived from the
+  // screen, or 0 to use the screen's scale factor
+  virtual float GetDeviceScaleFactorOverride() const { return 0.f; }
+
   virtual void ScheduleUpdate() = 0;
   virtual void EvictCurrentFrame() = 0;
 
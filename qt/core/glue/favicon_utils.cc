@@ -0,0 +1,48 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#include "favicon_utils.h"
+
+#include <QUrl>
+
+#include "url/gurl.h"
+
+#include "shared/browser/favicon_service.h"
+#include "shared/browser/oxide_browser_process_main.h"
+
+namespace oxide {
+namespace qt {
+
+QImage GetFaviconForPage(const QUrl& page_url, int desired_size) {
+  if (!BrowserProcessMain::GetInstance()->IsRunning()) {
+    return QImage();
+  }
+
+  FaviconCache::Bitmap bitmap;
+  if (!FaviconService::GetBitmapForPageFromAnyContext(
+          GURL(page_url.toString().toStdString()),
+          desired_size,
+          &bitmap)) {
+    return QImage();
+  }
+
+  return QImage::fromData(bitmap.png_data.data(),
+                          static_cast<int>(bitmap.png_data.size()),
+                          "PNG");
+}
+
+} // namespace qt
+} // namespace oxide
@@ -0,0 +1,54 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#ifndef _OXIDE_QT_CORE_GLUE_MEMORY_USAGE_H_
+#define _OXIDE_QT_CORE_GLUE_MEMORY_USAGE_H_
+
+#include <QList>
+#include <QtGlobal>
+#include <QUrl>
+
+namespace oxide {
+namespace qt {
+
+struct RendererMemoryUsage {
+  int processId = 0;
+  qint64 privateBytes = 0;
+  qint64 sharedBytes = 0;
+  QList<QUrl> sites;
+};
+
+struct WebViewMemoryUsage {
+  RendererMemoryUsage renderer;
+  int compositorFrameCount = 0;
+  qint64 compositorFrameBytes = 0;
+  int navigationEntryCount = 0;
+};
+
+struct WebContextMemoryUsage {
+  QList<RendererMemoryUsage> renderers;
+  int webViewCount = 0;
+  int compositorFrameCount = 0;
+  qint64 compositorFrameBytes = 0;
+  int navigationEntryCount = 0;
+  qint64 httpCacheBytes = -1;
+  qint64 faviconCacheBytes = 0;
+};
+
+} // namespace qt
+} // namespace oxide
+
+#endif // _OXIDE_QT_CORE_GLUE_MEMORY_USAGE_H_
@@ -50,7 +50,14 @@ class OXIDE_QTCORE_EXPORT ScriptMessageHandlerProxy
   virtual QList<QUrl> contexts() const  = 0;
   virtual void setContexts(const QList<QUrl>& contexts) = 0;
 
+  // Deliver messages on the UI thread via
+  // ScriptMessageHandlerProxyClient::ReceiveMessage
   virtual void attachHandler() = 0;
+
+  // Deliver messages via ScriptMessageHandlerProxyClient::ReceiveWorkerMessage
+  // without involving the UI thread
+  virtual void attachWorkerHandler() = 0;
+
   virtual void detachHandler() = 0;
 };
 
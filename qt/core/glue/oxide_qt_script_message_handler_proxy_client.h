@@ -35,6 +35,12 @@ class ScriptMessageHandlerProxyClient {
 
   virtual bool ReceiveMessage(ScriptMessageProxy* message,
                               QVariant* error) = 0;
+
+  // Called on an arbitrary thread when attached with
+  // ScriptMessageHandlerProxy::attachWorkerHandler. This takes ownership of
+  // |message|, and must be thread-safe. It won't be called after
+  // ScriptMessageHandlerProxy::detachHandler returns
+  virtual void ReceiveWorkerMessage(ScriptMessageProxy* message) = 0;
 };
 
 } // namespace qt
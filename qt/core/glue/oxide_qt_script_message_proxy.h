@@ -40,6 +40,10 @@ class OXIDE_QTCORE_EXPORT ScriptMessageProxy {
   virtual QVariant payload() const = 0;
   virtual void reply(const QVariant& payload) = 0;
   virtual void error(const QVariant& payload) = 0;
+
+  // Report that the handler threw an uncaught exception. This is for
+  // handlers that dispatch messages themselves, such as worker handlers
+  virtual void uncaughtException(const QVariant& payload) = 0;
 };
 
 } // namespace qt
@@ -65,6 +65,13 @@ class OXIDE_QTCORE_EXPORT WebContextProxy : public ProxyBase<WebContext> {
     SessionCookieModeRestored
   };
 
+  enum PermissionType {
+    PermissionTypeGeolocation,
+    PermissionTypeMicrophone,
+    PermissionTypeCamera,
+    PermissionTypeNotifications
+  };
+
   virtual void init(
       const QWeakPointer<WebContextProxyClient::IOClient>& io_client) = 0;
 
@@ -132,11 +139,44 @@ class OXIDE_QTCORE_EXPORT WebContextProxy : public ProxyBase<WebContext> {
       const QList<UserAgentOverride>& overrides) = 0;
 
   virtual void clearTemporarySavedPermissionStatuses() = 0;
+  virtual void clearTemporarySavedPermissionStatusesForType(
+      PermissionType type) = 0;
+  virtual void clearTemporarySavedPermissionStatusesForOrigin(
+      const QUrl& origin) = 0;
 
+  // Also discards cached results, so this should be called whenever the
+  // delegate that handles GetUserAgentOverride changes
   virtual void setLegacyUserAgentOverrideEnabled(bool enabled) = 0;
 
   virtual bool doNotTrack() const = 0;
   virtual void setDoNotTrack(bool dnt) = 0;
+
+  virtual bool persistentPermissions() const = 0;
+  virtual void setPersistentPermissions(bool persistent) = 0;
+
+  // In seconds. Zero means that saved permission decisions don't expire
+  virtual int permissionLifetime() const = 0;
+  virtual void setPermissionLifetime(int lifetime) = 0;
+
+  // Asynchronously samples the memory used by this context. The result is
+  // delivered via WebContextProxyClient::MemoryUsageAvailable
+  virtual void requestMemoryUsage() = 0;
+
+  // Serve requests for |scheme| from the archive at |path|, replacing any
+  // archive already registered for |scheme|. Returns false if |scheme| can't
+  // be served from an archive. Otherwise, the archive is opened
+  // asynchronously and the result delivered via
+  // WebContextProxyClient::PackedArchiveAdded
+  virtual bool addPackedArchive(const QString& scheme, const QUrl& path) = 0;
+  virtual void removePackedArchive(const QString& scheme) = 0;
+
+  // HTTP cache control. These must only be called once initialized. Each
+  // returns a request ID, and the result is delivered asynchronously via
+  // the corresponding WebContextProxyClient method
+  virtual int prefetchUrls(const QList<QUrl>& urls) = 0;
+  virtual int getCacheEntryInfo(const QUrl& url) = 0;
+  virtual int evictCacheEntries(const QString& url_prefix) = 0;
+  virtual int getCacheStats() = 0;
 };
 
 } // namespace qt
@@ -21,6 +21,11 @@
 #include <QString>
 #include <QtGlobal>
 
+#include <functional>
+
+#include "qt/core/glue/http_cache_stats.h"
+#include "qt/core/glue/memory_usage.h"
+
 class OxideQBeforeRedirectEvent;
 class OxideQBeforeSendHeadersEvent;
 class OxideQBeforeURLRequestEvent;
@@ -51,15 +56,45 @@ class WebContextProxyClient {
 
   virtual void DefaultVideoCaptureDeviceChanged() = 0;
 
+  virtual void MemoryUsageAvailable(const WebContextMemoryUsage& usage) = 0;
+
+  virtual void PackedArchiveAdded(const QString& scheme, bool success) = 0;
+
+  virtual void UrlsPrefetched(int request_id, int succeeded, int failed) = 0;
+  virtual void CacheEntryInfoRetrieved(int request_id,
+                                       bool cached,
+                                       qint64 size) = 0;
+  virtual void CacheEntriesEvicted(int request_id, int num_evicted) = 0;
+  virtual void CacheStatsRetrieved(int request_id,
+                                   const HttpCacheStats& stats) = 0;
+
   class IOClient {
    public:
     virtual ~IOClient() {}
 
-    virtual void OnBeforeURLRequest(OxideQBeforeURLRequestEvent* event) = 0;
+    // The network callbacks are called on Chromium's IO thread. If the
+    // client accepts |event| by returning true, it must run |done| exactly
+    // once when it has finished with it, which it may do asynchronously and
+    // from any thread. |event| remains valid until then. If the client
+    // returns false, |done| is never run
+    typedef std::function<void()> DoneCallback;
+
+    virtual bool OnBeforeURLRequest(OxideQBeforeURLRequestEvent* event,
+                                    const DoneCallback& done) = 0;
+
+    virtual bool OnBeforeSendHeaders(OxideQBeforeSendHeadersEvent* event,
+                                     const DoneCallback& done) = 0;
+
+    virtual bool OnBeforeRedirect(OxideQBeforeRedirectEvent* event,
+                                  const DoneCallback& done) = 0;
 
-    virtual void OnBeforeSendHeaders(OxideQBeforeSendHeadersEvent* event) = 0;
+    // How long to wait for |done| before continuing without it, in
+    // milliseconds. 0 means wait indefinitely
+    virtual int GetNetworkCallbackTimeout() = 0;
 
-    virtual void OnBeforeRedirect(OxideQBeforeRedirectEvent* event) = 0;
+    // Whether requests should be cancelled rather than allowed to continue
+    // when a network callback times out
+    virtual bool CancelRequestOnNetworkCallbackTimeout() = 0;
 
     virtual QString GetUserAgentOverride(const QUrl& url) = 0;
   };
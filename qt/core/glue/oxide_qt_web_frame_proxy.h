@@ -56,7 +56,12 @@ class OXIDE_QTCORE_EXPORT WebFrameProxy : public ProxyBase<WebFrame> {
                                   const QString& msg_id,
                                   const QVariant& payload) = 0;
 
-  virtual QList<QObject*>& messageHandlers() = 0;
+  virtual const QList<QObject*>& messageHandlers() const = 0;
+
+  // Attaches |handler|, moving it to the end of the list if it is already
+  // attached
+  virtual void addMessageHandler(QObject* handler) = 0;
+  virtual void removeMessageHandler(QObject* handler) = 0;
 };
 
 } // namespace qt
@@ -125,7 +125,12 @@ class OXIDE_QTCORE_EXPORT WebViewProxy : public ProxyBase<WebView> {
 
   virtual void loadHtml(const QString& html, const QUrl& base_url) = 0;
 
-  virtual QList<QObject*>& messageHandlers() = 0;
+  virtual const QList<QObject*>& messageHandlers() const = 0;
+
+  // Attaches |handler|, moving it to the end of the list if it is already
+  // attached
+  virtual void addMessageHandler(QObject* handler) = 0;
+  virtual void removeMessageHandler(QObject* handler) = 0;
 
   virtual QByteArray currentState() const = 0;
 
@@ -161,6 +166,10 @@ class OXIDE_QTCORE_EXPORT WebViewProxy : public ProxyBase<WebView> {
   static qreal maximumZoomFactor();
 
   virtual void teardownFrameTree() = 0;
+
+  // Asynchronously samples the memory used by this view. The result is
+  // delivered via WebViewProxyClient::MemoryUsageAvailable
+  virtual void requestMemoryUsage() = 0;
 };
 
 } // namespace qt
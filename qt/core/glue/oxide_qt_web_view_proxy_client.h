@@ -24,6 +24,7 @@
 #include <QRect>
 #include <QtGlobal>
 
+#include "qt/core/glue/memory_usage.h"
 #include "qt/core/glue/menu_item.h"
 
 class OxideQCertificateError;
@@ -124,6 +125,8 @@ class WebViewProxyClient {
   virtual void OnEditingCapabilitiesChanged() = 0;
   
   virtual void ZoomLevelChanged() = 0;
+
+  virtual void MemoryUsageAvailable(const WebViewMemoryUsage& usage) = 0;
 };
 
 } // namespace qt
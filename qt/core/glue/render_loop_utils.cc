@@ -0,0 +1,51 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "render_loop_utils.h"
+
+#include "shared/browser/compositor/oxide_compositor_frame_clock.h"
+#include "shared/browser/oxide_browser_process_main.h"
+
+namespace oxide {
+namespace qt {
+
+void WindowWillSynchronize(QWindow* window) {
+  if (!BrowserProcessMain::GetInstance()->IsRunning()) {
+    return;
+  }
+
+  CompositorFrameClock::WindowWillSynchronize(window);
+}
+
+void WindowFrameSwapped(QWindow* window) {
+  if (!BrowserProcessMain::GetInstance()->IsRunning()) {
+    return;
+  }
+
+  CompositorFrameClock::WindowFrameSwapped(window);
+}
+
+void WindowRenderLoopStopped(QWindow* window) {
+  if (!BrowserProcessMain::GetInstance()->IsRunning()) {
+    return;
+  }
+
+  CompositorFrameClock::WindowRenderLoopStopped(window);
+}
+
+} // namespace qt
+} // namespace oxide
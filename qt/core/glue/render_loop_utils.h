@@ -0,0 +1,50 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_QT_CORE_GLUE_RENDER_LOOP_UTILS_H_
+#define _OXIDE_QT_CORE_GLUE_RENDER_LOOP_UTILS_H_
+
+#include <QtGlobal>
+
+#include "qt/core/api/oxideqglobal.h"
+
+QT_BEGIN_NAMESPACE
+class QWindow;
+QT_END_NAMESPACE
+
+namespace oxide {
+namespace qt {
+
+// Notifications from the render loop of |window|, which are used to
+// synchronize the begin frames of web views in |window| with the frames that
+// it renders. These can be called on any thread
+
+// Called before the render loop synchronizes the scene graph with the items
+// in |window|
+OXIDE_QTCORE_EXPORT void WindowWillSynchronize(QWindow* window);
+
+// Called after the render loop has swapped a frame for |window|
+OXIDE_QTCORE_EXPORT void WindowFrameSwapped(QWindow* window);
+
+// Called when the render loop stops rendering |window|, eg, because it has
+// been hidden
+OXIDE_QTCORE_EXPORT void WindowRenderLoopStopped(QWindow* window);
+
+} // namespace qt
+} // namespace oxide
+
+#endif // _OXIDE_QT_CORE_GLUE_RENDER_LOOP_UTILS_H_
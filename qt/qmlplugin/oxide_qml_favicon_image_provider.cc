@@ -0,0 +1,59 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#include "oxide_qml_favicon_image_provider.h"
+
+#include <QUrl>
+
+#include "qt/core/glue/favicon_utils.h"
+
+namespace oxide {
+namespace qmlplugin {
+
+FaviconImageProvider::FaviconImageProvider()
+    : QQuickImageProvider(QQuickImageProvider::Image,
+                          QQuickImageProvider::ForceAsynchronousImageLoading) {}
+
+FaviconImageProvider::~FaviconImageProvider() {}
+
+QImage FaviconImageProvider::requestImage(const QString& id,
+                                          QSize* size,
+                                          const QSize& requested_size) {
+  QString encoded_page_url = id.section(QLatin1Char('?'), 0, 0);
+  QUrl page_url(QUrl::fromPercentEncoding(encoded_page_url.toUtf8()));
+  int desired_size = qMax(requested_size.width(), requested_size.height());
+
+  QImage image = oxide::qt::GetFaviconForPage(page_url, desired_size);
+  if (image.isNull()) {
+    return image;
+  }
+
+  if (size) {
+    *size = image.size();
+  }
+
+  if (requested_size.isValid() && !requested_size.isEmpty() &&
+      image.size() != requested_size) {
+    image = image.scaled(requested_size,
+                         Qt::KeepAspectRatio,
+                         Qt::SmoothTransformation);
+  }
+
+  return image;
+}
+
+} // namespace qmlplugin
+} // namespace oxide
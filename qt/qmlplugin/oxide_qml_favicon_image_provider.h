@@ -0,0 +1,43 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#ifndef _OXIDE_QMLPLUGIN_FAVICON_IMAGE_PROVIDER_H_
+#define _OXIDE_QMLPLUGIN_FAVICON_IMAGE_PROVIDER_H_
+
+#include <QQuickImageProvider>
+#include <QtGlobal>
+
+namespace oxide {
+namespace qmlplugin {
+
+// Provides cached favicons to QML via image://oxide-favicon/<page-url>, where
+// <page-url> is percent-encoded. Any unencoded query is ignored, which allows
+// applications to reload the image when the cached icon changes
+class FaviconImageProvider : public QQuickImageProvider {
+ public:
+  FaviconImageProvider();
+  ~FaviconImageProvider() override;
+
+  // QQuickImageProvider implementation
+  QImage requestImage(const QString& id,
+                      QSize* size,
+                      const QSize& requested_size) override;
+};
+
+} // namespace qmlplugin
+} // namespace oxide
+
+#endif // _OXIDE_QMLPLUGIN_FAVICON_IMAGE_PROVIDER_H_
@@ -35,6 +35,7 @@
 #include "qt/core/api/oxideqsslcertificate.h"
 #include "qt/core/api/oxideqwebpreferences.h"
 #include "qt/quick/api/oxideqquickcookiemanager_p.h"
+#include "qt/quick/api/oxideqquickframemetadata.h"
 #include "qt/quick/api/oxideqquickglobal_p.h"
 #include "qt/quick/api/oxideqquicklocationbarcontroller.h"
 #include "qt/quick/api/oxideqquicknavigationhistory.h"
@@ -48,6 +49,8 @@
 #include "qt/quick/api/oxideqquickwebframe.h"
 #include "qt/quick/api/oxideqquickwebview.h"
 
+#include "oxide_qml_favicon_image_provider.h"
+
 #ifdef LEGACY_QMLVALUE_TYPES
 #include "oxide_qml_download_request.h"
 #include "oxide_qml_load_event.h"
@@ -84,6 +87,12 @@ class OxideQmlPlugin : public QQmlExtensionPlugin {
   Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QQmlExtensionInterface" FILE "oxide_qml_plugin.json")
   Q_OBJECT
  public:
+  void initializeEngine(QQmlEngine* engine, const char* uri) {
+    Q_UNUSED(uri);
+    engine->addImageProvider(QLatin1String("oxide-favicon"),
+                             new oxide::qmlplugin::FaviconImageProvider());
+  }
+
   void registerTypes(const char* uri) {
     Q_ASSERT(QLatin1String(uri) == QLatin1String("com.canonical.Oxide"));
 
@@ -215,6 +224,16 @@ class OxideQmlPlugin : public QQmlExtensionPlugin {
     qmlRegisterUncreatableType<OxideQQuickNavigationHistory, 1>(
         uri, 1, 19, "NavigationHistory",
         "NavigationHistory is accessed via WebView.navigationHistory");
+
+    qmlRegisterType<OxideQQuickScriptMessageHandler, 1>(
+        uri, 1, 23, "ScriptMessageHandler");
+    qmlRegisterType<OxideQQuickWebContextDelegateWorker, 1>(
+        uri, 1, 23, "WebContextDelegateWorker");
+    qmlRegisterType<OxideQQuickWebContext, 4>(uri, 1, 23, "WebContext");
+    qmlRegisterUncreatableType<OxideQQuickFrameMetadata>(
+        uri, 1, 23, "FrameMetadata",
+        "FrameMetadata is accessed via WebView.frameMetadata");
+    qmlRegisterType<OxideQQuickWebView, 10>(uri, 1, 23, "WebView");
   }
 };
 
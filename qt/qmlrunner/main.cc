@@ -51,6 +51,8 @@ void usage(bool error) {
   qWarning("  --slow-animations ............... Run all animations in slow motion");
   qWarning("  --quit .......................... Quit immediately after starting");
   qWarning("  --resize-to-root ................ Resize the window to the size of the root item");
+  qWarning("  --headless ...................... Run without a window or GL context. The root item");
+  qWarning("                                    must set WebView.headless on its WebViews");
 
   qWarning(" ");
   exit(error ? 1 : 0);
@@ -62,7 +64,8 @@ struct Options {
       fullscreen(false),
       slowAnimations(false),
       quit(false),
-      resizeToRoot(false) {}
+      resizeToRoot(false),
+      headless(false) {}
 
   QUrl file;
   bool maximized;
@@ -70,6 +73,7 @@ struct Options {
   bool slowAnimations;
   bool quit;
   bool resizeToRoot;
+  bool headless;
 };
 
 int main(int argc, char** argv) {
@@ -92,6 +96,8 @@ int main(int argc, char** argv) {
         options.quit = true;
       } else if (larg == QLatin1String("--resize-to-root")) {
         options.resizeToRoot = true;
+      } else if (larg == QLatin1String("--headless")) {
+        options.headless = true;
       } else if (larg == QLatin1String("-i") && i + 1 < argc) {
         imports.append(QString::fromLatin1(argv[++i]));
       } else if (larg == QLatin1String("-h") ||
@@ -105,16 +111,25 @@ int main(int argc, char** argv) {
     usage(true);
   }
 
+  if (options.headless && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+    // Don't depend on a display server
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+
   QGuiApplication app(argc, argv);
   app.setApplicationName("OxideQmlViewer");
 
+  // Headless WebViews render with the software compositor, so there's no
+  // need for a shared GL context
   QOpenGLContext glcontext;
-  glcontext.create();
+  if (!options.headless) {
+    glcontext.create();
 #if QT_VERSION < QT_VERSION_CHECK(5, 3, 0)
-  QSGContext::setSharedOpenGLContext(&glcontext);
+    QSGContext::setSharedOpenGLContext(&glcontext);
 #else
-  QOpenGLContextPrivate::setGlobalShareContext(&glcontext);
+    QOpenGLContextPrivate::setGlobalShareContext(&glcontext);
 #endif
+  }
 
   QUnifiedTimer::instance()->setSlowModeEnabled(options.slowAnimations);
 
@@ -138,6 +153,15 @@ int main(int argc, char** argv) {
     return -1;
   }
 
+  if (options.headless) {
+    // Keep the root object alive without creating a window for it
+    QScopedPointer<QObject> root(toplevel);
+    if (options.quit) {
+      QMetaObject::invokeMethod(QCoreApplication::instance(), "quit", Qt::QueuedConnection);
+    }
+    return app.exec();
+  }
+
   QScopedPointer<QQuickWindow> window(qobject_cast<QQuickWindow *>(toplevel));
   if (window) {
     engine.setIncubationController(window->incubationController());
@@ -0,0 +1,218 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "accelerated_frame_reader.h"
+
+#include <cstring>
+#include <vector>
+
+#include <QImage>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QtDebug>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 3, 0) && \
+    QT_VERSION < QT_VERSION_CHECK(5, 4, 0)
+#include <QtGui/private/qopenglcontext_p.h>
+#endif
+
+#include "qt/core/glue/contents_view.h"
+
+namespace oxide {
+namespace qquick {
+
+namespace {
+
+QOpenGLContext* GetGlobalShareContext() {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 4, 0)
+  return QOpenGLContext::globalShareContext();
+#elif QT_VERSION >= QT_VERSION_CHECK(5, 3, 0)
+  return QOpenGLContextPrivate::globalShareContext();
+#else
+  return nullptr;
+#endif
+}
+
+// GL's origin is the bottom left, whereas QImage's is the top left
+void FlipVertically(QImage* image) {
+  std::vector<uchar> line(image->bytesPerLine());
+  for (int y = 0; y < image->height() / 2; ++y) {
+    uchar* top = image->scanLine(y);
+    uchar* bottom = image->scanLine(image->height() - y - 1);
+    memcpy(line.data(), top, line.size());
+    memcpy(top, bottom, line.size());
+    memcpy(bottom, line.data(), line.size());
+  }
+}
+
+}
+
+bool AcceleratedFrameReader::ensureContext() {
+  if (context_) {
+    return true;
+  }
+
+  QOpenGLContext* share_context = GetGlobalShareContext();
+  if (!share_context) {
+    qWarning() <<
+        "AcceleratedFrameReader: Can't read frames without a global share "
+        "context";
+    return false;
+  }
+
+  QScopedPointer<QOpenGLContext> context(new QOpenGLContext());
+  context->setFormat(share_context->format());
+  context->setShareContext(share_context);
+  if (!context->create()) {
+    qWarning() << "AcceleratedFrameReader: Failed to create a GL context";
+    return false;
+  }
+
+  QScopedPointer<QOffscreenSurface> surface(new QOffscreenSurface());
+  surface->setFormat(context->format());
+  surface->create();
+  if (!surface->isValid() || !context->makeCurrent(surface.data())) {
+    qWarning() << "AcceleratedFrameReader: Failed to create an offscreen "
+                  "surface";
+    return false;
+  }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 3, 0)
+  QOpenGLFunctions* functions = context->functions();
+  functions->glGenFramebuffers(1, &framebuffer_);
+  functions->glGenTextures(1, &image_texture_);
+#endif
+
+  context->doneCurrent();
+
+  context_.swap(context);
+  surface_.swap(surface);
+
+  return true;
+}
+
+void AcceleratedFrameReader::releaseContext() {
+  if (!context_) {
+    return;
+  }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 3, 0)
+  if (context_->makeCurrent(surface_.data())) {
+    QOpenGLFunctions* functions = context_->functions();
+    functions->glDeleteFramebuffers(1, &framebuffer_);
+    functions->glDeleteTextures(1, &image_texture_);
+    context_->doneCurrent();
+  }
+#endif
+
+  framebuffer_ = 0;
+  image_texture_ = 0;
+
+  context_.reset();
+  surface_.reset();
+}
+
+AcceleratedFrameReader::AcceleratedFrameReader()
+    : framebuffer_(0),
+      image_texture_(0) {}
+
+AcceleratedFrameReader::~AcceleratedFrameReader() {
+  releaseContext();
+}
+
+bool AcceleratedFrameReader::read(qt::CompositorFrameHandle* handle,
+                                  QImage* buffer) {
+  Q_ASSERT(buffer->size() == handle->GetSizeInPixels());
+  Q_ASSERT(buffer->format() == QImage::Format_RGBA8888_Premultiplied);
+
+#if QT_VERSION < QT_VERSION_CHECK(5, 3, 0)
+  qWarning() << "AcceleratedFrameReader: Reading frames requires Qt 5.3";
+  return false;
+#else
+  if (!ensureContext()) {
+    return false;
+  }
+
+  if (!context_->makeCurrent(surface_.data())) {
+    qWarning() << "AcceleratedFrameReader: Failed to make context current";
+    return false;
+  }
+
+  QOpenGLFunctions* functions = context_->functions();
+
+  GLuint texture = 0;
+  switch (handle->GetType()) {
+    case qt::CompositorFrameHandle::TYPE_ACCELERATED:
+      texture = handle->GetAcceleratedFrameTexture();
+      break;
+    case qt::CompositorFrameHandle::TYPE_IMAGE: {
+      typedef void (*glEGLImageTargetTexture2DOESProc)(GLenum target,
+                                                       GLeglImageOES image);
+      glEGLImageTargetTexture2DOESProc glEGLImageTargetTexture2DOESFn =
+          reinterpret_cast<glEGLImageTargetTexture2DOESProc>(
+            context_->getProcAddress("glEGLImageTargetTexture2DOES"));
+      if (!glEGLImageTargetTexture2DOESFn) {
+        qWarning() <<
+            "AcceleratedFrameReader: glEGLImageTargetTexture2DOES is not "
+            "available";
+        context_->doneCurrent();
+        return false;
+      }
+
+      functions->glBindTexture(GL_TEXTURE_2D, image_texture_);
+      glEGLImageTargetTexture2DOESFn(GL_TEXTURE_2D, handle->GetImageFrame());
+      functions->glBindTexture(GL_TEXTURE_2D, 0);
+      texture = image_texture_;
+      break;
+    }
+    default:
+      Q_UNREACHABLE();
+  }
+
+  functions->glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+  functions->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                    GL_TEXTURE_2D, texture, 0);
+
+  bool complete =
+      functions->glCheckFramebufferStatus(GL_FRAMEBUFFER) ==
+          GL_FRAMEBUFFER_COMPLETE;
+  if (complete) {
+    functions->glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    functions->glReadPixels(0, 0, buffer->width(), buffer->height(),
+                            GL_RGBA, GL_UNSIGNED_BYTE, buffer->bits());
+  }
+
+  functions->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                    GL_TEXTURE_2D, 0, 0);
+  functions->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  bool success = complete && functions->glGetError() == GL_NO_ERROR;
+
+  context_->doneCurrent();
+
+  if (!success) {
+    qWarning() << "AcceleratedFrameReader: Failed to read frame";
+    return false;
+  }
+
+  FlipVertically(buffer);
+
+  return true;
+#endif
+}
+
+} // namespace qquick
+} // namespace oxide
@@ -0,0 +1,71 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_QQUICK_ACCELERATED_FRAME_READER_H_
+#define _OXIDE_QQUICK_ACCELERATED_FRAME_READER_H_
+
+#include <QOpenGLFunctions>
+#include <QScopedPointer>
+#include <QtGlobal>
+
+QT_BEGIN_NAMESPACE
+class QImage;
+class QOffscreenSurface;
+class QOpenGLContext;
+QT_END_NAMESPACE
+
+namespace oxide {
+
+namespace qt {
+class CompositorFrameHandle;
+}
+
+namespace qquick {
+
+// Reads accelerated compositor frames back in to system memory, for headless
+// views. Frames are textures in Qt's global share group, so this uses its own
+// context in that share group and doesn't need a window
+class AcceleratedFrameReader {
+ public:
+  AcceleratedFrameReader();
+  ~AcceleratedFrameReader();
+
+  // Reads the frame in |handle| in to |buffer|, which must be the size of
+  // the frame in pixels with the format
+  // QImage::Format_RGBA8888_Premultiplied. Returns false if the frame
+  // couldn't be read
+  bool read(qt::CompositorFrameHandle* handle, QImage* buffer);
+
+ private:
+  bool ensureContext();
+  void releaseContext();
+
+  QScopedPointer<QOpenGLContext> context_;
+  QScopedPointer<QOffscreenSurface> surface_;
+
+  GLuint framebuffer_;
+
+  // Used to bind EGLImage frames
+  GLuint image_texture_;
+
+  Q_DISABLE_COPY(AcceleratedFrameReader)
+};
+
+} // namespace qquick
+} // namespace oxide
+
+#endif // _OXIDE_QQUICK_ACCELERATED_FRAME_READER_H_
@@ -0,0 +1,172 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "oxideqquickframemetadata.h"
+#include "oxideqquickframemetadata_p.h"
+
+OxideQQuickFrameMetadataPrivate::OxideQQuickFrameMetadataPrivate(
+    OxideQQuickFrameMetadata* q)
+    : q_ptr(q) {}
+
+OxideQQuickFrameMetadataPrivate::~OxideQQuickFrameMetadataPrivate() = default;
+
+// static
+std::unique_ptr<OxideQQuickFrameMetadata>
+OxideQQuickFrameMetadataPrivate::create() {
+  return std::unique_ptr<OxideQQuickFrameMetadata>(
+      new OxideQQuickFrameMetadata());
+}
+
+// static
+OxideQQuickFrameMetadataPrivate* OxideQQuickFrameMetadataPrivate::get(
+    OxideQQuickFrameMetadata* q) {
+  return q->d_func();
+}
+
+bool OxideQQuickFrameMetadataPrivate::update(const QPoint& scroll_offset,
+                                             const QSize& content_size,
+                                             const QSize& viewport_size) {
+  Q_Q(OxideQQuickFrameMetadata);
+
+  if (scroll_offset == scroll_offset_ &&
+      content_size == content_size_ &&
+      viewport_size == viewport_size_) {
+    return false;
+  }
+
+  scroll_offset_ = scroll_offset;
+  content_size_ = content_size;
+  viewport_size_ = viewport_size;
+
+  Q_EMIT q->changed();
+
+  return true;
+}
+
+/*!
+\class OxideQQuickFrameMetadata
+\inmodule OxideQtQuick
+\inheaderfile oxideqquickframemetadata.h
+\since OxideQt 1.23
+
+\brief Snapshot of the compositor frame metadata for a webview
+*/
+
+/*!
+\qmltype FrameMetadata
+\inqmlmodule com.canonical.Oxide 1.23
+\instantiates OxideQQuickFrameMetadata
+\since OxideQt 1.23
+
+\brief Snapshot of the compositor frame metadata for a webview
+
+FrameMetadata provides the scroll offset, content size and viewport size of the
+most recent compositor frame, in device-independent pixels.
+
+The snapshot is updated at most once per QtQuick frame, and all of the
+properties share a single \l{changed} signal. Applications that bind several
+properties to the geometry of the page (eg, scrollbars) should use this rather
+than the per-property notifications on WebView, which would otherwise cause
+bindings to be re-evaluated once for each property.
+*/
+
+OxideQQuickFrameMetadata::OxideQQuickFrameMetadata()
+    : d_ptr(new OxideQQuickFrameMetadataPrivate(this)) {}
+
+/*!
+\internal
+*/
+
+OxideQQuickFrameMetadata::~OxideQQuickFrameMetadata() = default;
+
+/*!
+\qmlproperty real FrameMetadata::contentX
+
+The horizontal scroll offset of the page.
+*/
+
+qreal OxideQQuickFrameMetadata::contentX() const {
+  Q_D(const OxideQQuickFrameMetadata);
+
+  return d->scroll_offset_.x();
+}
+
+/*!
+\qmlproperty real FrameMetadata::contentY
+
+The vertical scroll offset of the page.
+*/
+
+qreal OxideQQuickFrameMetadata::contentY() const {
+  Q_D(const OxideQQuickFrameMetadata);
+
+  return d->scroll_offset_.y();
+}
+
+/*!
+\qmlproperty real FrameMetadata::contentWidth
+
+The width of the page content.
+*/
+
+qreal OxideQQuickFrameMetadata::contentWidth() const {
+  Q_D(const OxideQQuickFrameMetadata);
+
+  return d->content_size_.width();
+}
+
+/*!
+\qmlproperty real FrameMetadata::contentHeight
+
+The height of the page content.
+*/
+
+qreal OxideQQuickFrameMetadata::contentHeight() const {
+  Q_D(const OxideQQuickFrameMetadata);
+
+  return d->content_size_.height();
+}
+
+/*!
+\qmlproperty real FrameMetadata::viewportWidth
+
+The width of the viewport.
+*/
+
+qreal OxideQQuickFrameMetadata::viewportWidth() const {
+  Q_D(const OxideQQuickFrameMetadata);
+
+  return d->viewport_size_.width();
+}
+
+/*!
+\qmlproperty real FrameMetadata::viewportHeight
+
+The height of the viewport.
+*/
+
+qreal OxideQQuickFrameMetadata::viewportHeight() const {
+  Q_D(const OxideQQuickFrameMetadata);
+
+  return d->viewport_size_.height();
+}
+
+/*!
+\qmlsignal void FrameMetadata::changed()
+
+Emitted once when any of the properties of this snapshot change.
+*/
@@ -0,0 +1,61 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef OXIDE_QTQUICK_FRAME_METADATA
+#define OXIDE_QTQUICK_FRAME_METADATA
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QtGlobal>
+
+#include <OxideQtQuick/oxideqquickglobal.h>
+
+class OxideQQuickFrameMetadataPrivate;
+
+class OXIDE_QTQUICK_EXPORT OxideQQuickFrameMetadata : public QObject {
+  Q_OBJECT
+
+  Q_PROPERTY(qreal contentX READ contentX NOTIFY changed)
+  Q_PROPERTY(qreal contentY READ contentY NOTIFY changed)
+  Q_PROPERTY(qreal contentWidth READ contentWidth NOTIFY changed)
+  Q_PROPERTY(qreal contentHeight READ contentHeight NOTIFY changed)
+  Q_PROPERTY(qreal viewportWidth READ viewportWidth NOTIFY changed)
+  Q_PROPERTY(qreal viewportHeight READ viewportHeight NOTIFY changed)
+
+  Q_DISABLE_COPY(OxideQQuickFrameMetadata)
+  Q_DECLARE_PRIVATE(OxideQQuickFrameMetadata)
+
+ public:
+  ~OxideQQuickFrameMetadata() Q_DECL_OVERRIDE;
+
+  qreal contentX() const;
+  qreal contentY() const;
+  qreal contentWidth() const;
+  qreal contentHeight() const;
+  qreal viewportWidth() const;
+  qreal viewportHeight() const;
+
+ Q_SIGNALS:
+  void changed();
+
+ private:
+  Q_DECL_HIDDEN OxideQQuickFrameMetadata();
+
+  QScopedPointer<OxideQQuickFrameMetadataPrivate> d_ptr;
+};
+
+#endif // OXIDE_QTQUICK_FRAME_METADATA
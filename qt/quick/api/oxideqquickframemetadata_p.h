@@ -0,0 +1,56 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_QT_QUICK_API_FRAME_METADATA_P_H_
+#define _OXIDE_QT_QUICK_API_FRAME_METADATA_P_H_
+
+#include <QPoint>
+#include <QSize>
+#include <QtGlobal>
+
+#include <memory>
+
+class OxideQQuickFrameMetadata;
+
+class OxideQQuickFrameMetadataPrivate {
+  Q_DECLARE_PUBLIC(OxideQQuickFrameMetadata)
+  Q_DISABLE_COPY(OxideQQuickFrameMetadataPrivate)
+
+ public:
+  ~OxideQQuickFrameMetadataPrivate();
+
+  static std::unique_ptr<OxideQQuickFrameMetadata> create();
+
+  static OxideQQuickFrameMetadataPrivate* get(OxideQQuickFrameMetadata* q);
+
+  // Replace the current snapshot, emitting changed() once if any of the
+  // values are different. Returns true if the snapshot changed
+  bool update(const QPoint& scroll_offset,
+              const QSize& content_size,
+              const QSize& viewport_size);
+
+ private:
+  OxideQQuickFrameMetadataPrivate(OxideQQuickFrameMetadata* q);
+
+  OxideQQuickFrameMetadata* q_ptr;
+
+  QPoint scroll_offset_;
+  QSize content_size_;
+  QSize viewport_size_;
+};
+
+#endif // _OXIDE_QT_QUICK_API_FRAME_METADATA_P_H_
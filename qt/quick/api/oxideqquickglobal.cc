@@ -19,9 +19,11 @@
 
 #include <QList>
 #include <QMap>
+#include <QPointer>
 #include <QString>
 
 #include "qt/core/api/oxideqglobal.h"
+#include "qt/core/api/oxideqglobal_p.h"
 #include "qt/core/api/oxideqmediacapturedevices.h"
 
 #include "oxideqquickwebcontext.h"
@@ -330,4 +332,80 @@ QString OxideQQuickGlobal::oxideVersion() const {
   return oxideGetVersion();
 }
 
+/*!
+\qmlproperty bool Oxide::tracing
+\since OxideQt 1.23
+
+Whether a performance trace is being recorded or written out.
+
+\sa startTracing, stopTracing
+*/
+
+bool OxideQQuickGlobal::isTracing() const {
+  return oxideIsTracing();
+}
+
+/*!
+\qmlmethod bool Oxide::startTracing(string categories)
+\since OxideQt 1.23
+
+Start recording a performance trace from the browser, web content and GPU
+processes. \a categories is a comma-separated list of trace categories to
+record, which may contain wildcards, and categories prefixed with \e{-} are
+excluded (eg, \e{"oxide.*,cc,gpu"}). If \a categories is omitted, the default
+set of categories is recorded.
+
+As well as Chromium's own categories, Oxide records events in the
+\e{oxide.delegate_worker}, \e{oxide.frame_delivery},
+\e{oxide.script_messages} and \e{oxide.user_scripts} categories.
+
+Oxide must be running before this is called - eg, by accessing
+defaultWebContext or by creating a WebView. Returns false if Oxide isn't running
+or if a trace is already being recorded.
+
+\sa stopTracing
+*/
+
+bool OxideQQuickGlobal::startTracing(const QString& categories) {
+  if (!oxideStartTracing(categories)) {
+    return false;
+  }
+
+  Q_EMIT tracingChanged();
+  return true;
+}
+
+/*!
+\qmlmethod bool Oxide::stopTracing(string path)
+\since OxideQt 1.23
+
+Stop recording the current performance trace, and write it to the file at
+\a path in the JSON trace format understood by Chrome's \e{about:tracing}.
+The file is written asynchronously, and tracingStopped is emitted once it has
+been written.
+
+Returns false if a trace isn't being recorded.
+
+\sa startTracing
+*/
+
+bool OxideQQuickGlobal::stopTracing(const QString& path) {
+  QPointer<OxideQQuickGlobal> self(this);
+  return oxideStopTracingWithCallback(path, [self, path]() {
+    if (!self) {
+      return;
+    }
+    Q_EMIT self->tracingStopped(path);
+    Q_EMIT self->tracingChanged();
+  });
+}
+
+/*!
+\qmlsignal Oxide::tracingStopped(string path)
+\since OxideQt 1.23
+
+Emitted when a trace started with startTracing has been written to \a path
+after a call to stopTracing.
+*/
+
 #include "moc_oxideqquickglobal_p.cpp"
@@ -40,6 +40,8 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickGlobal : public QObject {
   Q_PROPERTY(QString chromiumVersion READ chromiumVersion CONSTANT)
   Q_PROPERTY(QString version READ oxideVersion CONSTANT)
 
+  Q_PROPERTY(bool tracing READ isTracing NOTIFY tracingChanged)
+
   Q_ENUMS(ProcessModel)
 
   Q_DECLARE_PRIVATE(OxideQQuickGlobal)
@@ -74,11 +76,18 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickGlobal : public QObject {
 
   Q_INVOKABLE OxideQQuickWebContext* defaultWebContext();
 
+  bool isTracing() const;
+
+  Q_INVOKABLE bool startTracing(const QString& categories = QString());
+  Q_INVOKABLE bool stopTracing(const QString& path);
+
  Q_SIGNALS:
   void processModelChanged();
   void maxRendererProcessCountChanged();
   void availableAudioCaptureDevicesChanged();
   void availableVideoCaptureDevicesChanged();
+  void tracingChanged();
+  void tracingStopped(const QString& path);
 
  private:
   Q_PRIVATE_SLOT(d_func(), void availableAudioCaptureDevicesDidChange());
@@ -18,14 +18,168 @@
 #include "oxideqquickscriptmessagehandler.h"
 #include "oxideqquickscriptmessagehandler_p.h"
 
+#include <QCoreApplication>
+#include <QEvent>
+#include <QFile>
+#include <QIODevice>
+#include <QJSEngine>
+#include <QJSValueList>
 #include <QQmlEngine>
+#include <QString>
 #include <QtDebug>
+#include <QThread>
 
 #include "qt/core/glue/oxide_qt_script_message_handler_proxy.h"
+#include "qt/core/glue/oxide_qt_script_message_proxy.h"
 
 #include "oxideqquickscriptmessage.h"
 #include "oxideqquickscriptmessage_p.h"
 
+// When ScriptMessageHandler.workerSource is set, messages are handled by a
+// script running in its own QJSEngine on a dedicated thread, rather than by
+// ScriptMessageHandler.callback on the UI thread:
+// - oxide::qt::ScriptMessageHandler delivers messages to
+//    OxideQQuickScriptMessageHandlerPrivate::ReceiveWorkerMessage on
+//    Chromium's UI or IO thread.
+// - That posts a WorkerMessageEvent to WorkerController, which lives on the
+//    worker thread and calls the script's exports.onMessage entry point.
+// Replies and errors are sent back to the renderer directly from the worker
+// thread.
+
+namespace oxide {
+namespace qquick {
+namespace scriptmessagehandler {
+
+namespace {
+
+QEvent::Type GetWorkerMessageEventType() {
+  static int type = QEvent::registerEventType();
+  return static_cast<QEvent::Type>(type);
+}
+
+}
+
+class WorkerMessageEvent : public QEvent {
+ public:
+  // Takes ownership of |message|. If the event is never delivered, deleting
+  // it sends an error to the sender
+  WorkerMessageEvent(oxide::qt::ScriptMessageProxy* message)
+      : QEvent(GetWorkerMessageEventType()),
+        message_(message) {}
+
+  oxide::qt::ScriptMessageProxy* takeMessage() { return message_.take(); }
+
+ private:
+  QScopedPointer<oxide::qt::ScriptMessageProxy> message_;
+};
+
+class WorkerController : public QObject {
+  Q_OBJECT
+
+ public:
+  WorkerController()
+      : running_(false) {}
+  ~WorkerController() override {
+    Q_ASSERT(thread() == QThread::currentThread());
+  }
+
+  Q_INVOKABLE void runScript(const QUrl& source);
+
+ private:
+  void handleMessage(oxide::qt::ScriptMessageProxy* message);
+
+  // QObject implementation
+  bool event(QEvent* event) override;
+
+  bool running_;
+  QScopedPointer<QJSEngine> engine_;
+  QJSValue exports_;
+};
+
+void WorkerController::runScript(const QUrl& source) {
+  Q_ASSERT(thread() == QThread::currentThread());
+  Q_ASSERT(!running_);
+
+  // QJSEngine is created here instead of the constructor, as it must be
+  // created in the thread it executes code in
+  engine_.reset(new QJSEngine(this));
+  exports_ = engine_->newObject();
+
+  QFile f(source.toLocalFile());
+  if (!f.open(QIODevice::ReadOnly)) {
+    qWarning() << "ScriptMessageHandler: Failed to open worker script" << source;
+    return;
+  }
+
+  QString code("(function(exports) {\n");
+  code += f.readAll();
+  code += "\n})";
+
+  QJSValue func = engine_->evaluate(code, source.toString());
+  if (func.isError()) {
+    qWarning() << "ScriptMessageHandler: Worker script evaluation threw error:"
+               << func.toString();
+    return;
+  }
+
+  Q_ASSERT(func.isCallable());
+
+  QJSValueList argv;
+  argv.append(exports_);
+
+  QJSValue rv = func.call(argv);
+  if (rv.isError()) {
+    qWarning() << "ScriptMessageHandler: Worker script running threw error:"
+               << rv.toString();
+    return;
+  }
+
+  running_ = true;
+}
+
+void WorkerController::handleMessage(oxide::qt::ScriptMessageProxy* message) {
+  Q_ASSERT(thread() == QThread::currentThread());
+
+  OxideQQuickScriptMessage* m = OxideQQuickScriptMessagePrivate::create(message);
+
+  QJSValue func;
+  if (running_) {
+    func = exports_.property("onMessage");
+  }
+
+  if (!func.isCallable()) {
+    // This results in the sender getting an error
+    delete m;
+    return;
+  }
+
+  QJSValueList argv;
+  argv.append(engine_->newQObject(m));
+
+  // |m| is owned by the JS engine now, but it won't be collected before
+  // this returns
+  QJSValue rv = func.call(argv);
+  if (rv.isError()) {
+    message->uncaughtException(QVariant(rv.toString()));
+  }
+}
+
+bool WorkerController::event(QEvent* event) {
+  if (event->type() != GetWorkerMessageEventType()) {
+    return QObject::event(event);
+  }
+
+  handleMessage(static_cast<WorkerMessageEvent*>(event)->takeMessage());
+  return true;
+}
+
+} // namespace scriptmessagehandler
+} // namespace qquick
+} // namespace oxide
+
+using oxide::qquick::scriptmessagehandler::WorkerController;
+using oxide::qquick::scriptmessagehandler::WorkerMessageEvent;
+
 bool OxideQQuickScriptMessageHandlerPrivate::ReceiveMessage(
     oxide::qt::ScriptMessageProxy* message,
     QVariant* error) {
@@ -42,10 +196,60 @@ bool OxideQQuickScriptMessageHandlerPrivate::ReceiveMessage(
   return true;
 }
 
+void OxideQQuickScriptMessageHandlerPrivate::ReceiveWorkerMessage(
+    oxide::qt::ScriptMessageProxy* message) {
+  // This is called on Chromium's UI or IO thread. |worker_controller_| is
+  // only modified whilst the proxy is detached, so it is safe to read here
+  Q_ASSERT(worker_controller_);
+  QCoreApplication::postEvent(worker_controller_,
+                              new WorkerMessageEvent(message));
+}
+
+void OxideQQuickScriptMessageHandlerPrivate::startWorker() {
+  Q_ASSERT(!worker_thread_);
+  Q_ASSERT(!worker_source_.isEmpty());
+
+  worker_thread_ = new QThread();
+  worker_thread_->setObjectName(QStringLiteral("Oxide_ScriptMessageWorker"));
+  QObject::connect(worker_thread_, &QThread::finished,
+                   worker_thread_, &QObject::deleteLater);
+
+  worker_controller_ = new WorkerController();
+  worker_controller_->moveToThread(worker_thread_);
+
+  worker_thread_->start();
+
+  QMetaObject::invokeMethod(worker_controller_,
+                            "runScript",
+                            Q_ARG(QUrl, worker_source_));
+}
+
+void OxideQQuickScriptMessageHandlerPrivate::stopWorker() {
+  if (!worker_thread_) {
+    return;
+  }
+
+  // The controller and any messages queued for it are deleted on the worker
+  // thread when it finishes, which sends errors for any unhandled messages
+  worker_controller_->deleteLater();
+  worker_controller_ = nullptr;
+
+  worker_thread_->quit();
+  worker_thread_ = nullptr;
+}
+
 OxideQQuickScriptMessageHandlerPrivate::OxideQQuickScriptMessageHandlerPrivate(
     OxideQQuickScriptMessageHandler* q)
     : q_ptr(q),
-      proxy_(oxide::qt::ScriptMessageHandlerProxy::create(this, q)) {}
+      proxy_(oxide::qt::ScriptMessageHandlerProxy::create(this, q)),
+      worker_thread_(nullptr),
+      worker_controller_(nullptr) {}
+
+OxideQQuickScriptMessageHandlerPrivate::~OxideQQuickScriptMessageHandlerPrivate() {
+  // Make sure ReceiveWorkerMessage isn't called during destruction
+  proxy_->detachHandler();
+  stopWorker();
+}
 
 bool OxideQQuickScriptMessageHandlerPrivate::isActive() {
   Q_Q(OxideQQuickScriptMessageHandler);
@@ -89,6 +293,8 @@ handler will intercept messages with the specified msgId, from JS contexts with
 URLs listed in \l{contexts}.
 
 Incoming messages will be passed to the application provided \l{callback}.
+Alternatively, messages can be handled off the UI thread by a worker script
+specified by \l{workerSource}.
 */
 
 void OxideQQuickScriptMessageHandler::classBegin() {}
@@ -193,11 +399,80 @@ void OxideQQuickScriptMessageHandler::setCallback(const QJSValue& callback) {
 
   d->callback_ = callback;
 
-  if (is_null) {
-    d->proxy_->detachHandler();
-  } else {
-    d->proxy_->attachHandler();
+  // When a worker is set, it takes precedence over the callback
+  if (d->worker_source_.isEmpty()) {
+    if (is_null) {
+      d->proxy_->detachHandler();
+    } else {
+      d->proxy_->attachHandler();
+    }
   }
 
   emit callbackChanged();
 }
+
+/*!
+\qmlproperty url ScriptMessageHandler::workerSource
+\since OxideQt 1.23
+
+Specify a local file URL for a script that will handle incoming messages on a
+dedicated worker thread, instead of \l{callback}. This is useful for handlers
+that perform data processing, as messages are delivered to and answered from
+the worker without involving the UI thread. When this is set, \l{callback} is
+ignored.
+
+The script runs in its own JS engine, and has no access to QML or to the
+application's other objects. It is wrapped in a function with an \e{exports}
+parameter, and should set \e{exports.onMessage} to a function that accepts a
+single ScriptMessage argument. The message's \l{ScriptMessage::frame}{frame}
+property is always null in the worker.
+
+\code
+exports.onMessage = function(message) {
+  message.reply({ length: message.payload.str.length });
+}
+\endcode
+
+If \e{exports.onMessage} throws an exception, the sender will receive an
+error.
+
+Changing this stops the current worker. Messages that are queued for it will
+receive an error.
+*/
+
+QUrl OxideQQuickScriptMessageHandler::workerSource() const {
+  Q_D(const OxideQQuickScriptMessageHandler);
+
+  return d->worker_source_;
+}
+
+void OxideQQuickScriptMessageHandler::setWorkerSource(const QUrl& source) {
+  Q_D(OxideQQuickScriptMessageHandler);
+
+  if (source == d->worker_source_) {
+    return;
+  }
+
+  if (!source.isLocalFile() && !source.isEmpty()) {
+    qWarning() <<
+        "OxideQQuickScriptMessageHandler: workerSource only supports local "
+        "file URL's";
+    return;
+  }
+
+  d->proxy_->detachHandler();
+  d->stopWorker();
+
+  d->worker_source_ = source;
+
+  if (!source.isEmpty()) {
+    d->startWorker();
+    d->proxy_->attachWorkerHandler();
+  } else if (d->callback_.isCallable()) {
+    d->proxy_->attachHandler();
+  }
+
+  emit workerSourceChanged();
+}
+
+#include "oxideqquickscriptmessagehandler.moc"
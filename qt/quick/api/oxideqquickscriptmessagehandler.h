@@ -39,6 +39,7 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickScriptMessageHandler
   Q_PROPERTY(QString msgId READ msgId WRITE setMsgId NOTIFY msgIdChanged)
   Q_PROPERTY(QList<QUrl> contexts READ contexts WRITE setContexts NOTIFY contextsChanged)
   Q_PROPERTY(QJSValue callback READ callback WRITE setCallback NOTIFY callbackChanged)
+  Q_PROPERTY(QUrl workerSource READ workerSource WRITE setWorkerSource NOTIFY workerSourceChanged REVISION 1)
 
   Q_DECLARE_PRIVATE(OxideQQuickScriptMessageHandler)
 
@@ -55,10 +56,14 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickScriptMessageHandler
   QJSValue callback() const;
   void setCallback(const QJSValue& callback);
 
+  QUrl workerSource() const;
+  void setWorkerSource(const QUrl& source);
+
  Q_SIGNALS:
   void msgIdChanged();
   void contextsChanged();
   void callbackChanged();
+  Q_REVISION(1) void workerSourceChanged();
 
  protected:
   // QQmlParserStatus implementation
@@ -21,12 +21,22 @@
 #include <QJSValue>
 #include <QScopedPointer>
 #include <QtGlobal>
+#include <QUrl>
 
 #include "qt/core/glue/oxide_qt_script_message_handler_proxy_client.h"
 
 class OxideQQuickScriptMessageHandler;
 
+QT_BEGIN_NAMESPACE
+class QThread;
+QT_END_NAMESPACE
+
 namespace oxide {
+namespace qquick {
+namespace scriptmessagehandler {
+class WorkerController;
+}
+}
 namespace qt {
 class ScriptMessageHandlerProxy;
 }
@@ -38,6 +48,7 @@ class OxideQQuickScriptMessageHandlerPrivate
 
  public:
   OxideQQuickScriptMessageHandlerPrivate(OxideQQuickScriptMessageHandler* q);
+  ~OxideQQuickScriptMessageHandlerPrivate();
 
   bool isActive();
 
@@ -48,6 +59,10 @@ class OxideQQuickScriptMessageHandlerPrivate
   // oxide::qt::ScriptMessageHandlerProxyClient implementation
   bool ReceiveMessage(oxide::qt::ScriptMessageProxy* message,
                       QVariant* error) override;
+  void ReceiveWorkerMessage(oxide::qt::ScriptMessageProxy* message) override;
+
+  void startWorker();
+  void stopWorker();
 
   OxideQQuickScriptMessageHandler* q_ptr;
 
@@ -55,6 +70,13 @@ class OxideQQuickScriptMessageHandlerPrivate
 
   QJSValue callback_;
 
+  QUrl worker_source_;
+
+  // The thread that runs the script specified by |worker_source_|, and the
+  // object that lives on it. These are deleted asynchronously
+  QThread* worker_thread_;
+  oxide::qquick::scriptmessagehandler::WorkerController* worker_controller_;
+
   Q_DISABLE_COPY(OxideQQuickScriptMessageHandlerPrivate);
 };
 
@@ -50,6 +50,9 @@ namespace {
 bool g_default_context_initialized = false;
 OxideQQuickWebContext* g_default_context;
 
+// How long to wait for userAgentOverrideDelegate if its timeout isn't set
+const int kDefaultUserAgentOverrideTimeoutMs = 1000;
+
 void CleanupDefaultContext() {
   delete g_default_context;
   Q_ASSERT(!g_default_context);
@@ -130,61 +133,98 @@ class WebContextIODelegate : public oxide::qt::WebContextProxyClient::IOClient {
   WebContextIODelegate() {}
   virtual ~WebContextIODelegate() {}
 
-  void OnBeforeURLRequest(OxideQBeforeURLRequestEvent* event) override;
-  void OnBeforeRedirect(OxideQBeforeRedirectEvent* event) override;
-  void OnBeforeSendHeaders(OxideQBeforeSendHeadersEvent* event) override;
+  bool OnBeforeURLRequest(OxideQBeforeURLRequestEvent* event,
+                          const DoneCallback& done) override;
+  bool OnBeforeRedirect(OxideQBeforeRedirectEvent* event,
+                        const DoneCallback& done) override;
+  bool OnBeforeSendHeaders(OxideQBeforeSendHeadersEvent* event,
+                           const DoneCallback& done) override;
+  int GetNetworkCallbackTimeout() override;
+  bool CancelRequestOnNetworkCallbackTimeout() override;
   QString GetUserAgentOverride(const QUrl& url) override;
 
   QMutex lock;
 
-  QWeakPointer<IOThreadController> network_request_delegate;
-  QWeakPointer<IOThreadController> user_agent_override_delegate;
+  QWeakPointer<WorkerThreadController> network_request_delegate;
+  QWeakPointer<WorkerThreadController> user_agent_override_delegate;
 };
 
-void WebContextIODelegate::OnBeforeURLRequest(
-    OxideQBeforeURLRequestEvent* event) {
-  QSharedPointer<IOThreadController> delegate;
+bool WebContextIODelegate::OnBeforeURLRequest(
+    OxideQBeforeURLRequestEvent* event,
+    const DoneCallback& done) {
+  QSharedPointer<WorkerThreadController> delegate;
   {
     QMutexLocker locker(&lock);
     delegate = network_request_delegate.toStrongRef();
   }
   if (!delegate) {
-    return;
+    return false;
   }
 
-  delegate->CallEntryPointInWorker("onBeforeURLRequest", event);
+  delegate->CallEntryPointInWorker("onBeforeURLRequest", event, done);
+  return true;
 }
 
-void WebContextIODelegate::OnBeforeSendHeaders(
-    OxideQBeforeSendHeadersEvent* event) {
-  QSharedPointer<IOThreadController> delegate;
+bool WebContextIODelegate::OnBeforeSendHeaders(
+    OxideQBeforeSendHeadersEvent* event,
+    const DoneCallback& done) {
+  QSharedPointer<WorkerThreadController> delegate;
   {
     QMutexLocker locker(&lock);
     delegate = network_request_delegate.toStrongRef();
   }
   if (!delegate) {
-    return;
+    return false;
   }
 
-  delegate->CallEntryPointInWorker("onBeforeSendHeaders", event);
+  delegate->CallEntryPointInWorker("onBeforeSendHeaders", event, done);
+  return true;
 }
 
-void WebContextIODelegate::OnBeforeRedirect(
-    OxideQBeforeRedirectEvent* event) {
-  QSharedPointer<IOThreadController> delegate;
+bool WebContextIODelegate::OnBeforeRedirect(
+    OxideQBeforeRedirectEvent* event,
+    const DoneCallback& done) {
+  QSharedPointer<WorkerThreadController> delegate;
   {
     QMutexLocker locker(&lock);
     delegate = network_request_delegate.toStrongRef();
   }
   if (!delegate) {
-    return;
+    return false;
+  }
+
+  delegate->CallEntryPointInWorker("onBeforeRedirect", event, done);
+  return true;
+}
+
+int WebContextIODelegate::GetNetworkCallbackTimeout() {
+  QSharedPointer<WorkerThreadController> delegate;
+  {
+    QMutexLocker locker(&lock);
+    delegate = network_request_delegate.toStrongRef();
+  }
+  if (!delegate) {
+    return 0;
   }
 
-  emit delegate->CallEntryPointInWorker("onBeforeRedirect", event);
+  return delegate->timeout();
+}
+
+bool WebContextIODelegate::CancelRequestOnNetworkCallbackTimeout() {
+  QSharedPointer<WorkerThreadController> delegate;
+  {
+    QMutexLocker locker(&lock);
+    delegate = network_request_delegate.toStrongRef();
+  }
+  if (!delegate) {
+    return false;
+  }
+
+  return delegate->cancelOnTimeout();
 }
 
 QString WebContextIODelegate::GetUserAgentOverride(const QUrl& url) {
-  QSharedPointer<IOThreadController> delegate;
+  QSharedPointer<WorkerThreadController> delegate;
   {
     QMutexLocker locker(&lock);
     delegate = user_agent_override_delegate.toStrongRef();
@@ -193,11 +233,26 @@ QString WebContextIODelegate::GetUserAgentOverride(const QUrl& url) {
     return QString();
   }
 
-  OxideQUserAgentOverrideRequest req(url);
-  delegate->CallEntryPointInWorker("onGetUserAgentOverride", &req);
+  // This is called synchronously from the IO thread, so it must not wait
+  // indefinitely for a slow script
+  int timeout = delegate->timeout();
+  if (timeout == 0) {
+    timeout = kDefaultUserAgentOverrideTimeoutMs;
+  }
+
+  QSharedPointer<OxideQUserAgentOverrideRequest> req(
+      new OxideQUserAgentOverrideRequest(url));
+  if (!delegate->CallEntryPointInWorkerAndWait("onGetUserAgentOverride",
+                                               req,
+                                               timeout)) {
+    qWarning() <<
+        "OxideQQuickWebContext: userAgentOverrideDelegate timed out for" <<
+        url;
+    return QString();
+  }
 
   OxideQUserAgentOverrideRequestPrivate* p =
-      OxideQUserAgentOverrideRequestPrivate::get(&req);
+      OxideQUserAgentOverrideRequestPrivate::get(req.data());
 
   return p->user_agent;
 }
@@ -314,7 +369,7 @@ bool OxideQQuickWebContextPrivate::prepareToAttachDelegateWorker(
 
   ++p->attached_count;
 
-  Q_ASSERT(p->io_thread_controller().data());
+  Q_ASSERT(p->worker_thread_controller().data());
 
   return true;
 }
@@ -391,6 +446,81 @@ void OxideQQuickWebContextPrivate::DefaultVideoCaptureDeviceChanged() {
   emit q->defaultVideoCaptureDeviceIdChanged();
 }
 
+void OxideQQuickWebContextPrivate::MemoryUsageAvailable(
+    const oxide::qt::WebContextMemoryUsage& usage) {
+  Q_Q(OxideQQuickWebContext);
+
+  QVariantList renderers;
+  for (const auto& renderer : usage.renderers) {
+    QVariantMap r;
+    r["processId"] = renderer.processId;
+    r["privateBytes"] = renderer.privateBytes;
+    r["sharedBytes"] = renderer.sharedBytes;
+    QVariantList sites;
+    for (const QUrl& site : renderer.sites) {
+      sites.append(site);
+    }
+    r["sites"] = sites;
+    renderers.append(r);
+  }
+
+  QVariantMap report;
+  report["renderers"] = renderers;
+  report["webViewCount"] = usage.webViewCount;
+  report["compositorFrameCount"] = usage.compositorFrameCount;
+  report["compositorFrameBytes"] = usage.compositorFrameBytes;
+  report["navigationEntryCount"] = usage.navigationEntryCount;
+  report["httpCacheBytes"] = usage.httpCacheBytes;
+  report["faviconCacheBytes"] = usage.faviconCacheBytes;
+
+  emit q->memoryReportReady(report);
+}
+
+void OxideQQuickWebContextPrivate::PackedArchiveAdded(const QString& scheme,
+                                                      bool success) {
+  Q_Q(OxideQQuickWebContext);
+
+  emit q->archiveSchemeAdded(scheme, success);
+}
+
+void OxideQQuickWebContextPrivate::UrlsPrefetched(int request_id,
+                                                  int succeeded,
+                                                  int failed) {
+  Q_Q(OxideQQuickWebContext);
+
+  emit q->urlsPrefetched(request_id, succeeded, failed);
+}
+
+void OxideQQuickWebContextPrivate::CacheEntryInfoRetrieved(int request_id,
+                                                           bool cached,
+                                                           qint64 size) {
+  Q_Q(OxideQQuickWebContext);
+
+  emit q->cacheEntryInfoRetrieved(request_id, cached, size);
+}
+
+void OxideQQuickWebContextPrivate::CacheEntriesEvicted(int request_id,
+                                                       int num_evicted) {
+  Q_Q(OxideQQuickWebContext);
+
+  emit q->cacheEntriesEvicted(request_id, num_evicted);
+}
+
+void OxideQQuickWebContextPrivate::CacheStatsRetrieved(
+    int request_id,
+    const oxide::qt::HttpCacheStats& stats) {
+  Q_Q(OxideQQuickWebContext);
+
+  QVariantMap rv;
+  rv["hits"] = stats.hits;
+  rv["misses"] = stats.misses;
+  rv["prefetchesSucceeded"] = stats.prefetchesSucceeded;
+  rv["prefetchesFailed"] = stats.prefetchesFailed;
+  rv["prefetchesPending"] = stats.prefetchesPending;
+
+  emit q->cacheStatsRetrieved(request_id, rv);
+}
+
 OxideQQuickWebContextPrivate::~OxideQQuickWebContextPrivate() {}
 
 void OxideQQuickWebContextPrivate::delegateWorkerDestroyed(
@@ -1021,10 +1151,10 @@ void OxideQQuickWebContext::setNetworkRequestDelegate(
     return;
   }
 
-  QSharedPointer<webcontextdelegateworker::IOThreadController> io_delegate;
+  QSharedPointer<webcontextdelegateworker::WorkerThreadController> io_delegate;
   if (delegate) {
     io_delegate = OxideQQuickWebContextDelegateWorkerPrivate::get(
-        delegate)->io_thread_controller();
+        delegate)->worker_thread_controller();
   }
 
   OxideQQuickWebContextDelegateWorker* old = d->network_request_delegate_;
@@ -1089,6 +1219,17 @@ void OxideQQuickWebContext::setStorageAccessPermissionDelegate(
 /*!
 \qmlproperty WebContextDelegateWorker WebContext::userAgentOverrideDelegate
 \deprecated
+
+The network stack waits for this worker synchronously. If it does not respond
+within the worker's \e timeout, or within 1 second if that is not set, the
+default user agent is used for the request.
+
+The override returned by this worker applies per origin. The worker is passed
+the full URL of the first request for an origin, but its response is cached
+and reused for all subsequent requests to the same origin (scheme, host and
+port) until this delegate changes. The worker should therefore not return
+different user agents for different paths on the same origin - use
+userAgentOverrides for that.
 */
 
 OxideQQuickWebContextDelegateWorker*
@@ -1114,10 +1255,10 @@ void OxideQQuickWebContext::setUserAgentOverrideDelegate(
     return;
   }
 
-  QSharedPointer<webcontextdelegateworker::IOThreadController> io_delegate;
+  QSharedPointer<webcontextdelegateworker::WorkerThreadController> io_delegate;
   if (delegate) {
     io_delegate = OxideQQuickWebContextDelegateWorkerPrivate::get(
-        delegate)->io_thread_controller();
+        delegate)->worker_thread_controller();
   }
 
   OxideQQuickWebContextDelegateWorker* old = d->user_agent_override_delegate_;
@@ -1561,4 +1702,481 @@ void OxideQQuickWebContext::setDoNotTrack(bool dnt) {
   emit doNotTrackEnabledChanged();
 }
 
+/*!
+\qmlproperty bool WebContext::persistentPermissions
+\since OxideQt 1.23
+
+Whether the permission decisions that Oxide remembers (for example, when a
+geolocation or media access request is allowed or denied) should be written to
+disk, so that they are remembered the next time the application is started.
+This only has an effect if \l{dataPath} is set.
+
+This can only be set during construction. Attempts to change it after
+WebContext is constructed will be ignored.
+
+The default is false, which means that saved permission decisions only last
+until the application exits.
+*/
+
+bool OxideQQuickWebContext::persistentPermissions() const {
+  Q_D(const OxideQQuickWebContext);
+
+  return d->proxy_->persistentPermissions();
+}
+
+/*!
+\internal
+*/
+
+void OxideQQuickWebContext::setPersistentPermissions(bool persistent) {
+  Q_D(OxideQQuickWebContext);
+
+  if (d->proxy_->isInitialized()) {
+    qWarning() <<
+        "OxideQQuickWebContext: Cannot set persistentPermissions once the "
+        "context is in use";
+    return;
+  }
+
+  if (persistentPermissions() == persistent) {
+    return;
+  }
+
+  d->proxy_->setPersistentPermissions(persistent);
+  emit persistentPermissionsChanged();
+}
+
+/*!
+\qmlproperty int WebContext::permissionLifetime
+\since OxideQt 1.23
+
+The number of seconds that permission decisions saved by Oxide are remembered
+for (for example, when a geolocation or media access request is allowed or
+denied). Once a decision has expired, the next request from the same origin
+will be delivered to the application again.
+
+This can only be set during construction. Attempts to change it after
+WebContext is constructed will be ignored.
+
+The default is 0, which means that saved permission decisions don't expire.
+
+\sa persistentPermissions
+*/
+
+int OxideQQuickWebContext::permissionLifetime() const {
+  Q_D(const OxideQQuickWebContext);
+
+  return d->proxy_->permissionLifetime();
+}
+
+/*!
+\internal
+*/
+
+void OxideQQuickWebContext::setPermissionLifetime(int lifetime) {
+  Q_D(OxideQQuickWebContext);
+
+  if (d->proxy_->isInitialized()) {
+    qWarning() <<
+        "OxideQQuickWebContext: Cannot set permissionLifetime once the "
+        "context is in use";
+    return;
+  }
+
+  if (lifetime < 0) {
+    qWarning() <<
+        "OxideQQuickWebContext: permissionLifetime can't be negative";
+    return;
+  }
+
+  if (permissionLifetime() == lifetime) {
+    return;
+  }
+
+  d->proxy_->setPermissionLifetime(lifetime);
+  emit permissionLifetimeChanged();
+}
+
+/*!
+\qmlmethod void WebContext::clearSavedPermissionsForType(PermissionType type)
+\since OxideQt 1.23
+
+Forget all of the saved permission decisions of the specified \a{type}, so
+that the next request of that type from any origin is delivered to the
+application again. This also applies to the off-the-record context used by
+incognito WebViews. \a{type} can be one of the following values:
+
+\value WebContext.PermissionTypeGeolocation
+Geolocation requests
+
+\value WebContext.PermissionTypeMicrophone
+Requests to access an audio capture device
+
+\value WebContext.PermissionTypeCamera
+Requests to access a video capture device
+
+\value WebContext.PermissionTypeNotifications
+Requests to display notifications
+
+This does nothing if the WebContext isn't initialized yet.
+
+\sa clearSavedPermissionsForOrigin
+*/
+
+void OxideQQuickWebContext::clearSavedPermissionsForType(PermissionType type) {
+  Q_D(OxideQQuickWebContext);
+
+  Q_STATIC_ASSERT(
+      PermissionTypeGeolocation ==
+      static_cast<PermissionType>(
+        WebContextProxy::PermissionTypeGeolocation));
+  Q_STATIC_ASSERT(
+      PermissionTypeMicrophone ==
+      static_cast<PermissionType>(
+        WebContextProxy::PermissionTypeMicrophone));
+  Q_STATIC_ASSERT(
+      PermissionTypeCamera ==
+      static_cast<PermissionType>(
+        WebContextProxy::PermissionTypeCamera));
+  Q_STATIC_ASSERT(
+      PermissionTypeNotifications ==
+      static_cast<PermissionType>(
+        WebContextProxy::PermissionTypeNotifications));
+
+  if (!d->isInitialized()) {
+    qWarning() <<
+        "OxideQQuickWebContext::clearSavedPermissionsForType: WebContext is "
+        "not initialized yet";
+    return;
+  }
+
+  d->proxy_->clearTemporarySavedPermissionStatusesForType(
+      static_cast<WebContextProxy::PermissionType>(type));
+}
+
+/*!
+\qmlmethod void WebContext::clearSavedPermissionsForOrigin(url origin)
+\since OxideQt 1.23
+
+Forget all of the saved permission decisions that were made for requests from
+\a{origin}, or from frames embedded in a page from \a{origin}. Only the origin
+of \a{origin} is used. This also applies to the off-the-record context used by
+incognito WebViews.
+
+This does nothing if the WebContext isn't initialized yet.
+
+\sa clearSavedPermissionsForType
+*/
+
+void OxideQQuickWebContext::clearSavedPermissionsForOrigin(
+    const QUrl& origin) {
+  Q_D(OxideQQuickWebContext);
+
+  if (!d->isInitialized()) {
+    qWarning() <<
+        "OxideQQuickWebContext::clearSavedPermissionsForOrigin: WebContext is "
+        "not initialized yet";
+    return;
+  }
+
+  d->proxy_->clearTemporarySavedPermissionStatusesForOrigin(origin);
+}
+
+/*!
+\qmlmethod void WebContext::requestMemoryReport()
+\since OxideQt 1.23
+
+Requests a sample of the memory used on behalf of this WebContext. The sample
+is taken asynchronously, and is delivered via memoryReportReady.
+
+\sa memoryReportReady, WebView::requestMemoryReport
+*/
+
+void OxideQQuickWebContext::requestMemoryReport() {
+  Q_D(OxideQQuickWebContext);
+
+  d->proxy_->requestMemoryUsage();
+}
+
+/*!
+\qmlsignal void WebContext::memoryReportReady(object report)
+\since OxideQt 1.23
+
+Emitted in response to a call to requestMemoryReport. \a{report} has the
+following properties:
+
+\list
+  \li \e{renderers} - A list of objects describing each web process belonging
+  to this context, with \e{processId}, \e{privateBytes}, \e{sharedBytes} and
+  \e{sites} properties. \e{sites} is the list of sites currently assigned to
+  the process
+  \li \e{webViewCount} - The number of WebViews using this context
+  \li \e{compositorFrameCount} - The total number of compositor frames
+  retained by Oxide for those WebViews
+  \li \e{compositorFrameBytes} - An estimate of the size of the buffers
+  backing those frames, based on their dimensions
+  \li \e{navigationEntryCount} - The total number of navigation history
+  entries for those WebViews
+  \li \e{httpCacheBytes} - The total size of the entries in this context's
+  HTTP cache. This is stored on disk in \l{cachePath}, or held in memory if
+  \l{cachePath} isn't set. This is -1 if the size couldn't be determined
+  \li \e{faviconCacheBytes} - The size of the cached favicons held in memory
+  for this context
+\endlist
+
+If this context hasn't been used yet, the report is empty.
+
+\sa requestMemoryReport
+*/
+
+/*!
+\qmlmethod bool WebContext::addArchiveScheme(string scheme, url archive)
+\since OxideQt 1.23
+
+Serve requests for URLs with the specified \a{scheme} directly from the local
+\a{archive} file, without going through the application's network access
+manager. This is intended for serving web content that is bundled with the
+application.
+
+\a{archive} must be a ZIP file in which entries are stored without compression
+(eg, created with \c{zip -0}). Entries are looked up using the path of the
+requested URL - the host, query and fragment are ignored. Requests for a path
+ending in a slash are served from \e{index.html} in that directory. Entries
+that are compressed in the ZIP sense are ignored.
+
+A precompressed variant of an entry can be stored with a \e{.br} or \e{.gz}
+suffix appended to its name (eg, \e{js/app.js.br}). This is served in place of
+the uncompressed entry, other than for requests for a byte range.
+
+Responses have a MIME type determined by the entry's file extension, and an
+ETag derived from its contents. Requests for a single byte range and
+conditional requests are supported.
+
+The archive is opened asynchronously, after which archiveSchemeAdded is
+emitted. Any archive already added for \a{scheme} is replaced. Archive schemes
+take precedence over schemes in allowedExtraUrlSchemes.
+
+Returns false if \a{scheme} is one of the schemes handled internally by Oxide
+(eg, \e{http} or \e{file}), in which case archiveSchemeAdded isn't emitted.
+
+\sa removeArchiveScheme, archiveSchemeAdded
+*/
+
+bool OxideQQuickWebContext::addArchiveScheme(const QString& scheme,
+                                             const QUrl& archive) {
+  Q_D(OxideQQuickWebContext);
+
+  if (!archive.isLocalFile()) {
+    qWarning() <<
+        "OxideQQuickWebContext: addArchiveScheme only supports local files";
+    return false;
+  }
+
+  return d->proxy_->addPackedArchive(scheme, archive);
+}
+
+/*!
+\qmlmethod void WebContext::removeArchiveScheme(string scheme)
+\since OxideQt 1.23
+
+Stop serving requests for \a{scheme} from the archive added with
+addArchiveScheme. Requests that are already in progress will complete.
+
+\sa addArchiveScheme
+*/
+
+void OxideQQuickWebContext::removeArchiveScheme(const QString& scheme) {
+  Q_D(OxideQQuickWebContext);
+
+  d->proxy_->removePackedArchive(scheme);
+}
+
+/*!
+\qmlsignal void WebContext::archiveSchemeAdded(string scheme, bool success)
+\since OxideQt 1.23
+
+Emitted when the archive for \a{scheme} has been opened in response to a call
+to addArchiveScheme. If \a{success} is false, the archive could not be read
+and requests for \a{scheme} are handled as before.
+
+This isn't emitted for an archive that is replaced or removed before it has
+been opened.
+
+\sa addArchiveScheme
+*/
+
+/*!
+\qmlmethod int WebContext::prefetchUrls(list<url> urls)
+\since OxideQt 1.23
+
+Fetch each of the specified \a{urls} in to the HTTP cache, without loading
+them in a WebView. This can be used to warm the cache ahead of time - eg, to
+preload content overnight. Only \e{http} and \e{https} URLs are supported.
+
+Prefetches run at idle priority, with at most 4 in progress at once across
+all calls to this function. The remainder are queued. Responses that aren't
+cacheable are fetched but not stored.
+
+This returns a request ID, or -1 if the WebContext isn't initialized yet.
+urlsPrefetched is emitted with the same ID once all of \a{urls} have been
+fetched.
+
+\sa urlsPrefetched, getCacheEntryInfo
+*/
+
+int OxideQQuickWebContext::prefetchUrls(const QVariantList& urls) {
+  Q_D(OxideQQuickWebContext);
+
+  if (!d->isInitialized()) {
+    qWarning() <<
+        "OxideQQuickWebContext::prefetchUrls: WebContext is not initialized "
+        "yet";
+    return -1;
+  }
+
+  QList<QUrl> list;
+  for (const QVariant& url : urls) {
+    list.append(url.toUrl());
+  }
+
+  return d->proxy_->prefetchUrls(list);
+}
+
+/*!
+\qmlsignal void WebContext::urlsPrefetched(int requestId, int succeeded, int failed)
+\since OxideQt 1.23
+
+Emitted when all of the URLs for the prefetch request identified by
+\a{requestId} have been fetched. \a{succeeded} is the number of URLs that were
+fetched successfully, and \a{failed} is the number that failed to load or that
+returned an HTTP error.
+
+\sa prefetchUrls
+*/
+
+/*!
+\qmlmethod int WebContext::getCacheEntryInfo(url url)
+\since OxideQt 1.23
+
+Request information about the HTTP cache entry for \a{url}.
+
+This returns a request ID, or -1 if the WebContext isn't initialized yet.
+cacheEntryInfoRetrieved is emitted with the same ID when the information is
+available.
+
+\sa cacheEntryInfoRetrieved
+*/
+
+int OxideQQuickWebContext::getCacheEntryInfo(const QUrl& url) {
+  Q_D(OxideQQuickWebContext);
+
+  if (!d->isInitialized()) {
+    qWarning() <<
+        "OxideQQuickWebContext::getCacheEntryInfo: WebContext is not "
+        "initialized yet";
+    return -1;
+  }
+
+  return d->proxy_->getCacheEntryInfo(url);
+}
+
+/*!
+\qmlsignal void WebContext::cacheEntryInfoRetrieved(int requestId, bool cached, int size)
+\since OxideQt 1.23
+
+Emitted in response to getCacheEntryInfo for the request identified by
+\a{requestId}. \a{cached} indicates whether there is a cache entry for the
+URL, and \a{size} is the size of the cached response body in bytes.
+
+\sa getCacheEntryInfo
+*/
+
+/*!
+\qmlmethod int WebContext::evictCacheEntries(string urlPrefix)
+\since OxideQt 1.23
+
+Remove all entries from the HTTP cache for URLs that start with
+\a{urlPrefix}. Passing an empty string clears the cache.
+
+This returns a request ID, or -1 if the WebContext isn't initialized yet.
+cacheEntriesEvicted is emitted with the same ID once complete.
+
+\sa cacheEntriesEvicted
+*/
+
+int OxideQQuickWebContext::evictCacheEntries(const QString& urlPrefix) {
+  Q_D(OxideQQuickWebContext);
+
+  if (!d->isInitialized()) {
+    qWarning() <<
+        "OxideQQuickWebContext::evictCacheEntries: WebContext is not "
+        "initialized yet";
+    return -1;
+  }
+
+  return d->proxy_->evictCacheEntries(urlPrefix);
+}
+
+/*!
+\qmlsignal void WebContext::cacheEntriesEvicted(int requestId, int numEvicted)
+\since OxideQt 1.23
+
+Emitted when the request identified by \a{requestId} to evict cache entries
+has completed. \a{numEvicted} is the number of entries that were removed.
+
+\sa evictCacheEntries
+*/
+
+/*!
+\qmlmethod int WebContext::getCacheStats()
+\since OxideQt 1.23
+
+Request HTTP cache statistics for this WebContext.
+
+This returns a request ID, or -1 if the WebContext isn't initialized yet.
+cacheStatsRetrieved is emitted with the same ID when the statistics are
+available.
+
+\sa cacheStatsRetrieved
+*/
+
+int OxideQQuickWebContext::getCacheStats() {
+  Q_D(OxideQQuickWebContext);
+
+  if (!d->isInitialized()) {
+    qWarning() <<
+        "OxideQQuickWebContext::getCacheStats: WebContext is not "
+        "initialized yet";
+    return -1;
+  }
+
+  return d->proxy_->getCacheStats();
+}
+
+/*!
+\qmlsignal void WebContext::cacheStatsRetrieved(int requestId, object stats)
+\since OxideQt 1.23
+
+Emitted in response to getCacheStats for the request identified by
+\a{requestId}. \a{stats} has the following properties, which count from when
+the WebContext was initialized:
+
+\list
+  \li \e{hits} - The number of completed HTTP(S) requests that were served
+  from the cache, including those that were revalidated with the server
+  \li \e{misses} - The number of completed HTTP(S) requests that were not
+  served from the cache
+  \li \e{prefetchesSucceeded} - The number of URLs successfully fetched via
+  prefetchUrls
+  \li \e{prefetchesFailed} - The number of URLs that failed to be fetched via
+  prefetchUrls
+  \li \e{prefetchesPending} - The number of URLs from prefetchUrls that are
+  queued or in progress
+\endlist
+
+Prefetches aren't included in \e{hits} or \e{misses}.
+
+\sa getCacheStats
+*/
+
 #include "moc_oxideqquickwebcontext.cpp"
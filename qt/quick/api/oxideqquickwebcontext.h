@@ -24,6 +24,7 @@
 #include <QtCore/QtGlobal>
 #include <QtCore/QUrl>
 #include <QtCore/QVariantList>
+#include <QtCore/QVariantMap>
 #include <QtQml/QQmlListProperty>
 #include <QtQml/QQmlParserStatus>
 #include <QtQml/QtQml>
@@ -77,8 +78,12 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickWebContext : public QObject,
 
   Q_PROPERTY(bool doNotTrackEnabled READ doNotTrack WRITE setDoNotTrack NOTIFY doNotTrackEnabledChanged REVISION 3)
 
+  Q_PROPERTY(bool persistentPermissions READ persistentPermissions WRITE setPersistentPermissions NOTIFY persistentPermissionsChanged REVISION 4)
+  Q_PROPERTY(int permissionLifetime READ permissionLifetime WRITE setPermissionLifetime NOTIFY permissionLifetimeChanged REVISION 4)
+
   Q_ENUMS(CookiePolicy)
   Q_ENUMS(SessionCookieMode)
+  Q_ENUMS(PermissionType)
 
   Q_DECLARE_PRIVATE(OxideQQuickWebContext)
   Q_DISABLE_COPY(OxideQQuickWebContext)
@@ -99,6 +104,13 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickWebContext : public QObject,
     SessionCookieModeRestored
   };
 
+  enum PermissionType {
+    PermissionTypeGeolocation,
+    PermissionTypeMicrophone,
+    PermissionTypeCamera,
+    PermissionTypeNotifications
+  };
+
   OxideQQuickWebContext(QObject* parent = nullptr);
   ~OxideQQuickWebContext() Q_DECL_OVERRIDE;
 
@@ -173,6 +185,28 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickWebContext : public QObject,
   bool doNotTrack() const;
   void setDoNotTrack(bool dnt);
 
+  bool persistentPermissions() const;
+  void setPersistentPermissions(bool persistent);
+
+  int permissionLifetime() const;
+  void setPermissionLifetime(int lifetime);
+
+  Q_REVISION(4) Q_INVOKABLE void clearSavedPermissionsForType(
+      PermissionType type);
+  Q_REVISION(4) Q_INVOKABLE void clearSavedPermissionsForOrigin(
+      const QUrl& origin);
+
+  Q_REVISION(4) Q_INVOKABLE void requestMemoryReport();
+
+  Q_REVISION(4) Q_INVOKABLE bool addArchiveScheme(const QString& scheme,
+                                                  const QUrl& archive);
+  Q_REVISION(4) Q_INVOKABLE void removeArchiveScheme(const QString& scheme);
+
+  Q_REVISION(4) Q_INVOKABLE int prefetchUrls(const QVariantList& urls);
+  Q_REVISION(4) Q_INVOKABLE int getCacheEntryInfo(const QUrl& url);
+  Q_REVISION(4) Q_INVOKABLE int evictCacheEntries(const QString& urlPrefix);
+  Q_REVISION(4) Q_INVOKABLE int getCacheStats();
+
  Q_SIGNALS:
   void productChanged();
   void userAgentChanged();
@@ -196,6 +230,17 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickWebContext : public QObject,
   Q_REVISION(3) void defaultVideoCaptureDeviceIdChanged();
   Q_REVISION(3) void userAgentOverridesChanged();
   Q_REVISION(3) void doNotTrackEnabledChanged();
+  Q_REVISION(4) void persistentPermissionsChanged();
+  Q_REVISION(4) void permissionLifetimeChanged();
+  Q_REVISION(4) void memoryReportReady(const QVariantMap& report);
+  Q_REVISION(4) void archiveSchemeAdded(const QString& scheme, bool success);
+  Q_REVISION(4) void urlsPrefetched(int requestId, int succeeded, int failed);
+  Q_REVISION(4) void cacheEntryInfoRetrieved(int requestId,
+                                             bool cached,
+                                             qint64 size);
+  Q_REVISION(4) void cacheEntriesEvicted(int requestId, int numEvicted);
+  Q_REVISION(4) void cacheStatsRetrieved(int requestId,
+                                         const QVariantMap& stats);
 
  protected:
   // QQmlParserStatus implementation
@@ -45,7 +45,7 @@ class WebContextProxy;
 
 namespace qquick {
 namespace webcontextdelegateworker {
-class IOThreadController;
+class WorkerThreadController;
 }
 class WebContextIODelegate;
 }
@@ -108,6 +108,16 @@ class Q_DECL_EXPORT OxideQQuickWebContextPrivate
   QNetworkAccessManager* GetCustomNetworkAccessManager() override;
   void DefaultAudioCaptureDeviceChanged() override;
   void DefaultVideoCaptureDeviceChanged() override;
+  void MemoryUsageAvailable(
+      const oxide::qt::WebContextMemoryUsage& usage) override;
+  void PackedArchiveAdded(const QString& scheme, bool success) override;
+  void UrlsPrefetched(int request_id, int succeeded, int failed) override;
+  void CacheEntryInfoRetrieved(int request_id,
+                               bool cached,
+                               qint64 size) override;
+  void CacheEntriesEvicted(int request_id, int num_evicted) override;
+  void CacheStatsRetrieved(int request_id,
+                           const oxide::qt::HttpCacheStats& stats) override;
 
   OxideQQuickWebContext* q_ptr;
 
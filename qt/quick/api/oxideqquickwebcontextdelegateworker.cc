@@ -19,6 +19,8 @@
 #include "oxideqquickwebcontextdelegateworker_p_p.h"
 
 #include <QByteArray>
+#include <QCoreApplication>
+#include <QEvent>
 #include <QFile>
 #include <QGuiApplication>
 #include <QIODevice>
@@ -26,41 +28,93 @@
 #include <QJSValue>
 #include <QJSValueList>
 #include <QQmlEngine>
+#include <QSemaphore>
 #include <QString>
 #include <QtDebug>
 #include <QThread>
 #include <QVariant>
 
-#include "qt/core/api/oxideqglobal.h"
-#include "qt/quick/oxide_qquick_init.h"
-
 #include "oxideqquickwebcontext.h"
 #include "oxideqquickwebcontext_p.h"
 
-// WebContextDelegateWorker runs a script on Chromium's IO thread. It can
+// WebContextDelegateWorker runs a script on its own dedicated thread. It can
 // exchange messages with the UI thread, and provides entry points for
-// handling events from Chromium (on its IO thread).
+// handling events from Chromium's IO thread. Events are dispatched to the
+// worker asynchronously, so that a slow script doesn't block the IO thread.
 
 // There are several classes involved to make WebContextDelegateWorker function:
 // - OxideQQuickWebContextDelegateWorkerPrivate:
 //    This is the private impl for OxideQQuickWebContextDelegateWorker and lives
-//    on the UI thread. It has a strong reference to IOThreadController and
+//    on the UI thread. It has a strong reference to WorkerThreadController and
 //    calls methods on it asynchronously for starting the worker and sending
 //    messages
 //
-// - IOThreadController:
-//    This object lives on Chromium's IO thread and is responsible for
+// - WorkerThreadController:
+//    This object lives on the worker thread and is responsible for
 //    evaluating the script, receiving events from Chromium and handling
 //    asynchronous calls from the UI thread. OxideQQuickWebContextDelegateWorkerPrivate
 //    has an owning reference to it. Because the owning reference lives on the
-//    UI thread, accesses to it on the IO thread must be done via QSharedPointer
+//    UI thread, accesses to it from the IO thread must be done via
+//    QSharedPointer. The worker thread exits once the controller is deleted
 
 namespace oxide {
 namespace qquick {
 namespace webcontextdelegateworker {
 
-IOThreadController::IOThreadController() {}
-IOThreadController::~IOThreadController() {}
+namespace {
+
+// Carries an entry point call to the worker thread. |done| is run when the
+// event is deleted, which happens after it has been delivered or when it is
+// discarded because the controller was deleted first
+class CallEntryPointEvent : public QEvent {
+ public:
+  CallEntryPointEvent(const QString& entry,
+                      QObject* data,
+                      const std::function<void()>& done)
+      : QEvent(GetType()),
+        entry_(entry),
+        data_(data),
+        done_(done) {}
+  ~CallEntryPointEvent() override {
+    done_();
+  }
+
+  static QEvent::Type GetType() {
+    static int type = QEvent::registerEventType();
+    return static_cast<QEvent::Type>(type);
+  }
+
+  const QString& entry() const { return entry_; }
+  QObject* data() const { return data_; }
+
+ private:
+  QString entry_;
+  QObject* data_;
+  std::function<void()> done_;
+};
+
+}
+
+WorkerThreadController::WorkerThreadController()
+    : timeout_(0),
+      cancel_on_timeout_(false) {}
+
+WorkerThreadController::~WorkerThreadController() {}
+
+bool WorkerThreadController::CallEntryPointInWorkerAndWait(
+    const QString& entry,
+    const QSharedPointer<QObject>& data,
+    int timeout) {
+  Q_ASSERT(thread() != QThread::currentThread());
+
+  // The semaphore and |data| are shared with the callback, as they must
+  // outlive this call if we give up waiting
+  QSharedPointer<QSemaphore> sem(new QSemaphore());
+  CallEntryPointInWorker(entry, data.data(),
+                         [sem, data]() { sem->release(); });
+
+  return sem->tryAcquire(1, timeout);
+}
 
 class Api : public QObject {
   Q_OBJECT
@@ -68,7 +122,7 @@ class Api : public QObject {
   Q_PROPERTY(QJSValue onMessage READ onMessage WRITE setOnMessage)
 
  public:
-  Api(IOThreadControllerImpl* controller);
+  Api(WorkerThreadControllerImpl* controller);
   virtual ~Api() {}
 
   QJSValue onMessage() const {
@@ -81,18 +135,18 @@ class Api : public QObject {
   Q_INVOKABLE void sendMessage(const QVariant& message);
 
  private:
-  IOThreadControllerImpl* controller_;
+  WorkerThreadControllerImpl* controller_;
   QJSValue on_message_handler_;
 };
 
-class IOThreadControllerImpl : public IOThreadController {
+class WorkerThreadControllerImpl : public WorkerThreadController {
   Q_OBJECT
 
  public:
-  IOThreadControllerImpl()
+  WorkerThreadControllerImpl()
       : running_(false),
         api_(this) {}
-  virtual ~IOThreadControllerImpl() {
+  virtual ~WorkerThreadControllerImpl() {
     Q_ASSERT(thread() == QThread::currentThread());
   }
 
@@ -104,8 +158,15 @@ class IOThreadControllerImpl : public IOThreadController {
   void error(const QString& error);
 
  private:
-  // IOThreadController implementation
-  void CallEntryPointInWorker(const QString& entry, QObject* data) final;
+  void CallEntryPoint(const QString& entry, QObject* data);
+
+  // QObject implementation
+  bool event(QEvent* event) override;
+
+  // WorkerThreadController implementation
+  void CallEntryPointInWorker(const QString& entry,
+                              QObject* data,
+                              const std::function<void()>& done) final;
 
   bool running_;
   Api api_;
@@ -113,7 +174,7 @@ class IOThreadControllerImpl : public IOThreadController {
   QJSValue exports_;
 };
 
-Api::Api(IOThreadControllerImpl* controller)
+Api::Api(WorkerThreadControllerImpl* controller)
     : QObject(controller),
       controller_(controller) {}
    
@@ -132,8 +193,8 @@ void Api::sendMessage(const QVariant& message) {
   Q_EMIT controller_->sendMessage(doc.toVariant());
 }
 
-void IOThreadControllerImpl::CallEntryPointInWorker(
-    const QString& entry, QObject* data) {
+void WorkerThreadControllerImpl::CallEntryPoint(const QString& entry,
+                                                QObject* data) {
   Q_ASSERT(thread() == QThread::currentThread());
   if (!running_) {
     return;
@@ -152,7 +213,26 @@ void IOThreadControllerImpl::CallEntryPointInWorker(
   func.call(argv);
 }
 
-void IOThreadControllerImpl::runScript(const QUrl& source) {
+bool WorkerThreadControllerImpl::event(QEvent* event) {
+  if (event->type() != CallEntryPointEvent::GetType()) {
+    return WorkerThreadController::event(event);
+  }
+
+  CallEntryPointEvent* call = static_cast<CallEntryPointEvent*>(event);
+  CallEntryPoint(call->entry(), call->data());
+
+  return true;
+}
+
+void WorkerThreadControllerImpl::CallEntryPointInWorker(
+    const QString& entry,
+    QObject* data,
+    const std::function<void()>& done) {
+  QCoreApplication::postEvent(this,
+                              new CallEntryPointEvent(entry, data, done));
+}
+
+void WorkerThreadControllerImpl::runScript(const QUrl& source) {
   Q_ASSERT(thread() == QThread::currentThread());
   Q_ASSERT(!running_);
 
@@ -192,7 +272,7 @@ void IOThreadControllerImpl::runScript(const QUrl& source) {
   running_ = true;
 }
 
-void IOThreadControllerImpl::receiveMessage(
+void WorkerThreadControllerImpl::receiveMessage(
     const QVariant& message) {
   Q_ASSERT(thread() == QThread::currentThread());
   if (!running_) {
@@ -221,7 +301,7 @@ OxideQQuickWebContextDelegateWorkerPrivate::OxideQQuickWebContextDelegateWorkerP
       owned_by_context(false),
       constructed_(false),
       in_destruction_(false),
-      io_thread_controller_(new IOThreadControllerImpl(), &QObject::deleteLater) {}
+      worker_thread_controller_(new WorkerThreadControllerImpl(), &QObject::deleteLater) {}
 
 OxideQQuickWebContextDelegateWorkerPrivate::~OxideQQuickWebContextDelegateWorkerPrivate() {}
 
@@ -231,21 +311,30 @@ OxideQQuickWebContextDelegateWorkerPrivate::get(OxideQQuickWebContextDelegateWor
   return q->d_func();
 }
 
-QSharedPointer<oxide::qquick::webcontextdelegateworker::IOThreadController>
-OxideQQuickWebContextDelegateWorkerPrivate::io_thread_controller() const {
-  return io_thread_controller_;
+QSharedPointer<oxide::qquick::webcontextdelegateworker::WorkerThreadController>
+OxideQQuickWebContextDelegateWorkerPrivate::worker_thread_controller() const {
+  return worker_thread_controller_;
 }
 
 OxideQQuickWebContextDelegateWorker::OxideQQuickWebContextDelegateWorker() :
     d_ptr(new OxideQQuickWebContextDelegateWorkerPrivate()) {
   Q_D(OxideQQuickWebContextDelegateWorker);
 
-  oxide::qquick::EnsureChromiumStarted();
-  d->io_thread_controller_->moveToThread(oxideGetIOThread());
+  QThread* thread = new QThread();
+  thread->setObjectName(QStringLiteral("Oxide_DelegateWorker"));
+  d->worker_thread_controller_->moveToThread(thread);
 
-  connect(d->io_thread_controller_.data(), SIGNAL(error(const QString&)),
+  // The thread outlives us if the IO thread still holds a reference to the
+  // controller, so it stops itself once the controller has gone
+  connect(d->worker_thread_controller_.data(), SIGNAL(destroyed()),
+          thread, SLOT(quit()), Qt::DirectConnection);
+  connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
+
+  thread->start();
+
+  connect(d->worker_thread_controller_.data(), SIGNAL(error(const QString&)),
           this, SIGNAL(error(const QString&)));
-  connect(d->io_thread_controller_.data(),
+  connect(d->worker_thread_controller_.data(),
           SIGNAL(sendMessage(const QVariant&)),
           this, SIGNAL(message(const QVariant&)));
 }
@@ -263,10 +352,10 @@ OxideQQuickWebContextDelegateWorker::~OxideQQuickWebContextDelegateWorker() {
   Q_ASSERT(d->attached_count == 0);
   Q_ASSERT(!d->context);
 
-  disconnect(d->io_thread_controller_.data(),
+  disconnect(d->worker_thread_controller_.data(),
              SIGNAL(error(const QString&)),
              this, SIGNAL(error(const QString&)));
-  disconnect(d->io_thread_controller_.data(),
+  disconnect(d->worker_thread_controller_.data(),
              SIGNAL(sendMessage(const QVariant&)),
              this, SIGNAL(message(const QVariant&)));
 }
@@ -284,7 +373,7 @@ void OxideQQuickWebContextDelegateWorker::componentComplete() {
     return;
   }
 
-  QMetaObject::invokeMethod(d->io_thread_controller_.data(),
+  QMetaObject::invokeMethod(d->worker_thread_controller_.data(),
                             "runScript",
                             Q_ARG(QUrl, d->source_));
 }
@@ -306,6 +395,45 @@ void OxideQQuickWebContextDelegateWorker::setSource(const QUrl& source) {
   d->source_ = source;
 }
 
+int OxideQQuickWebContextDelegateWorker::timeout() const {
+  Q_D(const OxideQQuickWebContextDelegateWorker);
+
+  return d->worker_thread_controller_->timeout();
+}
+
+void OxideQQuickWebContextDelegateWorker::setTimeout(int timeout) {
+  Q_D(OxideQQuickWebContextDelegateWorker);
+
+  if (timeout < 0) {
+    qWarning() << "WebContextDelegateWorker.timeout cannot be negative";
+    return;
+  }
+
+  if (timeout == this->timeout()) {
+    return;
+  }
+
+  d->worker_thread_controller_->setTimeout(timeout);
+  Q_EMIT timeoutChanged();
+}
+
+bool OxideQQuickWebContextDelegateWorker::cancelOnTimeout() const {
+  Q_D(const OxideQQuickWebContextDelegateWorker);
+
+  return d->worker_thread_controller_->cancelOnTimeout();
+}
+
+void OxideQQuickWebContextDelegateWorker::setCancelOnTimeout(bool cancel) {
+  Q_D(OxideQQuickWebContextDelegateWorker);
+
+  if (cancel == cancelOnTimeout()) {
+    return;
+  }
+
+  d->worker_thread_controller_->setCancelOnTimeout(cancel);
+  Q_EMIT cancelOnTimeoutChanged();
+}
+
 void OxideQQuickWebContextDelegateWorker::sendMessage(const QVariant& message) {
   Q_D(OxideQQuickWebContextDelegateWorker);
 
@@ -321,7 +449,7 @@ void OxideQQuickWebContextDelegateWorker::sendMessage(const QVariant& message) {
     return;
   }
 
-  QMetaObject::invokeMethod(d->io_thread_controller_.data(),
+  QMetaObject::invokeMethod(d->worker_thread_controller_.data(),
                             "receiveMessage",
                             Q_ARG(QVariant, doc.toVariant()));
 }
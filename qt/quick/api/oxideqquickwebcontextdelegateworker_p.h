@@ -39,6 +39,8 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickWebContextDelegateWorker :
   Q_OBJECT
 
   Q_PROPERTY(QUrl source READ source WRITE setSource)
+  Q_PROPERTY(int timeout READ timeout WRITE setTimeout NOTIFY timeoutChanged REVISION 1)
+  Q_PROPERTY(bool cancelOnTimeout READ cancelOnTimeout WRITE setCancelOnTimeout NOTIFY cancelOnTimeoutChanged REVISION 1)
 
   Q_DECLARE_PRIVATE(OxideQQuickWebContextDelegateWorker)
   Q_DISABLE_COPY(OxideQQuickWebContextDelegateWorker)
@@ -55,12 +57,20 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickWebContextDelegateWorker :
   QUrl source() const;
   void setSource(const QUrl& url);
 
+  int timeout() const;
+  void setTimeout(int timeout);
+
+  bool cancelOnTimeout() const;
+  void setCancelOnTimeout(bool cancel);
+
  public Q_SLOTS:
   void sendMessage(const QVariant& message);
 
  Q_SIGNALS:
   void message(const QVariant& message);
   void error(const QString& error);
+  Q_REVISION(1) void timeoutChanged();
+  Q_REVISION(1) void cancelOnTimeoutChanged();
 
  private:
   QScopedPointer<OxideQQuickWebContextDelegateWorkerPrivate> d_ptr;
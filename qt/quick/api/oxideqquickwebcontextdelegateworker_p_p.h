@@ -18,12 +18,15 @@
 #ifndef _OXIDE_QT_QUICK_API_WEB_CONTEXT_DELEGATE_WORKER_P_P_H_
 #define _OXIDE_QT_QUICK_API_WEB_CONTEXT_DELEGATE_WORKER_P_P_H_
 
+#include <QAtomicInt>
 #include <QObject>
 #include <QPointer>
 #include <QSharedPointer>
 #include <QtGlobal>
 #include <QUrl>
 
+#include <functional>
+
 class OxideQQuickWebContext;
 class OxideQQuickWebContextDelegateWorker;
 
@@ -35,16 +38,42 @@ namespace oxide {
 namespace qquick {
 namespace webcontextdelegateworker {
 
-class IOThreadControllerImpl;
+class WorkerThreadControllerImpl;
 
-class IOThreadController : public QObject {
+class WorkerThreadController : public QObject {
  public:
-  virtual ~IOThreadController();
-
-  virtual void CallEntryPointInWorker(const QString& entry, QObject* data) = 0;
+  virtual ~WorkerThreadController();
+
+  // Asynchronously call |entry| in the worker with |data|. This can be called
+  // from any thread. |done| is run on the worker thread once the call has
+  // finished, or when the call is discarded because the worker is being
+  // destroyed. |data| must remain valid until then
+  virtual void CallEntryPointInWorker(const QString& entry,
+                                      QObject* data,
+                                      const std::function<void()>& done) = 0;
+
+  // Call |entry| in the worker with |data| and block until it has finished or
+  // |timeout| milliseconds have elapsed. Returns false if the call timed out,
+  // in which case the worker may still be using |data| and keeps a reference
+  // to it until the call completes. This must not be called from the worker
+  // thread
+  bool CallEntryPointInWorkerAndWait(const QString& entry,
+                                     const QSharedPointer<QObject>& data,
+                                     int timeout);
+
+  // These are read from Chromium's IO thread
+  int timeout() const { return timeout_.load(); }
+  void setTimeout(int timeout) { timeout_.store(timeout); }
+
+  bool cancelOnTimeout() const { return cancel_on_timeout_.load() != 0; }
+  void setCancelOnTimeout(bool cancel) { cancel_on_timeout_.store(cancel); }
 
  protected:
-  IOThreadController();
+  WorkerThreadController();
+
+ private:
+  QAtomicInt timeout_;
+  QAtomicInt cancel_on_timeout_;
 };
 
 }
@@ -58,8 +87,8 @@ class OxideQQuickWebContextDelegateWorkerPrivate final {
   static OxideQQuickWebContextDelegateWorkerPrivate* get(
       OxideQQuickWebContextDelegateWorker* q);
 
-  QSharedPointer<oxide::qquick::webcontextdelegateworker::IOThreadController>
-      io_thread_controller() const;
+  QSharedPointer<oxide::qquick::webcontextdelegateworker::WorkerThreadController>
+      worker_thread_controller() const;
 
   bool in_destruction() const { return in_destruction_; }
 
@@ -77,8 +106,8 @@ class OxideQQuickWebContextDelegateWorkerPrivate final {
 
   bool in_destruction_;
 
-  QSharedPointer<oxide::qquick::webcontextdelegateworker::IOThreadControllerImpl>
-      io_thread_controller_;
+  QSharedPointer<oxide::qquick::webcontextdelegateworker::WorkerThreadControllerImpl>
+      worker_thread_controller_;
 };
 
 #endif // _OXIDE_QT_QUICK_API_WEB_CONTEXT_DELEGATE_WORKER_P_P_H_
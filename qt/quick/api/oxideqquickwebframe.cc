@@ -237,12 +237,8 @@ void OxideQQuickWebFrame::addMessageHandler(
     return;
   }
 
-  if (d->proxy_->messageHandlers().contains(handler)) {
-    d->proxy_->messageHandlers().removeOne(handler);
-  }
-
   handler->setParent(this);
-  d->proxy_->messageHandlers().append(handler);
+  d->proxy_->addMessageHandler(handler);
 
   emit messageHandlersChanged();
 }
@@ -270,7 +266,7 @@ void OxideQQuickWebFrame::removeMessageHandler(
   }
 
   handler->setParent(nullptr);
-  d->proxy_->messageHandlers().removeOne(handler);
+  d->proxy_->removeMessageHandler(handler);
 
   emit messageHandlersChanged();
 }
@@ -56,6 +56,8 @@
 #include "qt/quick/oxide_qquick_init.h"
 #include "qt/quick/qquick_legacy_auxiliary_ui_factory.h"
 
+#include "oxideqquickframemetadata.h"
+#include "oxideqquickframemetadata_p.h"
 #include "oxideqquicklocationbarcontroller.h"
 #include "oxideqquicklocationbarcontroller_p.h"
 #include "oxideqquicknavigationhistory.h"
@@ -140,7 +142,11 @@ OxideQQuickWebViewPrivate::OxideQQuickWebViewPrivate(
       find_controller_(OxideQFindControllerPrivate::Create()),
       file_picker_(nullptr),
       using_old_load_event_signal_(false),
-      construct_props_(new ConstructProps()) {}
+      construct_props_(new ConstructProps()),
+      frame_metadata_(OxideQQuickFrameMetadataPrivate::create()),
+      pending_frame_metadata_flags_(oxide::qt::FRAME_METADATA_CHANGE_NONE),
+      frame_metadata_flush_scheduled_(false),
+      throttle_frame_metadata_(false) {}
 
 oxide::qt::LegacyExternalTouchEditingMenuControllerDelegate*
 OxideQQuickWebViewPrivate
@@ -397,22 +403,10 @@ void OxideQQuickWebViewPrivate::HttpAuthenticationRequested(
 
 void OxideQQuickWebViewPrivate::FrameMetadataUpdated(
     oxide::qt::FrameMetadataChangeFlags flags) {
-  Q_Q(OxideQQuickWebView);
-
-  QFlags<oxide::qt::FrameMetadataChangeFlags> f(flags);
-
-  if (f.testFlag(oxide::qt::FRAME_METADATA_CHANGE_SCROLL_OFFSET)) {
-    emit q->contentXChanged();
-    emit q->contentYChanged();
-  }
-  if (f.testFlag(oxide::qt::FRAME_METADATA_CHANGE_CONTENT)) {
-    emit q->contentWidthChanged();
-    emit q->contentHeightChanged();
-  }
-  if (f.testFlag(oxide::qt::FRAME_METADATA_CHANGE_VIEWPORT)) {
-    emit q->viewportWidthChanged();
-    emit q->viewportHeightChanged();
-  }
+  // Notifications are batched and delivered once per QtQuick frame - see
+  // flushFrameMetadata
+  pending_frame_metadata_flags_ |= flags;
+  scheduleFrameMetadataFlush();
 }
 
 void OxideQQuickWebViewPrivate::DownloadRequested(
@@ -483,6 +477,29 @@ void OxideQQuickWebViewPrivate::ZoomLevelChanged() {
   emit q->zoomFactorChanged();
 }
 
+void OxideQQuickWebViewPrivate::MemoryUsageAvailable(
+    const oxide::qt::WebViewMemoryUsage& usage) {
+  Q_Q(OxideQQuickWebView);
+
+  QVariantMap renderer;
+  renderer["processId"] = usage.renderer.processId;
+  renderer["privateBytes"] = usage.renderer.privateBytes;
+  renderer["sharedBytes"] = usage.renderer.sharedBytes;
+  QVariantList sites;
+  for (const QUrl& site : usage.renderer.sites) {
+    sites.append(site);
+  }
+  renderer["sites"] = sites;
+
+  QVariantMap report;
+  report["renderer"] = renderer;
+  report["compositorFrameCount"] = usage.compositorFrameCount;
+  report["compositorFrameBytes"] = usage.compositorFrameBytes;
+  report["navigationEntryCount"] = usage.navigationEntryCount;
+
+  emit q->memoryReportReady(report);
+}
+
 void OxideQQuickWebViewPrivate::completeConstruction() {
   Q_Q(OxideQQuickWebView);
 
@@ -534,7 +551,10 @@ void OxideQQuickWebViewPrivate::completeConstruction() {
     proxy_->setPreferences(construct_props_->preferences);
   }
 
-  proxy_->messageHandlers().swap(construct_props_->message_handlers);
+  for (QObject* handler : construct_props_->message_handlers) {
+    proxy_->addMessageHandler(handler);
+  }
+  construct_props_->message_handlers.clear();
 
   if (!construct_props_->new_view_request) {
     if (construct_props_->load_html) {
@@ -622,7 +642,7 @@ void OxideQQuickWebViewPrivate::messageHandler_clear(
   }
 }
 
-QList<QObject*>& OxideQQuickWebViewPrivate::messageHandlers() {
+const QList<QObject*>& OxideQQuickWebViewPrivate::messageHandlers() const {
   if (!proxy_) {
     return construct_props_->message_handlers;
   }
@@ -630,6 +650,25 @@ QList<QObject*>& OxideQQuickWebViewPrivate::messageHandlers() {
   return proxy_->messageHandlers();
 }
 
+void OxideQQuickWebViewPrivate::addMessageHandler(QObject* handler) {
+  if (!proxy_) {
+    construct_props_->message_handlers.removeOne(handler);
+    construct_props_->message_handlers.append(handler);
+    return;
+  }
+
+  proxy_->addMessageHandler(handler);
+}
+
+void OxideQQuickWebViewPrivate::removeMessageHandler(QObject* handler) {
+  if (!proxy_) {
+    construct_props_->message_handlers.removeOne(handler);
+    return;
+  }
+
+  proxy_->removeMessageHandler(handler);
+}
+
 QObject* OxideQQuickWebViewPrivate::contextHandle() const {
   if (!proxy_) {
     return construct_props_->context;
@@ -701,6 +740,159 @@ void OxideQQuickWebViewPrivate::preferencesDestroyed() {
   q->setPreferences(nullptr);
 }
 
+bool OxideQQuickWebViewPrivate::isFrameMetadataThrottled() const {
+  Q_Q(const OxideQQuickWebView);
+
+  if (!throttle_frame_metadata_) {
+    return false;
+  }
+
+  if (!q->isVisible()) {
+    return true;
+  }
+
+  if (!frame_metadata_window_) {
+    return false;
+  }
+
+  QWindow::Visibility visibility = frame_metadata_window_->visibility();
+  return visibility == QWindow::Hidden || visibility == QWindow::Minimized;
+}
+
+void OxideQQuickWebViewPrivate::scheduleFrameMetadataFlush() {
+  Q_Q(OxideQQuickWebView);
+
+  if (frame_metadata_flush_scheduled_ || isFrameMetadataThrottled()) {
+    return;
+  }
+
+  frame_metadata_flush_scheduled_ = true;
+
+  if (frame_metadata_window_ && frame_metadata_window_->isExposed()) {
+    // We're connected to QQuickWindow::afterAnimating. Metadata normally
+    // changes along with a new compositor frame, which schedules a QtQuick
+    // frame anyway. Only force one if nothing else has by the time the
+    // current event has been handled - see ensureFrameForFrameMetadata
+    QMetaObject::invokeMethod(q, "ensureFrameForFrameMetadata",
+                              Qt::QueuedConnection);
+    return;
+  }
+
+  // There's no window that will produce a frame (eg, we're headless), so
+  // flush from the event loop instead
+  QMetaObject::invokeMethod(q, "flushFrameMetadata", Qt::QueuedConnection);
+}
+
+void OxideQQuickWebViewPrivate::flushFrameMetadata() {
+  Q_Q(OxideQQuickWebView);
+
+  if (!frame_metadata_flush_scheduled_) {
+    return;
+  }
+
+  frame_metadata_flush_scheduled_ = false;
+
+  if (isFrameMetadataThrottled() || !proxy_) {
+    // Leave the changes pending until we become visible again
+    return;
+  }
+
+  QFlags<oxide::qt::FrameMetadataChangeFlags> f(
+      static_cast<oxide::qt::FrameMetadataChangeFlags>(
+          pending_frame_metadata_flags_));
+  pending_frame_metadata_flags_ = oxide::qt::FRAME_METADATA_CHANGE_NONE;
+
+  if (!f) {
+    return;
+  }
+
+  bool changed =
+      OxideQQuickFrameMetadataPrivate::get(frame_metadata_.get())->update(
+          proxy_->compositorFrameScrollOffset(),
+          proxy_->compositorFrameContentSize(),
+          proxy_->compositorFrameViewportSize());
+
+  if (f.testFlag(oxide::qt::FRAME_METADATA_CHANGE_SCROLL_OFFSET)) {
+    emit q->contentXChanged();
+    emit q->contentYChanged();
+  }
+  if (f.testFlag(oxide::qt::FRAME_METADATA_CHANGE_CONTENT)) {
+    emit q->contentWidthChanged();
+    emit q->contentHeightChanged();
+  }
+  if (f.testFlag(oxide::qt::FRAME_METADATA_CHANGE_VIEWPORT)) {
+    emit q->viewportWidthChanged();
+    emit q->viewportHeightChanged();
+  }
+
+  if (changed) {
+    emit q->frameMetadataChanged();
+  }
+}
+
+void OxideQQuickWebViewPrivate::ensureFrameForFrameMetadata() {
+  if (!frame_metadata_flush_scheduled_) {
+    // afterAnimating already flushed
+    return;
+  }
+
+  if (!frame_metadata_window_ || !frame_metadata_window_->isExposed()) {
+    flushFrameMetadata();
+    return;
+  }
+
+  if (contents_view_->hasPendingFrame()) {
+    return;
+  }
+
+  frame_metadata_window_->update();
+}
+
+void OxideQQuickWebViewPrivate::updateFrameMetadataThrottling() {
+  if (pending_frame_metadata_flags_ == oxide::qt::FRAME_METADATA_CHANGE_NONE) {
+    return;
+  }
+
+  scheduleFrameMetadataFlush();
+}
+
+void OxideQQuickWebViewPrivate::setFrameMetadataWindow(QQuickWindow* window) {
+  Q_Q(OxideQQuickWebView);
+
+  if (window == frame_metadata_window_) {
+    return;
+  }
+
+  if (frame_metadata_window_) {
+    QObject::disconnect(frame_metadata_window_, SIGNAL(afterAnimating()),
+                        q, SLOT(flushFrameMetadata()));
+    QObject::disconnect(
+        frame_metadata_window_,
+        SIGNAL(visibilityChanged(QWindow::Visibility)),
+        q, SLOT(windowVisibilityChanged()));
+  }
+
+  frame_metadata_window_ = window;
+
+  if (frame_metadata_window_) {
+    QObject::connect(frame_metadata_window_, SIGNAL(afterAnimating()),
+                     q, SLOT(flushFrameMetadata()));
+    QObject::connect(frame_metadata_window_,
+                     SIGNAL(visibilityChanged(QWindow::Visibility)),
+                     q, SLOT(windowVisibilityChanged()));
+  }
+
+  // A flush that is waiting for the old window won't happen now
+  if (frame_metadata_flush_scheduled_) {
+    frame_metadata_flush_scheduled_ = false;
+    scheduleFrameMetadataFlush();
+  }
+}
+
+void OxideQQuickWebViewPrivate::windowVisibilityChanged() {
+  updateFrameMetadataThrottling();
+}
+
 OxideQQuickWebViewPrivate::~OxideQQuickWebViewPrivate() {}
 
 // static
@@ -1014,6 +1206,11 @@ OxideQQuickWebView::OxideQQuickWebView(OxideQQuickWebViewPrivate& dd,
 
   connect(d->navigation_history_.get(), &OxideQQuickNavigationHistory::changed,
           this, &OxideQQuickWebView::navigationHistoryChanged);
+  connect(d->contents_view_.get(), &oxide::qquick::ContentsView::frameCaptured,
+          this, &OxideQQuickWebView::frameCaptured);
+  connect(d->contents_view_.get(),
+          &oxide::qquick::ContentsView::frameCaptureFailed,
+          this, &OxideQQuickWebView::frameCaptureFailed);
 }
 
 void OxideQQuickWebView::connectNotify(const QMetaMethod& signal) {
@@ -1096,6 +1293,12 @@ void OxideQQuickWebView::itemChange(QQuickItem::ItemChange change,
 
   QQuickItem::itemChange(change, value);
   d->contents_view_->handleItemChange(change);
+
+  if (change == QQuickItem::ItemSceneChange) {
+    d->setFrameMetadataWindow(value.window);
+  } else if (change == QQuickItem::ItemVisibleHasChanged) {
+    d->updateFrameMetadataThrottling();
+  }
 }
 
 void OxideQQuickWebView::keyPressEvent(QKeyEvent* event) {
@@ -1350,8 +1553,40 @@ specified by the \e{<link rel="icon">} element if it exists in the page, else it
 will fallback to \e{<domain>/favicon.ico} if the page is loaded over http: or
 https:.
 
-The application is responsible for downloading the icon. The icon specified by
-this property is not guaranteed to exist.
+The icon specified by this property is not guaranteed to exist.
+
+Since OxideQt 1.23, Oxide downloads and caches the icon itself. Cached icons
+are shared between all web views and persist across restarts for web contexts
+with a \l{WebContext::dataPath}{dataPath}. The cached icon for any page that
+has been visited can be displayed with an \e{Image} whose source is
+\e{image://oxide-favicon/} followed by the percent-encoded page URL.
+
+The icon for the current page might not be in the cache yet when the URL
+changes. Once it has been downloaded and cached, \e{iconChanged} is emitted
+again even though the value of this property is unchanged. As an \e{Image}
+doesn't reload an unchanged source, a query that changes with each
+notification can be appended to the source - the query is ignored when looking
+up the icon:
+
+\code
+Image {
+  id: favicon
+  property int revision: 0
+  asynchronous: true
+  sourceSize: Qt.size(16, 16)
+  source: "image://oxide-favicon/" + encodeURIComponent(webView.url) +
+          "?" + revision
+
+  Connections {
+    target: webView
+    onIconChanged: favicon.revision++
+  }
+}
+\endcode
+
+The icon bitmap that best matches \e{sourceSize} is used. Icons for pages
+visited in an \l{incognito} web view are never available from
+\e{image://oxide-favicon/}.
 
 There is currently no support for other favicon types (\e{<link
 rel="apple-touch-icon">} or \e{<link rel="apple-touch-icon-precomposed">}).
@@ -1617,12 +1852,8 @@ void OxideQQuickWebView::addMessageHandler(
     return;
   }
 
-  if (d->messageHandlers().contains(handler)) {
-    d->messageHandlers().removeOne(handler);
-  }
-
   handler->setParent(this);
-  d->messageHandlers().append(handler);
+  d->addMessageHandler(handler);
 
   emit messageHandlersChanged();
 }
@@ -1650,7 +1881,7 @@ void OxideQQuickWebView::removeMessageHandler(
   }
 
   handler->setParent(nullptr);
-  d->messageHandlers().removeOne(handler);
+  d->removeMessageHandler(handler);
 
   emit messageHandlersChanged();
 }
@@ -2881,6 +3112,191 @@ void OxideQQuickWebView::terminateWebProcess() {
   d->proxy_->terminateWebProcess();
 }
 
+/*!
+\qmlproperty bool WebView::headless
+\since OxideQt 1.23
+
+Whether this WebView renders without a window. This is false by default.
+
+A headless WebView doesn't need to be in a QQuickWindow, and it doesn't draw
+anything in to the scene graph. Its viewport size is taken from its width and
+height, and its device scale factor from deviceScaleFactor. Each new frame is
+copied to an offscreen buffer and the frameCaptured signal is emitted. Use
+grabFrame or saveFrame to get the contents.
+
+If the application runs on a Qt platform without GL, such as \e{offscreen},
+frames are rendered with the software compositor and no display server is
+needed. Otherwise, frames are rendered with the GPU and read back in to system
+memory, which requires a GL context that shares with Qt's global share context.
+If a frame can't be captured, frameCaptureFailed is emitted instead of
+frameCaptured.
+
+\sa deviceScaleFactor, frameCaptured, frameCaptureFailed, grabFrame, saveFrame
+*/
+
+bool OxideQQuickWebView::headless() const {
+  Q_D(const OxideQQuickWebView);
+
+  return d->contents_view_->headless();
+}
+
+void OxideQQuickWebView::setHeadless(bool headless) {
+  Q_D(OxideQQuickWebView);
+
+  if (headless == this->headless()) {
+    return;
+  }
+
+  d->contents_view_->setHeadless(headless);
+  update();
+
+  emit headlessChanged();
+}
+
+/*!
+\qmlproperty real WebView::deviceScaleFactor
+\since OxideQt 1.23
+
+The device scale factor to render with when the WebView is headless. The
+captured frames are the WebView's size multiplied by this. The default is 0,
+which means the primary screen's scale factor is used.
+
+This has no effect unless headless is true.
+
+\sa headless
+*/
+
+qreal OxideQQuickWebView::deviceScaleFactor() const {
+  Q_D(const OxideQQuickWebView);
+
+  return d->contents_view_->deviceScaleFactor();
+}
+
+void OxideQQuickWebView::setDeviceScaleFactor(qreal scale) {
+  Q_D(OxideQQuickWebView);
+
+  if (qFuzzyCompare(scale, deviceScaleFactor())) {
+    return;
+  }
+
+  if (scale < 0) {
+    qWarning() <<
+        "OxideQQuickWebView: invalid value for device scale factor, expected "
+        "to be 0 or greater";
+    return;
+  }
+
+  d->contents_view_->setDeviceScaleFactor(scale);
+
+  emit deviceScaleFactorChanged();
+}
+
+/*!
+\qmlsignal void WebView::frameCaptured()
+\since OxideQt 1.23
+
+Emitted when a headless WebView has captured a new frame. The frame can be
+retrieved with grabFrame or saveFrame.
+
+\sa headless
+*/
+
+/*!
+\qmlsignal void WebView::frameCaptureFailed()
+\since OxideQt 1.23
+
+Emitted when a headless WebView received a new frame but couldn't copy it to an
+offscreen buffer - for example, because a GL context for reading back a frame
+rendered by the GPU couldn't be created. grabFrame and saveFrame continue to
+return the last frame that was captured successfully.
+
+\sa headless, frameCaptured
+*/
+
+/*!
+\qmlmethod image WebView::grabFrame()
+\since OxideQt 1.23
+
+Returns the most recent frame captured by a headless WebView, in physical
+pixels. This returns a null image if the WebView isn't headless or hasn't
+captured a frame yet.
+
+\sa headless, saveFrame
+*/
+
+QImage OxideQQuickWebView::grabFrame() const {
+  Q_D(const OxideQQuickWebView);
+
+  return d->contents_view_->capturedFrame();
+}
+
+/*!
+\qmlmethod bool WebView::saveFrame(string fileName)
+\since OxideQt 1.23
+
+Saves the most recent frame captured by a headless WebView to \a{fileName}. The
+image format is determined from the file extension. Returns true on success.
+
+\sa headless, grabFrame
+*/
+
+bool OxideQQuickWebView::saveFrame(const QString& fileName) const {
+  QImage frame = grabFrame();
+  if (frame.isNull()) {
+    qWarning() << "OxideQQuickWebView::saveFrame: No frame has been captured";
+    return false;
+  }
+
+  return frame.save(fileName);
+}
+
+/*!
+\qmlmethod void WebView::requestMemoryReport()
+\since OxideQt 1.23
+
+Requests a sample of the memory used on behalf of this WebView. The sample is
+taken asynchronously, and is delivered via memoryReportReady.
+
+\sa memoryReportReady, WebContext::requestMemoryReport
+*/
+
+void OxideQQuickWebView::requestMemoryReport() {
+  Q_D(OxideQQuickWebView);
+
+  if (!d->proxy_) {
+    qWarning() <<
+        "OxideQQuickWebView::requestMemoryReport: There is no web process yet";
+    return;
+  }
+
+  d->proxy_->requestMemoryUsage();
+}
+
+/*!
+\qmlsignal void WebView::memoryReportReady(object report)
+\since OxideQt 1.23
+
+Emitted in response to a call to requestMemoryReport. \a{report} has the
+following properties:
+
+\list
+  \li \e{renderer} - An object describing the web process hosting the main
+  frame, with \e{processId}, \e{privateBytes}, \e{sharedBytes} and
+  \e{sites} properties. \e{privateBytes} is the resident memory private to
+  the process, \e{sharedBytes} is the resident memory shared with other
+  processes, and \e{sites} is the list of sites currently assigned to the
+  process. Note that a web process might be shared by several WebViews
+  \li \e{compositorFrameCount} - The number of compositor frames retained by
+  Oxide for this WebView
+  \li \e{compositorFrameBytes} - An estimate of the size of the buffers
+  backing those frames, based on their dimensions
+  \li \e{navigationEntryCount} - The number of entries in the navigation
+  history
+\endlist
+
+\sa requestMemoryReport
+*/
+
 /*!
 \qmlproperty FindController WebView::findController
 \since OxideQt 1.8
@@ -2909,4 +3325,63 @@ OxideQQuickTouchSelectionController* OxideQQuickWebView::touchSelectionControlle
   return d->touch_selection_controller_.get();
 }
 
+/*!
+\qmlproperty FrameMetadata WebView::frameMetadata
+\since OxideQt 1.23
+
+A snapshot of the scroll offset, content size and viewport size of the most
+recent compositor frame. This is updated at most once per QtQuick frame, and
+\l{frameMetadataChanged} is emitted once for each update.
+
+Applications should prefer binding to this over the deprecated contentX,
+contentY, contentWidth, contentHeight, viewportWidth and viewportHeight
+properties.
+
+\sa throttleFrameMetadata
+*/
+
+OxideQQuickFrameMetadata* OxideQQuickWebView::frameMetadata() {
+  Q_D(OxideQQuickWebView);
+
+  return d->frame_metadata_.get();
+}
+
+/*!
+\qmlsignal void WebView::frameMetadataChanged()
+\since OxideQt 1.23
+
+Emitted when frameMetadata has been updated.
+*/
+
+/*!
+\qmlproperty bool WebView::throttleFrameMetadata
+\since OxideQt 1.23
+
+Whether frame metadata notifications should be suspended whilst this WebView
+is hidden, or whilst its window is hidden or minimized. When the WebView is
+shown again, any changes are delivered in a single update.
+
+This applies to frameMetadata and to the deprecated per-property
+notifications. The default is false.
+*/
+
+bool OxideQQuickWebView::throttleFrameMetadata() const {
+  Q_D(const OxideQQuickWebView);
+
+  return d->throttle_frame_metadata_;
+}
+
+void OxideQQuickWebView::setThrottleFrameMetadata(bool throttle) {
+  Q_D(OxideQQuickWebView);
+
+  if (throttle == d->throttle_frame_metadata_) {
+    return;
+  }
+
+  d->throttle_frame_metadata_ = throttle;
+  d->updateFrameMetadataThrottling();
+
+  emit throttleFrameMetadataChanged();
+}
+
 #include "moc_oxideqquickwebview.cpp"
@@ -22,6 +22,8 @@
 #include <QtCore/QString>
 #include <QtCore/QtGlobal>
 #include <QtCore/QUrl>
+#include <QtCore/QVariantMap>
+#include <QtGui/QImage>
 #include <QtQml/QQmlListProperty>
 #include <QtQml/QtQml>
 #include <QtQuick/QQuickItem>
@@ -37,6 +39,7 @@ class OxideQLoadEvent;
 class OxideQNavigationRequest;
 class OxideQNewViewRequest;
 class OxideQWebPreferences;
+class OxideQQuickFrameMetadata;
 class OxideQQuickLocationBarController;
 class OxideQQuickNavigationHistory;
 class OxideQQuickScriptMessageHandler;
@@ -138,6 +141,12 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickWebView : public QQuickItem {
   Q_PROPERTY(qreal minimumZoomFactor READ minimumZoomFactor CONSTANT REVISION 8)
   Q_PROPERTY(qreal maximumZoomFactor READ maximumZoomFactor CONSTANT REVISION 8)
 
+  Q_PROPERTY(bool headless READ headless WRITE setHeadless NOTIFY headlessChanged REVISION 10)
+  Q_PROPERTY(qreal deviceScaleFactor READ deviceScaleFactor WRITE setDeviceScaleFactor NOTIFY deviceScaleFactorChanged REVISION 10)
+
+  Q_PROPERTY(OxideQQuickFrameMetadata* frameMetadata READ frameMetadata CONSTANT REVISION 10)
+  Q_PROPERTY(bool throttleFrameMetadata READ throttleFrameMetadata WRITE setThrottleFrameMetadata NOTIFY throttleFrameMetadataChanged REVISION 10)
+
   Q_DECLARE_PRIVATE(OxideQQuickWebView)
 
  public:
@@ -316,6 +325,22 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickWebView : public QQuickItem {
   qreal minimumZoomFactor() const;
   qreal maximumZoomFactor() const;
 
+  bool headless() const;
+  void setHeadless(bool headless);
+
+  qreal deviceScaleFactor() const;
+  void setDeviceScaleFactor(qreal scale);
+
+  Q_REVISION(10) Q_INVOKABLE QImage grabFrame() const;
+  Q_REVISION(10) Q_INVOKABLE bool saveFrame(const QString& fileName) const;
+
+  Q_REVISION(10) Q_INVOKABLE void requestMemoryReport();
+
+  OxideQQuickFrameMetadata* frameMetadata();
+
+  bool throttleFrameMetadata() const;
+  void setThrottleFrameMetadata(bool throttle);
+
  public Q_SLOTS:
   void goBack();
   void goForward();
@@ -379,6 +404,13 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickWebView : public QQuickItem {
   Q_REVISION(7) void hoveredUrlChanged();
   Q_REVISION(7) void editingCapabilitiesChanged();
   Q_REVISION(8) void zoomFactorChanged();
+  Q_REVISION(10) void headlessChanged();
+  Q_REVISION(10) void deviceScaleFactorChanged();
+  Q_REVISION(10) void frameCaptured();
+  Q_REVISION(10) void frameCaptureFailed();
+  Q_REVISION(10) void frameMetadataChanged();
+  Q_REVISION(10) void throttleFrameMetadataChanged();
+  Q_REVISION(10) void memoryReportReady(const QVariantMap& report);
 
   // Deprecated since 1.3
   void loadingChanged(const OxideQLoadEvent& loadEvent);
@@ -429,6 +461,9 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickWebView : public QQuickItem {
   Q_PRIVATE_SLOT(d_func(), void contextConstructed());
   Q_PRIVATE_SLOT(d_func(), void contextDestroyed());
   Q_PRIVATE_SLOT(d_func(), void preferencesDestroyed());
+  Q_PRIVATE_SLOT(d_func(), void flushFrameMetadata());
+  Q_PRIVATE_SLOT(d_func(), void ensureFrameForFrameMetadata());
+  Q_PRIVATE_SLOT(d_func(), void windowVisibilityChanged());
 };
 
 QML_DECLARE_TYPE(OxideQQuickWebView)
@@ -35,6 +35,7 @@
 
 class OxideQNewViewRequest;
 class OxideQWebPreferences;
+class OxideQQuickFrameMetadata;
 class OxideQQuickLocationBarController;
 class OxideQQuickNavigationHistory;
 class OxideQQuickScriptMessageHandler;
@@ -46,6 +47,7 @@ QT_BEGIN_NAMESPACE
 class QQmlComponent;
 template <typename T> class QQmlListProperty;
 class QQuickItem;
+class QQuickWindow;
 QT_END_NAMESPACE
 
 namespace oxide {
@@ -120,6 +122,8 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickWebViewPrivate
   void TargetURLChanged() override;
   void OnEditingCapabilitiesChanged() override;
   void ZoomLevelChanged() override;
+  void MemoryUsageAvailable(
+      const oxide::qt::WebViewMemoryUsage& usage) override;
 
   void completeConstruction();
 
@@ -134,7 +138,9 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickWebViewPrivate
   static void messageHandler_clear(
       QQmlListProperty<OxideQQuickScriptMessageHandler>* prop);
 
-  QList<QObject*>& messageHandlers();
+  const QList<QObject*>& messageHandlers() const;
+  void addMessageHandler(QObject* handler);
+  void removeMessageHandler(QObject* handler);
 
   QObject* contextHandle() const;
 
@@ -145,6 +151,14 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickWebViewPrivate
   void attachPreferencesSignals(OxideQWebPreferences* prefs);
   void preferencesDestroyed();
 
+  bool isFrameMetadataThrottled() const;
+  void scheduleFrameMetadataFlush();
+  void flushFrameMetadata();
+  void ensureFrameForFrameMetadata();
+  void updateFrameMetadataThrottling();
+  void setFrameMetadataWindow(QQuickWindow* window);
+  void windowVisibilityChanged();
+
   std::unique_ptr<oxide::qt::AuxiliaryUIFactory> aux_ui_factory_;
   oxide::qquick::LegacyAuxiliaryUIFactory* legacy_aux_ui_factory_;
 
@@ -170,6 +184,17 @@ class OXIDE_QTQUICK_EXPORT OxideQQuickWebViewPrivate
   QScopedPointer<ConstructProps> construct_props_;
 
   std::unique_ptr<OxideQQuickLocationBarController> location_bar_controller_;
+
+  std::unique_ptr<OxideQQuickFrameMetadata> frame_metadata_;
+
+  // Frame metadata changes that haven't been delivered yet. These are
+  // accumulated between QtQuick frames so that each property is only
+  // notified once per frame
+  int pending_frame_metadata_flags_;
+  bool frame_metadata_flush_scheduled_;
+  bool throttle_frame_metadata_;
+
+  QPointer<QQuickWindow> frame_metadata_window_;
 };
 
 #endif // _OXIDE_QT_QUICK_API_WEB_VIEW_P_P_H_
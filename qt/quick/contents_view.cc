@@ -23,12 +23,14 @@
 #include <QQuickWindow>
 #include <QScreen>
 #include <QTouchEvent>
+#include <QtDebug>
 
 #include "qt/core/glue/web_popup_menu.h"
 
 #include "oxide_qquick_accelerated_frame_node.h"
 #include "oxide_qquick_image_frame_node.h"
 #include "oxide_qquick_software_frame_node.h"
+#include "render_loop_observer.h"
 
 namespace oxide {
 namespace qquick {
@@ -84,6 +86,10 @@ void ContentsView::didUpdatePaintNode() {
 }
 
 QWindow* ContentsView::GetWindow() const {
+  if (headless_) {
+    return nullptr;
+  }
+
   return item_->window();
 }
 
@@ -92,11 +98,19 @@ bool ContentsView::IsVisible() const {
 }
 
 bool ContentsView::HasFocus() const {
+  if (headless_) {
+    return item_->hasActiveFocus();
+  }
+
   return item_->hasActiveFocus() &&
       (item_->window() ? item_->window()->isActive() : false);
 }
 
 QRect ContentsView::GetBounds() const {
+  if (headless_) {
+    return QRect(0, 0, qRound(item_->width()), qRound(item_->height()));
+  }
+
   if (!item_->window()) {
     return QRect();
   }
@@ -107,7 +121,24 @@ QRect ContentsView::GetBounds() const {
                qRound(item_->width()), qRound(item_->height()));
 }
 
+float ContentsView::GetDeviceScaleFactorOverride() const {
+  if (!headless_) {
+    return 0.f;
+  }
+
+  return device_scale_factor_;
+}
+
 void ContentsView::ScheduleUpdate() {
+  if (headless_) {
+    if (!capture_pending_) {
+      capture_pending_ = true;
+      QMetaObject::invokeMethod(this, "captureCompositorFrame",
+                                Qt::QueuedConnection);
+    }
+    return;
+  }
+
   frame_evicted_ = false;
   received_new_compositor_frame_ = true;
 
@@ -115,6 +146,12 @@ void ContentsView::ScheduleUpdate() {
 }
 
 void ContentsView::EvictCurrentFrame() {
+  if (headless_) {
+    captured_frame_ = QImage();
+    buffer_pool_.clear();
+    return;
+  }
+
   frame_evicted_ = true;
   received_new_compositor_frame_ = false;
 
@@ -155,7 +192,10 @@ ContentsView::ContentsView(QQuickItem* item)
       received_new_compositor_frame_(false),
       frame_evicted_(false),
       last_composited_frame_type_(qt::CompositorFrameHandle::TYPE_INVALID),
-      handling_unhandled_key_event_(false) {}
+      handling_unhandled_key_event_(false),
+      headless_(false),
+      device_scale_factor_(0.f),
+      capture_pending_(false) {}
 
 ContentsView::~ContentsView() {}
 
@@ -163,6 +203,51 @@ void ContentsView::init() {
   connect(item_, SIGNAL(windowChanged(QQuickWindow*)), SLOT(windowChanged()));
 }
 
+void ContentsView::setHeadless(bool headless) {
+  if (headless == headless_) {
+    return;
+  }
+
+  headless_ = headless;
+
+  if (!headless_) {
+    captured_frame_ = QImage();
+    buffer_pool_.clear();
+  }
+
+  if (!view()) {
+    return;
+  }
+
+  // This changes the window, bounds and scale that we report
+  view()->windowChanged();
+
+  if (!headless_) {
+    // Any frame received whilst headless has already been acknowledged, so
+    // make sure the scenegraph catches up with the current one
+    ScheduleUpdate();
+  }
+}
+
+void ContentsView::setDeviceScaleFactor(float scale) {
+  if (scale < 0.f) {
+    qWarning() << "ContentsView: Invalid device scale factor" << scale;
+    return;
+  }
+
+  if (qFuzzyCompare(scale, device_scale_factor_)) {
+    return;
+  }
+
+  device_scale_factor_ = scale;
+
+  if (!view() || !headless_) {
+    return;
+  }
+
+  view()->windowChanged();
+}
+
 QVariant ContentsView::inputMethodQuery(Qt::InputMethodQuery query) const {
   switch (query) {
     case Qt::ImEnabled:
@@ -184,7 +269,55 @@ void ContentsView::handleItemChange(QQuickItem::ItemChange change) {
   }
 }
 
+void ContentsView::captureCompositorFrame() {
+  capture_pending_ = false;
+
+  if (!headless_ || !view()) {
+    return;
+  }
+
+  QSharedPointer<qt::CompositorFrameHandle> handle =
+      view()->compositorFrameHandle();
+
+  bool captured = false;
+  switch (handle->GetType()) {
+    case qt::CompositorFrameHandle::TYPE_SOFTWARE:
+      captured_frame_ = buffer_pool_.copy(handle->GetSoftwareFrame());
+      captured = !captured_frame_.isNull();
+      break;
+    case qt::CompositorFrameHandle::TYPE_ACCELERATED:
+    case qt::CompositorFrameHandle::TYPE_IMAGE: {
+      QImage buffer =
+          buffer_pool_.acquire(handle->GetSizeInPixels(),
+                               QImage::Format_RGBA8888_Premultiplied);
+      if (!buffer.isNull() &&
+          accelerated_frame_reader_.read(handle.data(), &buffer)) {
+        buffer_pool_.add(buffer);
+        captured_frame_ = buffer;
+        captured = true;
+      }
+      break;
+    }
+    case qt::CompositorFrameHandle::TYPE_INVALID:
+      // There's nothing to capture yet
+      break;
+  }
+
+  // Acknowledge the frame immediately, as there's no scenegraph to wait for
+  view()->didCommitCompositorFrame();
+
+  if (captured) {
+    Q_EMIT frameCaptured();
+  } else if (handle->GetType() != qt::CompositorFrameHandle::TYPE_INVALID) {
+    Q_EMIT frameCaptureFailed();
+  }
+}
+
 void ContentsView::windowChanged() {
+  if (item_->window()) {
+    RenderLoopObserver::EnsureForWindow(item_->window());
+  }
+
   if (!view()) {
     return;
   }
@@ -298,7 +431,7 @@ void ContentsView::handleGeometryChanged(const QRectF& new_geometry,
     return;
   }
 
-  if (!item_->window()) {
+  if (!item_->window() && !headless_) {
     return;
   }
 
@@ -18,6 +18,7 @@
 #ifndef _OXIDE_QQUICK_CONTENTS_VIEW_H_
 #define _OXIDE_QQUICK_CONTENTS_VIEW_H_
 
+#include <QImage>
 #include <QObject>
 #include <QPointer>
 #include <QQuickItem>
@@ -26,7 +27,9 @@
 #include "qt/core/glue/contents_view.h"
 #include "qt/core/glue/contents_view_client.h"
 
+#include "qt/quick/accelerated_frame_reader.h"
 #include "qt/quick/api/oxideqquickglobal.h"
+#include "qt/quick/offscreen_buffer_pool.h"
 
 QT_BEGIN_NAMESPACE
 class QDragEnterEvent;
@@ -56,6 +59,25 @@ class OXIDE_QTQUICK_EXPORT ContentsView : public QObject,
 
   void init();
 
+  // In headless mode, the view renders without a window. Compositor frames
+  // are copied to an offscreen buffer as they arrive rather than being drawn
+  // in the scenegraph, and the view is sized from the item geometry alone
+  bool headless() const { return headless_; }
+  void setHeadless(bool headless);
+
+  // Overrides the screen's device scale factor in headless mode. 0 means
+  // use the screen's scale factor
+  float deviceScaleFactor() const { return device_scale_factor_; }
+  void setDeviceScaleFactor(float scale);
+
+  // The most recent frame captured in headless mode
+  QImage capturedFrame() const { return captured_frame_; }
+
+  // Whether a new compositor frame has been received that the scenegraph
+  // hasn't picked up yet. If this is true, a QtQuick frame is already
+  // scheduled
+  bool hasPendingFrame() const { return received_new_compositor_frame_; }
+
   QVariant inputMethodQuery(Qt::InputMethodQuery query) const;
 
   void handleItemChange(QQuickItem::ItemChange change);
@@ -80,11 +102,16 @@ class OXIDE_QTQUICK_EXPORT ContentsView : public QObject,
 
   QSGNode* updatePaintNode(QSGNode* old_node);
 
+ Q_SIGNALS:
+  void frameCaptured();
+  void frameCaptureFailed();
+
  protected:
   QQuickItem* item() const { return item_; }
 
  private Q_SLOTS:
   void windowChanged();
+  void captureCompositorFrame();
 
  private:
   friend class UpdatePaintNodeScope;
@@ -100,6 +127,7 @@ class OXIDE_QTQUICK_EXPORT ContentsView : public QObject,
   bool IsVisible() const override;
   bool HasFocus() const override;
   QRect GetBounds() const override;
+  float GetDeviceScaleFactorOverride() const override;
   void ScheduleUpdate() override;
   void EvictCurrentFrame() override;
   void UpdateCursor(const QCursor& cursor) override;
@@ -121,6 +149,13 @@ class OXIDE_QTQUICK_EXPORT ContentsView : public QObject,
 
   bool handling_unhandled_key_event_;
 
+  bool headless_;
+  float device_scale_factor_;
+  bool capture_pending_;
+  QImage captured_frame_;
+  OffscreenBufferPool buffer_pool_;
+  AcceleratedFrameReader accelerated_frame_reader_;
+
   Q_DISABLE_COPY(ContentsView)
 };
 
@@ -0,0 +1,97 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "offscreen_buffer_pool.h"
+
+#include <cstring>
+
+#include <QtDebug>
+
+namespace oxide {
+namespace qquick {
+
+namespace {
+// Enough for the current frame, the previous frame if the application still
+// holds it, and one to copy the next frame in to
+const int kMaxBuffers = 3;
+}
+
+QImage OffscreenBufferPool::acquire(const QSize& size, QImage::Format format) {
+  for (int i = 0; i < buffers_.size();) {
+    if (!buffers_[i].isDetached()) {
+      // Still referenced outside of the pool
+      ++i;
+      continue;
+    }
+
+    if (buffers_[i].size() != size || buffers_[i].format() != format) {
+      // Free buffers with the wrong geometry won't be used again
+      buffers_.removeAt(i);
+      continue;
+    }
+
+    // Take the buffer out of the pool, so that writing to it doesn't detach
+    return buffers_.takeAt(i);
+  }
+
+  while (buffers_.size() >= kMaxBuffers) {
+    // Stop tracking the oldest buffer. Whoever holds it keeps it alive
+    buffers_.removeFirst();
+  }
+
+  return QImage(size, format);
+}
+
+OffscreenBufferPool::OffscreenBufferPool() = default;
+
+OffscreenBufferPool::~OffscreenBufferPool() = default;
+
+QImage OffscreenBufferPool::copy(const QImage& source) {
+  if (source.isNull()) {
+    return QImage();
+  }
+
+  QImage buffer = acquire(source.size(), source.format());
+  if (buffer.isNull()) {
+    qWarning() << "OffscreenBufferPool: Failed to allocate buffer";
+    return QImage();
+  }
+
+  if (buffer.bytesPerLine() == source.bytesPerLine()) {
+    memcpy(buffer.bits(), source.constBits(), source.byteCount());
+  } else {
+    int line_size = qMin(buffer.bytesPerLine(), source.bytesPerLine());
+    for (int y = 0; y < source.height(); ++y) {
+      memcpy(buffer.scanLine(y), source.constScanLine(y), line_size);
+    }
+  }
+
+  add(buffer);
+
+  return buffer;
+}
+
+void OffscreenBufferPool::add(const QImage& buffer) {
+  buffers_.append(buffer);
+}
+
+void OffscreenBufferPool::clear() {
+  buffers_.clear();
+}
+
+} // namespace qquick
+} // namespace oxide
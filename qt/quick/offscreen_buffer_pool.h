@@ -0,0 +1,58 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_QQUICK_OFFSCREEN_BUFFER_POOL_H_
+#define _OXIDE_QQUICK_OFFSCREEN_BUFFER_POOL_H_
+
+#include <QImage>
+#include <QList>
+#include <QSize>
+#include <QtGlobal>
+
+namespace oxide {
+namespace qquick {
+
+// A small pool of images that headless views copy compositor frames in to.
+// Frames are handed out as implicitly shared QImages, and a buffer is reused
+// once the pool holds the only reference to it, so steady-state capture
+// doesn't allocate
+class OffscreenBufferPool {
+ public:
+  OffscreenBufferPool();
+  ~OffscreenBufferPool();
+
+  // Returns a copy of |source| in a buffer from the pool
+  QImage copy(const QImage& source);
+
+  // Returns a buffer from the pool to write a frame in to directly. Once it
+  // has been written, the buffer should be passed to add() so that it can be
+  // reused
+  QImage acquire(const QSize& size, QImage::Format format);
+  void add(const QImage& buffer);
+
+  void clear();
+
+ private:
+  QList<QImage> buffers_;
+
+  Q_DISABLE_COPY(OffscreenBufferPool)
+};
+
+} // namespace qquick
+} // namespace oxide
+
+#endif // _OXIDE_QQUICK_OFFSCREEN_BUFFER_POOL_H_
@@ -0,0 +1,81 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "render_loop_observer.h"
+
+#include <QQuickWindow>
+
+#include "qt/core/glue/render_loop_utils.h"
+
+namespace oxide {
+namespace qquick {
+
+void RenderLoopObserver::beforeSynchronizing() {
+  qt::WindowWillSynchronize(window_);
+}
+
+void RenderLoopObserver::frameSwapped() {
+  qt::WindowFrameSwapped(window_);
+}
+
+void RenderLoopObserver::sceneGraphInvalidated() {
+  qt::WindowRenderLoopStopped(window_);
+}
+
+void RenderLoopObserver::visibleChanged(bool visible) {
+  if (visible) {
+    return;
+  }
+
+  qt::WindowRenderLoopStopped(window_);
+}
+
+RenderLoopObserver::RenderLoopObserver(QQuickWindow* window)
+    : QObject(window),
+      window_(window) {
+  // These are emitted on the render thread with the threaded render loop.
+  // Direct connections are used so that the timing information isn't
+  // delayed by the GUI thread, which is blocked during synchronization
+  connect(window, &QQuickWindow::beforeSynchronizing,
+          this, &RenderLoopObserver::beforeSynchronizing,
+          Qt::DirectConnection);
+  connect(window, &QQuickWindow::frameSwapped,
+          this, &RenderLoopObserver::frameSwapped,
+          Qt::DirectConnection);
+  connect(window, &QQuickWindow::sceneGraphInvalidated,
+          this, &RenderLoopObserver::sceneGraphInvalidated,
+          Qt::DirectConnection);
+  connect(window, &QWindow::visibleChanged,
+          this, &RenderLoopObserver::visibleChanged);
+}
+
+RenderLoopObserver::~RenderLoopObserver() {
+  qt::WindowRenderLoopStopped(window_);
+}
+
+// static
+void RenderLoopObserver::EnsureForWindow(QQuickWindow* window) {
+  if (window->findChild<RenderLoopObserver*>(QString(),
+                                             Qt::FindDirectChildrenOnly)) {
+    return;
+  }
+
+  new RenderLoopObserver(window);
+}
+
+} // namespace qquick
+} // namespace oxide
@@ -0,0 +1,61 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_QQUICK_RENDER_LOOP_OBSERVER_H_
+#define _OXIDE_QQUICK_RENDER_LOOP_OBSERVER_H_
+
+#include <QObject>
+#include <QtGlobal>
+
+QT_BEGIN_NAMESPACE
+class QQuickWindow;
+QT_END_NAMESPACE
+
+namespace oxide {
+namespace qquick {
+
+// Forwards render loop notifications for a QQuickWindow to Oxide, so that
+// web views in the window produce exactly one frame per frame rendered by the
+// window. There is one instance per window, which is owned by the window.
+//
+// With the threaded render loop, the notifications arrive on the render
+// thread, and are forwarded from there without going via the GUI thread
+class RenderLoopObserver : public QObject {
+  Q_OBJECT
+
+ public:
+  static void EnsureForWindow(QQuickWindow* window);
+
+ private Q_SLOTS:
+  void beforeSynchronizing();
+  void frameSwapped();
+  void sceneGraphInvalidated();
+  void visibleChanged(bool visible);
+
+ private:
+  RenderLoopObserver(QQuickWindow* window);
+  ~RenderLoopObserver() override;
+
+  QQuickWindow* window_;
+
+  Q_DISABLE_COPY(RenderLoopObserver)
+};
+
+} // namespace qquick
+} // namespace oxide
+
+#endif // _OXIDE_QQUICK_RENDER_LOOP_OBSERVER_H_
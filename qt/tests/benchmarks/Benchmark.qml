@@ -0,0 +1,134 @@
+import QtQuick 2.0
+import com.canonical.Oxide 1.3
+
+// Drives a WebView through the loads requested by the harness. The page
+// reports its own metrics by setting document.title to a string starting
+// with kTitlePrefix (see pages/bench.js)
+Item {
+  id: root
+
+  readonly property string kTitlePrefix: "oxide-bench:"
+
+  // Abort an iteration that hasn't completed after this long
+  readonly property int kIterationTimeoutMs: 60000
+
+  property int iteration: Benchmark.mode == "warm" ? -1 : 0
+  property bool navigatingToBlank: false
+  property var current: null
+
+  WebContext {
+    id: webContext
+    dataPath: Benchmark.dataPath
+    hostMappingRules: [
+      "MAP benchmarks:80 localhost:8080"
+    ]
+  }
+
+  WebView {
+    id: webView
+    anchors.fill: parent
+    context: webContext
+
+    onLoadEvent: {
+      if (root.navigatingToBlank) {
+        if (event.type == LoadEvent.TypeSucceeded) {
+          root.navigatingToBlank = false;
+          root.startIteration();
+        }
+        return;
+      }
+
+      if (!root.current) {
+        return;
+      }
+
+      if (event.type == LoadEvent.TypeFailed) {
+        Benchmark.fail("Failed to load " + event.url + ": " + event.errorString);
+      } else if (event.type == LoadEvent.TypeSucceeded &&
+                 root.current.load_finished_ms === undefined) {
+        root.current.load_finished_ms = Benchmark.now() - root.current.start;
+        root.maybeFinishIteration();
+      }
+    }
+
+    onTitleChanged: {
+      if (!root.current || title.indexOf(root.kTitlePrefix) != 0) {
+        return;
+      }
+
+      var msg = JSON.parse(title.substr(root.kTitlePrefix.length));
+      if (msg.state == "scroll-start") {
+        root.current.scrollStartFrames = Benchmark.windowFrameCount();
+      } else if (msg.state == "done") {
+        root.current.result = msg;
+        root.maybeFinishIteration();
+      }
+    }
+  }
+
+  Timer {
+    id: timeout
+    interval: root.kIterationTimeoutMs
+    onTriggered: Benchmark.fail("Iteration " + root.iteration + " timed out")
+  }
+
+  function navigateToBlank() {
+    navigatingToBlank = true;
+    webView.url = "about:blank";
+  }
+
+  function startIteration() {
+    current = { start: Benchmark.now() };
+    timeout.restart();
+    webView.url = Benchmark.page;
+  }
+
+  // The page's report and the browser's load event can arrive in either
+  // order
+  function maybeFinishIteration() {
+    if (current.result === undefined ||
+        current.load_finished_ms === undefined) {
+      return;
+    }
+
+    timeout.stop();
+
+    var msg = current.result;
+
+    var windowFrames = 0;
+    if (current.scrollStartFrames !== undefined) {
+      windowFrames = Benchmark.windowFrameCount() - current.scrollStartFrames;
+    }
+
+    // The warm-up load in warm mode isn't recorded
+    if (iteration >= 0) {
+      Benchmark.addResult({
+        iteration: iteration,
+        load_finished_ms: current.load_finished_ms,
+        dom_content_loaded_ms: msg.dom_content_loaded_ms,
+        first_paint_ms: msg.first_paint_ms,
+        scroll_frames: msg.scroll_frames,
+        scroll_dropped_frames: msg.scroll_dropped_frames,
+        scroll_window_frames: windowFrames
+      });
+    }
+
+    current = null;
+    ++iteration;
+
+    if (iteration >= Benchmark.iterations) {
+      Benchmark.finish();
+    } else {
+      navigateToBlank();
+    }
+  }
+
+  Component.onCompleted: {
+    // In cold mode, the first load is made straight from a fresh WebView
+    if (Benchmark.mode == "warm") {
+      navigateToBlank();
+    } else {
+      startIteration();
+    }
+  }
+}
@@ -0,0 +1,187 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "benchmark_support.h"
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QList>
+#include <QQuickWindow>
+#include <QStringList>
+#include <QtDebug>
+
+#include <unistd.h>
+
+namespace {
+
+// Returns the peak resident set size of process |pid| in kB, or -1 if it
+// can't be determined
+qint64 GetPeakRssKb(qint64 pid) {
+  QFile status(QStringLiteral("/proc/%1/status").arg(pid));
+  if (!status.open(QIODevice::ReadOnly)) {
+    return -1;
+  }
+
+  while (!status.atEnd()) {
+    QByteArray line = status.readLine();
+    if (!line.startsWith("VmHWM:")) {
+      continue;
+    }
+
+    QList<QByteArray> fields = line.mid(6).simplified().split(' ');
+    if (fields.isEmpty()) {
+      return -1;
+    }
+
+    bool ok = false;
+    qint64 value = fields.at(0).toLongLong(&ok);
+    return ok ? value : -1;
+  }
+
+  return -1;
+}
+
+// Returns the IDs of all processes that are descendants of this one, which
+// includes the zygote and renderer processes
+QList<qint64> GetDescendantProcesses() {
+  QMultiHash<qint64, qint64> children;
+
+  QDir proc(QStringLiteral("/proc"));
+  for (const QString& entry : proc.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+    bool ok = false;
+    qint64 pid = entry.toLongLong(&ok);
+    if (!ok) {
+      continue;
+    }
+
+    QFile stat(QStringLiteral("/proc/%1/stat").arg(pid));
+    if (!stat.open(QIODevice::ReadOnly)) {
+      continue;
+    }
+
+    // The command name is in parentheses and can contain spaces, so parse
+    // the fields that follow the last ')'
+    QByteArray data = stat.readAll();
+    int comm_end = data.lastIndexOf(')');
+    if (comm_end == -1) {
+      continue;
+    }
+
+    QList<QByteArray> fields = data.mid(comm_end + 1).simplified().split(' ');
+    if (fields.size() < 2) {
+      continue;
+    }
+
+    children.insert(fields.at(1).toLongLong(), pid);
+  }
+
+  QList<qint64> rv;
+  QList<qint64> pending;
+  pending.append(getpid());
+
+  while (!pending.isEmpty()) {
+    qint64 pid = pending.takeFirst();
+    for (qint64 child : children.values(pid)) {
+      rv.append(child);
+      pending.append(child);
+    }
+  }
+
+  return rv;
+}
+
+}
+
+BenchmarkSupport::BenchmarkSupport(const QUrl& page,
+                                   const QString& mode,
+                                   int iterations,
+                                   const QUrl& data_path,
+                                   const QString& output_path)
+    : page_(page),
+      mode_(mode),
+      iterations_(iterations),
+      data_path_(data_path),
+      output_path_(output_path),
+      failed_(false) {
+  timer_.start();
+}
+
+BenchmarkSupport::~BenchmarkSupport() {}
+
+void BenchmarkSupport::setWindow(QQuickWindow* window) {
+  // frameSwapped is emitted on the render thread when using the threaded
+  // render loop
+  connect(window, &QQuickWindow::frameSwapped,
+          this, &BenchmarkSupport::onFrameSwapped,
+          Qt::DirectConnection);
+}
+
+double BenchmarkSupport::now() const {
+  return timer_.nsecsElapsed() / 1000000.0;
+}
+
+int BenchmarkSupport::windowFrameCount() const {
+  return window_frame_count_.load();
+}
+
+void BenchmarkSupport::addResult(const QVariantMap& result) {
+  QVariantMap r = result;
+  r[QStringLiteral("page")] = page_.toString();
+  r[QStringLiteral("mode")] = mode_;
+
+  r[QStringLiteral("browser_peak_rss_kb")] = GetPeakRssKb(getpid());
+
+  // This is the sum of the per-process peaks, so it's an upper bound on the
+  // combined peak of the child processes
+  qint64 children_rss = 0;
+  for (qint64 pid : GetDescendantProcesses()) {
+    qint64 rss = GetPeakRssKb(pid);
+    if (rss > 0) {
+      children_rss += rss;
+    }
+  }
+  r[QStringLiteral("renderer_peak_rss_kb")] = children_rss;
+
+  results_.append(r);
+}
+
+void BenchmarkSupport::finish() {
+  QFile output(output_path_);
+  if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qWarning() << "Failed to open benchmark output file" << output_path_;
+    failed_ = true;
+  } else {
+    output.write(QJsonDocument::fromVariant(results_).toJson());
+  }
+
+  QCoreApplication::exit(failed_ ? 1 : 0);
+}
+
+void BenchmarkSupport::fail(const QString& reason) {
+  qWarning() << "Benchmark failed:" << reason;
+  failed_ = true;
+  QCoreApplication::exit(1);
+}
+
+void BenchmarkSupport::onFrameSwapped() {
+  window_frame_count_.fetchAndAddRelaxed(1);
+}
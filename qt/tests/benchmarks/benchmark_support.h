@@ -0,0 +1,95 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_QT_TESTS_BENCHMARKS_BENCHMARK_SUPPORT_H_
+#define _OXIDE_QT_TESTS_BENCHMARKS_BENCHMARK_SUPPORT_H_
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QtGlobal>
+#include <QUrl>
+#include <QVariantList>
+#include <QVariantMap>
+
+QT_BEGIN_NAMESPACE
+class QQuickWindow;
+QT_END_NAMESPACE
+
+// Exposed to Benchmark.qml as "Benchmark". It provides the benchmark
+// parameters, a monotonic clock, frame and memory counters, and collects the
+// per-iteration results that are written to the output file
+class BenchmarkSupport : public QObject {
+  Q_OBJECT
+  Q_PROPERTY(QUrl page READ page CONSTANT)
+  Q_PROPERTY(QString mode READ mode CONSTANT)
+  Q_PROPERTY(int iterations READ iterations CONSTANT)
+  Q_PROPERTY(QUrl dataPath READ dataPath CONSTANT)
+
+ public:
+  BenchmarkSupport(const QUrl& page,
+                   const QString& mode,
+                   int iterations,
+                   const QUrl& data_path,
+                   const QString& output_path);
+  ~BenchmarkSupport() override;
+
+  // Start counting frames swapped by |window|
+  void setWindow(QQuickWindow* window);
+
+  bool failed() const { return failed_; }
+
+  QUrl page() const { return page_; }
+  QString mode() const { return mode_; }
+  int iterations() const { return iterations_; }
+  QUrl dataPath() const { return data_path_; }
+
+  // Milliseconds since the harness started, from a monotonic clock
+  Q_INVOKABLE double now() const;
+
+  // The number of frames swapped by the window so far
+  Q_INVOKABLE int windowFrameCount() const;
+
+  // Record the result of an iteration. Peak RSS values for the browser
+  // process and its child processes are added to |result|
+  Q_INVOKABLE void addResult(const QVariantMap& result);
+
+  // Write the results and quit
+  Q_INVOKABLE void finish();
+
+  // Abort the benchmark with an error
+  Q_INVOKABLE void fail(const QString& reason);
+
+ private Q_SLOTS:
+  void onFrameSwapped();
+
+ private:
+  QUrl page_;
+  QString mode_;
+  int iterations_;
+  QUrl data_path_;
+  QString output_path_;
+
+  QElapsedTimer timer_;
+  QAtomicInt window_frame_count_;
+
+  QVariantList results_;
+  bool failed_;
+};
+
+#endif // _OXIDE_QT_TESTS_BENCHMARKS_BENCHMARK_SUPPORT_H_
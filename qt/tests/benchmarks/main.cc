@@ -0,0 +1,194 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QGuiApplication>
+#include <QLatin1String>
+#include <QOpenGLContext>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QQuickView>
+#include <QString>
+#include <QtDebug>
+#include <QtGlobal>
+#include <QUrl>
+#if QT_VERSION < QT_VERSION_CHECK(5, 3, 0)
+#include <QtQuick/private/qsgcontext_p.h>
+#else
+#include <QtGui/private/qopenglcontext_p.h>
+#endif
+
+#include "qt/core/api/oxideqglobal.h"
+
+#include "benchmark_support.h"
+
+// A minimal QQuickView host for Benchmark.qml. It is normally run by
+// runbenchmarks.py, which serves the pages and aggregates the results
+
+struct Options {
+  QString page;
+  QString mode = QStringLiteral("cold");
+  int iterations = 1;
+  QString plugin_path;
+  QString nss_db_path;
+  QString tmp_path;
+  QString output_path;
+  bool single_process = false;
+};
+
+static void Usage() {
+  qWarning("Usage: oxide_benchmark --page <url> --output <file> [options]");
+  qWarning(" ");
+  qWarning(" Options:");
+  qWarning("  --mode <cold|warm> .............. In warm mode, an unrecorded load is performed first");
+  qWarning("  --iterations <n> ................ The number of recorded loads");
+  qWarning("  --tmpdir <dir> .................. The directory to use for the WebContext data");
+  qWarning("  --qt-plugin-path <dir> .......... An additional Qt plugin path");
+  qWarning("  --nss-db-path <dir> ............. The NSS database to use");
+  qWarning("  --single-process ................ Run in single process mode");
+  qWarning(" ");
+  exit(1);
+}
+
+static Options ParseOptions(int& argc, char** argv) {
+  Options options;
+
+  int index = 1;
+  int outargc = 1;
+
+  while (index < argc) {
+    auto handle_string_option = [&index, argc, argv](const char* option,
+                                                     QString* out) {
+      if (QLatin1String(argv[index]) == QLatin1String(option) &&
+          (index + 1) < argc) {
+        *out = QString::fromLocal8Bit(argv[index + 1]);
+        index += 2;
+        return true;
+      }
+      return false;
+    };
+
+    QString iterations;
+    if (handle_string_option("--page", &options.page) ||
+        handle_string_option("--mode", &options.mode) ||
+        handle_string_option("--qt-plugin-path", &options.plugin_path) ||
+        handle_string_option("--nss-db-path", &options.nss_db_path) ||
+        handle_string_option("--tmpdir", &options.tmp_path) ||
+        handle_string_option("--output", &options.output_path)) {
+      continue;
+    }
+    if (handle_string_option("--iterations", &iterations)) {
+      bool ok = false;
+      options.iterations = iterations.toInt(&ok);
+      if (!ok || options.iterations < 1) {
+        Usage();
+      }
+      continue;
+    }
+    if (QLatin1String(argv[index]) == QLatin1String("--single-process")) {
+      options.single_process = true;
+      ++index;
+      continue;
+    }
+
+    if (index != outargc) {
+      argv[outargc++] = argv[index++];
+    } else {
+      outargc++;
+      index++;
+    }
+  }
+
+  argv[outargc] = nullptr;
+  argc = outargc;
+
+  if (options.page.isEmpty() || options.output_path.isEmpty()) {
+    Usage();
+  }
+  if (options.mode != QLatin1String("cold") &&
+      options.mode != QLatin1String("warm")) {
+    Usage();
+  }
+
+  return options;
+}
+
+int main(int argc, char** argv) {
+  Options options = ParseOptions(argc, argv);
+
+  if (!options.plugin_path.isEmpty()) {
+    QCoreApplication::addLibraryPath(options.plugin_path);
+  }
+
+  QGuiApplication app(argc, argv);
+
+  if (!options.nss_db_path.isEmpty()) {
+    oxideSetNSSDbPath(options.nss_db_path);
+  }
+  if (options.single_process) {
+    oxideSetProcessModel(OxideProcessModelSingleProcess);
+  }
+
+  QOpenGLContext context;
+  context.create();
+#if QT_VERSION >= QT_VERSION_CHECK(5, 4, 0)
+  qt_gl_set_global_share_context(&context);
+#elif QT_VERSION >= QT_VERSION_CHECK(5, 3, 0)
+  QOpenGLContextPrivate::setGlobalShareContext(&context);
+#else
+  QSGContext::setSharedOpenGLContext(&context);
+#endif
+
+  QString qml_path(BENCHMARK_QML_PATH);
+  if (!QFile::exists(qml_path)) {
+    qml_path = QDir(QCoreApplication::applicationDirPath())
+        .filePath(QStringLiteral("Benchmark.qml"));
+  }
+
+  if (options.tmp_path.isEmpty()) {
+    options.tmp_path = QDir::currentPath();
+  }
+
+  BenchmarkSupport support(
+      QUrl::fromUserInput(options.page),
+      options.mode,
+      options.iterations,
+      QUrl::fromLocalFile(QDir(options.tmp_path).absolutePath()),
+      options.output_path);
+
+  QQuickView view;
+  view.engine()->rootContext()->setContextProperty(
+      QStringLiteral("Benchmark"), &support);
+  support.setWindow(&view);
+
+  view.setResizeMode(QQuickView::SizeRootObjectToView);
+  view.resize(800, 600);
+  view.setSource(QUrl::fromLocalFile(qml_path));
+  if (view.status() == QQuickView::Error) {
+    for (const auto& error : view.errors()) {
+      qWarning() << error.toString();
+    }
+    return 1;
+  }
+
+  view.show();
+
+  int rv = app.exec();
+  return support.failed() ? 1 : rv;
+}
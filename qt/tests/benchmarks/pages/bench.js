@@ -0,0 +1,99 @@
+// Included in the <head> of every benchmark page. It measures the page from
+// the renderer side and reports to Benchmark.qml by setting document.title,
+// which avoids depending on any other browser APIs.
+//
+// Reported values (all times in ms since navigationStart):
+// - first_paint_ms: approximated by the second animation frame after the
+//    page started loading, i.e. once a frame containing content has been
+//    produced
+// - dom_content_loaded_ms: from the Navigation Timing API
+// - scroll_frames / scroll_dropped_frames: the number of animation frames
+//    during a scripted scroll, and the number of frames that were missed
+//    assuming a 60Hz display. Pages that don't scroll report 0 for both
+(function() {
+  var kTitlePrefix = "oxide-bench:";
+  var kScrollDurationMs = 3000;
+  var kScrollStepPx = 12;
+  var kFrameIntervalMs = 1000 / 60;
+
+  var seq = 0;
+  var result = {
+    first_paint_ms: undefined,
+    scroll_frames: 0,
+    scroll_dropped_frames: 0
+  };
+  var loaded = false;
+
+  function report(state) {
+    result.state = state;
+    result.seq = ++seq;
+    document.title = kTitlePrefix + JSON.stringify(result);
+  }
+
+  function runScroll(callback) {
+    var doc = document.documentElement;
+    if (doc.scrollHeight <= window.innerHeight) {
+      callback();
+      return;
+    }
+
+    report("scroll-start");
+
+    var start = undefined;
+    var last = undefined;
+
+    function step(t) {
+      if (start === undefined) {
+        start = last = t;
+      } else {
+        var delta = t - last;
+        last = t;
+        ++result.scroll_frames;
+        if (delta > kFrameIntervalMs * 1.5) {
+          result.scroll_dropped_frames += Math.round(delta / kFrameIntervalMs) - 1;
+        }
+      }
+
+      if (t - start >= kScrollDurationMs) {
+        callback();
+        return;
+      }
+
+      if (window.scrollY + window.innerHeight >= doc.scrollHeight) {
+        window.scrollTo(0, 0);
+      } else {
+        window.scrollBy(0, kScrollStepPx);
+      }
+      window.requestAnimationFrame(step);
+    }
+
+    window.requestAnimationFrame(step);
+  }
+
+  function maybeFinish() {
+    if (!loaded || result.first_paint_ms === undefined) {
+      return;
+    }
+
+    var timing = window.performance.timing;
+    result.dom_content_loaded_ms =
+        timing.domContentLoadedEventStart - timing.navigationStart;
+
+    runScroll(function() { report("done"); });
+  }
+
+  window.requestAnimationFrame(function() {
+    window.requestAnimationFrame(function() {
+      result.first_paint_ms = window.performance.now();
+      maybeFinish();
+    });
+  });
+
+  window.addEventListener("load", function() {
+    // Let the load event finish before measuring anything else
+    window.setTimeout(function() {
+      loaded = true;
+      maybeFinish();
+    }, 0);
+  });
+})();
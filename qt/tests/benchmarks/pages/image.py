@@ -0,0 +1,49 @@
+# Generates a deterministic PNG image. Query parameters:
+# - i: the image index, which varies the content
+# - size: the width and height in pixels (default 256)
+
+import struct
+import urlparse
+import zlib
+
+def chunk(kind, data):
+  c = struct.pack(">I", len(data)) + kind + data
+  return c + struct.pack(">I", zlib.crc32(kind + data) & 0xffffffff)
+
+def make_png(index, size):
+  # Each row is a rotation of a gradient, which is cheap to generate in
+  # Python (the server handles one request at a time) but still produces
+  # distinct, non-trivial image data
+  base = bytearray()
+  for x in range(size):
+    base.append((x * 3 + index * 17) & 0xff)
+    base.append((x * 5 + index * 31) & 0xff)
+    base.append((x * 7 + index * 47) & 0xff)
+  base = bytes(base)
+
+  rows = []
+  for y in range(size):
+    k = ((y * (index + 1)) % size) * 3
+    rows.append("\0" + base[k:] + base[:k])
+
+  header = struct.pack(">IIBBBBB", size, size, 8, 2, 0, 0, 0)
+  return ("\x89PNG\r\n\x1a\n" +
+          chunk("IHDR", header) +
+          chunk("IDAT", zlib.compress("".join(rows), 6)) +
+          chunk("IEND", ""))
+
+def handler(request):
+  query = urlparse.parse_qs(urlparse.urlparse(request.path).query)
+  index = int(query.get("i", ["0"])[0])
+  size = max(1, min(1024, int(query.get("size", ["256"])[0])))
+
+  data = make_png(index, size)
+
+  request.send_response(200)
+  request.send_header("Content-type", "image/png")
+  request.send_header("Content-Length", len(data))
+  # Cacheable, so that warm runs load images from the HTTP cache
+  request.send_header("Cache-Control", "max-age=3600")
+  request.end_headers()
+
+  request.wfile.write(data)
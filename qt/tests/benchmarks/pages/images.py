@@ -0,0 +1,24 @@
+# A page with many distinct images, served as images.html
+
+from cStringIO import StringIO
+
+IMAGE_COUNT = 120
+
+def handler(request):
+  html = StringIO()
+  html.write("<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n")
+  html.write("<title>Images</title>\n")
+  html.write("<script src=\"bench.js\"></script>\n")
+  html.write("<style>img { width: 192px; height: 192px; margin: 4px; }</style>\n")
+  html.write("</head>\n<body>\n<h1>Images</h1>\n")
+  for i in range(IMAGE_COUNT):
+    html.write("<img src=\"image.py?i=%d&amp;size=256\">\n" % i)
+  html.write("</body>\n</html>\n")
+
+  request.send_response(200)
+  request.send_header("Content-type", "text/html")
+  request.send_header("Content-Length", html.tell())
+  request.send_header("Cache-Control", "max-age=3600")
+  request.end_headers()
+
+  request.wfile.write(html.getvalue())
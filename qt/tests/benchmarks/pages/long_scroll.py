@@ -0,0 +1,34 @@
+# A long page with a mix of text, boxes and fixed-position content for
+# measuring scrolling performance, served as long_scroll.html
+
+from cStringIO import StringIO
+
+BLOCK_COUNT = 600
+
+def handler(request):
+  html = StringIO()
+  html.write("<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n")
+  html.write("<title>Long scroll</title>\n")
+  html.write("<script src=\"bench.js\"></script>\n")
+  html.write("<style>\n"
+             "body { font-family: sans-serif; margin: 0; padding: 48px 16px 16px; }\n"
+             "#header { position: fixed; top: 0; left: 0; right: 0; height: 40px;"
+             " background: rgba(40, 40, 40, 0.9); color: white; }\n"
+             ".block { margin: 8px 0; padding: 8px; border-radius: 6px;"
+             " box-shadow: 0 1px 3px rgba(0, 0, 0, 0.3); }\n"
+             "</style>\n")
+  html.write("</head>\n<body>\n<div id=\"header\">Long scroll</div>\n")
+  for i in range(BLOCK_COUNT):
+    html.write("<div class=\"block\" style=\"background: hsl(%d, 60%%, 85%%)\">"
+               "<b>Block %d</b> Lorem ipsum dolor sit amet, consectetur "
+               "adipiscing elit, sed do eiusmod tempor incididunt ut labore et "
+               "dolore magna aliqua.</div>\n" % ((i * 37) % 360, i))
+  html.write("</body>\n</html>\n")
+
+  request.send_response(200)
+  request.send_header("Content-type", "text/html")
+  request.send_header("Content-Length", html.tell())
+  request.send_header("Cache-Control", "max-age=3600")
+  request.end_headers()
+
+  request.wfile.write(html.getvalue())
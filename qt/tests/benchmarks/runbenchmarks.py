@@ -0,0 +1,300 @@
+#!/usr/bin/python
+# vim:expandtab:shiftwidth=2:tabstop=2:
+
+# Copyright (C) 2017 Canonical Ltd.
+
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+# Runs the page load and scrolling benchmarks against a local TestHTTPServer
+# and writes the aggregated results as JSON.
+#
+# In cold mode, every iteration runs in a new process with an empty data
+# directory. In warm mode, a single process performs an unrecorded load
+# followed by the recorded iterations, so the HTTP cache and renderer are
+# warm.
+#
+# If --baseline is specified, the median of each metric is compared with the
+# baseline, and the script exits with a non-zero status if any metric has
+# regressed by more than --threshold percent.
+
+from __future__ import print_function
+
+import json
+from optparse import OptionParser
+import os
+import os.path
+from subprocess import Popen
+import sys
+import thread
+import yaml
+
+sys.dont_write_bytecode = True
+os.environ["PYTHONDONTWRITEBYTECODE"] = "1"
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), os.pardir, os.pardir, os.pardir, "build", "python"))
+from constants import OXIDESRC_DIR
+from eventloop import EventLoop
+from httpserver import TestHTTPServer
+from utils import ScopedTmpdir
+
+SERVER_PORT = 8080
+
+PAGES = [
+  "static",
+  "js_heavy",
+  "images",
+  "long_scroll"
+]
+
+MODES = [ "cold", "warm" ]
+
+# Metrics where a lower value is better. All other metrics are better when
+# they are higher
+LOWER_IS_BETTER = set([
+  "load_finished_ms",
+  "dom_content_loaded_ms",
+  "first_paint_ms",
+  "scroll_dropped_frames",
+  "browser_peak_rss_kb",
+  "renderer_peak_rss_kb"
+])
+
+METRICS = sorted(LOWER_IS_BETTER | set([ "scroll_frames", "scroll_window_frames" ]))
+
+class BenchmarkProcess(object):
+  def __init__(self, args):
+    self.returncode = None
+
+    self._args = args
+    (self._rfd, self._wfd) = os.pipe()
+
+    thread.start_new_thread(self._run_child, ())
+
+  def _run_child(self):
+    w = os.fdopen(self._wfd, "w")
+    p = Popen(self._args)
+
+    w.write(str(p.wait()))
+
+  def handle_event(self, event_loop):
+    self.returncode = int(os.fdopen(self._rfd, "r").read())
+    self._rfd = -1
+    self._wfd = -1
+    event_loop.quit()
+
+  def fileno(self):
+    return self._rfd
+
+def load_config(filename):
+  with open(filename, "r") as fd:
+    return yaml.load(fd.read());
+
+def median(values):
+  s = sorted(values)
+  n = len(s)
+  if n % 2 == 1:
+    return s[n // 2]
+  return (s[n // 2 - 1] + s[n // 2]) / 2.0
+
+def summarize(samples):
+  values = [ v for v in samples if v is not None ]
+  if len(values) == 0:
+    return None
+
+  return {
+    "min": min(values),
+    "max": max(values),
+    "mean": sum(values) / float(len(values)),
+    "median": median(values),
+    "samples": values
+  }
+
+def compare_with_baseline(results, baseline, threshold):
+  regressions = []
+
+  for page in results:
+    for mode in results[page]:
+      for metric in results[page][mode]:
+        current = results[page][mode][metric]
+        try:
+          base = baseline["results"][page][mode][metric]
+        except KeyError:
+          continue
+        if current is None or base is None or base["median"] == 0:
+          continue
+
+        change = (current["median"] - base["median"]) * 100.0 / base["median"]
+        if metric not in LOWER_IS_BETTER:
+          change = -change
+
+        if change > threshold:
+          regressions.append("%s/%s/%s: %s -> %s (%.1f%% worse)" %
+                             (page, mode, metric, base["median"],
+                              current["median"], change))
+
+  return regressions
+
+class Options(OptionParser):
+  def __init__(self):
+    OptionParser.__init__(self)
+
+    self.add_option("--config", dest="config",
+                    help="Path to the benchmark configuration file")
+    self.add_option("--iterations", dest="iterations", type="int", default=5,
+                    help="Number of recorded loads per page and mode")
+    self.add_option("--page", dest="pages", action="append",
+                    help="Page to run (can be specified more than once). "
+                         "Defaults to all pages: %s" % ", ".join(PAGES))
+    self.add_option("--mode", dest="modes", action="append",
+                    help="Mode to run (cold or warm, can be specified more "
+                         "than once). Defaults to both")
+    self.add_option("--output", dest="output",
+                    help="Path to write the JSON results to. Defaults to "
+                         "stdout")
+    self.add_option("--baseline", dest="baseline",
+                    help="Path to a previous JSON result to compare against")
+    self.add_option("--threshold", dest="threshold", type="float", default=10.0,
+                    help="Percentage change in a median that is considered a "
+                         "regression when comparing against --baseline")
+    self.add_option("--single-process", dest="single_process",
+                    action="store_true",
+                    help="Run the browser in single process mode")
+
+class Runner(object):
+  def __init__(self):
+    self._event_loop = EventLoop()
+
+  def run(self, options):
+    (opts, args) = options.parse_args()
+
+    if not opts.config:
+      print("Missing --config option", file=sys.stderr)
+      sys.exit(1)
+
+    config = load_config(opts.config)
+
+    pages = opts.pages or PAGES
+    modes = opts.modes or MODES
+    for mode in modes:
+      if mode not in MODES:
+        print("Invalid mode '%s'" % mode, file=sys.stderr)
+        sys.exit(1)
+
+    os.environ["OXIDE_TESTING_MODE"] = "1"
+
+    server = TestHTTPServer(SERVER_PORT, config["http_server_dir"])
+    self._event_loop.add_reader(server, server.handle_event)
+
+    results = {}
+    failed = False
+    for page in pages:
+      results[page] = {}
+      for mode in modes:
+        samples = self._run_page(config, opts, page, mode)
+        if samples is None:
+          failed = True
+          continue
+
+        results[page][mode] = {}
+        for metric in METRICS:
+          results[page][mode][metric] = summarize([ s.get(metric) for s in samples ])
+
+    self._event_loop.close()
+
+    output = {
+      "version": 1,
+      "iterations": opts.iterations,
+      "single_process": bool(opts.single_process),
+      "results": results
+    }
+
+    if opts.output:
+      with open(opts.output, "w") as fd:
+        json.dump(output, fd, indent=2, sort_keys=True)
+    else:
+      json.dump(output, sys.stdout, indent=2, sort_keys=True)
+      print()
+
+    if failed:
+      print("runbenchmarks.py: Some benchmarks failed", file=sys.stderr)
+      return 1
+
+    if opts.baseline:
+      with open(opts.baseline, "r") as fd:
+        baseline = json.load(fd)
+      regressions = compare_with_baseline(results, baseline, opts.threshold)
+      if len(regressions) > 0:
+        print("runbenchmarks.py: Regressions compared with baseline:",
+              file=sys.stderr)
+        for r in regressions:
+          print("  " + r, file=sys.stderr)
+        return 1
+
+    return 0
+
+  def _run_page(self, config, opts, page, mode):
+    url = "http://benchmarks/%s.html" % page
+
+    samples = []
+    if mode == "cold":
+      for i in range(opts.iterations):
+        s = self._run_harness(config, opts, url, mode, 1)
+        if s is None:
+          return None
+        for sample in s:
+          sample["iteration"] = i
+        samples.extend(s)
+    else:
+      samples = self._run_harness(config, opts, url, mode, opts.iterations)
+
+    return samples
+
+  def _run_harness(self, config, opts, url, mode, iterations):
+    with ScopedTmpdir(prefix="tmp-oxide-benchmarks") as tmpdir:
+      output = os.path.join(tmpdir, "results.json")
+      args = [ config["exec"],
+               "--page", url,
+               "--mode", mode,
+               "--iterations", str(iterations),
+               "--qt-plugin-path", config["qt_plugin_path"],
+               "--nss-db-path", os.path.join(OXIDESRC_DIR, "qt/tests/ssldata/nss"),
+               "--tmpdir", tmpdir,
+               "--output", output ]
+      if opts.single_process:
+        args.append("--single-process")
+
+      print("runbenchmarks.py: Running command '%s'" % ' '.join(args),
+            file=sys.stderr)
+
+      p = BenchmarkProcess(args)
+      fd = p.fileno()
+      self._event_loop.add_reader(fd, p.handle_event, self._event_loop)
+      self._event_loop.run()
+      self._event_loop.remove_reader(fd)
+
+      if p.returncode != 0 or not os.path.isfile(output):
+        print("runbenchmarks.py: Benchmark for %s (%s) failed" % (url, mode),
+              file=sys.stderr)
+        return None
+
+      with open(output, "r") as fd:
+        return json.load(fd)
+
+def main():
+  parser = Options()
+  return Runner().run(parser)
+
+if __name__ == "__main__":
+  sys.exit(main())
@@ -36,4 +36,33 @@ TestCase {
   function test_OxideGlobal3_oxideVersion() {
     verify(/^\d+\.\d+\.\d+$/.test(Oxide.version));
   }
+
+  SignalSpy {
+    id: tracingSpy
+    target: Oxide
+    signalName: "tracingStopped"
+  }
+
+  function test_OxideGlobal4_tracing() {
+    // Make sure Oxide is running
+    verify(Oxide.defaultWebContext());
+
+    var path =
+        TestConstants.TMPDIR.toString().replace(/^file:\/\//, "") +
+        "/_test_trace.json";
+
+    verify(!Oxide.tracing);
+    verify(!Oxide.stopTracing(path),
+           "Stopping should fail when not tracing");
+
+    verify(Oxide.startTracing("oxide.*"));
+    verify(Oxide.tracing);
+    verify(!Oxide.startTracing(), "Shouldn't be able to start tracing twice");
+
+    verify(Oxide.stopTracing(path));
+    tracingSpy.wait();
+    compare(tracingSpy.count, 1);
+    compare(tracingSpy.signalArguments[0][0], path);
+    verify(!Oxide.tracing);
+  }
 }
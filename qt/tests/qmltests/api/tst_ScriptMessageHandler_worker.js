@@ -0,0 +1,14 @@
+var nextSequenceNumber = 0;
+
+exports.onMessage = function(msg) {
+  if (msg.msgId == "TEST-SEQUENCE") {
+    msg.reply({ inOrder: msg.payload == nextSequenceNumber });
+    nextSequenceNumber = msg.payload + 1;
+  } else if (msg.msgId == "TEST-REPLY") {
+    msg.reply({ out: msg.payload, id: msg.msgId, context: msg.context, hasFrame: !!msg.frame });
+  } else if (msg.msgId == "TEST-ERROR") {
+    msg.error(msg.payload);
+  } else if (msg.msgId == "TEST-THROW") {
+    throw Error("This is an error");
+  }
+}
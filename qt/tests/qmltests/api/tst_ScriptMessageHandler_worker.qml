@@ -0,0 +1,163 @@
+import QtQuick 2.0
+import QtTest 1.0
+import com.canonical.Oxide 1.23
+import Oxide.testsupport 1.0
+
+TestWebView {
+  id: webView
+  focus: true
+
+  Component {
+    id: messageHandler
+    ScriptMessageHandler {
+      contexts: [ ScriptMessageTestUtils.kDefaultContextUrl ]
+    }
+  }
+
+  SignalSpy {
+    id: spy
+    signalName: "workerSourceChanged"
+  }
+
+  Component.onCompleted: {
+    ScriptMessageTestUtils.init(webView.context);
+  }
+
+  // These tests verify that ScriptMessageHandler.workerSource works correctly.
+  // The messages are handled by tst_ScriptMessageHandler_worker.js on a worker
+  // thread
+  TestCase {
+    id: test
+    name: "ScriptMessageHandler_worker"
+    when: windowShown
+
+    function cleanupTestCase() {
+      webView.context.clearTestUserScripts();
+    }
+
+    function init() {
+      while (webView.rootFrame.messageHandlers.length > 0) {
+        webView.rootFrame.removeMessageHandler(webView.rootFrame.messageHandlers[0]);
+      }
+      spy.clear();
+      webView.url = "http://testsuite/empty.html";
+      verify(webView.waitForLoadSucceeded(),
+             "Timed out waiting for successful load");
+    }
+
+    function _createHandler(msgId) {
+      var handler = messageHandler.createObject(
+          webView.rootFrame,
+          { msgId: msgId,
+            workerSource: Qt.resolvedUrl("tst_ScriptMessageHandler_worker.js") });
+      return handler;
+    }
+
+    function test_ScriptMessageHandler_worker1_workerSource() {
+      var handler = messageHandler.createObject(null, {});
+      spy.target = handler;
+
+      handler.workerSource = "http://foo/bar.js";
+      compare(spy.count, 0, "Shouldn't have had a signal");
+      compare(handler.workerSource, "", "Non-local URL should be rejected");
+
+      var source = Qt.resolvedUrl("tst_ScriptMessageHandler_worker.js");
+      handler.workerSource = source;
+      compare(spy.count, 1, "Should have had a signal");
+      compare(handler.workerSource, source, "Unexpected workerSource");
+
+      handler.workerSource = handler.workerSource;
+      compare(spy.count, 1, "Shouldn't have had a signal");
+
+      handler.destroy();
+    }
+
+    function test_ScriptMessageHandler_worker2_reply_data() {
+      return [
+        { payload: 10 },
+        { payload: "This is a string" },
+        { payload: { a: 7, b: "foo", c: [ 87.243532, true ] } }
+      ];
+    }
+
+    function test_ScriptMessageHandler_worker2_reply(data) {
+      _createHandler("TEST-REPLY");
+
+      var api = new ScriptMessageTestUtils.FrameHelper(webView.rootFrame);
+
+      // Send twice - the first message is routed on the UI thread, and the
+      // second one is delivered directly to the worker
+      for (var i = 0; i < 2; ++i) {
+        var res = api.sendMessageToBrowser("TEST-REPLY", data.payload);
+        compare(res.out, data.payload, "Invalid response from worker");
+        compare(res.id, "TEST-REPLY", "Invalid ID for message");
+        compare(res.context, ScriptMessageTestUtils.kDefaultContextUrl,
+                "Invalid context for message");
+        compare(res.hasFrame, false, "Workers should not see the frame");
+      }
+    }
+
+    function test_ScriptMessageHandler_worker3_error() {
+      _createHandler("TEST-ERROR");
+
+      var api = new ScriptMessageTestUtils.FrameHelper(webView.rootFrame);
+      var res = api.sendMessageToBrowser("TEST-ERROR", "foo");
+      verify(res instanceof TestUtils.MessageError, "Invalid result type");
+      compare(res.error, ScriptMessageRequest.ErrorHandlerReportedError,
+              "Unexpected error type");
+      compare(res.message, "foo", "Unexpected error message");
+    }
+
+    function test_ScriptMessageHandler_worker4_throw() {
+      _createHandler("TEST-THROW");
+
+      var api = new ScriptMessageTestUtils.FrameHelper(webView.rootFrame);
+      var res = api.sendMessageToBrowser("TEST-THROW");
+      verify(res instanceof TestUtils.MessageError, "Invalid result type");
+      compare(res.error, ScriptMessageRequest.ErrorUncaughtException,
+              "Unexpected error type");
+    }
+
+    function test_ScriptMessageHandler_worker5_removed() {
+      var handler = _createHandler("TEST-REPLY");
+
+      var api = new ScriptMessageTestUtils.FrameHelper(webView.rootFrame);
+      compare(api.sendMessageToBrowser("TEST-REPLY", 5).out, 5);
+
+      // Removing the handler must invalidate the route to the worker
+      webView.rootFrame.removeMessageHandler(handler);
+
+      var res = api.sendMessageToBrowser("TEST-REPLY", 5);
+      verify(res instanceof TestUtils.MessageError, "Invalid result type");
+      compare(res.error, ScriptMessageRequest.ErrorNoHandler,
+              "Unexpected error type");
+    }
+
+    // Messages that are sent while the first one is being routed on the UI
+    // thread must not overtake it, or each other
+    function test_ScriptMessageHandler_worker6_ordering() {
+      _createHandler("TEST-SEQUENCE");
+
+      var api = new ScriptMessageTestUtils.FrameHelper(webView.rootFrame);
+
+      var count = 50;
+      var requests = [];
+      var results = [];
+      for (var i = 0; i < count; ++i) {
+        var req = api.sendMessageToBrowserNoWait("TEST-SEQUENCE", i);
+        req.onreply = function(r) { results.push(r); };
+        req.onerror = function(code, r) { results.push({ error: code }); };
+        requests.push(req);
+      }
+
+      verify(TestUtils.waitFor(function() { return results.length == count; }),
+             "Timed out waiting for replies");
+
+      for (var i = 0; i < count; ++i) {
+        compare(results[i].error, 0, "Unexpected error");
+        verify(results[i].response.inOrder,
+               "Messages reached the worker out of order");
+      }
+    }
+  }
+}
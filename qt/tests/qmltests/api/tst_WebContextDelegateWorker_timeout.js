@@ -0,0 +1,19 @@
+exports.onBeforeURLRequest = function(event) {
+  if (event.url.toString().indexOf("slow") == -1) {
+    return;
+  }
+
+  // Simulate a handler that takes much longer than the timeout
+  var start = Date.now();
+  while (Date.now() - start < 2000) {}
+}
+
+exports.onGetUserAgentOverride = function(data) {
+  if (data.url.toString().indexOf("delayua") == -1) {
+    return;
+  }
+
+  var start = Date.now();
+  while (Date.now() - start < 2000) {}
+  data.userAgentOverride = "Too late";
+}
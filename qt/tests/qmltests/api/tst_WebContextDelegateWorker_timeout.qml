@@ -0,0 +1,115 @@
+import QtQuick 2.0
+import QtTest 1.0
+import com.canonical.Oxide 1.23
+import Oxide.testsupport 1.0
+
+TestWebView {
+  id: webView
+
+  Component {
+    id: webContextDelegateWorkerFactory
+    WebContextDelegateWorker {}
+  }
+
+  WebContextDelegateWorker {
+    id: worker
+    source: Qt.resolvedUrl("tst_WebContextDelegateWorker_timeout.js")
+  }
+
+  WebContextDelegateWorker {
+    id: userAgentWorker
+    source: Qt.resolvedUrl("tst_WebContextDelegateWorker_timeout.js")
+  }
+
+  Component.onCompleted: {
+    context.networkRequestDelegate = worker;
+  }
+
+  SignalSpy {
+    id: timeoutSpy
+    signalName: "timeoutChanged"
+  }
+
+  SignalSpy {
+    id: cancelSpy
+    signalName: "cancelOnTimeoutChanged"
+  }
+
+  TestCase {
+    name: "WebContextDelegateWorker_timeout"
+    when: windowShown
+
+    function init() {
+      timeoutSpy.clear();
+      cancelSpy.clear();
+    }
+
+    function cleanupTestCase() {
+      webView.context.networkRequestDelegate = null;
+      webView.context.userAgentOverrideDelegate = null;
+    }
+
+    function test_WebContextDelegateWorker_timeout1_properties() {
+      var d = webContextDelegateWorkerFactory.createObject(null, {});
+      timeoutSpy.target = d;
+      cancelSpy.target = d;
+
+      compare(d.timeout, 0);
+      compare(d.cancelOnTimeout, false);
+
+      d.timeout = 500;
+      compare(d.timeout, 500);
+      compare(timeoutSpy.count, 1);
+
+      d.timeout = 500;
+      compare(timeoutSpy.count, 1);
+
+      d.timeout = -1;
+      compare(d.timeout, 500);
+      compare(timeoutSpy.count, 1);
+
+      d.cancelOnTimeout = true;
+      compare(d.cancelOnTimeout, true);
+      compare(cancelSpy.count, 1);
+    }
+
+    // A slow handler shouldn't hold up the request for longer than the
+    // timeout, and the request should continue
+    function test_WebContextDelegateWorker_timeout2_continue() {
+      worker.timeout = 200;
+      worker.cancelOnTimeout = false;
+
+      webView.url = "http://testsuite/empty.html?slow1";
+      verify(webView.waitForLoadSucceeded(1500),
+             "Timed out waiting for a successful load");
+    }
+
+    // With cancelOnTimeout, a slow handler should result in the request
+    // being cancelled
+    function test_WebContextDelegateWorker_timeout3_cancel() {
+      worker.timeout = 200;
+      worker.cancelOnTimeout = true;
+
+      webView.url = "http://testsuite/empty.html?slow2";
+      verify(webView.waitForLoadStopped(1500),
+             "Timed out waiting for the load to stop");
+
+      worker.timeout = 0;
+      worker.cancelOnTimeout = false;
+    }
+
+    // The deprecated userAgentOverrideDelegate is called synchronously from
+    // the network stack. A slow handler should fall back to the default user
+    // agent once the timeout expires, rather than stalling the request
+    function test_WebContextDelegateWorker_timeout4_user_agent_override() {
+      userAgentWorker.timeout = 200;
+      webView.context.userAgentOverrideDelegate = userAgentWorker;
+
+      webView.url = "http://testsuite/empty.html?delayua";
+      verify(webView.waitForLoadSucceeded(1500),
+             "Timed out waiting for a successful load");
+
+      webView.context.userAgentOverrideDelegate = null;
+    }
+  }
+}
@@ -0,0 +1,14 @@
+from cStringIO import StringIO
+
+def handler(request):
+  request.send_response(200)
+  request.send_header("Content-type", "text/html")
+
+  html = StringIO()
+  html.write("<html><body><div id='content'>Cached content</div></body></html>")
+
+  request.send_header("Content-Length", html.tell())
+  request.send_header("Cache-Control", "max-age=3600")
+  request.end_headers()
+
+  request.wfile.write(html.getvalue())
@@ -0,0 +1,126 @@
+import QtQuick 2.0
+import QtTest 1.0
+import com.canonical.Oxide 1.23
+import Oxide.testsupport 1.0
+
+TestWebView {
+  id: webView
+  focus: true
+  width: 200
+  height: 200
+
+  SignalSpy {
+    id: prefetchSpy
+    target: webView.context
+    signalName: "urlsPrefetched"
+  }
+
+  SignalSpy {
+    id: entryInfoSpy
+    target: webView.context
+    signalName: "cacheEntryInfoRetrieved"
+  }
+
+  SignalSpy {
+    id: evictSpy
+    target: webView.context
+    signalName: "cacheEntriesEvicted"
+  }
+
+  SignalSpy {
+    id: statsSpy
+    target: webView.context
+    signalName: "cacheStatsRetrieved"
+  }
+
+  readonly property string testUrl:
+      "http://testsuite/tst_WebContext_httpCache.py"
+
+  TestCase {
+    id: test
+    name: "WebContext_httpCache"
+    when: windowShown
+
+    function getEntryInfo(url) {
+      entryInfoSpy.clear();
+      var id = webView.context.getCacheEntryInfo(url);
+      verify(id != -1);
+      entryInfoSpy.wait();
+      compare(entryInfoSpy.signalArguments[0][0], id);
+      return { cached: entryInfoSpy.signalArguments[0][1],
+               size: entryInfoSpy.signalArguments[0][2] };
+    }
+
+    function evict(prefix) {
+      evictSpy.clear();
+      var id = webView.context.evictCacheEntries(prefix);
+      verify(id != -1);
+      evictSpy.wait();
+      compare(evictSpy.signalArguments[0][0], id);
+      return evictSpy.signalArguments[0][1];
+    }
+
+    function getStats() {
+      statsSpy.clear();
+      var id = webView.context.getCacheStats();
+      verify(id != -1);
+      statsSpy.wait();
+      compare(statsSpy.signalArguments[0][0], id);
+      return statsSpy.signalArguments[0][1];
+    }
+
+    function init() {
+      prefetchSpy.clear();
+      evict("");
+    }
+
+    function test_WebContext_httpCache1_prefetch() {
+      verify(!getEntryInfo(testUrl).cached);
+
+      var id = webView.context.prefetchUrls([ testUrl, "ftp://testsuite/" ]);
+      verify(id != -1);
+      prefetchSpy.wait();
+      compare(prefetchSpy.signalArguments[0][0], id);
+      compare(prefetchSpy.signalArguments[0][1], 1);
+      compare(prefetchSpy.signalArguments[0][2], 1);
+
+      var info = getEntryInfo(testUrl);
+      verify(info.cached);
+      verify(info.size > 0);
+
+      var stats = getStats();
+      verify(stats.prefetchesSucceeded >= 1);
+      verify(stats.prefetchesFailed >= 1);
+      compare(stats.prefetchesPending, 0);
+    }
+
+    function test_WebContext_httpCache2_hits() {
+      var before = getStats();
+
+      webView.url = testUrl;
+      verify(webView.waitForLoadSucceeded());
+      verify(getEntryInfo(testUrl).cached);
+
+      webView.url = "about:blank";
+      verify(webView.waitForLoadSucceeded());
+      webView.url = testUrl;
+      verify(webView.waitForLoadSucceeded());
+
+      var after = getStats();
+      verify(after.hits > before.hits);
+      verify(after.misses > before.misses);
+    }
+
+    function test_WebContext_httpCache3_evict() {
+      webView.url = testUrl;
+      verify(webView.waitForLoadSucceeded());
+      verify(getEntryInfo(testUrl).cached);
+
+      compare(evict("http://example.com/"), 0);
+      verify(getEntryInfo(testUrl).cached);
+
+      verify(evict("http://testsuite/tst_WebContext_httpCache") >= 1);
+      verify(!getEntryInfo(testUrl).cached);
+    }
+  }
+}
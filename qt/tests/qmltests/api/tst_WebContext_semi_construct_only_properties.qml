@@ -1,6 +1,6 @@
 import QtQuick 2.0
 import QtTest 1.0
-import com.canonical.Oxide 1.6
+import com.canonical.Oxide 1.23
 import Oxide.testsupport 1.0
 
 TestCase {
@@ -30,6 +30,8 @@ TestCase {
       { prop: "dataPath", signal: "dataPathChanged", val: "file:///foo", dataPath: "" },
       { prop: "cachePath", signal: "cachePathChanged", val: "file:///foo", dataPath: "" },
       { prop: "maxCacheSizeHint", signal: "maxCacheSizeHintChanged", val: 1, dataPath: "" },
+      { prop: "persistentPermissions", signal: "persistentPermissionsChanged", val: true, dataPath: "" },
+      { prop: "permissionLifetime", signal: "permissionLifetimeChanged", val: 60, dataPath: "" },
       { prop: "sessionCookieMode", signal: "sessionCookieModeChanged", val: WebContext.SessionCookieModeRestored, dataPath: TestConstants.TMPDIR + "/_test_dir" }
     ];
 
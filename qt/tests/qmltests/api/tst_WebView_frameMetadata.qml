@@ -0,0 +1,110 @@
+import QtQuick 2.0
+import QtTest 1.0
+import com.canonical.Oxide 1.23
+import Oxide.testsupport 1.0
+
+TestWebView {
+  id: webView
+  focus: true
+
+  SignalSpy {
+    id: metadataSpy
+    target: webView
+    signalName: "frameMetadataChanged"
+  }
+
+  SignalSpy {
+    id: snapshotSpy
+    target: webView.frameMetadata
+    signalName: "changed"
+  }
+
+  SignalSpy {
+    id: throttleSpy
+    target: webView
+    signalName: "throttleFrameMetadataChanged"
+  }
+
+  TestCase {
+    name: "WebView_frameMetadata"
+    when: windowShown
+
+    function get(attr) {
+      return parseFloat(webView.getTestApi().evaluateCode(attr));
+    }
+
+    function set(attr, value) {
+      webView.getTestApi().evaluateCode(attr + " = " + value.toString());
+    }
+
+    function init() {
+      webView.throttleFrameMetadata = false;
+      metadataSpy.clear();
+      snapshotSpy.clear();
+      throttleSpy.clear();
+    }
+
+    function test_WebView_frameMetadata1_snapshot() {
+      webView.url = "http://testsuite/tst_WebView_flickableLikeAPI.html";
+      verify(webView.waitForLoadSucceeded(),
+             "Timed out waiting for a successful load");
+
+      var metadata = webView.frameMetadata;
+      tryCompare(metadata, "viewportWidth", get("document.body.clientWidth"));
+      tryCompare(metadata, "contentHeight", get("document.body.scrollHeight"));
+
+      metadataSpy.clear();
+      snapshotSpy.clear();
+
+      // Scrolling in both directions in the same task should update both
+      // offsets in a single notification
+      webView.getTestApi().evaluateCode(
+          "document.body.scrollLeft = 200; document.body.scrollTop = 500;");
+      metadataSpy.wait();
+      compare(metadataSpy.count, 1);
+
+      compare(metadata.contentX, get("document.body.scrollLeft"));
+      compare(metadata.contentY, get("document.body.scrollTop"));
+      compare(metadata.contentX, webView.contentX);
+      compare(metadata.contentY, webView.contentY);
+      compare(metadata.contentWidth, webView.contentWidth);
+      compare(metadata.contentHeight, webView.contentHeight);
+      compare(metadata.viewportWidth, webView.viewportWidth);
+      compare(metadata.viewportHeight, webView.viewportHeight);
+      compare(snapshotSpy.count, metadataSpy.count);
+    }
+
+    function test_WebView_frameMetadata2_throttle() {
+      compare(webView.throttleFrameMetadata, false);
+
+      webView.throttleFrameMetadata = true;
+      compare(webView.throttleFrameMetadata, true);
+      compare(throttleSpy.count, 1);
+
+      webView.throttleFrameMetadata = true;
+      compare(throttleSpy.count, 1);
+
+      webView.url = "http://testsuite/tst_WebView_flickableLikeAPI.html";
+      verify(webView.waitForLoadSucceeded(),
+             "Timed out waiting for a successful load");
+
+      // Notifications are still delivered whilst the view is visible
+      metadataSpy.clear();
+      set("document.body.scrollTop", 300);
+      metadataSpy.wait();
+      compare(webView.frameMetadata.contentY, get("document.body.scrollTop"));
+
+      // Changes made whilst hidden are delivered when shown again
+      webView.visible = false;
+      metadataSpy.clear();
+      set("document.body.scrollTop", 600);
+      webView.visible = true;
+      tryCompare(webView.frameMetadata, "contentY",
+                 get("document.body.scrollTop"));
+      verify(metadataSpy.count > 0);
+
+      webView.throttleFrameMetadata = false;
+      compare(throttleSpy.count, 2);
+    }
+  }
+}
@@ -0,0 +1,161 @@
+import QtQuick 2.0
+import QtTest 1.0
+import com.canonical.Oxide 1.23
+import Oxide.testsupport 1.0
+
+TestWebView {
+  id: webView
+
+  SignalSpy {
+    id: headlessSpy
+    target: webView
+    signalName: "headlessChanged"
+  }
+
+  SignalSpy {
+    id: scaleSpy
+    target: webView
+    signalName: "deviceScaleFactorChanged"
+  }
+
+  SignalSpy {
+    id: frameSpy
+    target: webView
+    signalName: "frameCaptured"
+  }
+
+  SignalSpy {
+    id: frameFailedSpy
+    target: webView
+    signalName: "frameCaptureFailed"
+  }
+
+  TestCase {
+    name: "WebView_headless"
+    when: windowShown
+
+    property size initialSize
+
+    function initTestCase() {
+      initialSize = Qt.size(webView.width, webView.height);
+    }
+
+    function init() {
+      webView.headless = false;
+      webView.deviceScaleFactor = 0;
+      webView.width = initialSize.width;
+      webView.height = initialSize.height;
+      headlessSpy.clear();
+      scaleSpy.clear();
+      frameSpy.clear();
+      frameFailedSpy.clear();
+    }
+
+    function test_WebView_headless1_defaults() {
+      compare(webView.headless, false);
+      compare(webView.deviceScaleFactor, 0);
+    }
+
+    function test_WebView_headless2_toggle() {
+      webView.headless = true;
+      compare(webView.headless, true);
+      compare(headlessSpy.count, 1);
+
+      webView.headless = true;
+      compare(headlessSpy.count, 1);
+
+      webView.headless = false;
+      compare(webView.headless, false);
+      compare(headlessSpy.count, 2);
+    }
+
+    function test_WebView_headless3_deviceScaleFactor() {
+      webView.deviceScaleFactor = 2;
+      compare(webView.deviceScaleFactor, 2);
+      compare(scaleSpy.count, 1);
+
+      ignoreWarning("OxideQQuickWebView: invalid value for device scale " +
+                    "factor, expected to be 0 or greater");
+      webView.deviceScaleFactor = -1;
+      compare(webView.deviceScaleFactor, 2);
+      compare(scaleSpy.count, 1);
+    }
+
+    function test_WebView_headless4_saveFrameWithoutFrame() {
+      ignoreWarning("OxideQQuickWebView::saveFrame: No frame has been captured");
+      verify(!webView.saveFrame("/dev/null"));
+    }
+
+    function test_WebView_headless5_capture_data() {
+      return [
+        { tag: "scale1", scale: 1 },
+        { tag: "scale2", scale: 2 },
+        { tag: "scale1.5", scale: 1.5 }
+      ];
+    }
+
+    // Verify that a headless WebView captures frames at its viewport size
+    // multiplied by deviceScaleFactor, and that they can be saved
+    function test_WebView_headless5_capture(data) {
+      webView.width = 200;
+      webView.height = 100;
+      webView.deviceScaleFactor = data.scale;
+      webView.headless = true;
+
+      webView.url = "http://testsuite/tst_WebView_headless.html";
+      verify(webView.waitForLoadSucceeded(),
+             "Timed out waiting for successful load");
+
+      var width = Math.round(200 * data.scale);
+      var height = Math.round(100 * data.scale);
+
+      // Frames from before the page loaded may have the wrong size or
+      // contents, so wait for one that matches
+      verify(TestUtils.waitFor(function() {
+        var frame = webView.grabFrame();
+        var size = TestSupport.imageSize(frame);
+        return size.width == width && size.height == height &&
+               Qt.colorEqual(TestSupport.imagePixelColor(frame, width / 2, height / 2),
+                             "#00ff00");
+      }), "Timed out waiting for a frame of the expected size");
+
+      verify(frameSpy.count > 0, "Should have had a frameCaptured signal");
+      compare(frameFailedSpy.count, 0);
+
+      var url = TestConstants.TMPDIR + "/tst_WebView_headless_" + data.tag + ".png";
+      verify(webView.saveFrame(decodeURIComponent(url.replace(/^file:\/\//, ""))));
+
+      var saved = TestSupport.loadImage(url);
+      var size = TestSupport.imageSize(saved);
+      compare(size.width, width);
+      compare(size.height, height);
+      verify(Qt.colorEqual(TestSupport.imagePixelColor(saved, width / 2, height / 2),
+                           "#00ff00"));
+    }
+
+    // Verify that a new frame is captured when the viewport is resized
+    function test_WebView_headless6_resize() {
+      webView.width = 200;
+      webView.height = 100;
+      webView.deviceScaleFactor = 1;
+      webView.headless = true;
+
+      webView.url = "http://testsuite/tst_WebView_headless.html";
+      verify(webView.waitForLoadSucceeded(),
+             "Timed out waiting for successful load");
+      verify(TestUtils.waitFor(function() {
+        return TestSupport.imageSize(webView.grabFrame()).width == 200;
+      }));
+
+      frameSpy.clear();
+      webView.width = 300;
+      webView.height = 150;
+
+      verify(TestUtils.waitFor(function() {
+        var size = TestSupport.imageSize(webView.grabFrame());
+        return size.width == 300 && size.height == 150;
+      }), "Timed out waiting for a resized frame");
+      verify(frameSpy.count > 0);
+    }
+  }
+}
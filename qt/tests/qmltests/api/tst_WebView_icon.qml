@@ -13,6 +13,18 @@ TestWebView {
     signalName: "iconChanged"
   }
 
+  Image {
+    id: favicon
+    property int revision: 0
+    source: "image://oxide-favicon/" + encodeURIComponent(webView.url) +
+            "?" + revision
+  }
+
+  Connections {
+    target: webView
+    onIconChanged: favicon.revision++
+  }
+
   property url iconAtStart: ""
   property url iconAtCommit: ""
   property int spyCountAtStart: -1
@@ -152,5 +164,19 @@ TestWebView {
 
       compare(webView.icon.toString(), "http://testsuite/icon.ico");
     }
+
+    // Verify that iconChanged is emitted again once the icon has been cached,
+    // so that an Image using image://oxide-favicon/ picks it up
+    function test_WebView_icon5_cached_image() {
+      webView.url = "http://testsuite/tst_WebView_icon_cached.html";
+      verify(webView.waitForLoadSucceeded());
+
+      compare(webView.icon.toString(),
+              "http://testsuite/tst_WebView_icon_cached.png");
+
+      tryCompare(favicon, "status", Image.Ready);
+      tryCompare(favicon, "implicitWidth", 16);
+      compare(favicon.implicitHeight, 16);
+    }
   }
 }
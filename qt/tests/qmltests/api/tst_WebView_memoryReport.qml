@@ -0,0 +1,69 @@
+import QtQuick 2.0
+import QtTest 1.0
+import com.canonical.Oxide 1.23
+import Oxide.testsupport 1.0
+
+TestWebView {
+  id: webView
+
+  SignalSpy {
+    id: viewSpy
+    target: webView
+    signalName: "memoryReportReady"
+  }
+
+  SignalSpy {
+    id: contextSpy
+    target: webView.context
+    signalName: "memoryReportReady"
+  }
+
+  TestCase {
+    name: "WebView_memoryReport"
+    when: windowShown
+
+    function initTestCase() {
+      webView.url = "http://testsuite/empty.html";
+      verify(webView.waitForLoadSucceeded(),
+             "Timed out waiting for successful load");
+    }
+
+    function init() {
+      viewSpy.clear();
+      contextSpy.clear();
+    }
+
+    function test_WebView_memoryReport1_view() {
+      webView.requestMemoryReport();
+      viewSpy.wait();
+
+      var report = viewSpy.signalArguments[0][0];
+      verify(report.renderer.processId > 0);
+      verify(report.renderer.privateBytes > 0);
+      verify(report.compositorFrameCount >= 0);
+      verify(report.compositorFrameBytes >= 0);
+      compare(report.navigationEntryCount, 1);
+    }
+
+    function test_WebView_memoryReport2_context() {
+      webView.context.requestMemoryReport();
+      contextSpy.wait();
+
+      var report = contextSpy.signalArguments[0][0];
+      verify(report.webViewCount >= 1);
+      verify(report.renderers.length >= 1);
+      verify(report.navigationEntryCount >= 1);
+      verify(report.httpCacheBytes >= 0);
+      verify(report.faviconCacheBytes >= 0);
+
+      var found = false;
+      for (var i = 0; i < report.renderers.length; ++i) {
+        verify(report.renderers[i].privateBytes >= 0);
+        if (report.renderers[i].processId > 0) {
+          found = true;
+        }
+      }
+      verify(found);
+    }
+  }
+}
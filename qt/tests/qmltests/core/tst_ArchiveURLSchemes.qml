@@ -0,0 +1,69 @@
+import QtQuick 2.0
+import QtTest 1.0
+import com.canonical.Oxide 1.23
+import Oxide.testsupport 1.0
+
+TestWebView {
+  id: webView
+  focus: true
+
+  SignalSpy {
+    id: spy
+    target: webView.context
+    signalName: "archiveSchemeAdded"
+  }
+
+  TestCase {
+    name: "ArchiveURLSchemes"
+    when: windowShown
+
+    function init() {
+      spy.clear();
+    }
+
+    function test_ArchiveURLSchemes1_load() {
+      verify(webView.context.addArchiveScheme(
+          "archive", Qt.resolvedUrl("tst_ArchiveURLSchemes.zip")));
+      spy.wait();
+      compare(spy.signalArguments[0][0], "archive");
+      verify(spy.signalArguments[0][1], "Archive should have been opened");
+
+      webView.url = "archive://app/";
+      verify(webView.waitForLoadSucceeded());
+
+      compare(webView.getTestApi().evaluateCode(
+                  "return document.getElementById(\"content\").innerHTML;",
+                  true),
+              "Hello from the archive");
+      verify(webView.getTestApi().evaluateCode("return window.appLoaded;",
+                                               true),
+             "Subresource should have been loaded from the archive");
+    }
+
+    function test_ArchiveURLSchemes2_missing_entry() {
+      webView.url = "archive://app/missing.html";
+      verify(webView.waitForLoadFailed());
+    }
+
+    function test_ArchiveURLSchemes3_removed() {
+      webView.context.removeArchiveScheme("archive");
+      webView.url = "archive://app/";
+      verify(webView.waitForLoadStopped());
+    }
+
+    function test_ArchiveURLSchemes4_invalid_archive() {
+      verify(webView.context.addArchiveScheme(
+          "archive", Qt.resolvedUrl("tst_CustomURLSchemes.txt")));
+      spy.wait();
+      compare(spy.signalArguments[0][0], "archive");
+      verify(!spy.signalArguments[0][1], "Archive should have failed to open");
+    }
+
+    function test_ArchiveURLSchemes5_disallowed_scheme() {
+      verify(!webView.context.addArchiveScheme(
+          "http", Qt.resolvedUrl("tst_ArchiveURLSchemes.zip")));
+      verify(!webView.context.addArchiveScheme(
+          "file", Qt.resolvedUrl("tst_ArchiveURLSchemes.zip")));
+    }
+  }
+}
@@ -1,6 +1,6 @@
 import QtQuick 2.0
 import QtTest 1.0
-import com.canonical.Oxide 1.0
+import com.canonical.Oxide 1.23
 import Oxide.testsupport 1.0
 
 Item {
@@ -232,5 +232,49 @@ Item {
       verify(TestUtils.waitFor(function() { return webView.lastGeolocationStatus != -1; }));
       compare(webView.lastGeolocationStatus, 0);
     }
+
+    function test_GeolocationPermissionRequest_session_persist5_data() {
+      return [
+        { clear: function() { SingletonTestWebContext.clearSavedPermissionsForOrigin("https://testsuite/foo"); }, save: false },
+        { clear: function() { SingletonTestWebContext.clearSavedPermissionsForOrigin("https://foo.testsuite/"); }, save: false },
+        { clear: function() { SingletonTestWebContext.clearSavedPermissionsForOrigin("https://bar.testsuite/"); }, save: true },
+        { clear: function() { SingletonTestWebContext.clearSavedPermissionsForType(WebContext.PermissionTypeGeolocation); }, save: false },
+        { clear: function() { SingletonTestWebContext.clearSavedPermissionsForType(WebContext.PermissionTypeNotifications); }, save: true },
+      ];
+    }
+
+    // Verify that saved decisions are forgotten when they are cleared by
+    // origin or type
+    function test_GeolocationPermissionRequest_session_persist5(data) {
+      var webView = webViewFactory.createObject(null, {});
+      spy.target = webView;
+
+      webView.url = "https://foo.testsuite/tst_GeolocationPermissionRequest_session_persist_embedder.html";
+      verify(webView.waitForLoadSucceeded());
+
+      spy.wait();
+
+      webView.lastGeolocationRequest.allow();
+
+      verify(TestUtils.waitFor(function() { return webView.lastGeolocationStatus != -1; }));
+      compare(webView.lastGeolocationStatus, 0);
+
+      data.clear();
+
+      spy.clear();
+      webView.lastGeolocationStatus = -1;
+
+      webView.reload();
+      verify(webView.waitForLoadSucceeded());
+
+      if (data.save) {
+        verify(TestUtils.waitFor(function() { return webView.lastGeolocationStatus != -1; }));
+        compare(webView.lastGeolocationStatus, 0);
+      } else {
+        spy.wait();
+        compare(webView.lastGeolocationRequest.origin, "https://testsuite/");
+        compare(webView.lastGeolocationRequest.embedder, "https://foo.testsuite/");
+      }
+    }
   }
 }
@@ -78,6 +78,20 @@ TestWebView {
               "Unexpected result message");
     }
 
+    function test_WebView_scriptWithoutContextIsNotInjected() {
+      webView.addedScript = userScript.createObject(null, {
+        url: "tst_WebView_scriptMainWorld_user_script.js"});
+      webView.context.addUserScript(webView.addedScript);
+
+      webView.url = "http://testsuite/tst_WebView_scriptMainWorld.html";
+      verify(webView.waitForLoadSucceeded(),
+             "Timed out waiting for successful load");
+
+      // The script runs at document end, so it would have run by now
+      compare(resultUpdated(webView.getTestApi()), "",
+              "A script without a context should not be injected");
+    }
+
     function test_WebView_receiveMessageFromMainWorldUserscript() {
       webView.addedScript = userScript.createObject(null, {
         context: "oxide://main-world",
@@ -23,6 +23,7 @@
 #include <QCoreApplication>
 #include <QDesktopServices>
 #include <QGuiApplication>
+#include <QImage>
 #include <QJSValue>
 #include <QLatin1String>
 #include <QList>
@@ -453,3 +454,21 @@ QVariantList TestSupport::findItemsInScene(QQuickItem* root,
 
   return rv;
 }
+
+QSize TestSupport::imageSize(const QVariant& image) {
+  return image.value<QImage>().size();
+}
+
+QColor TestSupport::imagePixelColor(const QVariant& image, int x, int y) {
+  QImage i = image.value<QImage>();
+  if (!i.valid(x, y)) {
+    qWarning() << "Invalid pixel" << x << y;
+    return QColor();
+  }
+
+  return QColor(i.pixel(x, y));
+}
+
+QVariant TestSupport::loadImage(const QUrl& url) {
+  return QImage(url.toLocalFile());
+}
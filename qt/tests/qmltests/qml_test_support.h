@@ -18,11 +18,14 @@
 #ifndef _OXIDE_QT_TESTS_QMLTEST_QML_TEST_SUPPORT_H_
 #define _OXIDE_QT_TESTS_QMLTEST_QML_TEST_SUPPORT_H_
 
+#include <QColor>
 #include <QObject>
 #include <QPointer>
 #include <QQmlParserStatus>
+#include <QSize>
 #include <QString>
 #include <QtQml>
+#include <QUrl>
 #include <QVariant>
 #include <QVariantList>
 #include <signal.h>
@@ -225,6 +228,10 @@ class TestSupport : public QObject {
   Q_INVOKABLE QVariantList findItemsInScene(QQuickItem* root,
                                             const QString& namePrefix);
 
+  Q_INVOKABLE QSize imageSize(const QVariant& image);
+  Q_INVOKABLE QColor imagePixelColor(const QVariant& image, int x, int y);
+  Q_INVOKABLE QVariant loadImage(const QUrl& url);
+
  Q_SIGNALS:
   void testLoadedChanged();
 
@@ -19,22 +19,27 @@
 
 #include <utility>
 
+#include "base/bind.h"
+#include "base/location.h"
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "base/trace_event/trace_event.h"
 #include "cc/animation/animation_host.h"
 #include "cc/layers/layer.h"
+#include "cc/output/compositor_frame.h"
 #include "cc/output/compositor_frame_sink.h"
 #include "cc/output/context_provider.h"
 #include "cc/output/output_surface.h"
 #include "cc/output/renderer_settings.h"
 #include "cc/output/texture_mailbox_deleter.h"
+#include "cc/quads/render_pass.h"
 #include "cc/scheduler/begin_frame_source.h"
-#include "cc/scheduler/delay_based_time_source.h"
 #include "cc/surfaces/direct_compositor_frame_sink.h"
 #include "cc/surfaces/display.h"
 #include "cc/surfaces/display_scheduler.h"
+#include "cc/surfaces/surface_factory.h"
+#include "cc/surfaces/surface_manager.h"
 #include "cc/trees/layer_tree_host.h"
 #include "cc/trees/layer_tree_settings.h"
 #include "content/browser/gpu/browser_gpu_channel_host_factory.h" // nogncheck
@@ -54,6 +59,7 @@
 
 #include "oxide_compositor_client.h"
 #include "oxide_compositor_frame_ack.h"
+#include "oxide_compositor_frame_clock.h"
 #include "oxide_compositor_frame_data.h"
 #include "oxide_compositor_frame_handle.h"
 #include "oxide_compositor_gpu_shims.h"
@@ -62,6 +68,8 @@
 #include "oxide_compositor_output_surface_gl.h"
 #include "oxide_compositor_output_surface_software.h"
 #include "oxide_compositor_software_output_device.h"
+#include "oxide_compositor_thread_frame_sink.h"
+#include "oxide_compositor_thread_proxy.h"
 #include "oxide_compositor_utils.h"
 
 namespace oxide {
@@ -109,13 +117,13 @@ Compositor::Compositor(CompositorClient* client)
     : mode_(CompositorUtils::GetInstance()->GetCompositingMode()),
       client_(client),
       task_runner_(base::ThreadTaskRunnerHandle::Get()),
+      impl_task_runner_(
+          CompositorUtils::GetInstance()->GetCompositorTaskRunner()),
       output_surface_(nullptr),
       mailbox_buffer_map_(mode_),
       frame_sink_id_(CompositorUtils::GetInstance()->AllocateFrameSinkId()),
-      begin_frame_source_(
-          new cc::DelayBasedBeginFrameSource(
-              base::MakeUnique<cc::DelayBasedTimeSource>(
-                  base::ThreadTaskRunnerHandle::Get().get()))),
+      frame_clock_(new CompositorFrameClock(task_runner_)),
+      display_frame_sink_id_(0),
       animation_host_(cc::AnimationHost::CreateMainInstance()),
       layer_tree_host_eviction_pending_(false),
       can_evict_layer_tree_host_(false),
@@ -131,12 +139,94 @@ Compositor::Compositor(CompositorClient* client)
   CompositorUtils::GetInstance()
       ->GetSurfaceManager()
       ->RegisterFrameSinkId(frame_sink_id_);
+
+  if (is_threaded()) {
+    thread_proxy_ = new CompositorThreadProxy(weak_factory_.GetWeakPtr(),
+                                              task_runner_,
+                                              impl_task_runner_);
+  }
 }
 
 bool Compositor::SurfaceIdIsCurrent(uint32_t surface_id) {
   return output_surface_ && output_surface_->surface_id() == surface_id;
 }
 
+void Compositor::ResetDisplay() {
+  DestroySurfaceFactory();
+  display_.reset();
+  display_frame_sink_id_ = 0;
+}
+
+void Compositor::DestroySurfaceFactory() {
+  if (!surface_factory_) {
+    return;
+  }
+
+  surface_factory_->EvictSurface();
+  CompositorUtils::GetInstance()
+      ->GetSurfaceManager()
+      ->UnregisterSurfaceFactoryClient(frame_sink_id_);
+  surface_factory_.reset();
+
+  local_surface_id_ = cc::LocalSurfaceId();
+  last_frame_size_ = gfx::Size();
+
+  thread_proxy_->SetBeginFrameSource(nullptr);
+}
+
+void Compositor::ImplFrameSinkBound(uint32_t sink_id) {
+  DCHECK(is_threaded());
+
+  // |display_| may have been replaced since this was posted
+  if (!display_ || sink_id != display_frame_sink_id_) {
+    return;
+  }
+
+  DCHECK(!surface_factory_);
+
+  cc::SurfaceManager* manager =
+      CompositorUtils::GetInstance()->GetSurfaceManager();
+  surface_factory_ =
+      base::MakeUnique<cc::SurfaceFactory>(frame_sink_id_, manager, this);
+  manager->RegisterSurfaceFactoryClient(frame_sink_id_, this);
+
+  display_->Initialize(this, manager);
+}
+
+void Compositor::ImplFrameSinkDestroyed(uint32_t sink_id) {
+  DCHECK(is_threaded());
+
+  if (sink_id != display_frame_sink_id_) {
+    return;
+  }
+
+  DestroySurfaceFactory();
+}
+
+void Compositor::SubmitCompositorFrameFromImplThread(
+    uint32_t sink_id,
+    cc::CompositorFrame frame) {
+  DCHECK(is_threaded());
+
+  if (!surface_factory_ || sink_id != display_frame_sink_id_) {
+    return;
+  }
+
+  gfx::Size frame_size = frame.render_pass_list.back()->output_rect.size();
+  if (frame_size.IsEmpty() || frame_size != last_frame_size_) {
+    local_surface_id_ = surface_id_allocator_.GenerateId();
+    last_frame_size_ = frame_size;
+  }
+
+  display_->SetLocalSurfaceId(local_surface_id_,
+                              frame.metadata.device_scale_factor);
+  surface_factory_->SubmitCompositorFrame(
+      local_surface_id_,
+      std::move(frame),
+      base::Bind(&CompositorThreadProxy::DidDrawFrame,
+                 thread_proxy_, sink_id));
+}
+
 void Compositor::DidCompleteGLFrame(uint32_t surface_id,
                                     std::unique_ptr<CompositorFrameData> frame) {
   TRACE_EVENT_ASYNC_END1(
@@ -310,12 +400,21 @@ Compositor::CreateCompositorFrameSink() {
   uint32_t output_surface_id = next_output_surface_id_++;
 
   scoped_refptr<cc::ContextProvider> context_provider;
+  scoped_refptr<cc::ContextProvider> impl_context_provider;
   std::unique_ptr<cc::OutputSurface> output_surface;
   if (CompositorUtils::GetInstance()->CanUseGpuCompositing()) {
     context_provider = CreateOffscreenContextProvider();
     if (!context_provider.get()) {
       return nullptr;
     }
+    if (is_threaded()) {
+      // The display's context is only used on this thread, so the compositor
+      // thread gets its own
+      impl_context_provider = CreateOffscreenContextProvider();
+      if (!impl_context_provider.get()) {
+        return nullptr;
+      }
+    }
     output_surface =
         base::MakeUnique<CompositorOutputSurfaceGL>(output_surface_id,
                                                     context_provider,
@@ -335,32 +434,44 @@ Compositor::CreateCompositorFrameSink() {
           base::ThreadTaskRunnerHandle::Get().get(),
           output_surface->capabilities().max_frames_pending));
 
+  ResetDisplay();
   display_ =
       base::MakeUnique<cc::Display>(
           content::HostSharedBitmapManager::current(),
           content::BrowserGpuMemoryBufferManager::current(),
           cc::RendererSettings(),
           frame_sink_id_,
-          begin_frame_source_.get(),
+          frame_clock_->begin_frame_source(),
           std::move(output_surface),
           std::move(scheduler),
           base::MakeUnique<cc::TextureMailboxDeleter>(
               base::ThreadTaskRunnerHandle::Get().get()));
 
-  std::unique_ptr<cc::DirectCompositorFrameSink> sink =
-      base::MakeUnique<cc::DirectCompositorFrameSink>(
-          frame_sink_id_,
-          CompositorUtils::GetInstance()->GetSurfaceManager(),
-          display_.get(),
-          context_provider,
-          nullptr,
-          content::BrowserGpuMemoryBufferManager::current(),
-          content::HostSharedBitmapManager::current());
-
   display_->Resize(layer_tree_host_->device_viewport_size());
   display_->SetVisible(layer_tree_host_->IsVisible());
 
-  return std::move(sink);
+  if (is_threaded()) {
+    // The display stays on this thread, as it aggregates surfaces that
+    // RenderWidgetHostView submits to the SurfaceManager here. The returned
+    // sink is bound on the compositor thread, and its frames are submitted to
+    // the display in SubmitCompositorFrameFromImplThread
+    display_frame_sink_id_ = output_surface_id;
+    return base::MakeUnique<CompositorThreadFrameSink>(
+        output_surface_id,
+        thread_proxy_,
+        impl_context_provider,
+        content::BrowserGpuMemoryBufferManager::current(),
+        content::HostSharedBitmapManager::current());
+  }
+
+  return base::MakeUnique<cc::DirectCompositorFrameSink>(
+      frame_sink_id_,
+      CompositorUtils::GetInstance()->GetSurfaceManager(),
+      display_.get(),
+      context_provider,
+      nullptr,
+      content::BrowserGpuMemoryBufferManager::current(),
+      content::HostSharedBitmapManager::current());
 }
 
 void Compositor::AddObserver(CompositorObserver* observer) {
@@ -389,8 +500,13 @@ void Compositor::EnsureLayerTreeHost() {
   params.main_task_runner = base::ThreadTaskRunnerHandle::Get();
   params.mutator_host = animation_host_.get();
 
-  layer_tree_host_ =
-      cc::LayerTreeHost::CreateSingleThreaded(this, &params);
+  if (is_threaded()) {
+    layer_tree_host_ =
+        cc::LayerTreeHost::CreateThreaded(impl_task_runner_, &params);
+  } else {
+    layer_tree_host_ =
+        cc::LayerTreeHost::CreateSingleThreaded(this, &params);
+  }
   DCHECK(layer_tree_host_);
 
   can_evict_layer_tree_host_ = true;
@@ -411,7 +527,7 @@ void Compositor::MaybeEvictLayerTreeHost() {
   can_evict_layer_tree_host_ = false;
 
   layer_tree_host_.reset();
-  display_.reset();
+  ResetDisplay();
 }
 
 void Compositor::GetTextureFromMailboxResponse(uint32_t surface_id,
@@ -651,6 +767,32 @@ void Compositor::AllFramesReturnedFromClient()  {
                                     weak_factory_.GetWeakPtr()));
 }
 
+void Compositor::ReturnResources(const cc::ReturnedResourceArray& resources) {
+  DCHECK(is_threaded());
+
+  if (resources.empty()) {
+    return;
+  }
+
+  thread_proxy_->ReclaimResources(display_frame_sink_id_, resources);
+}
+
+void Compositor::SetBeginFrameSource(cc::BeginFrameSource* begin_frame_source) {
+  DCHECK(is_threaded());
+  thread_proxy_->SetBeginFrameSource(begin_frame_source);
+}
+
+void Compositor::DisplayOutputSurfaceLost() {
+  DCHECK(is_threaded());
+  thread_proxy_->DidLoseOutputSurface(display_frame_sink_id_);
+}
+
+void Compositor::DisplayWillDrawAndSwap(
+    bool will_draw_and_swap,
+    const cc::RenderPassList& render_passes) {}
+
+void Compositor::DisplayDidDrawAndSwap() {}
+
 void Compositor::ReclaimResourcesForFrame(uint32_t surface_id,
                                           CompositorFrameData* frame) {
   CompositorFrameAck ack;
@@ -685,7 +827,14 @@ Compositor::~Compositor() {
   }
 
   layer_tree_host_.reset();
-  display_.reset();
+  ResetDisplay();
+
+  if (is_threaded()) {
+    thread_proxy_->Shutdown();
+    thread_proxy_ = nullptr;
+  }
+
+  frame_clock_->Shutdown();
 
   CompositorUtils::GetInstance()
       ->GetSurfaceManager()
@@ -763,4 +912,8 @@ void Compositor::SetNeedsRedraw() {
   layer_tree_host_->SetNeedsRedrawRect(gfx::Rect(size_));
 }
 
+void Compositor::SetTopLevelWindowKey(const void* key) {
+  frame_clock_->SetWindowKey(key);
+}
+
 } // namespace oxide
@@ -26,7 +26,11 @@
 #include "base/memory/scoped_vector.h"
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
+#include "cc/surfaces/display_client.h"
 #include "cc/surfaces/frame_sink_id.h"
+#include "cc/surfaces/local_surface_id.h"
+#include "cc/surfaces/surface_factory_client.h"
+#include "cc/surfaces/surface_id_allocator.h"
 #include "cc/trees/layer_tree_host_client.h"
 #include "cc/trees/layer_tree_host_single_thread_client.h"
 #include "ui/gfx/geometry/size.h"
@@ -35,6 +39,7 @@
 #include "shared/browser/compositor/oxide_compositor_client.h"
 #include "shared/browser/compositor/oxide_compositor_frame_collector.h"
 #include "shared/browser/compositor/oxide_compositor_output_surface_listener.h"
+#include "shared/browser/compositor/oxide_compositor_thread_proxy.h"
 #include "shared/browser/compositor/oxide_mailbox_buffer_map.h"
 
 namespace base {
@@ -43,11 +48,12 @@ class SingleThreadTaskRunner;
 
 namespace cc {
 class AnimationHost;
+class CompositorFrame;
 class CompositorFrameSink;
-class DelayBasedBeginFrameSource;
 class Display;
 class Layer;
 class LayerTreeHost;
+class SurfaceFactory;
 }
 
 namespace gfx {
@@ -58,12 +64,29 @@ namespace oxide {
 
 class CompositorFrameData;
 class CompositorFrameHandle;
+class CompositorFrameClock;
 class CompositorObserver;
 
+// The browser-side compositor for a web view. By default this runs entirely on
+// the UI thread. If threaded compositing is enabled (see
+// CompositorUtils::GetCompositorTaskRunner), the impl side of the
+// LayerTreeHost runs on the compositor thread instead, and submits frames
+// through a CompositorThreadFrameSink. The cc::Display, the output surface and
+// every cc::SurfaceManager call stay on the UI thread in both modes, as the
+// display aggregates the surfaces that RenderWidgetHostView submits there.
+// CompositorClient is always called on the UI thread.
+//
+// Each Compositor has its own begin-frame source, which can be synchronized
+// with the render loop of the top-level window that it is displayed in (see
+// CompositorFrameClock)
+
 class Compositor : public cc::LayerTreeHostClient,
                    public cc::LayerTreeHostSingleThreadClient,
                    public CompositorOutputSurfaceListener,
-                   public CompositorFrameCollector {
+                   public CompositorFrameCollector,
+                   public CompositorThreadProxyClient,
+                   public cc::SurfaceFactoryClient,
+                   public cc::DisplayClient {
  public:
   static std::unique_ptr<Compositor> Create(CompositorClient* client);
   ~Compositor() override;
@@ -77,13 +100,26 @@ class Compositor : public cc::LayerTreeHostClient,
   void SetRootLayer(scoped_refptr<cc::Layer> layer);
   void SetNeedsRedraw();
 
+  // Synchronizes begin frames with the render loop of the top-level window
+  // identified by |key|. A null |key| means that begin frames are driven by a
+  // timer
+  void SetTopLevelWindowKey(const void* key);
+
  private:
   friend class CompositorObserver;
 
   Compositor(CompositorClient* client);
 
+  bool is_threaded() const { return !!impl_task_runner_; }
+
   bool SurfaceIdIsCurrent(uint32_t surface_id);
 
+  void ResetDisplay();
+
+  // Disconnects |display_| from the CompositorThreadFrameSink in threaded
+  // mode
+  void DestroySurfaceFactory();
+
   void DidCompleteGLFrame(uint32_t surface_id,
                           std::unique_ptr<CompositorFrameData> frame);
   void ContinueSwapGLFrame(uint32_t surface_id,
@@ -163,12 +199,32 @@ class Compositor : public cc::LayerTreeHostClient,
   void ReclaimResourcesForFrame(uint32_t surface_id,
                                 CompositorFrameData* frame) override;
 
+  // CompositorThreadProxyClient implementation
+  void ImplFrameSinkBound(uint32_t sink_id) override;
+  void ImplFrameSinkDestroyed(uint32_t sink_id) override;
+  void SubmitCompositorFrameFromImplThread(uint32_t sink_id,
+                                           cc::CompositorFrame frame) override;
+
+  // cc::SurfaceFactoryClient implementation
+  void ReturnResources(const cc::ReturnedResourceArray& resources) override;
+  void SetBeginFrameSource(cc::BeginFrameSource* begin_frame_source) override;
+
+  // cc::DisplayClient implementation
+  void DisplayOutputSurfaceLost() override;
+  void DisplayWillDrawAndSwap(bool will_draw_and_swap,
+                              const cc::RenderPassList& render_passes) override;
+  void DisplayDidDrawAndSwap() override;
+
   CompositingMode mode_;
 
   CompositorClient* client_;
 
   scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
 
+  // The compositor thread task runner. Only set in threaded mode
+  scoped_refptr<base::SingleThreadTaskRunner> impl_task_runner_;
+  scoped_refptr<CompositorThreadProxy> thread_proxy_;
+
   CompositorOutputSurface* output_surface_;
 
   MailboxBufferMap mailbox_buffer_map_;
@@ -181,12 +237,23 @@ class Compositor : public cc::LayerTreeHostClient,
 
   cc::FrameSinkId frame_sink_id_;
 
-  // This needs to outlive |display_|
-  std::unique_ptr<cc::DelayBasedBeginFrameSource> begin_frame_source_;
+  // Provides the begin-frame source, so this needs to outlive |display_|
+  scoped_refptr<CompositorFrameClock> frame_clock_;
 
   // This needs to outlive |layer_tree_host_|
   std::unique_ptr<cc::Display> display_;
 
+  // The ID of the CompositorThreadFrameSink that submits frames to
+  // |display_| in threaded mode
+  uint32_t display_frame_sink_id_;
+
+  // Used in threaded mode to submit frames from the compositor thread to
+  // |display_|
+  std::unique_ptr<cc::SurfaceFactory> surface_factory_;
+  cc::SurfaceIdAllocator surface_id_allocator_;
+  cc::LocalSurfaceId local_surface_id_;
+  gfx::Size last_frame_size_;
+
   std::unique_ptr<cc::AnimationHost> animation_host_;
 
   bool layer_tree_host_eviction_pending_;
@@ -0,0 +1,306 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "oxide_compositor_frame_clock.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/lazy_instance.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "base/single_thread_task_runner.h"
+#include "base/synchronization/lock.h"
+#include "cc/output/begin_frame_args.h"
+
+namespace oxide {
+
+namespace {
+
+// The number of render loop frame intervals without a frame, after which we
+// fall back to the timer
+const int kRenderLoopTimeoutFrames = 2;
+
+// Render loop notifications can arrive on any thread, so the clocks associated
+// with each window are tracked under a lock. Clocks remove themselves during
+// Shutdown, whilst they are still referenced
+struct WindowRegistry {
+  base::Lock lock;
+  std::map<const void*, std::set<CompositorFrameClock*>> clocks;
+};
+base::LazyInstance<WindowRegistry> g_window_registry =
+    LAZY_INSTANCE_INITIALIZER;
+
+std::vector<scoped_refptr<CompositorFrameClock>> GetClocksForWindow(
+    const void* key) {
+  std::vector<scoped_refptr<CompositorFrameClock>> rv;
+  if (!key) {
+    return rv;
+  }
+
+  WindowRegistry& registry = g_window_registry.Get();
+  base::AutoLock lock(registry.lock);
+
+  auto it = registry.clocks.find(key);
+  if (it == registry.clocks.end()) {
+    return rv;
+  }
+
+  for (CompositorFrameClock* clock : it->second) {
+    rv.push_back(clock);
+  }
+
+  return rv;
+}
+
+}
+
+CompositorFrameClock::~CompositorFrameClock() {
+  DCHECK(!begin_frame_source_);
+  DCHECK(!window_key_);
+}
+
+void CompositorFrameClock::DidSynchronizeOnTaskRunner(base::TimeTicks time) {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+  last_sync_time_ = time;
+}
+
+void CompositorFrameClock::DidSwapFrameOnTaskRunner(base::TimeTicks time) {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+
+  if (!begin_frame_source_) {
+    return;
+  }
+
+  if (!last_swap_time_.is_null()) {
+    // Only consecutive frames are used to estimate the interval - the render
+    // loop doesn't produce frames when nothing has changed
+    base::TimeDelta delta = time - last_swap_time_;
+    if (delta > base::TimeDelta() && delta < render_loop_interval_ * 2) {
+      render_loop_interval_ = (render_loop_interval_ * 7 + delta) / 8;
+    }
+  }
+
+  last_swap_time_ = time;
+
+  SetRenderLoopActive(true);
+
+  if (!needs_begin_frames_) {
+    return;
+  }
+
+  // Aim to have the next frame ready for the render loop's next
+  // synchronization
+  base::TimeTicks deadline = last_sync_time_ + render_loop_interval_;
+  if (deadline <= time) {
+    deadline = time + render_loop_interval_ / 2;
+  }
+
+  IssueBeginFrame(time, deadline, render_loop_interval_);
+
+  render_loop_timeout_timer_->Start(
+      FROM_HERE,
+      render_loop_interval_ * kRenderLoopTimeoutFrames,
+      base::Bind(&CompositorFrameClock::OnRenderLoopTimeout,
+                 base::Unretained(this)));
+}
+
+void CompositorFrameClock::RenderLoopStoppedOnTaskRunner() {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+
+  if (!begin_frame_source_) {
+    return;
+  }
+
+  SetRenderLoopActive(false);
+}
+
+void CompositorFrameClock::ShutdownOnTaskRunner() {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+
+  SetWindowKey(nullptr);
+
+  render_loop_timeout_timer_.reset();
+  time_source_.reset();
+  begin_frame_source_.reset();
+}
+
+void CompositorFrameClock::SetRenderLoopActive(bool active) {
+  if (active == render_loop_active_) {
+    return;
+  }
+
+  render_loop_active_ = active;
+
+  if (!active) {
+    render_loop_timeout_timer_->Stop();
+  }
+
+  UpdateTimeSource();
+}
+
+void CompositorFrameClock::UpdateTimeSource() {
+  time_source_->SetActive(needs_begin_frames_ && !render_loop_active_);
+}
+
+void CompositorFrameClock::IssueBeginFrame(base::TimeTicks frame_time,
+                                           base::TimeTicks deadline,
+                                           base::TimeDelta interval) {
+  begin_frame_source_->OnBeginFrame(
+      cc::BeginFrameArgs::Create(BEGINFRAME_FROM_HERE,
+                                 frame_time,
+                                 deadline,
+                                 interval,
+                                 cc::BeginFrameArgs::NORMAL));
+}
+
+void CompositorFrameClock::OnRenderLoopTimeout() {
+  DVLOG(1) << "Render loop stopped producing frames, falling back to timer";
+  SetRenderLoopActive(false);
+}
+
+void CompositorFrameClock::OnNeedsBeginFrames(bool needs_begin_frames) {
+  if (needs_begin_frames == needs_begin_frames_) {
+    return;
+  }
+
+  needs_begin_frames_ = needs_begin_frames;
+
+  if (!needs_begin_frames_) {
+    render_loop_timeout_timer_->Stop();
+  } else if (render_loop_active_) {
+    // The render loop only produces frames when something in the scene
+    // changes, so it might be idle now. If we don't get a frame soon, we fall
+    // back to the timer to produce the first frame from web content, which
+    // will then cause the render loop to draw
+    render_loop_timeout_timer_->Start(
+        FROM_HERE,
+        render_loop_interval_,
+        base::Bind(&CompositorFrameClock::OnRenderLoopTimeout,
+                   base::Unretained(this)));
+  }
+
+  UpdateTimeSource();
+}
+
+void CompositorFrameClock::OnTimerTick() {
+  IssueBeginFrame(time_source_->LastTickTime(),
+                  time_source_->NextTickTime(),
+                  time_source_->Interval());
+}
+
+CompositorFrameClock::CompositorFrameClock(
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner)
+    : task_runner_(task_runner),
+      window_key_(nullptr),
+      begin_frame_source_(
+          base::MakeUnique<cc::ExternalBeginFrameSource>(this)),
+      time_source_(
+          base::MakeUnique<cc::DelayBasedTimeSource>(task_runner_.get())),
+      render_loop_timeout_timer_(base::MakeUnique<base::OneShotTimer>()),
+      needs_begin_frames_(false),
+      render_loop_active_(false),
+      render_loop_interval_(cc::BeginFrameArgs::DefaultInterval()) {
+  time_source_->SetClient(this);
+}
+
+cc::BeginFrameSource* CompositorFrameClock::begin_frame_source() const {
+  return begin_frame_source_.get();
+}
+
+void CompositorFrameClock::SetWindowKey(const void* key) {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+
+  if (key == window_key_) {
+    return;
+  }
+
+  WindowRegistry& registry = g_window_registry.Get();
+  base::AutoLock lock(registry.lock);
+
+  if (window_key_) {
+    auto it = registry.clocks.find(window_key_);
+    DCHECK(it != registry.clocks.end());
+    it->second.erase(this);
+    if (it->second.empty()) {
+      registry.clocks.erase(it);
+    }
+  }
+
+  window_key_ = key;
+
+  if (window_key_) {
+    registry.clocks[window_key_].insert(this);
+  }
+}
+
+void CompositorFrameClock::DidSynchronize() {
+  task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&CompositorFrameClock::DidSynchronizeOnTaskRunner,
+                 this, base::TimeTicks::Now()));
+}
+
+void CompositorFrameClock::DidSwapFrame() {
+  task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&CompositorFrameClock::DidSwapFrameOnTaskRunner,
+                 this, base::TimeTicks::Now()));
+}
+
+void CompositorFrameClock::RenderLoopStopped() {
+  task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&CompositorFrameClock::RenderLoopStoppedOnTaskRunner, this));
+}
+
+// static
+void CompositorFrameClock::WindowWillSynchronize(const void* key) {
+  for (auto& clock : GetClocksForWindow(key)) {
+    clock->DidSynchronize();
+  }
+}
+
+// static
+void CompositorFrameClock::WindowFrameSwapped(const void* key) {
+  for (auto& clock : GetClocksForWindow(key)) {
+    clock->DidSwapFrame();
+  }
+}
+
+// static
+void CompositorFrameClock::WindowRenderLoopStopped(const void* key) {
+  for (auto& clock : GetClocksForWindow(key)) {
+    clock->RenderLoopStopped();
+  }
+}
+
+void CompositorFrameClock::Shutdown() {
+  if (task_runner_->BelongsToCurrentThread()) {
+    ShutdownOnTaskRunner();
+    return;
+  }
+
+  task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&CompositorFrameClock::ShutdownOnTaskRunner, this));
+}
+
+} // namespace oxide
@@ -0,0 +1,134 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_SHARED_BROWSER_COMPOSITOR_COMPOSITOR_FRAME_CLOCK_H_
+#define _OXIDE_SHARED_BROWSER_COMPOSITOR_COMPOSITOR_FRAME_CLOCK_H_
+
+#include <memory>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "cc/scheduler/begin_frame_source.h"
+#include "cc/scheduler/delay_based_time_source.h"
+
+namespace base {
+class SingleThreadTaskRunner;
+}
+
+namespace oxide {
+
+// Drives begin frames for a Compositor. When the render loop of the embedder's
+// window reports its frames (see DidSynchronize and DidSwapFrame), one begin
+// frame is issued per rendered frame, with a deadline at the predicted next
+// synchronization point. This avoids web content producing frames just after
+// the render loop has synchronized, which would add a frame of latency.
+//
+// If the render loop stops producing frames (because the window is hidden or
+// idle), begin frames fall back to a timer.
+//
+// The embedder identifies windows by an opaque key (see
+// WebContentsViewClient::GetTopLevelWindowKey). Each clock is associated with
+// at most one window, and a window's notifications are forwarded to all of the
+// clocks associated with it.
+//
+// The cc::BeginFrameSource and timers live on |task_runner|. The public
+// notification methods can be called on any thread
+class CompositorFrameClock
+    : public base::RefCountedThreadSafe<CompositorFrameClock>,
+      public cc::ExternalBeginFrameSourceClient,
+      public cc::DelayBasedTimeSourceClient {
+ public:
+  CompositorFrameClock(
+      scoped_refptr<base::SingleThreadTaskRunner> task_runner);
+
+  // Must only be accessed on |task_runner|
+  cc::BeginFrameSource* begin_frame_source() const;
+
+  // Associates this clock with the window identified by |key|. A null |key|
+  // detaches it from any window. Must be called on |task_runner|
+  void SetWindowKey(const void* key);
+
+  // Notifications from the render loop. These can be called on any thread
+  void DidSynchronize();
+  void DidSwapFrame();
+  void RenderLoopStopped();
+
+  // Notifications from the render loop of the window identified by |key|,
+  // which are forwarded to every clock associated with it. These can be called
+  // on any thread
+  static void WindowWillSynchronize(const void* key);
+  static void WindowFrameSwapped(const void* key);
+  static void WindowRenderLoopStopped(const void* key);
+
+  // Detaches this clock from its window and destroys the begin-frame source on
+  // |task_runner|. Must be called before the last reference is released
+  void Shutdown();
+
+ private:
+  friend class base::RefCountedThreadSafe<CompositorFrameClock>;
+  ~CompositorFrameClock() override;
+
+  void DidSynchronizeOnTaskRunner(base::TimeTicks time);
+  void DidSwapFrameOnTaskRunner(base::TimeTicks time);
+  void RenderLoopStoppedOnTaskRunner();
+  void ShutdownOnTaskRunner();
+
+  void SetRenderLoopActive(bool active);
+  void UpdateTimeSource();
+  void IssueBeginFrame(base::TimeTicks frame_time,
+                       base::TimeTicks deadline,
+                       base::TimeDelta interval);
+
+  // Called if the render loop hasn't produced a frame for a while
+  void OnRenderLoopTimeout();
+
+  // cc::ExternalBeginFrameSourceClient implementation
+  void OnNeedsBeginFrames(bool needs_begin_frames) override;
+
+  // cc::DelayBasedTimeSourceClient implementation
+  void OnTimerTick() override;
+
+  scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
+
+  const void* window_key_;
+
+  std::unique_ptr<cc::ExternalBeginFrameSource> begin_frame_source_;
+
+  // The fallback timer, used when the render loop isn't producing frames
+  std::unique_ptr<cc::DelayBasedTimeSource> time_source_;
+
+  std::unique_ptr<base::OneShotTimer> render_loop_timeout_timer_;
+
+  bool needs_begin_frames_;
+
+  // Whether begin frames are currently driven by the render loop
+  bool render_loop_active_;
+
+  base::TimeTicks last_sync_time_;
+  base::TimeTicks last_swap_time_;
+
+  // The render loop frame interval, estimated from consecutive frames
+  base::TimeDelta render_loop_interval_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompositorFrameClock);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_COMPOSITOR_COMPOSITOR_FRAME_CLOCK_H_
@@ -0,0 +1,110 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "oxide_compositor_thread_frame_sink.h"
+
+#include <utility>
+
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "cc/output/compositor_frame.h"
+#include "cc/output/compositor_frame_sink_client.h"
+
+#include "oxide_compositor_thread_proxy.h"
+
+namespace oxide {
+
+void CompositorThreadFrameSink::OnNeedsBeginFrames(bool needs_begin_frames) {
+  proxy_->SetNeedsBeginFrames(needs_begin_frames);
+}
+
+CompositorThreadFrameSink::CompositorThreadFrameSink(
+    uint32_t id,
+    scoped_refptr<CompositorThreadProxy> proxy,
+    scoped_refptr<cc::ContextProvider> context_provider,
+    gpu::GpuMemoryBufferManager* gpu_memory_buffer_manager,
+    cc::SharedBitmapManager* shared_bitmap_manager)
+    : cc::CompositorFrameSink(std::move(context_provider),
+                              nullptr,
+                              gpu_memory_buffer_manager,
+                              shared_bitmap_manager),
+      id_(id),
+      proxy_(proxy) {
+  DCHECK(proxy_);
+}
+
+CompositorThreadFrameSink::~CompositorThreadFrameSink() {
+  if (HasClient()) {
+    DetachFromClient();
+  }
+}
+
+void CompositorThreadFrameSink::BeginFrame(const cc::BeginFrameArgs& args) {
+  DCHECK(begin_frame_source_);
+  begin_frame_source_->OnBeginFrame(args);
+}
+
+void CompositorThreadFrameSink::SetBeginFramesPaused(bool paused) {
+  DCHECK(begin_frame_source_);
+  begin_frame_source_->OnSetBeginFrameSourcePaused(paused);
+}
+
+void CompositorThreadFrameSink::DidDrawFrame() {
+  DCHECK(HasClient());
+  client_->DidReceiveCompositorFrameAck();
+}
+
+void CompositorThreadFrameSink::ReclaimResources(
+    const cc::ReturnedResourceArray& resources) {
+  DCHECK(HasClient());
+  client_->ReclaimResources(resources);
+}
+
+void CompositorThreadFrameSink::DidLoseOutputSurface() {
+  DCHECK(HasClient());
+  client_->DidLoseCompositorFrameSink();
+}
+
+bool CompositorThreadFrameSink::BindToClient(
+    cc::CompositorFrameSinkClient* client) {
+  if (!cc::CompositorFrameSink::BindToClient(client)) {
+    return false;
+  }
+
+  begin_frame_source_ = base::MakeUnique<cc::ExternalBeginFrameSource>(this);
+  client_->SetBeginFrameSource(begin_frame_source_.get());
+
+  proxy_->FrameSinkBound(this);
+
+  return true;
+}
+
+void CompositorThreadFrameSink::DetachFromClient() {
+  proxy_->FrameSinkDestroyed(this);
+
+  client_->SetBeginFrameSource(nullptr);
+  begin_frame_source_.reset();
+
+  cc::CompositorFrameSink::DetachFromClient();
+}
+
+void CompositorThreadFrameSink::SubmitCompositorFrame(
+    cc::CompositorFrame frame) {
+  proxy_->SubmitCompositorFrame(std::move(frame));
+}
+
+} // namespace oxide
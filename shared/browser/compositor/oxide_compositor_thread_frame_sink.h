@@ -0,0 +1,84 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_SHARED_BROWSER_COMPOSITOR_COMPOSITOR_THREAD_FRAME_SINK_H_
+#define _OXIDE_SHARED_BROWSER_COMPOSITOR_COMPOSITOR_THREAD_FRAME_SINK_H_
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "cc/output/compositor_frame_sink.h"
+#include "cc/resources/returned_resource.h"
+#include "cc/scheduler/begin_frame_source.h"
+
+#include "shared/common/oxide_shared_export.h"
+
+namespace oxide {
+
+class CompositorThreadProxy;
+
+// The CompositorFrameSink given to a threaded LayerTreeHost. It is created on
+// the UI thread and then bound and used on the compositor thread, where it
+// forwards frames to the Compositor's display via CompositorThreadProxy. It
+// has its own context, as the display's context is only used on the UI
+// thread. Begin frames from the display's begin-frame source are delivered
+// through an ExternalBeginFrameSource
+class OXIDE_SHARED_EXPORT CompositorThreadFrameSink
+    : public cc::CompositorFrameSink,
+      public cc::ExternalBeginFrameSourceClient {
+ public:
+  CompositorThreadFrameSink(
+      uint32_t id,
+      scoped_refptr<CompositorThreadProxy> proxy,
+      scoped_refptr<cc::ContextProvider> context_provider,
+      gpu::GpuMemoryBufferManager* gpu_memory_buffer_manager,
+      cc::SharedBitmapManager* shared_bitmap_manager);
+  ~CompositorThreadFrameSink() override;
+
+  uint32_t id() const { return id_; }
+
+  // Notifications from CompositorThreadProxy
+  void BeginFrame(const cc::BeginFrameArgs& args);
+  void SetBeginFramesPaused(bool paused);
+  void DidDrawFrame();
+  void ReclaimResources(const cc::ReturnedResourceArray& resources);
+  void DidLoseOutputSurface();
+
+  // cc::CompositorFrameSink implementation
+  bool BindToClient(cc::CompositorFrameSinkClient* client) override;
+  void DetachFromClient() override;
+  void SubmitCompositorFrame(cc::CompositorFrame frame) override;
+
+ private:
+  // cc::ExternalBeginFrameSourceClient implementation
+  void OnNeedsBeginFrames(bool needs_begin_frames) override;
+
+  uint32_t id_;
+
+  scoped_refptr<CompositorThreadProxy> proxy_;
+
+  std::unique_ptr<cc::ExternalBeginFrameSource> begin_frame_source_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompositorThreadFrameSink);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_COMPOSITOR_COMPOSITOR_THREAD_FRAME_SINK_H_
@@ -0,0 +1,242 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "oxide_compositor_thread_proxy.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/single_thread_task_runner.h"
+#include "base/trace_event/trace_event.h"
+#include "cc/output/compositor_frame.h"
+
+#include "oxide_compositor_thread_frame_sink.h"
+
+namespace oxide {
+
+CompositorThreadProxy::CompositorThreadProxy(
+    base::WeakPtr<CompositorThreadProxyClient> client,
+    scoped_refptr<base::SingleThreadTaskRunner> main_task_runner,
+    scoped_refptr<base::SingleThreadTaskRunner> impl_task_runner)
+    : client_(client),
+      main_task_runner_(main_task_runner),
+      impl_task_runner_(impl_task_runner),
+      begin_frame_source_(nullptr),
+      needs_begin_frames_(false),
+      observing_begin_frame_source_(false),
+      frame_sink_(nullptr) {}
+
+CompositorThreadProxy::~CompositorThreadProxy() {
+  DCHECK(!observing_begin_frame_source_);
+  DCHECK(!frame_sink_);
+}
+
+bool CompositorThreadProxy::IsCurrentFrameSink(uint32_t sink_id) const {
+  DCHECK(impl_task_runner_->BelongsToCurrentThread());
+  return frame_sink_ && frame_sink_->id() == sink_id;
+}
+
+void CompositorThreadProxy::SetNeedsBeginFramesOnMainThread(
+    bool needs_begin_frames) {
+  needs_begin_frames_ = needs_begin_frames;
+  UpdateBeginFrameObserver();
+}
+
+void CompositorThreadProxy::UpdateBeginFrameObserver() {
+  DCHECK(main_task_runner_->BelongsToCurrentThread());
+
+  bool should_observe = begin_frame_source_ && needs_begin_frames_;
+  if (should_observe == observing_begin_frame_source_) {
+    return;
+  }
+
+  observing_begin_frame_source_ = should_observe;
+
+  if (should_observe) {
+    begin_frame_source_->AddObserver(this);
+  } else {
+    begin_frame_source_->RemoveObserver(this);
+  }
+}
+
+void CompositorThreadProxy::BeginFrameOnImplThread(
+    const cc::BeginFrameArgs& args) {
+  DCHECK(impl_task_runner_->BelongsToCurrentThread());
+
+  if (!frame_sink_) {
+    return;
+  }
+
+  frame_sink_->BeginFrame(args);
+}
+
+void CompositorThreadProxy::SetBeginFramesPausedOnImplThread(bool paused) {
+  DCHECK(impl_task_runner_->BelongsToCurrentThread());
+
+  if (!frame_sink_) {
+    return;
+  }
+
+  frame_sink_->SetBeginFramesPaused(paused);
+}
+
+void CompositorThreadProxy::DidDrawFrameOnImplThread(uint32_t sink_id) {
+  if (!IsCurrentFrameSink(sink_id)) {
+    return;
+  }
+
+  frame_sink_->DidDrawFrame();
+}
+
+void CompositorThreadProxy::ReclaimResourcesOnImplThread(
+    uint32_t sink_id,
+    const cc::ReturnedResourceArray& resources) {
+  if (!IsCurrentFrameSink(sink_id)) {
+    return;
+  }
+
+  frame_sink_->ReclaimResources(resources);
+}
+
+void CompositorThreadProxy::DidLoseOutputSurfaceOnImplThread(
+    uint32_t sink_id) {
+  if (!IsCurrentFrameSink(sink_id)) {
+    return;
+  }
+
+  frame_sink_->DidLoseOutputSurface();
+}
+
+bool CompositorThreadProxy::OnBeginFrameDerivedImpl(
+    const cc::BeginFrameArgs& args) {
+  impl_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&CompositorThreadProxy::BeginFrameOnImplThread, this, args));
+  return true;
+}
+
+void CompositorThreadProxy::OnBeginFrameSourcePausedChanged(bool paused) {
+  impl_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&CompositorThreadProxy::SetBeginFramesPausedOnImplThread,
+                 this, paused));
+}
+
+void CompositorThreadProxy::SetBeginFrameSource(
+    cc::BeginFrameSource* begin_frame_source) {
+  DCHECK(main_task_runner_->BelongsToCurrentThread());
+
+  if (begin_frame_source == begin_frame_source_) {
+    return;
+  }
+
+  if (observing_begin_frame_source_) {
+    begin_frame_source_->RemoveObserver(this);
+    observing_begin_frame_source_ = false;
+  }
+
+  begin_frame_source_ = begin_frame_source;
+  UpdateBeginFrameObserver();
+}
+
+void CompositorThreadProxy::DidDrawFrame(uint32_t sink_id) {
+  DCHECK(main_task_runner_->BelongsToCurrentThread());
+  impl_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&CompositorThreadProxy::DidDrawFrameOnImplThread,
+                 this, sink_id));
+}
+
+void CompositorThreadProxy::ReclaimResources(
+    uint32_t sink_id,
+    const cc::ReturnedResourceArray& resources) {
+  DCHECK(main_task_runner_->BelongsToCurrentThread());
+  impl_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&CompositorThreadProxy::ReclaimResourcesOnImplThread,
+                 this, sink_id, resources));
+}
+
+void CompositorThreadProxy::DidLoseOutputSurface(uint32_t sink_id) {
+  DCHECK(main_task_runner_->BelongsToCurrentThread());
+  impl_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&CompositorThreadProxy::DidLoseOutputSurfaceOnImplThread,
+                 this, sink_id));
+}
+
+void CompositorThreadProxy::Shutdown() {
+  SetBeginFrameSource(nullptr);
+}
+
+void CompositorThreadProxy::FrameSinkBound(
+    CompositorThreadFrameSink* frame_sink) {
+  DCHECK(impl_task_runner_->BelongsToCurrentThread());
+  DCHECK(!frame_sink_);
+
+  frame_sink_ = frame_sink;
+
+  main_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&CompositorThreadProxyClient::ImplFrameSinkBound,
+                 client_, frame_sink->id()));
+}
+
+void CompositorThreadProxy::FrameSinkDestroyed(
+    CompositorThreadFrameSink* frame_sink) {
+  DCHECK(impl_task_runner_->BelongsToCurrentThread());
+
+  if (frame_sink != frame_sink_) {
+    return;
+  }
+
+  frame_sink_ = nullptr;
+
+  main_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&CompositorThreadProxy::SetNeedsBeginFramesOnMainThread,
+                 this, false));
+  main_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&CompositorThreadProxyClient::ImplFrameSinkDestroyed,
+                 client_, frame_sink->id()));
+}
+
+void CompositorThreadProxy::SetNeedsBeginFrames(bool needs_begin_frames) {
+  DCHECK(impl_task_runner_->BelongsToCurrentThread());
+  main_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&CompositorThreadProxy::SetNeedsBeginFramesOnMainThread,
+                 this, needs_begin_frames));
+}
+
+void CompositorThreadProxy::SubmitCompositorFrame(cc::CompositorFrame frame) {
+  DCHECK(impl_task_runner_->BelongsToCurrentThread());
+  DCHECK(frame_sink_);
+
+  TRACE_EVENT0("cc", "oxide::CompositorThreadProxy::SubmitCompositorFrame");
+
+  main_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(
+          &CompositorThreadProxyClient::SubmitCompositorFrameFromImplThread,
+          client_, frame_sink_->id(), base::Passed(&frame)));
+}
+
+} // namespace oxide
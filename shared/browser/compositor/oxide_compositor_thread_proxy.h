@@ -0,0 +1,135 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_SHARED_BROWSER_COMPOSITOR_COMPOSITOR_THREAD_PROXY_H_
+#define _OXIDE_SHARED_BROWSER_COMPOSITOR_COMPOSITOR_THREAD_PROXY_H_
+
+#include <stdint.h>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "cc/resources/returned_resource.h"
+#include "cc/scheduler/begin_frame_source.h"
+
+#include "shared/common/oxide_shared_export.h"
+
+namespace base {
+class SingleThreadTaskRunner;
+}
+
+namespace cc {
+class CompositorFrame;
+}
+
+namespace oxide {
+
+class CompositorThreadFrameSink;
+
+// Receives notifications from CompositorThreadFrameSink on the UI thread
+class OXIDE_SHARED_EXPORT CompositorThreadProxyClient {
+ public:
+  virtual ~CompositorThreadProxyClient() {}
+
+  // Notification that the frame sink identified by |sink_id| was bound on the
+  // compositor thread
+  virtual void ImplFrameSinkBound(uint32_t sink_id) = 0;
+
+  // Notification that the frame sink identified by |sink_id| was detached
+  // from its client
+  virtual void ImplFrameSinkDestroyed(uint32_t sink_id) = 0;
+
+  // A frame from the frame sink identified by |sink_id|. The client should
+  // call CompositorThreadProxy::DidDrawFrame once it has been drawn, and
+  // return its resources with CompositorThreadProxy::ReclaimResources
+  virtual void SubmitCompositorFrameFromImplThread(
+      uint32_t sink_id,
+      cc::CompositorFrame frame) = 0;
+};
+
+// Used by Compositor in threaded compositing mode, where the impl side of the
+// LayerTreeHost and its CompositorThreadFrameSink live on the compositor
+// thread, but the cc::Display and the SurfaceManager are only used on the UI
+// thread. This forwards frames from the compositor thread to the client on
+// the UI thread, and forwards acks, returned resources and begin frames from
+// the display's begin-frame source in the other direction
+class OXIDE_SHARED_EXPORT CompositorThreadProxy
+    : public base::RefCountedThreadSafe<CompositorThreadProxy>,
+      public cc::BeginFrameObserverBase {
+ public:
+  CompositorThreadProxy(
+      base::WeakPtr<CompositorThreadProxyClient> client,
+      scoped_refptr<base::SingleThreadTaskRunner> main_task_runner,
+      scoped_refptr<base::SingleThreadTaskRunner> impl_task_runner);
+
+  // Called on the UI thread
+  void SetBeginFrameSource(cc::BeginFrameSource* begin_frame_source);
+  void DidDrawFrame(uint32_t sink_id);
+  void ReclaimResources(uint32_t sink_id,
+                        const cc::ReturnedResourceArray& resources);
+  void DidLoseOutputSurface(uint32_t sink_id);
+
+  // Called on the UI thread to stop observing the begin-frame source, before
+  // the client is deleted
+  void Shutdown();
+
+  // Called on the compositor thread by CompositorThreadFrameSink
+  void FrameSinkBound(CompositorThreadFrameSink* frame_sink);
+  void FrameSinkDestroyed(CompositorThreadFrameSink* frame_sink);
+  void SetNeedsBeginFrames(bool needs_begin_frames);
+  void SubmitCompositorFrame(cc::CompositorFrame frame);
+
+ private:
+  friend class base::RefCountedThreadSafe<CompositorThreadProxy>;
+  ~CompositorThreadProxy() override;
+
+  bool IsCurrentFrameSink(uint32_t sink_id) const;
+
+  void SetNeedsBeginFramesOnMainThread(bool needs_begin_frames);
+  void UpdateBeginFrameObserver();
+
+  void BeginFrameOnImplThread(const cc::BeginFrameArgs& args);
+  void SetBeginFramesPausedOnImplThread(bool paused);
+  void DidDrawFrameOnImplThread(uint32_t sink_id);
+  void ReclaimResourcesOnImplThread(uint32_t sink_id,
+                                    const cc::ReturnedResourceArray& resources);
+  void DidLoseOutputSurfaceOnImplThread(uint32_t sink_id);
+
+  // cc::BeginFrameObserverBase implementation
+  bool OnBeginFrameDerivedImpl(const cc::BeginFrameArgs& args) override;
+  void OnBeginFrameSourcePausedChanged(bool paused) override;
+
+  // Only dereferenced on the UI thread
+  base::WeakPtr<CompositorThreadProxyClient> client_;
+
+  scoped_refptr<base::SingleThreadTaskRunner> main_task_runner_;
+  scoped_refptr<base::SingleThreadTaskRunner> impl_task_runner_;
+
+  // Only accessed on the UI thread
+  cc::BeginFrameSource* begin_frame_source_;
+  bool needs_begin_frames_;
+  bool observing_begin_frame_source_;
+
+  // Only accessed on the compositor thread
+  CompositorThreadFrameSink* frame_sink_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompositorThreadProxy);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_COMPOSITOR_COMPOSITOR_THREAD_PROXY_H_
@@ -0,0 +1,298 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <algorithm>
+#include <memory>
+#include <queue>
+#include <string>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/macros.h"
+#include "base/memory/ptr_util.h"
+#include "base/memory/weak_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/single_thread_task_runner.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "cc/output/compositor_frame.h"
+#include "cc/resources/transferable_resource.h"
+#include "cc/scheduler/begin_frame_source.h"
+#include "cc/test/fake_compositor_frame_sink_client.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+#include "oxide_compositor_thread_frame_sink.h"
+#include "oxide_compositor_thread_proxy.h"
+
+namespace oxide {
+
+namespace {
+
+const int kFrameCount = 1000;
+
+// Stands in for Compositor on the UI thread. Frames are drawn as soon as they
+// arrive, after which the next begin frame is issued
+class TestProxyClient : public CompositorThreadProxyClient,
+                        public cc::ExternalBeginFrameSourceClient {
+ public:
+  TestProxyClient()
+      : begin_frame_source_(this),
+        weak_factory_(this) {}
+
+  void set_proxy(scoped_refptr<CompositorThreadProxy> proxy) {
+    proxy_ = proxy;
+  }
+
+  cc::BeginFrameSource* begin_frame_source() { return &begin_frame_source_; }
+
+  base::WeakPtr<CompositorThreadProxyClient> GetWeakPtr() {
+    return weak_factory_.GetWeakPtr();
+  }
+
+ private:
+  void IssueBeginFrame() {
+    base::TimeTicks now = base::TimeTicks::Now();
+    begin_frame_source_.OnBeginFrame(
+        cc::BeginFrameArgs::Create(BEGINFRAME_FROM_HERE,
+                                   now,
+                                   now + cc::BeginFrameArgs::DefaultInterval(),
+                                   cc::BeginFrameArgs::DefaultInterval(),
+                                   cc::BeginFrameArgs::NORMAL));
+  }
+
+  // CompositorThreadProxyClient implementation
+  void ImplFrameSinkBound(uint32_t sink_id) override {}
+  void ImplFrameSinkDestroyed(uint32_t sink_id) override {}
+  void SubmitCompositorFrameFromImplThread(
+      uint32_t sink_id,
+      cc::CompositorFrame frame) override {
+    cc::ReturnedResourceArray resources;
+    cc::TransferableResource::ReturnResources(frame.resource_list, &resources);
+
+    proxy_->DidDrawFrame(sink_id);
+    if (!resources.empty()) {
+      proxy_->ReclaimResources(sink_id, resources);
+    }
+
+    IssueBeginFrame();
+  }
+
+  // cc::ExternalBeginFrameSourceClient implementation
+  void OnNeedsBeginFrames(bool needs_begin_frames) override {
+    if (!needs_begin_frames) {
+      return;
+    }
+
+    // This is called from inside AddObserver
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE,
+        base::Bind(&TestProxyClient::IssueBeginFrame,
+                   weak_factory_.GetWeakPtr()));
+  }
+
+  scoped_refptr<CompositorThreadProxy> proxy_;
+
+  cc::ExternalBeginFrameSource begin_frame_source_;
+
+  base::WeakPtrFactory<TestProxyClient> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestProxyClient);
+};
+
+// Stands in for the impl side of a threaded LayerTreeHost. A frame is
+// submitted for each begin frame until kFrameCount frames have been acked
+class TestFrameSinkClient : public cc::FakeCompositorFrameSinkClient,
+                            public cc::BeginFrameObserverBase {
+ public:
+  TestFrameSinkClient(
+      int resources_per_frame,
+      scoped_refptr<base::SingleThreadTaskRunner> main_task_runner,
+      const base::Closure& quit_closure)
+      : resources_per_frame_(resources_per_frame),
+        main_task_runner_(main_task_runner),
+        quit_closure_(quit_closure),
+        frame_sink_(nullptr),
+        begin_frame_source_(nullptr),
+        submitted_frames_(0),
+        acked_frames_(0),
+        returned_resources_(0) {}
+
+  void Bind(CompositorThreadFrameSink* frame_sink) {
+    frame_sink_ = frame_sink;
+    CHECK(frame_sink_->BindToClient(this));
+  }
+
+  void Unbind() {
+    frame_sink_->DetachFromClient();
+    frame_sink_ = nullptr;
+  }
+
+  int acked_frames() const { return acked_frames_; }
+  int returned_resources() const { return returned_resources_; }
+  base::TimeDelta total_latency() const { return total_latency_; }
+  base::TimeDelta max_latency() const { return max_latency_; }
+
+ private:
+  // cc::CompositorFrameSinkClient implementation
+  void SetBeginFrameSource(cc::BeginFrameSource* source) override {
+    if (begin_frame_source_) {
+      begin_frame_source_->RemoveObserver(this);
+    }
+    begin_frame_source_ = source;
+    if (begin_frame_source_) {
+      begin_frame_source_->AddObserver(this);
+    }
+  }
+
+  void ReclaimResources(const cc::ReturnedResourceArray& resources) override {
+    returned_resources_ += resources.size();
+  }
+
+  void DidReceiveCompositorFrameAck() override {
+    // Measured from when the begin frame was issued on the UI thread, so this
+    // covers a thread hop in each direction plus the ack
+    base::TimeDelta latency =
+        base::TimeTicks::Now() - pending_frame_times_.front();
+    pending_frame_times_.pop();
+
+    total_latency_ += latency;
+    max_latency_ = std::max(max_latency_, latency);
+
+    if (++acked_frames_ == kFrameCount) {
+      main_task_runner_->PostTask(FROM_HERE, quit_closure_);
+    }
+  }
+
+  // cc::BeginFrameObserverBase implementation
+  bool OnBeginFrameDerivedImpl(const cc::BeginFrameArgs& args) override {
+    if (submitted_frames_ == kFrameCount) {
+      return false;
+    }
+
+    cc::CompositorFrame frame;
+    for (int i = 0; i < resources_per_frame_; ++i) {
+      cc::TransferableResource resource;
+      resource.id = i + 1;
+      frame.resource_list.push_back(resource);
+    }
+
+    ++submitted_frames_;
+    pending_frame_times_.push(args.frame_time);
+    frame_sink_->SubmitCompositorFrame(std::move(frame));
+
+    return true;
+  }
+
+  void OnBeginFrameSourcePausedChanged(bool paused) override {}
+
+  int resources_per_frame_;
+  scoped_refptr<base::SingleThreadTaskRunner> main_task_runner_;
+  base::Closure quit_closure_;
+
+  CompositorThreadFrameSink* frame_sink_;
+  cc::BeginFrameSource* begin_frame_source_;
+
+  int submitted_frames_;
+  int acked_frames_;
+  int returned_resources_;
+
+  std::queue<base::TimeTicks> pending_frame_times_;
+  base::TimeDelta total_latency_;
+  base::TimeDelta max_latency_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestFrameSinkClient);
+};
+
+}
+
+class CompositorThreadProxyPerfTest : public testing::TestWithParam<int> {
+ protected:
+  base::MessageLoop message_loop_;
+};
+
+INSTANTIATE_TEST_CASE_P(Resources,
+                        CompositorThreadProxyPerfTest,
+                        testing::Values(0, 32, 256));
+
+// Measures frame timing on the threaded compositing path, from a begin frame
+// on the UI thread, through a frame submitted on the compositor thread and
+// drawn on the UI thread, to the ack arriving back on the compositor thread
+TEST_P(CompositorThreadProxyPerfTest, FrameTiming) {
+  const int resources_per_frame = GetParam();
+
+  base::Thread impl_thread("Oxide_CompositorThread");
+  ASSERT_TRUE(impl_thread.Start());
+
+  TestProxyClient proxy_client;
+  scoped_refptr<CompositorThreadProxy> proxy =
+      new CompositorThreadProxy(proxy_client.GetWeakPtr(),
+                                message_loop_.task_runner(),
+                                impl_thread.task_runner());
+  proxy_client.set_proxy(proxy);
+  proxy->SetBeginFrameSource(proxy_client.begin_frame_source());
+
+  std::unique_ptr<CompositorThreadFrameSink> frame_sink =
+      base::MakeUnique<CompositorThreadFrameSink>(1, proxy,
+                                                  nullptr, nullptr, nullptr);
+
+  base::RunLoop run_loop;
+  TestFrameSinkClient sink_client(resources_per_frame,
+                                  message_loop_.task_runner(),
+                                  run_loop.QuitClosure());
+
+  base::ElapsedTimer timer;
+  impl_thread.task_runner()->PostTask(
+      FROM_HERE,
+      base::Bind(&TestFrameSinkClient::Bind,
+                 base::Unretained(&sink_client),
+                 base::Unretained(frame_sink.get())));
+  run_loop.Run();
+  base::TimeDelta elapsed = timer.Elapsed();
+
+  impl_thread.task_runner()->PostTask(
+      FROM_HERE,
+      base::Bind(&TestFrameSinkClient::Unbind,
+                 base::Unretained(&sink_client)));
+  impl_thread.Stop();
+  base::RunLoop().RunUntilIdle();
+
+  proxy->Shutdown();
+
+  EXPECT_EQ(kFrameCount, sink_client.acked_frames());
+  EXPECT_EQ(kFrameCount * resources_per_frame,
+            sink_client.returned_resources());
+
+  std::string modifier = base::StringPrintf("_%d_resources",
+                                            resources_per_frame);
+  perf_test::PrintResult(
+      "compositor_thread_proxy", modifier, "mean_frame_latency",
+      sink_client.total_latency().InMicrosecondsF() / kFrameCount,
+      "us", true);
+  perf_test::PrintResult(
+      "compositor_thread_proxy", modifier, "max_frame_latency",
+      sink_client.max_latency().InMicrosecondsF(), "us", true);
+  perf_test::PrintResult(
+      "compositor_thread_proxy", modifier, "frame_rate",
+      kFrameCount / elapsed.InSecondsF(), "frames/s", true);
+}
+
+} // namespace oxide
@@ -21,12 +21,15 @@
 
 #include "base/auto_reset.h"
 #include "base/bind.h"
+#include "base/command_line.h"
 #include "base/containers/hash_tables.h"
 #include "base/logging.h"
 #include "base/memory/singleton.h"
 #include "base/message_loop/message_loop.h"
 #include "base/single_thread_task_runner.h"
 #include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "base/threading/thread_restrictions.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "cc/output/context_provider.h"
 #include "cc/raster/single_thread_task_graph_runner.h"
@@ -43,6 +46,7 @@
 #include "ui/gl/gl_switches.h"
 
 #include "shared/browser/oxide_browser_platform_integration.h"
+#include "shared/common/oxide_constants.h"
 #include "shared/common/oxide_id_allocator.h"
 
 #include "oxide_compositor_frame_handle.h"
@@ -155,6 +159,8 @@ class CompositorUtilsImpl : public CompositorUtils,
   cc::TaskGraphRunner* GetTaskGraphRunner() const override;
   cc::SurfaceManager* GetSurfaceManager() const override;
   cc::FrameSinkId AllocateFrameSinkId() override;
+  scoped_refptr<base::SingleThreadTaskRunner>
+      GetCompositorTaskRunner() const override;
 
   bool CalledOnMainThread() const;
   bool CalledOnGpuThread() const;
@@ -211,6 +217,7 @@ class CompositorUtilsImpl : public CompositorUtils,
 
   struct MainData {
     std::unique_ptr<cc::SingleThreadTaskGraphRunner> task_graph_runner;
+    std::unique_ptr<base::Thread> compositor_thread;
   } main_unsafe_access_;
 
   struct GpuData {
@@ -452,6 +459,12 @@ void CompositorUtilsImpl::Initialize(bool has_share_context) {
   main().task_graph_runner->Start("CompositorTileWorker1",
                                   base::SimpleThread::Options());
 
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableThreadedBrowserCompositor)) {
+    main().compositor_thread.reset(new base::Thread("Oxide_CompositorThread"));
+    CHECK(main().compositor_thread->Start());
+  }
+
   scoped_refptr<gpu::GpuChannelHost> gpu_channel_host(
       content::BrowserGpuChannelHostFactory::instance()->EstablishGpuChannelSync());
   if (gpu_channel_host.get()) {
@@ -465,6 +478,13 @@ void CompositorUtilsImpl::Initialize(bool has_share_context) {
 }
 
 void CompositorUtilsImpl::Shutdown() {
+  if (main().compositor_thread) {
+    // All compositors have been destroyed by now, so this just waits for
+    // their impl-side objects to be deleted
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    main().compositor_thread.reset();
+  }
+
   main().task_graph_runner->Shutdown();
   main().task_graph_runner.reset();
 
@@ -601,6 +621,15 @@ cc::FrameSinkId CompositorUtilsImpl::AllocateFrameSinkId() {
   return content::AllocateFrameSinkId();
 }
 
+scoped_refptr<base::SingleThreadTaskRunner>
+CompositorUtilsImpl::GetCompositorTaskRunner() const {
+  if (!main().compositor_thread) {
+    return nullptr;
+  }
+
+  return main().compositor_thread->task_runner();
+}
+
 bool CompositorUtilsImpl::CalledOnMainThread() const {
   return main_thread_checker_.CalledOnValidThread();
 }
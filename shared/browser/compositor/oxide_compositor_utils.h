@@ -93,6 +93,12 @@ class CompositorUtils {
 
   virtual cc::FrameSinkId AllocateFrameSinkId() = 0;
 
+  // Return the task runner for the thread that runs the impl side of browser
+  // compositors in threaded compositing mode, or null if threaded compositing
+  // is not enabled
+  virtual scoped_refptr<base::SingleThreadTaskRunner>
+      GetCompositorTaskRunner() const = 0;
+
  protected:
   virtual ~CompositorUtils();
 };
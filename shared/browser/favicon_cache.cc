@@ -0,0 +1,476 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#include "favicon_cache.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/pickle.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/string_piece.h"
+#include "base/time/time.h"
+#include "url/gurl.h"
+
+namespace oxide {
+
+namespace {
+
+const int kCurrentVersion = 1;
+
+const int kCommitIntervalSeconds = 10;
+
+// Upper bounds used when reading from disk, to avoid allocating large
+// amounts of memory for a corrupt file
+const int kMaxBitmapsPerIcon = 16;
+const int kMaxBitmapDimension = 1024;
+
+}
+
+FaviconCache::Bitmap::Bitmap() {}
+
+FaviconCache::Bitmap::Bitmap(const gfx::Size& size,
+                             const std::vector<unsigned char>& png_data)
+    : size(size),
+      png_data(png_data) {}
+
+FaviconCache::Bitmap::Bitmap(const Bitmap& other) = default;
+
+FaviconCache::Bitmap::~Bitmap() {}
+
+FaviconCache::IconEntry::IconEntry() {}
+
+FaviconCache::IconEntry::IconEntry(const IconEntry& other) = default;
+
+FaviconCache::IconEntry::~IconEntry() {}
+
+FaviconCache::~FaviconCache() {}
+
+void FaviconCache::TouchIconLocked(IconEntry* entry) {
+  lock_.AssertAcquired();
+  icon_use_list_.splice(icon_use_list_.end(),
+                        icon_use_list_,
+                        entry->use_position);
+}
+
+void FaviconCache::TouchPageLocked(PageEntry* entry) {
+  lock_.AssertAcquired();
+  page_use_list_.splice(page_use_list_.end(),
+                        page_use_list_,
+                        entry->use_position);
+}
+
+void FaviconCache::RemovePageLocked(const std::string& page_url) {
+  lock_.AssertAcquired();
+
+  auto page = pages_.find(page_url);
+  DCHECK(page != pages_.end());
+
+  auto icon = icons_.find(page->second.icon_url);
+  if (icon != icons_.end()) {
+    icon->second.pages.erase(page_url);
+  }
+
+  page_use_list_.erase(page->second.use_position);
+  pages_.erase(page);
+}
+
+void FaviconCache::RemoveIconLocked(const std::string& icon_url) {
+  lock_.AssertAcquired();
+
+  auto icon = icons_.find(icon_url);
+  DCHECK(icon != icons_.end());
+
+  for (const auto& page_url : icon->second.pages) {
+    auto page = pages_.find(page_url);
+    DCHECK(page != pages_.end());
+    page_use_list_.erase(page->second.use_position);
+    pages_.erase(page);
+  }
+
+  icon_use_list_.erase(icon->second.use_position);
+  icons_.erase(icon);
+}
+
+void FaviconCache::EvictIconsLocked() {
+  lock_.AssertAcquired();
+
+  while (icons_.size() > max_icons_) {
+    // Copy the key, as RemoveIconLocked destroys the list node
+    std::string icon_url = icon_use_list_.front();
+    RemoveIconLocked(icon_url);
+  }
+}
+
+void FaviconCache::EvictPagesLocked() {
+  lock_.AssertAcquired();
+
+  while (pages_.size() > max_pages_) {
+    std::string page_url = page_use_list_.front();
+    RemovePageLocked(page_url);
+  }
+}
+
+void FaviconCache::ScheduleCommitLocked() {
+  lock_.AssertAcquired();
+
+  if (!file_task_runner_ || commit_pending_) {
+    return;
+  }
+
+  commit_pending_ = true;
+  file_task_runner_->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&FaviconCache::Commit, this),
+      base::TimeDelta::FromSeconds(kCommitIntervalSeconds));
+}
+
+void FaviconCache::Load(const base::FilePath& path) {
+  DCHECK(file_task_runner_->RunsTasksOnCurrentThread());
+
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents)) {
+    return;
+  }
+
+  base::Pickle pickle(contents.data(), contents.size());
+
+  base::AutoLock lock(lock_);
+  MergeLoadedDataLocked(&pickle);
+}
+
+void FaviconCache::MergeLoadedDataLocked(base::Pickle* pickle) {
+  lock_.AssertAcquired();
+
+  base::PickleIterator iter(*pickle);
+
+  int version = 0;
+  if (!iter.ReadInt(&version) || version != kCurrentVersion) {
+    return;
+  }
+
+  int icon_count = 0;
+  if (!iter.ReadInt(&icon_count) || icon_count < 0) {
+    return;
+  }
+
+  // Entries are written least recently used first. They're inserted in that
+  // order ahead of any entries that were added before the load finished, so
+  // that the loaded entries are the first to be evicted
+  auto icons_insert_position = icon_use_list_.begin();
+  auto pages_insert_position = page_use_list_.begin();
+
+  for (int i = 0; i < icon_count; ++i) {
+    std::string icon_url;
+    int bitmap_count = 0;
+    if (!iter.ReadString(&icon_url) ||
+        !iter.ReadInt(&bitmap_count) ||
+        bitmap_count < 0 || bitmap_count > kMaxBitmapsPerIcon) {
+      return;
+    }
+
+    IconEntry entry;
+    for (int j = 0; j < bitmap_count; ++j) {
+      int width = 0;
+      int height = 0;
+      const char* data = nullptr;
+      int length = 0;
+      if (!iter.ReadInt(&width) || !iter.ReadInt(&height) ||
+          !iter.ReadData(&data, &length)) {
+        return;
+      }
+      if (width <= 0 || width > kMaxBitmapDimension ||
+          height <= 0 || height > kMaxBitmapDimension) {
+        continue;
+      }
+      entry.bitmaps.push_back(
+          Bitmap(gfx::Size(width, height),
+                 std::vector<unsigned char>(data, data + length)));
+    }
+
+    if (entry.bitmaps.empty() || icons_.find(icon_url) != icons_.end()) {
+      continue;
+    }
+
+    entry.use_position =
+        icon_use_list_.insert(icons_insert_position, icon_url);
+    icons_[icon_url] = entry;
+  }
+
+  int page_count = 0;
+  if (!iter.ReadInt(&page_count) || page_count < 0) {
+    return;
+  }
+
+  for (int i = 0; i < page_count; ++i) {
+    std::string page_url;
+    PageEntry entry;
+    if (!iter.ReadString(&page_url) || !iter.ReadString(&entry.icon_url)) {
+      return;
+    }
+
+    if (pages_.find(page_url) != pages_.end()) {
+      continue;
+    }
+
+    auto icon = icons_.find(entry.icon_url);
+    if (icon == icons_.end()) {
+      continue;
+    }
+
+    icon->second.pages.insert(page_url);
+    entry.use_position =
+        page_use_list_.insert(pages_insert_position, page_url);
+    pages_[page_url] = entry;
+  }
+
+  EvictIconsLocked();
+  EvictPagesLocked();
+}
+
+void FaviconCache::Commit() {
+  DCHECK(file_task_runner_->RunsTasksOnCurrentThread());
+
+  // Take a copy of the entries and serialize them without holding |lock_|,
+  // so that writing a large cache doesn't block other threads
+  std::vector<std::pair<std::string, std::vector<Bitmap>>> icons;
+  std::vector<std::pair<std::string, std::string>> pages;
+
+  {
+    base::AutoLock lock(lock_);
+    if (!commit_pending_) {
+      return;
+    }
+    commit_pending_ = false;
+
+    icons.reserve(icon_use_list_.size());
+    for (const auto& icon_url : icon_use_list_) {
+      icons.push_back(std::make_pair(icon_url, icons_.at(icon_url).bitmaps));
+    }
+
+    pages.reserve(page_use_list_.size());
+    for (const auto& page_url : page_use_list_) {
+      pages.push_back(std::make_pair(page_url, pages_.at(page_url).icon_url));
+    }
+  }
+
+  base::Pickle pickle;
+
+  pickle.WriteInt(kCurrentVersion);
+  pickle.WriteInt(static_cast<int>(icons.size()));
+  for (const auto& icon : icons) {
+    pickle.WriteString(icon.first);
+    pickle.WriteInt(static_cast<int>(icon.second.size()));
+    for (const auto& bitmap : icon.second) {
+      pickle.WriteInt(bitmap.size.width());
+      pickle.WriteInt(bitmap.size.height());
+      pickle.WriteData(
+          reinterpret_cast<const char*>(bitmap.png_data.data()),
+          static_cast<int>(bitmap.png_data.size()));
+    }
+  }
+
+  pickle.WriteInt(static_cast<int>(pages.size()));
+  for (const auto& page : pages) {
+    pickle.WriteString(page.first);
+    pickle.WriteString(page.second);
+  }
+
+  if (!base::ImportantFileWriter::WriteFileAtomically(
+          path_,
+          base::StringPiece(static_cast<const char*>(pickle.data()),
+                            pickle.size()))) {
+    LOG(WARNING) << "Failed to write favicon cache to " << path_.value();
+  }
+}
+
+FaviconCache::FaviconCache(size_t max_icons, size_t max_pages)
+    : max_icons_(max_icons),
+      max_pages_(max_pages),
+      commit_pending_(false) {
+  DCHECK_GT(max_icons_, 0U);
+  DCHECK_GT(max_pages_, 0U);
+}
+
+void FaviconCache::EnablePersistence(
+    const base::FilePath& path,
+    scoped_refptr<base::SequencedTaskRunner> file_task_runner) {
+  DCHECK(!path.empty());
+  DCHECK(file_task_runner);
+
+  base::AutoLock lock(lock_);
+  DCHECK(!file_task_runner_);
+
+  path_ = path;
+  file_task_runner_ = file_task_runner;
+
+  file_task_runner_->PostTask(FROM_HERE,
+                              base::Bind(&FaviconCache::Load, this, path));
+
+  if (!icons_.empty()) {
+    ScheduleCommitLocked();
+  }
+}
+
+void FaviconCache::Flush() {
+  base::AutoLock lock(lock_);
+  if (!commit_pending_) {
+    return;
+  }
+
+  file_task_runner_->PostTask(FROM_HERE,
+                              base::Bind(&FaviconCache::Commit, this));
+}
+
+bool FaviconCache::SetIconForPage(const GURL& page_url, const GURL& icon_url) {
+  base::AutoLock lock(lock_);
+
+  auto icon = icons_.find(icon_url.spec());
+  if (icon == icons_.end()) {
+    return false;
+  }
+
+  TouchIconLocked(&icon->second);
+
+  auto page = pages_.find(page_url.spec());
+  if (page != pages_.end()) {
+    TouchPageLocked(&page->second);
+    if (page->second.icon_url == icon_url.spec()) {
+      return true;
+    }
+
+    auto old_icon = icons_.find(page->second.icon_url);
+    DCHECK(old_icon != icons_.end());
+    old_icon->second.pages.erase(page_url.spec());
+  } else {
+    page = pages_.insert(std::make_pair(page_url.spec(), PageEntry())).first;
+    page->second.use_position =
+        page_use_list_.insert(page_use_list_.end(), page_url.spec());
+  }
+
+  page->second.icon_url = icon_url.spec();
+  icon->second.pages.insert(page_url.spec());
+
+  EvictPagesLocked();
+  ScheduleCommitLocked();
+
+  return true;
+}
+
+void FaviconCache::SetBitmapsForIcon(const GURL& icon_url,
+                                     const std::vector<Bitmap>& bitmaps) {
+  DCHECK(!bitmaps.empty());
+
+  base::AutoLock lock(lock_);
+
+  auto icon = icons_.find(icon_url.spec());
+  if (icon != icons_.end()) {
+    TouchIconLocked(&icon->second);
+  } else {
+    icon = icons_.insert(std::make_pair(icon_url.spec(), IconEntry())).first;
+    icon->second.use_position =
+        icon_use_list_.insert(icon_use_list_.end(), icon_url.spec());
+  }
+
+  icon->second.bitmaps = bitmaps;
+
+  EvictIconsLocked();
+  ScheduleCommitLocked();
+}
+
+bool FaviconCache::HasIcon(const GURL& icon_url) const {
+  base::AutoLock lock(lock_);
+  return icons_.find(icon_url.spec()) != icons_.end();
+}
+
+bool FaviconCache::GetBitmapForPage(const GURL& page_url,
+                                    int desired_size,
+                                    Bitmap* bitmap) {
+  DCHECK(bitmap);
+
+  base::AutoLock lock(lock_);
+
+  auto page = pages_.find(page_url.spec());
+  if (page == pages_.end()) {
+    return false;
+  }
+
+  auto icon = icons_.find(page->second.icon_url);
+  DCHECK(icon != icons_.end());
+
+  TouchPageLocked(&page->second);
+  TouchIconLocked(&icon->second);
+
+  const Bitmap* best = nullptr;
+  const Bitmap* largest = nullptr;
+  for (const auto& candidate : icon->second.bitmaps) {
+    int width = candidate.size.width();
+    if (!largest || width > largest->size.width()) {
+      largest = &candidate;
+    }
+    if (desired_size > 0 && width >= desired_size &&
+        (!best || width < best->size.width())) {
+      best = &candidate;
+    }
+  }
+
+  *bitmap = best ? *best : *largest;
+  return true;
+}
+
+void FaviconCache::Clear() {
+  base::AutoLock lock(lock_);
+
+  if (icons_.empty() && pages_.empty()) {
+    return;
+  }
+
+  icons_.clear();
+  pages_.clear();
+  icon_use_list_.clear();
+  page_use_list_.clear();
+
+  ScheduleCommitLocked();
+}
+
+size_t FaviconCache::icon_count() const {
+  base::AutoLock lock(lock_);
+  return icons_.size();
+}
+
+size_t FaviconCache::page_count() const {
+  base::AutoLock lock(lock_);
+  return pages_.size();
+}
+
+size_t FaviconCache::GetBitmapDataSize() const {
+  base::AutoLock lock(lock_);
+
+  size_t size = 0;
+  for (const auto& icon : icons_) {
+    for (const auto& bitmap : icon.second.bitmaps) {
+      size += bitmap.png_data.size();
+    }
+  }
+
+  return size;
+}
+
+} // namespace oxide
@@ -0,0 +1,169 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#ifndef _OXIDE_SHARED_BROWSER_FAVICON_CACHE_H_
+#define _OXIDE_SHARED_BROWSER_FAVICON_CACHE_H_
+
+#include <list>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "ui/gfx/geometry/size.h"
+
+#include "shared/common/oxide_shared_export.h"
+
+class GURL;
+
+namespace base {
+class Pickle;
+class SequencedTaskRunner;
+}
+
+namespace oxide {
+
+// A thread-safe store of PNG encoded favicons, keyed by icon URL, and a
+// mapping of page URL to icon URL. Each icon can have several bitmaps of
+// different sizes. The number of icons and pages is bounded, with the least
+// recently used entries being evicted first.
+//
+// If a path is provided, the contents are loaded from and periodically
+// written to disk on the provided task runner. All other methods can be
+// called from any thread
+class OXIDE_SHARED_EXPORT FaviconCache
+    : public base::RefCountedThreadSafe<FaviconCache> {
+ public:
+  struct Bitmap {
+    Bitmap();
+    Bitmap(const gfx::Size& size, const std::vector<unsigned char>& png_data);
+    Bitmap(const Bitmap& other);
+    ~Bitmap();
+
+    gfx::Size size;
+    std::vector<unsigned char> png_data;
+  };
+
+  FaviconCache(size_t max_icons, size_t max_pages);
+
+  // Start loading the cache from |path|, and enable writing changes back to
+  // it. Entries loaded from disk never replace entries that have been added
+  // since this was called
+  void EnablePersistence(
+      const base::FilePath& path,
+      scoped_refptr<base::SequencedTaskRunner> file_task_runner);
+
+  // Write any pending changes to disk immediately, on the file task runner
+  void Flush();
+
+  // Associate |page_url| with |icon_url|. Returns false if there are no
+  // bitmaps for |icon_url|, in which case nothing is recorded
+  bool SetIconForPage(const GURL& page_url, const GURL& icon_url);
+
+  // Store |bitmaps| for |icon_url|, replacing any existing bitmaps
+  void SetBitmapsForIcon(const GURL& icon_url,
+                         const std::vector<Bitmap>& bitmaps);
+
+  bool HasIcon(const GURL& icon_url) const;
+
+  // Find the most appropriate bitmap for |page_url|. This is the smallest
+  // bitmap that is at least |desired_size| pixels wide, or the largest
+  // bitmap if none are big enough. If |desired_size| is <= 0, the largest
+  // bitmap is returned
+  bool GetBitmapForPage(const GURL& page_url,
+                        int desired_size,
+                        Bitmap* bitmap);
+
+  void Clear();
+
+  size_t icon_count() const;
+  size_t page_count() const;
+
+  // The total size of the PNG data held for all icons
+  size_t GetBitmapDataSize() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<FaviconCache>;
+
+  typedef std::list<std::string> UseList;
+
+  struct IconEntry {
+    IconEntry();
+    IconEntry(const IconEntry& other);
+    ~IconEntry();
+
+    std::vector<Bitmap> bitmaps;
+
+    // The pages that use this icon, so that they can be dropped without a
+    // scan of |pages_| when the icon is evicted
+    std::set<std::string> pages;
+
+    // This entry's position in |icon_use_list_|
+    UseList::iterator use_position;
+  };
+
+  struct PageEntry {
+    std::string icon_url;
+
+    // This entry's position in |page_use_list_|
+    UseList::iterator use_position;
+  };
+
+  ~FaviconCache();
+
+  void TouchIconLocked(IconEntry* entry);
+  void TouchPageLocked(PageEntry* entry);
+
+  void RemovePageLocked(const std::string& page_url);
+  void RemoveIconLocked(const std::string& icon_url);
+
+  void EvictIconsLocked();
+  void EvictPagesLocked();
+
+  void ScheduleCommitLocked();
+
+  void Load(const base::FilePath& path);
+  void MergeLoadedDataLocked(base::Pickle* pickle);
+  void Commit();
+
+  size_t max_icons_;
+  size_t max_pages_;
+
+  mutable base::Lock lock_;
+
+  std::unordered_map<std::string, IconEntry> icons_;
+  std::unordered_map<std::string, PageEntry> pages_;
+
+  // The keys of |icons_| and |pages_|, ordered from least to most recently
+  // used. Eviction takes entries from the front
+  UseList icon_use_list_;
+  UseList page_use_list_;
+
+  // Only set when persistence is enabled
+  base::FilePath path_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  bool commit_pending_;
+
+  DISALLOW_COPY_AND_ASSIGN(FaviconCache);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_FAVICON_CACHE_H_
@@ -0,0 +1,196 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/ref_counted.h"
+#include "base/test/test_simple_task_runner.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+#include "favicon_cache.h"
+
+namespace oxide {
+
+namespace {
+
+std::vector<FaviconCache::Bitmap> MakeBitmaps(
+    const std::vector<int>& sizes) {
+  std::vector<FaviconCache::Bitmap> bitmaps;
+  for (int size : sizes) {
+    bitmaps.push_back(
+        FaviconCache::Bitmap(gfx::Size(size, size),
+                             std::vector<unsigned char>(1, size)));
+  }
+  return bitmaps;
+}
+
+}
+
+TEST(FaviconCacheTest, SelectsBestSize) {
+  scoped_refptr<FaviconCache> cache(new FaviconCache(10, 10));
+
+  GURL page_url("https://www.example.com/");
+  GURL icon_url("https://www.example.com/favicon.ico");
+
+  EXPECT_FALSE(cache->SetIconForPage(page_url, icon_url));
+
+  cache->SetBitmapsForIcon(icon_url, MakeBitmaps({16, 64, 32}));
+  EXPECT_TRUE(cache->SetIconForPage(page_url, icon_url));
+
+  FaviconCache::Bitmap bitmap;
+  ASSERT_TRUE(cache->GetBitmapForPage(page_url, 24, &bitmap));
+  EXPECT_EQ(32, bitmap.size.width());
+
+  ASSERT_TRUE(cache->GetBitmapForPage(page_url, 16, &bitmap));
+  EXPECT_EQ(16, bitmap.size.width());
+
+  ASSERT_TRUE(cache->GetBitmapForPage(page_url, 128, &bitmap));
+  EXPECT_EQ(64, bitmap.size.width());
+
+  ASSERT_TRUE(cache->GetBitmapForPage(page_url, 0, &bitmap));
+  EXPECT_EQ(64, bitmap.size.width());
+
+  EXPECT_FALSE(cache->GetBitmapForPage(GURL("https://www.google.com/"), 16,
+                                       &bitmap));
+}
+
+TEST(FaviconCacheTest, BitmapDataSize) {
+  scoped_refptr<FaviconCache> cache(new FaviconCache(1, 10));
+
+  EXPECT_EQ(0U, cache->GetBitmapDataSize());
+
+  cache->SetBitmapsForIcon(GURL("https://www.example.com/1.ico"),
+                           MakeBitmaps({16, 32}));
+  EXPECT_EQ(2U, cache->GetBitmapDataSize());
+
+  // The cache holds a single icon, so this evicts the first one
+  cache->SetBitmapsForIcon(GURL("https://www.example.com/2.ico"),
+                           MakeBitmaps({16, 32, 64}));
+  EXPECT_EQ(3U, cache->GetBitmapDataSize());
+
+  cache->Clear();
+  EXPECT_EQ(0U, cache->GetBitmapDataSize());
+}
+
+TEST(FaviconCacheTest, EvictsLeastRecentlyUsed) {
+  scoped_refptr<FaviconCache> cache(new FaviconCache(2, 10));
+
+  GURL icon1("https://www.example.com/1.ico");
+  GURL icon2("https://www.example.com/2.ico");
+  GURL icon3("https://www.example.com/3.ico");
+  GURL page1("https://www.example.com/1");
+  GURL page2("https://www.example.com/2");
+
+  cache->SetBitmapsForIcon(icon1, MakeBitmaps({16}));
+  cache->SetBitmapsForIcon(icon2, MakeBitmaps({16}));
+  EXPECT_TRUE(cache->SetIconForPage(page1, icon1));
+  EXPECT_TRUE(cache->SetIconForPage(page2, icon2));
+
+  // Use |icon1| so that |icon2| is evicted when |icon3| is added
+  FaviconCache::Bitmap bitmap;
+  EXPECT_TRUE(cache->GetBitmapForPage(page1, 16, &bitmap));
+
+  cache->SetBitmapsForIcon(icon3, MakeBitmaps({16}));
+  EXPECT_EQ(2U, cache->icon_count());
+  EXPECT_TRUE(cache->HasIcon(icon1));
+  EXPECT_FALSE(cache->HasIcon(icon2));
+  EXPECT_TRUE(cache->HasIcon(icon3));
+
+  // Pages referring to an evicted icon are removed
+  EXPECT_EQ(1U, cache->page_count());
+  EXPECT_FALSE(cache->GetBitmapForPage(page2, 16, &bitmap));
+}
+
+TEST(FaviconCacheTest, ReassignedPageIsNotEvictedWithOldIcon) {
+  scoped_refptr<FaviconCache> cache(new FaviconCache(2, 10));
+
+  GURL icon1("https://www.example.com/1.ico");
+  GURL icon2("https://www.example.com/2.ico");
+  GURL icon3("https://www.example.com/3.ico");
+  GURL page("https://www.example.com/");
+
+  cache->SetBitmapsForIcon(icon1, MakeBitmaps({16}));
+  EXPECT_TRUE(cache->SetIconForPage(page, icon1));
+
+  cache->SetBitmapsForIcon(icon2, MakeBitmaps({32}));
+  EXPECT_TRUE(cache->SetIconForPage(page, icon2));
+
+  // |icon1| is the least recently used, and no longer has any pages
+  cache->SetBitmapsForIcon(icon3, MakeBitmaps({16}));
+  EXPECT_FALSE(cache->HasIcon(icon1));
+  EXPECT_EQ(1U, cache->page_count());
+
+  FaviconCache::Bitmap bitmap;
+  ASSERT_TRUE(cache->GetBitmapForPage(page, 16, &bitmap));
+  EXPECT_EQ(32, bitmap.size.width());
+}
+
+TEST(FaviconCacheTest, EvictsLeastRecentlyUsedPages) {
+  scoped_refptr<FaviconCache> cache(new FaviconCache(10, 2));
+
+  GURL icon("https://www.example.com/favicon.ico");
+  GURL page1("https://www.example.com/1");
+  GURL page2("https://www.example.com/2");
+  GURL page3("https://www.example.com/3");
+
+  cache->SetBitmapsForIcon(icon, MakeBitmaps({16}));
+  EXPECT_TRUE(cache->SetIconForPage(page1, icon));
+  EXPECT_TRUE(cache->SetIconForPage(page2, icon));
+
+  FaviconCache::Bitmap bitmap;
+  EXPECT_TRUE(cache->GetBitmapForPage(page1, 16, &bitmap));
+
+  EXPECT_TRUE(cache->SetIconForPage(page3, icon));
+  EXPECT_EQ(2U, cache->page_count());
+  EXPECT_TRUE(cache->GetBitmapForPage(page1, 16, &bitmap));
+  EXPECT_FALSE(cache->GetBitmapForPage(page2, 16, &bitmap));
+  EXPECT_TRUE(cache->GetBitmapForPage(page3, 16, &bitmap));
+}
+
+TEST(FaviconCacheTest, Persistence) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.GetPath().Append("Favicons");
+
+  scoped_refptr<base::TestSimpleTaskRunner> task_runner(
+      new base::TestSimpleTaskRunner());
+
+  GURL page_url("https://www.example.com/");
+  GURL icon_url("https://www.example.com/favicon.ico");
+
+  scoped_refptr<FaviconCache> cache(new FaviconCache(10, 10));
+  cache->EnablePersistence(path, task_runner);
+  cache->SetBitmapsForIcon(icon_url, MakeBitmaps({16, 32}));
+  EXPECT_TRUE(cache->SetIconForPage(page_url, icon_url));
+  task_runner->RunPendingTasks();
+  EXPECT_TRUE(base::PathExists(path));
+
+  cache = new FaviconCache(10, 10);
+  FaviconCache::Bitmap bitmap;
+  EXPECT_FALSE(cache->GetBitmapForPage(page_url, 16, &bitmap));
+
+  cache->EnablePersistence(path, task_runner);
+  task_runner->RunPendingTasks();
+
+  ASSERT_TRUE(cache->GetBitmapForPage(page_url, 32, &bitmap));
+  EXPECT_EQ(32, bitmap.size.width());
+  EXPECT_EQ(std::vector<unsigned char>(1, 32), bitmap.png_data);
+}
+
+} // namespace oxide
@@ -0,0 +1,354 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#include "favicon_service.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/lazy_instance.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "base/memory/singleton.h"
+#include "base/synchronization/lock.h"
+#include "components/keyed_service/content/browser_context_dependency_manager.h"
+#include "components/keyed_service/content/browser_context_keyed_service_factory.h"
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/web_contents.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/codec/png_codec.h"
+#include "ui/gfx/geometry/size.h"
+
+namespace oxide {
+
+namespace {
+
+const base::FilePath::CharType kFaviconsFilename[] =
+    FILE_PATH_LITERAL("Favicons");
+
+const size_t kMaxIcons = 500;
+const size_t kMaxPages = 2000;
+
+// Larger bitmaps are scaled down in the renderer before they are returned
+const uint32_t kMaxBitmapSize = 128;
+
+struct CacheRegistry {
+  base::Lock lock;
+  std::vector<scoped_refptr<FaviconCache>> caches;
+};
+
+base::LazyInstance<CacheRegistry> g_cache_registry = LAZY_INSTANCE_INITIALIZER;
+
+void EncodeBitmaps(const std::vector<SkBitmap>& bitmaps,
+                   std::vector<FaviconCache::Bitmap>* encoded) {
+  for (const auto& bitmap : bitmaps) {
+    FaviconCache::Bitmap result;
+    if (!gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false,
+                                           &result.png_data)) {
+      continue;
+    }
+    result.size = gfx::Size(bitmap.width(), bitmap.height());
+    encoded->push_back(result);
+  }
+}
+
+}
+
+class FaviconService::WebContentsTracker
+    : public content::WebContentsObserver {
+ public:
+  WebContentsTracker(FaviconService* service, content::WebContents* contents)
+      : content::WebContentsObserver(contents),
+        service_(service) {}
+  ~WebContentsTracker() override {}
+
+ private:
+  // content::WebContentsObserver implementation
+  void WebContentsDestroyed() override {
+    // This deletes |this|
+    service_->OnWebContentsDestroyed(web_contents());
+  }
+
+  FaviconService* service_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebContentsTracker);
+};
+
+class FaviconServiceFactory : public BrowserContextKeyedServiceFactory {
+ public:
+  static FaviconServiceFactory* GetInstance();
+  static FaviconService* GetForContext(content::BrowserContext* context);
+
+ private:
+  friend struct base::DefaultSingletonTraits<FaviconServiceFactory>;
+
+  FaviconServiceFactory();
+  ~FaviconServiceFactory() override;
+
+  // BrowserContextKeyedServiceFactory implementation
+  KeyedService* BuildServiceInstanceFor(
+      content::BrowserContext* context) const override;
+  content::BrowserContext* GetBrowserContextToUse(
+      content::BrowserContext* context) const override;
+
+  DISALLOW_COPY_AND_ASSIGN(FaviconServiceFactory);
+};
+
+FaviconServiceFactory::FaviconServiceFactory()
+    : BrowserContextKeyedServiceFactory(
+        "FaviconService",
+        BrowserContextDependencyManager::GetInstance()) {}
+
+FaviconServiceFactory::~FaviconServiceFactory() {}
+
+KeyedService* FaviconServiceFactory::BuildServiceInstanceFor(
+    content::BrowserContext* context) const {
+  return new FaviconService(context);
+}
+
+content::BrowserContext* FaviconServiceFactory::GetBrowserContextToUse(
+    content::BrowserContext* context) const {
+  // Off the record contexts get their own in-memory cache, so that icons for
+  // pages visited in them aren't written to disk
+  return context;
+}
+
+// static
+FaviconServiceFactory* FaviconServiceFactory::GetInstance() {
+  return base::Singleton<FaviconServiceFactory>::get();
+}
+
+// static
+FaviconService* FaviconServiceFactory::GetForContext(
+    content::BrowserContext* context) {
+  return static_cast<FaviconService*>(
+      GetInstance()->GetServiceForBrowserContext(context, true));
+}
+
+FaviconService::PendingDownload::PendingDownload()
+    : contents(nullptr) {}
+
+FaviconService::PendingDownload::PendingDownload(
+    const PendingDownload& other) = default;
+
+FaviconService::PendingDownload::~PendingDownload() {}
+
+FaviconService::FaviconService(content::BrowserContext* context)
+    : cache_(new FaviconCache(kMaxIcons, kMaxPages)),
+      registered_(!context->IsOffTheRecord()),
+      weak_ptr_factory_(this) {
+  if (!registered_) {
+    // Icons for pages visited in an off the record context shouldn't be
+    // visible outside of it
+    return;
+  }
+
+  if (!context->GetPath().empty()) {
+    cache_->EnablePersistence(
+        context->GetPath().Append(kFaviconsFilename),
+        content::BrowserThread::GetTaskRunnerForThread(
+            content::BrowserThread::FILE));
+  }
+
+  CacheRegistry& registry = g_cache_registry.Get();
+  base::AutoLock lock(registry.lock);
+  registry.caches.push_back(cache_);
+}
+
+FaviconService::~FaviconService() {}
+
+void FaviconService::OnWebContentsDestroyed(content::WebContents* contents) {
+  for (auto it = pending_downloads_.begin();
+       it != pending_downloads_.end();) {
+    if (it->second.contents == contents) {
+      it = pending_downloads_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  trackers_.erase(contents);
+}
+
+void FaviconService::MaybeStopTrackingWebContents(
+    content::WebContents* contents) {
+  for (const auto& download : pending_downloads_) {
+    if (download.second.contents == contents) {
+      return;
+    }
+  }
+
+  trackers_.erase(contents);
+}
+
+void FaviconService::OnDownloadFinished(
+    int id,
+    int http_status_code,
+    const GURL& image_url,
+    const std::vector<SkBitmap>& bitmaps,
+    const std::vector<gfx::Size>& original_sizes) {
+  auto it = pending_downloads_.find(image_url);
+  if (it == pending_downloads_.end()) {
+    return;
+  }
+
+  content::WebContents* contents = it->second.contents;
+  it->second.contents = nullptr;
+  MaybeStopTrackingWebContents(contents);
+
+  if (bitmaps.empty()) {
+    pending_downloads_.erase(it);
+    return;
+  }
+
+  std::vector<FaviconCache::Bitmap>* encoded =
+      new std::vector<FaviconCache::Bitmap>();
+  content::BrowserThread::PostBlockingPoolTaskAndReply(
+      FROM_HERE,
+      base::Bind(&EncodeBitmaps, bitmaps, encoded),
+      base::Bind(&FaviconService::OnBitmapsEncoded,
+                 weak_ptr_factory_.GetWeakPtr(),
+                 image_url, base::Owned(encoded)));
+}
+
+void FaviconService::OnBitmapsEncoded(
+    const GURL& icon_url,
+    const std::vector<FaviconCache::Bitmap>* bitmaps) {
+  auto it = pending_downloads_.find(icon_url);
+  if (it == pending_downloads_.end()) {
+    return;
+  }
+
+  DCHECK(!it->second.contents);
+
+  std::set<GURL> pages;
+  std::swap(pages, it->second.pages);
+  pending_downloads_.erase(it);
+
+  if (bitmaps->empty()) {
+    return;
+  }
+
+  cache_->SetBitmapsForIcon(icon_url, *bitmaps);
+  for (const auto& page_url : pages) {
+    if (!cache_->SetIconForPage(page_url, icon_url)) {
+      // The icon was evicted straight away
+      continue;
+    }
+
+    for (auto& observer : observers_) {
+      observer.OnFaviconCached(page_url, icon_url);
+    }
+  }
+}
+
+void FaviconService::Shutdown() {
+  weak_ptr_factory_.InvalidateWeakPtrs();
+  pending_downloads_.clear();
+  trackers_.clear();
+
+  if (!registered_) {
+    return;
+  }
+
+  cache_->Flush();
+
+  CacheRegistry& registry = g_cache_registry.Get();
+  base::AutoLock lock(registry.lock);
+  registry.caches.erase(
+      std::find(registry.caches.begin(), registry.caches.end(), cache_));
+}
+
+// static
+FaviconService* FaviconService::Get(content::BrowserContext* context) {
+  return FaviconServiceFactory::GetForContext(context);
+}
+
+// static
+bool FaviconService::GetBitmapForPageFromAnyContext(
+    const GURL& page_url,
+    int desired_size,
+    FaviconCache::Bitmap* bitmap) {
+  CacheRegistry& registry = g_cache_registry.Get();
+  base::AutoLock lock(registry.lock);
+
+  for (const auto& cache : registry.caches) {
+    if (cache->GetBitmapForPage(page_url, desired_size, bitmap)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool FaviconService::FetchFavicon(content::WebContents* contents,
+                                  const GURL& page_url,
+                                  const GURL& icon_url) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  if (!registered_) {
+    // Nothing can read icons cached for off the record contexts, so don't
+    // spend network and CPU time fetching them
+    return false;
+  }
+
+  if (!page_url.is_valid() || !icon_url.is_valid()) {
+    return false;
+  }
+
+  if (cache_->SetIconForPage(page_url, icon_url)) {
+    return true;
+  }
+
+  auto it = pending_downloads_.find(icon_url);
+  if (it != pending_downloads_.end()) {
+    it->second.pages.insert(page_url);
+    return false;
+  }
+
+  PendingDownload& download = pending_downloads_[icon_url];
+  download.contents = contents;
+  download.pages.insert(page_url);
+
+  if (trackers_.find(contents) == trackers_.end()) {
+    trackers_[contents] = base::MakeUnique<WebContentsTracker>(this, contents);
+  }
+
+  contents->DownloadImage(
+      icon_url,
+      true,
+      kMaxBitmapSize,
+      false,
+      base::Bind(&FaviconService::OnDownloadFinished,
+                 weak_ptr_factory_.GetWeakPtr()));
+
+  return false;
+}
+
+void FaviconService::AddObserver(Observer* observer) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  observers_.AddObserver(observer);
+}
+
+void FaviconService::RemoveObserver(Observer* observer) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  observers_.RemoveObserver(observer);
+}
+
+} // namespace oxide
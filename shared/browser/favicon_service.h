@@ -0,0 +1,153 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#ifndef _OXIDE_SHARED_BROWSER_FAVICON_SERVICE_H_
+#define _OXIDE_SHARED_BROWSER_FAVICON_SERVICE_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/observer_list.h"
+#include "components/keyed_service/core/keyed_service.h"
+#include "url/gurl.h"
+
+#include "shared/browser/favicon_cache.h"
+#include "shared/common/oxide_shared_export.h"
+
+class SkBitmap;
+
+namespace content {
+class BrowserContext;
+class WebContents;
+}
+
+namespace gfx {
+class Size;
+}
+
+namespace oxide {
+
+class FaviconServiceFactory;
+
+// A per-BrowserContext service that downloads, decodes and caches favicons,
+// so that embedders can display the icon for a page without fetching it
+// again. Icons are fetched via the WebContents that displayed the page, which
+// means they are requested with that WebContents' network stack and decoded
+// in the renderer. Decoded bitmaps are PNG encoded on the blocking pool and
+// stored in a FaviconCache, which is persisted to disk for contexts that
+// aren't off the record.
+//
+// Icons for pages visited in off the record contexts must never be visible
+// through GetBitmapForPageFromAnyContext. As that is the only way to read
+// cached icons, the services for these contexts don't fetch icons at all
+class OXIDE_SHARED_EXPORT FaviconService : public KeyedService {
+ public:
+  class Observer {
+   public:
+    virtual ~Observer() {}
+
+    // Called when the bitmaps for |icon_url| have been downloaded and cached
+    // for |page_url|
+    virtual void OnFaviconCached(const GURL& page_url,
+                                 const GURL& icon_url) = 0;
+  };
+
+  static FaviconService* Get(content::BrowserContext* context);
+
+  // Look up the best bitmap for |page_url| in the cache for any live
+  // BrowserContext that isn't off the record. This can be called on any
+  // thread
+  static bool GetBitmapForPageFromAnyContext(const GURL& page_url,
+                                             int desired_size,
+                                             FaviconCache::Bitmap* bitmap);
+
+  // Ensure that the icon at |icon_url| is cached and associated with
+  // |page_url|. Returns true if the icon is already cached, in which case it
+  // is available immediately. Otherwise it is downloaded using |contents|,
+  // and observers are notified once it has been cached
+  bool FetchFavicon(content::WebContents* contents,
+                    const GURL& page_url,
+                    const GURL& icon_url);
+
+  void AddObserver(Observer* observer);
+  void RemoveObserver(Observer* observer);
+
+  FaviconCache* cache() const { return cache_.get(); }
+
+ private:
+  friend class FaviconServiceFactory;
+  class WebContentsTracker;
+
+  struct PendingDownload {
+    PendingDownload();
+    PendingDownload(const PendingDownload& other);
+    ~PendingDownload();
+
+    // The WebContents that the download was started with. This is null once
+    // the download has completed
+    content::WebContents* contents;
+
+    // The pages waiting for the icon
+    std::set<GURL> pages;
+  };
+
+  FaviconService(content::BrowserContext* context);
+  ~FaviconService() override;
+
+  void OnWebContentsDestroyed(content::WebContents* contents);
+  void MaybeStopTrackingWebContents(content::WebContents* contents);
+
+  void OnDownloadFinished(int id,
+                          int http_status_code,
+                          const GURL& image_url,
+                          const std::vector<SkBitmap>& bitmaps,
+                          const std::vector<gfx::Size>& original_sizes);
+  void OnBitmapsEncoded(const GURL& icon_url,
+                        const std::vector<FaviconCache::Bitmap>* bitmaps);
+
+  // KeyedService implementation
+  void Shutdown() override;
+
+  scoped_refptr<FaviconCache> cache_;
+
+  // Whether |cache_| is in the registry used by
+  // GetBitmapForPageFromAnyContext
+  bool registered_;
+
+  // In-progress downloads, keyed by icon URL
+  std::map<GURL, PendingDownload> pending_downloads_;
+
+  // Observers for WebContents with an in-progress download. A WebContents
+  // drops its download callbacks when it is destroyed, so the corresponding
+  // entries in |pending_downloads_| are removed when that happens
+  std::map<content::WebContents*, std::unique_ptr<WebContentsTracker>>
+      trackers_;
+
+  base::ObserverList<Observer> observers_;
+
+  base::WeakPtrFactory<FaviconService> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(FaviconService);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_FAVICON_SERVICE_H_
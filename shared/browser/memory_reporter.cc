@@ -0,0 +1,290 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#include "memory_reporter.h"
+
+#include <memory>
+#include <set>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "base/process/process_metrics.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/navigation_controller.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_view_host.h"
+#include "content/public/browser/render_widget_host.h"
+#include "content/public/browser/render_widget_host_iterator.h"
+#include "content/public/browser/web_contents.h"
+
+#include "favicon_service.h"
+#include "oxide_browser_context.h"
+#include "oxide_web_contents_view.h"
+#include "oxide_web_view.h"
+#include "renderer_process_pool.h"
+
+namespace oxide {
+
+namespace {
+
+typedef std::vector<base::ProcessHandle> ProcessHandleList;
+
+void AddRenderer(content::RenderProcessHost* host,
+                 std::vector<RendererMemoryUsage>* renderers,
+                 ProcessHandleList* handles) {
+  // This is null if the process hasn't launched yet
+  base::ProcessHandle handle = host->GetHandle();
+
+  RendererMemoryUsage usage;
+  usage.render_process_id = host->GetID();
+  if (handle != base::kNullProcessHandle) {
+    usage.pid = base::GetProcId(handle);
+  }
+  usage.sites = RendererProcessPool::GetSitesForHost(host);
+
+  renderers->push_back(usage);
+  handles->push_back(handle);
+}
+
+void AddBrowserSideUsage(WebView* view,
+                         size_t* compositor_frame_count,
+                         size_t* compositor_frame_bytes,
+                         int* navigation_entry_count) {
+  content::WebContents* contents = view->GetWebContents();
+
+  size_t count = 0;
+  size_t bytes = 0;
+  WebContentsView::FromWebContents(contents)
+      ->GetRetainedCompositorFrameUsage(&count, &bytes);
+
+  *compositor_frame_count += count;
+  *compositor_frame_bytes += bytes;
+  *navigation_entry_count += contents->GetController().GetEntryCount();
+}
+
+// Runs on the blocking pool, as reading the process metrics hits procfs
+void ReadRendererMemoryUsage(const ProcessHandleList& handles,
+                             std::vector<RendererMemoryUsage>* renderers) {
+  DCHECK_EQ(handles.size(), renderers->size());
+
+  for (size_t i = 0; i < handles.size(); ++i) {
+    if (handles[i] == base::kNullProcessHandle) {
+      continue;
+    }
+
+    std::unique_ptr<base::ProcessMetrics> metrics(
+        base::ProcessMetrics::CreateProcessMetrics(handles[i]));
+    base::WorkingSetKBytes ws;
+    if (!metrics->GetWorkingSetKBytes(&ws)) {
+      // The process has probably exited
+      continue;
+    }
+
+    (*renderers)[i].private_bytes = ws.priv * 1024;
+    (*renderers)[i].shared_bytes = ws.shared * 1024;
+  }
+}
+
+void DidSampleWebView(const WebViewMemoryUsage& usage,
+                      const MemoryReporter::WebViewCallback& callback,
+                      const std::vector<RendererMemoryUsage>* renderers) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  WebViewMemoryUsage result = usage;
+  if (!renderers->empty()) {
+    result.renderer = renderers->front();
+  }
+
+  callback.Run(result);
+}
+
+// Collects the parts of a BrowserContext sample that are read on other
+// threads, and runs the callback once they have all arrived. The callbacks
+// that reference this pass through the IO thread, hence the thread-safe
+// ref-counting. Otherwise it is only used on the UI thread
+class BrowserContextSample
+    : public base::RefCountedThreadSafe<BrowserContextSample> {
+ public:
+  BrowserContextSample(const BrowserContextMemoryUsage& usage,
+                       const MemoryReporter::BrowserContextCallback& callback)
+      : usage_(usage),
+        callback_(callback),
+        pending_(2) {}
+
+  void DidReadRendererMemoryUsage(
+      const std::vector<RendererMemoryUsage>* renderers) {
+    DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+    usage_.renderers = *renderers;
+    MaybeFinish();
+  }
+
+  void DidGetHttpCacheSize(int64_t size) {
+    DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+    usage_.http_cache_bytes = size;
+    MaybeFinish();
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<BrowserContextSample>;
+  ~BrowserContextSample() {}
+
+  void MaybeFinish() {
+    DCHECK_GT(pending_, 0);
+    if (--pending_ > 0) {
+      return;
+    }
+
+    callback_.Run(usage_);
+  }
+
+  BrowserContextMemoryUsage usage_;
+  MemoryReporter::BrowserContextCallback callback_;
+  int pending_;
+
+  DISALLOW_COPY_AND_ASSIGN(BrowserContextSample);
+};
+
+}
+
+RendererMemoryUsage::RendererMemoryUsage()
+    : render_process_id(-1),
+      pid(base::kNullProcessId),
+      private_bytes(0),
+      shared_bytes(0) {}
+
+RendererMemoryUsage::RendererMemoryUsage(
+    const RendererMemoryUsage& other) = default;
+
+RendererMemoryUsage::~RendererMemoryUsage() {}
+
+WebViewMemoryUsage::WebViewMemoryUsage()
+    : compositor_frame_count(0),
+      compositor_frame_bytes(0),
+      navigation_entry_count(0) {}
+
+WebViewMemoryUsage::WebViewMemoryUsage(
+    const WebViewMemoryUsage& other) = default;
+
+WebViewMemoryUsage::~WebViewMemoryUsage() {}
+
+BrowserContextMemoryUsage::BrowserContextMemoryUsage()
+    : web_view_count(0),
+      compositor_frame_count(0),
+      compositor_frame_bytes(0),
+      navigation_entry_count(0),
+      http_cache_bytes(-1),
+      favicon_cache_bytes(0) {}
+
+BrowserContextMemoryUsage::BrowserContextMemoryUsage(
+    const BrowserContextMemoryUsage& other) = default;
+
+BrowserContextMemoryUsage::~BrowserContextMemoryUsage() {}
+
+// static
+void MemoryReporter::SampleWebView(WebView* view,
+                                   const WebViewCallback& callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  DCHECK(view);
+
+  WebViewMemoryUsage usage;
+  AddBrowserSideUsage(view,
+                      &usage.compositor_frame_count,
+                      &usage.compositor_frame_bytes,
+                      &usage.navigation_entry_count);
+
+  std::vector<RendererMemoryUsage>* renderers =
+      new std::vector<RendererMemoryUsage>();
+  ProcessHandleList handles;
+  AddRenderer(view->GetWebContents()->GetRenderProcessHost(),
+              renderers, &handles);
+
+  content::BrowserThread::PostBlockingPoolTaskAndReply(
+      FROM_HERE,
+      base::Bind(&ReadRendererMemoryUsage, handles, renderers),
+      base::Bind(&DidSampleWebView, usage, callback, base::Owned(renderers)));
+}
+
+// static
+void MemoryReporter::SampleBrowserContext(
+    BrowserContext* context,
+    const BrowserContextCallback& callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  DCHECK(context);
+
+  BrowserContextMemoryUsage usage;
+
+  std::set<content::WebContents*> seen;
+  std::unique_ptr<content::RenderWidgetHostIterator> widgets(
+      content::RenderWidgetHost::GetRenderWidgetHosts());
+  while (content::RenderWidgetHost* widget = widgets->GetNextHost()) {
+    content::RenderViewHost* rvh = content::RenderViewHost::From(widget);
+    if (!rvh) {
+      continue;
+    }
+
+    content::WebContents* contents =
+        content::WebContents::FromRenderViewHost(rvh);
+    if (!contents || !seen.insert(contents).second) {
+      continue;
+    }
+
+    WebView* view = WebView::FromWebContents(contents);
+    if (!view ||
+        !context->IsSameContext(
+            BrowserContext::FromContent(contents->GetBrowserContext()))) {
+      continue;
+    }
+
+    ++usage.web_view_count;
+    AddBrowserSideUsage(view,
+                        &usage.compositor_frame_count,
+                        &usage.compositor_frame_bytes,
+                        &usage.navigation_entry_count);
+  }
+
+  std::vector<RendererMemoryUsage>* renderers =
+      new std::vector<RendererMemoryUsage>();
+  ProcessHandleList handles;
+  for (content::RenderProcessHost::iterator it =
+          content::RenderProcessHost::AllHostsIterator();
+       !it.IsAtEnd(); it.Advance()) {
+    content::RenderProcessHost* host = it.GetCurrentValue();
+    if (!context->IsSameContext(
+            BrowserContext::FromContent(host->GetBrowserContext()))) {
+      continue;
+    }
+
+    AddRenderer(host, renderers, &handles);
+  }
+
+  usage.favicon_cache_bytes =
+      FaviconService::Get(context)->cache()->GetBitmapDataSize();
+
+  scoped_refptr<BrowserContextSample> sample =
+      new BrowserContextSample(usage, callback);
+
+  content::BrowserThread::PostBlockingPoolTaskAndReply(
+      FROM_HERE,
+      base::Bind(&ReadRendererMemoryUsage, handles, renderers),
+      base::Bind(&BrowserContextSample::DidReadRendererMemoryUsage,
+                 sample, base::Owned(renderers)));
+
+  context->GetHttpCacheSize(
+      base::Bind(&BrowserContextSample::DidGetHttpCacheSize, sample));
+}
+
+} // namespace oxide
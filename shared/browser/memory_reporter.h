@@ -0,0 +1,121 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#ifndef _OXIDE_SHARED_BROWSER_MEMORY_REPORTER_H_
+#define _OXIDE_SHARED_BROWSER_MEMORY_REPORTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/process/process_handle.h"
+
+#include "url/gurl.h"
+
+#include "shared/common/oxide_shared_export.h"
+
+namespace oxide {
+
+class BrowserContext;
+class WebView;
+
+struct OXIDE_SHARED_EXPORT RendererMemoryUsage {
+  RendererMemoryUsage();
+  RendererMemoryUsage(const RendererMemoryUsage& other);
+  ~RendererMemoryUsage();
+
+  int render_process_id;
+  base::ProcessId pid;
+
+  // Resident memory that is private to the renderer process
+  size_t private_bytes;
+
+  // Resident memory that is shared with other processes
+  size_t shared_bytes;
+
+  // The sites currently assigned to the renderer. See RendererProcessPool
+  std::vector<GURL> sites;
+};
+
+struct OXIDE_SHARED_EXPORT WebViewMemoryUsage {
+  WebViewMemoryUsage();
+  WebViewMemoryUsage(const WebViewMemoryUsage& other);
+  ~WebViewMemoryUsage();
+
+  // The renderer hosting the main frame. Note that this process might be
+  // shared with other WebViews
+  RendererMemoryUsage renderer;
+
+  // Compositor frames held in the browser process on behalf of this view.
+  // |compositor_frame_bytes| is an estimate (see
+  // WebContentsView::GetRetainedCompositorFrameUsage)
+  size_t compositor_frame_count;
+  size_t compositor_frame_bytes;
+
+  int navigation_entry_count;
+};
+
+struct OXIDE_SHARED_EXPORT BrowserContextMemoryUsage {
+  BrowserContextMemoryUsage();
+  BrowserContextMemoryUsage(const BrowserContextMemoryUsage& other);
+  ~BrowserContextMemoryUsage();
+
+  // All renderers belonging to the context
+  std::vector<RendererMemoryUsage> renderers;
+
+  // Totals for all WebViews belonging to the context
+  size_t web_view_count;
+  size_t compositor_frame_count;
+  size_t compositor_frame_bytes;
+  int navigation_entry_count;
+
+  // The total size of the entries in the context's HTTP cache. This is held
+  // on disk, except for off the record contexts and contexts without a cache
+  // path, where it is held in memory. This is -1 if the size couldn't be
+  // determined
+  int64_t http_cache_bytes;
+
+  // The size of the encoded icons held in memory by the context's
+  // FaviconService
+  size_t favicon_cache_bytes;
+};
+
+// Samples the memory used on behalf of a WebView or BrowserContext, so that
+// the application can decide what to discard when under memory pressure.
+// Renderer memory is read from the process metrics on the blocking pool, and
+// the HTTP cache size is calculated on the IO thread. The result is delivered
+// asynchronously on the UI thread. In single process mode, the renderer
+// figures are those of the browser process
+class OXIDE_SHARED_EXPORT MemoryReporter {
+ public:
+  using WebViewCallback = base::Callback<void(const WebViewMemoryUsage&)>;
+  using BrowserContextCallback =
+      base::Callback<void(const BrowserContextMemoryUsage&)>;
+
+  static void SampleWebView(WebView* view, const WebViewCallback& callback);
+
+  static void SampleBrowserContext(BrowserContext* context,
+                                   const BrowserContextCallback& callback);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(MemoryReporter);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_MEMORY_REPORTER_H_
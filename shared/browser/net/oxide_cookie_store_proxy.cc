@@ -17,6 +17,7 @@
 
 #include "oxide_cookie_store_proxy.h"
 
+#include <algorithm>
 #include <string>
 
 #include "base/synchronization/lock.h"
@@ -24,6 +25,88 @@
 
 namespace oxide {
 
+namespace {
+
+// Tracks a batched cookie import on the cookie thread, so that the client is
+// only notified once every cookie in the batch has been handled
+class SetCookiesBatchContext
+    : public base::RefCounted<SetCookiesBatchContext> {
+ public:
+  // |remaining_| is initialized with an extra reference, which is dropped by
+  // Done() once all of the cookies have been dispatched. This handles the
+  // case where the underlying store completes requests synchronously
+  SetCookiesBatchContext(
+      size_t count,
+      const CookieStoreProxy::SetCookiesBatchCallback& callback)
+      : remaining_(count + 1),
+        callback_(callback) {}
+
+  void OnCookieSet(size_t index, bool success) {
+    if (!success) {
+      failed_.push_back(index);
+    }
+    Done();
+  }
+
+  void OnCookieFailed(size_t index) {
+    OnCookieSet(index, false);
+  }
+
+  void Done() {
+    DCHECK_GT(remaining_, 0U);
+    if (--remaining_ > 0) {
+      return;
+    }
+
+    if (callback_.is_null()) {
+      return;
+    }
+
+    std::sort(failed_.begin(), failed_.end());
+    callback_.Run(failed_);
+  }
+
+ private:
+  friend class base::RefCounted<SetCookiesBatchContext>;
+  ~SetCookiesBatchContext() {}
+
+  size_t remaining_;
+  std::vector<size_t> failed_;
+  CookieStoreProxy::SetCookiesBatchCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(SetCookiesBatchContext);
+};
+
+void DeliverCookieListInChunks(
+    size_t chunk_size,
+    const CookieStoreProxy::CookieListChunkCallback& callback,
+    const net::CookieList& cookies) {
+  if (cookies.empty()) {
+    callback.Run(net::CookieList(), true);
+    return;
+  }
+
+  for (size_t start = 0; start < cookies.size(); start += chunk_size) {
+    size_t end = std::min(start + chunk_size, cookies.size());
+    callback.Run(net::CookieList(cookies.begin() + start,
+                                 cookies.begin() + end),
+                 end == cookies.size());
+  }
+}
+
+}
+
+CookieStoreProxy::CookieDetails::CookieDetails()
+    : secure(false),
+      http_only(false),
+      same_site(net::CookieSameSite::DEFAULT_MODE),
+      priority(net::COOKIE_PRIORITY_DEFAULT) {}
+
+CookieStoreProxy::CookieDetails::CookieDetails(
+    const CookieDetails& other) = default;
+
+CookieStoreProxy::CookieDetails::~CookieDetails() {}
+
 CookieStoreOwner::CookieStoreOwner()
     : weak_ptr_factory_(this) {}
 
@@ -67,6 +150,11 @@ class CookieStoreProxy::Core : public base::RefCountedThreadSafe<Core> {
       const base::Time& delete_end,
       const net::CookieStore::DeleteCallback& callback);
   void FlushStore(const base::Closure& callback);
+  void SetCookiesWithDetailsBatchAsync(
+      const CookieDetailsList& cookies,
+      const SetCookiesBatchCallback& callback);
+  void GetAllCookiesChunkedAsync(size_t chunk_size,
+                                 const CookieListChunkCallback& callback);
 
   void DispatchTask(base::Closure task);
 
@@ -190,6 +278,44 @@ void CookieStoreProxy::Core::FlushStore(const base::Closure& callback) {
   store->FlushStore(callback);
 }
 
+void CookieStoreProxy::Core::SetCookiesWithDetailsBatchAsync(
+    const CookieDetailsList& cookies,
+    const SetCookiesBatchCallback& callback) {
+  scoped_refptr<SetCookiesBatchContext> ctxt =
+      new SetCookiesBatchContext(cookies.size(), callback);
+
+  net::CookieStore* store = GetStore();
+
+  for (size_t i = 0; i < cookies.size(); ++i) {
+    if (!store) {
+      ctxt->OnCookieFailed(i);
+      continue;
+    }
+
+    const CookieDetails& cookie = cookies[i];
+    store->SetCookieWithDetailsAsync(
+        cookie.url, cookie.name, cookie.value, cookie.domain, cookie.path,
+        cookie.creation_time, cookie.expiration_time, cookie.last_access_time,
+        cookie.secure, cookie.http_only, cookie.same_site, cookie.priority,
+        base::Bind(&SetCookiesBatchContext::OnCookieSet, ctxt, i));
+  }
+
+  ctxt->Done();
+}
+
+void CookieStoreProxy::Core::GetAllCookiesChunkedAsync(
+    size_t chunk_size,
+    const CookieListChunkCallback& callback) {
+  net::CookieStore* store = GetStore();
+  if (!store) {
+    callback.Run(net::CookieList(), true);
+    return;
+  }
+
+  store->GetAllCookiesAsync(
+      base::Bind(&DeliverCookieListInChunks, chunk_size, callback));
+}
+
 void CookieStoreProxy::Core::DispatchTask(base::Closure task) {
   // XXX(chrisccoulson): There might not be a cookie store yet. In this case,
   //  we should queue the task and dispatch it after the cookie store is
@@ -224,6 +350,28 @@ void CookieStoreProxy::RunClosure(base::Closure callback) {
   callback.Run();
 }
 
+void CookieStoreProxy::RunChunkCallback(CookieListChunkCallback callback,
+                                        const net::CookieList& cookies,
+                                        bool last) {
+  DCHECK(IsOnClientThread());
+  callback.Run(cookies, last);
+}
+
+// static
+void CookieStoreProxy::ChunkCallbackThunk(
+    base::WeakPtr<CookieStoreProxy> cookie_store,
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner,
+    CookieListChunkCallback callback,
+    const net::CookieList& cookies,
+    bool last) {
+  task_runner->PostTask(FROM_HERE,
+                        base::Bind(&CookieStoreProxy::RunChunkCallback,
+                                   cookie_store,
+                                   callback,
+                                   cookies,
+                                   last));
+}
+
 CookieStoreProxy::CookieStoreProxy(
     base::WeakPtr<CookieStoreOwner> store_owner,
     scoped_refptr<base::SingleThreadTaskRunner> client_task_runner,
@@ -376,4 +524,33 @@ bool CookieStoreProxy::IsEphemeral() {
   return false;
 }
 
+void CookieStoreProxy::SetCookiesWithDetailsBatchAsync(
+    const CookieDetailsList& cookies,
+    const SetCookiesBatchCallback& callback) {
+  DCHECK(IsOnClientThread());
+  PostTaskToCookieThread(
+      base::Bind(&Core::SetCookiesWithDetailsBatchAsync,
+                 core_, cookies, WrapCallback(callback)));
+}
+
+void CookieStoreProxy::GetAllCookiesChunkedAsync(
+    size_t chunk_size,
+    const CookieListChunkCallback& callback) {
+  DCHECK(IsOnClientThread());
+  DCHECK_GT(chunk_size, 0U);
+
+  if (callback.is_null()) {
+    return;
+  }
+
+  PostTaskToCookieThread(
+      base::Bind(&Core::GetAllCookiesChunkedAsync,
+                 core_,
+                 chunk_size,
+                 base::Bind(&CookieStoreProxy::ChunkCallbackThunk,
+                            weak_ptr_factory_.GetWeakPtr(),
+                            client_task_runner_,
+                            callback)));
+}
+
 } // namespace oxide
@@ -18,6 +18,8 @@
 #ifndef _OXIDE_SHARED_BROWSER_COOKIE_STORE_PROXY_H_
 #define _OXIDE_SHARED_BROWSER_COOKIE_STORE_PROXY_H_
 
+#include <vector>
+
 #include "base/bind.h"
 #include "base/callback.h"
 #include "base/logging.h"
@@ -26,6 +28,7 @@
 #include "base/memory/weak_ptr.h"
 #include "base/single_thread_task_runner.h"
 #include "net/cookies/cookie_store.h"
+#include "url/gurl.h"
 
 #include "shared/common/oxide_shared_export.h"
 
@@ -51,6 +54,39 @@ class OXIDE_SHARED_EXPORT CookieStoreOwner {
 
 class OXIDE_SHARED_EXPORT CookieStoreProxy : public net::CookieStore {
  public:
+  // The parameters for a single cookie in a batched import. These mirror the
+  // arguments to SetCookieWithDetailsAsync
+  struct CookieDetails {
+    CookieDetails();
+    CookieDetails(const CookieDetails& other);
+    ~CookieDetails();
+
+    GURL url;
+    std::string name;
+    std::string value;
+    std::string domain;
+    std::string path;
+    base::Time creation_time;
+    base::Time expiration_time;
+    base::Time last_access_time;
+    bool secure;
+    bool http_only;
+    net::CookieSameSite same_site;
+    net::CookiePriority priority;
+  };
+
+  typedef std::vector<CookieDetails> CookieDetailsList;
+
+  // Run once a batched import has completed, with the indices in to the
+  // original CookieDetailsList of any cookies that could not be set
+  typedef base::Callback<void(const std::vector<size_t>&)>
+      SetCookiesBatchCallback;
+
+  // Run for each chunk of a chunked export. |last| is true for the final
+  // chunk, which may be empty
+  typedef base::Callback<void(const net::CookieList&, bool last)>
+      CookieListChunkCallback;
+
   CookieStoreProxy(
       base::WeakPtr<CookieStoreOwner> store_owner,
       scoped_refptr<base::SingleThreadTaskRunner> client_task_runner,
@@ -104,6 +140,20 @@ class OXIDE_SHARED_EXPORT CookieStoreProxy : public net::CookieStore {
       const CookieChangedCallback& callback) override;
   bool IsEphemeral() override;
 
+  // Applies all of |cookies| to the underlying store in a single task on the
+  // cookie thread, and runs |callback| once on the client thread when done
+  void SetCookiesWithDetailsBatchAsync(const CookieDetailsList& cookies,
+                                       const SetCookiesBatchCallback& callback);
+
+  // Retrieves all cookies from the underlying store, and delivers them to the
+  // client thread in chunks of up to |chunk_size| cookies, each in its own
+  // task. This allows the client to process a large cookie jar without
+  // blocking its thread for the whole duration. Note that the underlying store
+  // still retrieves the whole cookie jar in one go, so this doesn't reduce
+  // peak memory usage
+  void GetAllCookiesChunkedAsync(size_t chunk_size,
+                                 const CookieListChunkCallback& callback);
+
  private:
   bool IsOnClientThread() const;
 
@@ -131,6 +181,17 @@ class OXIDE_SHARED_EXPORT CookieStoreProxy : public net::CookieStore {
                                      result));
   }
 
+  void RunChunkCallback(CookieListChunkCallback callback,
+                        const net::CookieList& cookies,
+                        bool last);
+
+  static void ChunkCallbackThunk(
+      base::WeakPtr<CookieStoreProxy> cookie_store,
+      scoped_refptr<base::SingleThreadTaskRunner> task_runner,
+      CookieListChunkCallback callback,
+      const net::CookieList& cookies,
+      bool last);
+
   template <typename T>
   base::Callback<void(T)> WrapCallback(
       const base::Callback<void(T)>& callback) {
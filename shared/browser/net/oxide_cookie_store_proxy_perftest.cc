@@ -0,0 +1,278 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/macros.h"
+#include "base/memory/ptr_util.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "net/cookies/cookie_constants.h"
+#include "net/cookies/cookie_monster.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+#include "oxide_cookie_store_proxy.h"
+
+namespace oxide {
+
+namespace {
+
+void RunAndSignal(const base::Closure& task,
+                  base::Lock* lock,
+                  base::ConditionVariable* cv) {
+  task.Run();
+  base::AutoLock al(*lock);
+  cv->Signal();
+}
+
+void RunOnCookieThread(base::Thread* thread, const base::Closure& task) {
+  base::Lock lock;
+  base::ConditionVariable cv(&lock);
+
+  base::AutoLock al(lock);
+
+  thread->task_runner()->PostTask(
+      FROM_HERE,
+      base::Bind(&RunAndSignal,
+                 task,
+                 base::Unretained(&lock),
+                 base::Unretained(&cv)));
+
+  cv.Wait();
+}
+
+void InitializeCookieStore(CookieStoreOwner* store_owner) {
+  store_owner->set_store(
+      base::MakeUnique<net::CookieMonster>(nullptr, nullptr));
+}
+
+void TeardownCookieStore(CookieStoreOwner* store_owner) {
+  store_owner->set_store(nullptr);
+}
+
+void OnSetCookie(const base::Closure& quit_closure,
+                 int* failures,
+                 bool success) {
+  if (!success) {
+    ++*failures;
+  }
+  quit_closure.Run();
+}
+
+void OnSetCookiesBatch(const base::Closure& quit_closure,
+                       int* failures,
+                       const std::vector<size_t>& failed) {
+  *failures += failed.size();
+  quit_closure.Run();
+}
+
+void OnGotCookies(const base::Closure& quit_closure,
+                  size_t* count,
+                  const net::CookieList& cookies) {
+  *count += cookies.size();
+  quit_closure.Run();
+}
+
+void OnGotCookiesChunk(const base::Closure& quit_closure,
+                       size_t* count,
+                       const net::CookieList& cookies,
+                       bool last) {
+  *count += cookies.size();
+  if (last) {
+    quit_closure.Run();
+  }
+}
+
+CookieStoreProxy::CookieDetails MakeCookieDetails(int i) {
+  CookieStoreProxy::CookieDetails details;
+  details.url = GURL(base::StringPrintf("https://host%d.example.com/", i));
+  details.name = base::StringPrintf("cookie%d", i);
+  details.value = "value";
+  details.creation_time = base::Time::Now();
+  details.expiration_time =
+      details.creation_time + base::TimeDelta::FromDays(1);
+  details.same_site = net::CookieSameSite::NO_RESTRICTION;
+  details.priority = net::COOKIE_PRIORITY_DEFAULT;
+  return details;
+}
+
+}
+
+// Measures the cost of a round trip from the client thread to the cookie
+// thread and back, for |GetParam()| cookies
+class CookieStoreProxyPerfTest : public testing::TestWithParam<int> {
+ public:
+  CookieStoreProxyPerfTest() = default;
+
+ protected:
+  CookieStoreProxy* store() const { return store_.get(); }
+
+  void PrintResult(const std::string& trace,
+                   base::TimeDelta elapsed,
+                   int operations);
+
+  // Populates the store using a single batch
+  void PopulateStore();
+
+ private:
+  // testing::Test implementation
+  void SetUp() override;
+  void TearDown() override;
+
+  base::MessageLoop message_loop_;
+  std::unique_ptr<base::Thread> cookie_thread_;
+
+  std::unique_ptr<CookieStoreOwner> store_owner_;
+  std::unique_ptr<CookieStoreProxy> store_;
+
+  DISALLOW_COPY_AND_ASSIGN(CookieStoreProxyPerfTest);
+};
+
+void CookieStoreProxyPerfTest::SetUp() {
+  cookie_thread_ = base::MakeUnique<base::Thread>("TestCookieThread");
+  cookie_thread_->Start();
+
+  store_owner_ = base::MakeUnique<CookieStoreOwner>();
+  store_ =
+      base::MakeUnique<CookieStoreProxy>(store_owner_->GetWeakPtr(),
+                                         base::ThreadTaskRunnerHandle::Get(),
+                                         cookie_thread_->task_runner());
+
+  RunOnCookieThread(cookie_thread_.get(),
+                    base::Bind(&InitializeCookieStore,
+                               base::Unretained(store_owner_.get())));
+}
+
+void CookieStoreProxyPerfTest::TearDown() {
+  RunOnCookieThread(cookie_thread_.get(),
+                    base::Bind(&TeardownCookieStore,
+                               base::Unretained(store_owner_.get())));
+
+  cookie_thread_->Stop();
+
+  base::RunLoop run_loop;
+  run_loop.RunUntilIdle();
+}
+
+void CookieStoreProxyPerfTest::PrintResult(const std::string& trace,
+                                           base::TimeDelta elapsed,
+                                           int operations) {
+  perf_test::PrintResult(
+      "cookie_store_proxy", base::StringPrintf("_%d_cookies", GetParam()),
+      trace, elapsed.InMicrosecondsF() / operations, "us/op", true);
+}
+
+void CookieStoreProxyPerfTest::PopulateStore() {
+  CookieStoreProxy::CookieDetailsList batch;
+  for (int i = 0; i < GetParam(); ++i) {
+    batch.push_back(MakeCookieDetails(i));
+  }
+
+  int failures = 0;
+  base::RunLoop run_loop;
+  store()->SetCookiesWithDetailsBatchAsync(
+      batch,
+      base::Bind(&OnSetCookiesBatch, run_loop.QuitClosure(), &failures));
+  run_loop.Run();
+
+  ASSERT_EQ(0, failures);
+}
+
+INSTANTIATE_TEST_CASE_P(Cookies,
+                        CookieStoreProxyPerfTest,
+                        testing::Values(10, 100, 1000));
+
+TEST_P(CookieStoreProxyPerfTest, SetCookieWithDetailsAsync) {
+  int failures = 0;
+
+  base::ElapsedTimer timer;
+  for (int i = 0; i < GetParam(); ++i) {
+    CookieStoreProxy::CookieDetails details = MakeCookieDetails(i);
+    base::RunLoop run_loop;
+    store()->SetCookieWithDetailsAsync(
+        details.url, details.name, details.value, details.domain,
+        details.path, details.creation_time, details.expiration_time,
+        details.last_access_time, details.secure, details.http_only,
+        details.same_site, details.priority,
+        base::Bind(&OnSetCookie, run_loop.QuitClosure(), &failures));
+    run_loop.Run();
+  }
+
+  PrintResult("set_cookie_round_trip", timer.Elapsed(), GetParam());
+  EXPECT_EQ(0, failures);
+}
+
+TEST_P(CookieStoreProxyPerfTest, SetCookiesWithDetailsBatchAsync) {
+  base::ElapsedTimer timer;
+  PopulateStore();
+
+  PrintResult("set_cookies_batch", timer.Elapsed(), GetParam());
+}
+
+TEST_P(CookieStoreProxyPerfTest, GetAllCookiesAsync) {
+  const int kIterations = 20;
+
+  PopulateStore();
+
+  size_t count = 0;
+
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    base::RunLoop run_loop;
+    store()->GetAllCookiesAsync(
+        base::Bind(&OnGotCookies, run_loop.QuitClosure(), &count));
+    run_loop.Run();
+  }
+
+  PrintResult("get_all_cookies", timer.Elapsed(), kIterations);
+  EXPECT_EQ(static_cast<size_t>(GetParam() * kIterations), count);
+}
+
+TEST_P(CookieStoreProxyPerfTest, GetAllCookiesChunkedAsync) {
+  const int kIterations = 20;
+  const size_t kChunkSize = 100;
+
+  PopulateStore();
+
+  size_t count = 0;
+
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    base::RunLoop run_loop;
+    store()->GetAllCookiesChunkedAsync(
+        kChunkSize,
+        base::Bind(&OnGotCookiesChunk, run_loop.QuitClosure(), &count));
+    run_loop.Run();
+  }
+
+  PrintResult("get_all_cookies_chunked", timer.Elapsed(), kIterations);
+  EXPECT_EQ(static_cast<size_t>(GetParam() * kIterations), count);
+}
+
+} // namespace oxide
@@ -186,7 +186,7 @@ class CookieStoreProxyTest : public testing::Test {
   CookieStoreProxyTest() = default;
 
  protected:
-  net::CookieStore* store() const { return store_.get(); }
+  CookieStoreProxy* store() const { return store_.get(); }
 
   using CookieChange =
       std::tuple<net::CanonicalCookie,
@@ -493,6 +493,122 @@ TEST_F(CookieStoreProxyTest, GetAllCookiesAsync) {
   EXPECT_EQ(net::COOKIE_PRIORITY_DEFAULT, callback.result()[0].Priority());
 }
 
+class CookieListChunkCollector : public CookieStoreCallbackBase {
+ public:
+  CookieListChunkCollector()
+      : weak_ptr_factory_(this) {}
+
+  ~CookieListChunkCollector() override = default;
+
+  CookieStoreProxy::CookieListChunkCallback MakeCallback() {
+    chunk_sizes_.clear();
+    cookies_.clear();
+    Reset();
+    return base::Bind(&CookieListChunkCollector::OnChunk,
+                      weak_ptr_factory_.GetWeakPtr());
+  }
+
+  const std::vector<size_t>& chunk_sizes() const { return chunk_sizes_; }
+  const net::CookieList& cookies() const { return cookies_; }
+
+ private:
+  void OnChunk(const net::CookieList& cookies, bool last) {
+    chunk_sizes_.push_back(cookies.size());
+    cookies_.insert(cookies_.end(), cookies.begin(), cookies.end());
+    if (last) {
+      NotifyCalled();
+    }
+  }
+
+  std::vector<size_t> chunk_sizes_;
+  net::CookieList cookies_;
+  base::WeakPtrFactory<CookieListChunkCollector> weak_ptr_factory_;
+};
+
+CookieStoreProxy::CookieDetails MakeCookieDetails(const std::string& url,
+                                                  const std::string& name,
+                                                  const std::string& value) {
+  CookieStoreProxy::CookieDetails details;
+  details.url = GURL(url);
+  details.name = name;
+  details.value = value;
+  details.creation_time = base::Time::Now();
+  details.expiration_time =
+      details.creation_time + base::TimeDelta::FromDays(1);
+  return details;
+}
+
+TEST_F(CookieStoreProxyTest, SetCookiesWithDetailsBatchAsync) {
+  CookieStoreProxy::CookieDetailsList batch;
+  batch.push_back(MakeCookieDetails("https://www.google.com/", "foo", "bar"));
+  // Invalid - the domain doesn't match the URL
+  batch.push_back(MakeCookieDetails("https://www.google.com/", "baz", "1"));
+  batch.back().domain = "www.example.com";
+  batch.push_back(MakeCookieDetails("https://www.example.com/", "bar", "foo"));
+
+  CookieStoreCallback<const std::vector<size_t>&, std::vector<size_t>>
+      callback;
+  store()->SetCookiesWithDetailsBatchAsync(
+      batch, callback.MakeCallback());
+
+  EXPECT_TRUE(callback.WaitForCallback());
+  ASSERT_EQ(1U, callback.result().size());
+  EXPECT_EQ(1U, callback.result()[0]);
+
+  const CookieChangeVector& changes = cookie_changes();
+  ASSERT_EQ(2U, changes.size());
+  EXPECT_EQ("foo", std::get<0>(changes[0]).Name());
+  EXPECT_EQ("www.google.com", std::get<0>(changes[0]).Domain());
+  EXPECT_EQ("bar", std::get<0>(changes[1]).Name());
+  EXPECT_EQ("www.example.com", std::get<0>(changes[1]).Domain());
+}
+
+TEST_F(CookieStoreProxyTest, SetCookiesWithDetailsBatchAsyncEmpty) {
+  CookieStoreCallback<const std::vector<size_t>&, std::vector<size_t>>
+      callback;
+  store()->SetCookiesWithDetailsBatchAsync(
+      CookieStoreProxy::CookieDetailsList(), callback.MakeCallback());
+
+  EXPECT_TRUE(callback.WaitForCallback());
+  EXPECT_EQ(0U, callback.result().size());
+  EXPECT_EQ(0U, cookie_changes().size());
+}
+
+TEST_F(CookieStoreProxyTest, GetAllCookiesChunkedAsync) {
+  CookieStoreProxy::CookieDetailsList batch;
+  for (int i = 0; i < 5; ++i) {
+    batch.push_back(MakeCookieDetails("https://www.google.com/",
+                                      "foo" + std::to_string(i),
+                                      "bar"));
+  }
+
+  CookieStoreCallback<const std::vector<size_t>&, std::vector<size_t>>
+      set_callback;
+  store()->SetCookiesWithDetailsBatchAsync(batch, set_callback.MakeCallback());
+  EXPECT_TRUE(set_callback.WaitForCallback());
+  EXPECT_EQ(0U, set_callback.result().size());
+
+  CookieListChunkCollector callback;
+  store()->GetAllCookiesChunkedAsync(2, callback.MakeCallback());
+
+  EXPECT_TRUE(callback.WaitForCallback());
+  ASSERT_EQ(3U, callback.chunk_sizes().size());
+  EXPECT_EQ(2U, callback.chunk_sizes()[0]);
+  EXPECT_EQ(2U, callback.chunk_sizes()[1]);
+  EXPECT_EQ(1U, callback.chunk_sizes()[2]);
+  EXPECT_EQ(5U, callback.cookies().size());
+}
+
+TEST_F(CookieStoreProxyTest, GetAllCookiesChunkedAsyncEmpty) {
+  CookieListChunkCollector callback;
+  store()->GetAllCookiesChunkedAsync(
+      10, callback.MakeCallback());
+
+  EXPECT_TRUE(callback.WaitForCallback());
+  ASSERT_EQ(1U, callback.chunk_sizes().size());
+  EXPECT_EQ(0U, callback.chunk_sizes()[0]);
+}
+
 TEST_F(CookieStoreProxyTest, FlushStore) {
   // XXX: We don't actually test that we call FlushStore on the underlying
   //  CookieStore
@@ -0,0 +1,460 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#include "oxide_http_cache_controller.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "base/strings/string_util.h"
+#include "base/supports_user_data.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/request_priority.h"
+#include "net/disk_cache/disk_cache.h"
+#include "net/http/http_cache.h"
+#include "net/http/http_transaction_factory.h"
+#include "net/http/http_util.h"
+#include "net/url_request/url_request_context.h"
+
+namespace oxide {
+
+namespace {
+
+// The stream index of the response body in HTTP cache entries
+const int kResponseContentIndex = 1;
+
+const int kPrefetchReadBufferSize = 32 * 1024;
+
+// Marks requests created for prefetches, which are excluded from the hit
+// and miss counts
+int kPrefetchUserDataKey;
+
+void OnEntryOpened(const HttpCacheController::EntryInfoCallback& callback,
+                   disk_cache::Entry** entry,
+                   int rv) {
+  HttpCacheController::EntryInfo info;
+  if (rv == net::OK) {
+    info.cached = true;
+    info.size = (*entry)->GetDataSize(kResponseContentIndex);
+    (*entry)->Close();
+  }
+
+  callback.Run(info);
+}
+
+void GetEntryInfoWithBackend(
+    const std::string& key,
+    const HttpCacheController::EntryInfoCallback& callback,
+    disk_cache::Backend* backend) {
+  if (!backend) {
+    callback.Run(HttpCacheController::EntryInfo());
+    return;
+  }
+
+  disk_cache::Entry** entry = new disk_cache::Entry*(nullptr);
+  net::CompletionCallback open_callback =
+      base::Bind(&OnEntryOpened, callback, base::Owned(entry));
+  int rv = backend->OpenEntry(key, entry, open_callback);
+  if (rv != net::ERR_IO_PENDING) {
+    open_callback.Run(rv);
+  }
+}
+
+void OnSizeCalculated(const HttpCacheController::SizeCallback& callback,
+                      int rv) {
+  callback.Run(rv < 0 ? -1 : static_cast<int64_t>(rv));
+}
+
+void GetSizeWithBackend(const HttpCacheController::SizeCallback& callback,
+                        disk_cache::Backend* backend) {
+  if (!backend) {
+    callback.Run(-1);
+    return;
+  }
+
+  net::CompletionCallback size_callback =
+      base::Bind(&OnSizeCalculated, callback);
+  int rv = backend->CalculateSizeOfAllEntries(size_callback);
+  if (rv != net::ERR_IO_PENDING) {
+    size_callback.Run(rv);
+  }
+}
+
+}
+
+class HttpCacheController::PrefetchBatch
+    : public base::RefCounted<PrefetchBatch> {
+ public:
+  PrefetchBatch(size_t count, const PrefetchCallback& callback)
+      : remaining_(count),
+        callback_(callback) {}
+
+  void PrefetchDone(bool success) {
+    DCHECK_GT(remaining_, 0U);
+
+    if (success) {
+      ++result_.succeeded;
+    } else {
+      ++result_.failed;
+    }
+
+    if (--remaining_ == 0 && !callback_.is_null()) {
+      callback_.Run(result_);
+    }
+  }
+
+ private:
+  friend class base::RefCounted<PrefetchBatch>;
+  ~PrefetchBatch() {}
+
+  size_t remaining_;
+  PrefetchResult result_;
+  PrefetchCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrefetchBatch);
+};
+
+struct HttpCacheController::ActivePrefetch {
+  std::unique_ptr<net::URLRequest> request;
+  scoped_refptr<PrefetchBatch> batch;
+  scoped_refptr<net::IOBuffer> buffer;
+};
+
+// Iterates over all entries in the cache, dooming those whose key starts
+// with a given prefix
+class HttpCacheController::Evictor {
+ public:
+  Evictor(HttpCacheController* controller,
+          disk_cache::Backend* backend,
+          const std::string& url_prefix,
+          const EvictCallback& callback)
+      : controller_(controller),
+        iterator_(backend->CreateIterator()),
+        entry_(nullptr),
+        url_prefix_(url_prefix),
+        callback_(callback),
+        evicted_(0),
+        weak_factory_(this) {}
+
+  ~Evictor() {
+    if (entry_) {
+      entry_->Close();
+    }
+  }
+
+  void OpenNextEntry() {
+    while (true) {
+      int rv = iterator_->OpenNextEntry(
+          &entry_,
+          base::Bind(&Evictor::OnEntryOpened, weak_factory_.GetWeakPtr()));
+      if (rv == net::ERR_IO_PENDING || !HandleEntry(rv)) {
+        return;
+      }
+    }
+  }
+
+ private:
+  void OnEntryOpened(int rv) {
+    if (HandleEntry(rv)) {
+      OpenNextEntry();
+    }
+  }
+
+  // Returns false once iteration has finished, in which case |this| has
+  // been deleted
+  bool HandleEntry(int rv) {
+    if (rv != net::OK) {
+      callback_.Run(evicted_);
+      controller_->OnEvictorDone(this);
+      return false;
+    }
+
+    if (base::StartsWith(entry_->GetKey(), url_prefix_,
+                         base::CompareCase::SENSITIVE)) {
+      entry_->Doom();
+      ++evicted_;
+    }
+
+    entry_->Close();
+    entry_ = nullptr;
+
+    return true;
+  }
+
+  HttpCacheController* controller_;
+
+  std::unique_ptr<disk_cache::Backend::Iterator> iterator_;
+  disk_cache::Entry* entry_;
+
+  std::string url_prefix_;
+  EvictCallback callback_;
+  int evicted_;
+
+  base::WeakPtrFactory<Evictor> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(Evictor);
+};
+
+void HttpCacheController::GetBackend(const BackendCallback& callback) {
+  net::HttpCache* cache = context_->http_transaction_factory()->GetCache();
+  if (!cache) {
+    callback.Run(nullptr);
+    return;
+  }
+
+  disk_cache::Backend** backend = new disk_cache::Backend*(nullptr);
+  net::CompletionCallback backend_callback =
+      base::Bind(&HttpCacheController::OnGotBackend,
+                 weak_factory_.GetWeakPtr(),
+                 callback, base::Owned(backend));
+  int rv = cache->GetBackend(backend, backend_callback);
+  if (rv != net::ERR_IO_PENDING) {
+    backend_callback.Run(rv);
+  }
+}
+
+void HttpCacheController::OnGotBackend(const BackendCallback& callback,
+                                       disk_cache::Backend** backend,
+                                       int rv) {
+  callback.Run(rv == net::OK ? *backend : nullptr);
+}
+
+void HttpCacheController::StartEvictor(const std::string& url_prefix,
+                                       const EvictCallback& callback,
+                                       disk_cache::Backend* backend) {
+  if (!backend) {
+    callback.Run(0);
+    return;
+  }
+
+  evictors_.push_back(
+      base::MakeUnique<Evictor>(this, backend, url_prefix, callback));
+  evictors_.back()->OpenNextEntry();
+}
+
+void HttpCacheController::OnEvictorDone(Evictor* evictor) {
+  for (auto it = evictors_.begin(); it != evictors_.end(); ++it) {
+    if (it->get() == evictor) {
+      evictors_.erase(it);
+      return;
+    }
+  }
+
+  NOTREACHED();
+}
+
+void HttpCacheController::StartPrefetches() {
+  while (active_prefetches_.size() < kMaxConcurrentPrefetches &&
+         !queued_prefetches_.empty()) {
+    GURL url = queued_prefetches_.front().first;
+    scoped_refptr<PrefetchBatch> batch = queued_prefetches_.front().second;
+    queued_prefetches_.pop_front();
+
+    if (!url.is_valid() || !url.SchemeIsHTTPOrHTTPS()) {
+      ++stats_.prefetches_failed;
+      batch->PrefetchDone(false);
+      continue;
+    }
+
+    std::unique_ptr<ActivePrefetch> prefetch =
+        base::MakeUnique<ActivePrefetch>();
+    prefetch->request = context_->CreateRequest(url, net::IDLE, this);
+    prefetch->request->SetUserData(&kPrefetchUserDataKey,
+                                   new base::SupportsUserData::Data());
+    prefetch->batch = batch;
+    prefetch->buffer = new net::IOBuffer(kPrefetchReadBufferSize);
+
+    net::URLRequest* request = prefetch->request.get();
+    active_prefetches_[request] = std::move(prefetch);
+
+    request->Start();
+  }
+}
+
+void HttpCacheController::ReadPrefetchBody(net::URLRequest* request) {
+  auto it = active_prefetches_.find(request);
+  DCHECK(it != active_prefetches_.end());
+  net::IOBuffer* buffer = it->second->buffer.get();
+
+  // The body is discarded - reading it to completion is what populates the
+  // cache entry
+  int rv;
+  do {
+    rv = request->Read(buffer, kPrefetchReadBufferSize);
+  } while (rv > 0);
+
+  if (rv == net::ERR_IO_PENDING) {
+    return;
+  }
+
+  FinishPrefetch(request, rv == net::OK);
+}
+
+void HttpCacheController::FinishPrefetch(net::URLRequest* request,
+                                         bool success) {
+  auto it = active_prefetches_.find(request);
+  DCHECK(it != active_prefetches_.end());
+
+  // Deleting the request from within its delegate callbacks is fine
+  std::unique_ptr<ActivePrefetch> prefetch = std::move(it->second);
+  active_prefetches_.erase(it);
+
+  if (success) {
+    ++stats_.prefetches_succeeded;
+  } else {
+    ++stats_.prefetches_failed;
+  }
+
+  prefetch->batch->PrefetchDone(success);
+  prefetch.reset();
+
+  StartPrefetches();
+}
+
+void HttpCacheController::OnResponseStarted(net::URLRequest* request,
+                                            int net_error) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  if (net_error != net::OK || request->GetResponseCode() / 100 != 2) {
+    FinishPrefetch(request, false);
+    return;
+  }
+
+  ReadPrefetchBody(request);
+}
+
+void HttpCacheController::OnReadCompleted(net::URLRequest* request,
+                                          int bytes_read) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  if (bytes_read > 0) {
+    ReadPrefetchBody(request);
+    return;
+  }
+
+  FinishPrefetch(request, bytes_read == 0);
+}
+
+HttpCacheController::PrefetchResult::PrefetchResult()
+    : succeeded(0),
+      failed(0) {}
+
+HttpCacheController::EntryInfo::EntryInfo()
+    : cached(false),
+      size(0) {}
+
+HttpCacheController::Stats::Stats()
+    : hits(0),
+      misses(0),
+      prefetches_succeeded(0),
+      prefetches_failed(0),
+      prefetches_pending(0) {}
+
+// static
+const size_t HttpCacheController::kMaxConcurrentPrefetches = 4;
+
+HttpCacheController::HttpCacheController(net::URLRequestContext* context)
+    : context_(context),
+      weak_factory_(this) {
+  DCHECK(context_);
+}
+
+HttpCacheController::~HttpCacheController() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+}
+
+void HttpCacheController::Prefetch(const std::vector<GURL>& urls,
+                                   const PrefetchCallback& callback) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  if (urls.empty()) {
+    if (!callback.is_null()) {
+      callback.Run(PrefetchResult());
+    }
+    return;
+  }
+
+  scoped_refptr<PrefetchBatch> batch =
+      new PrefetchBatch(urls.size(), callback);
+  for (const auto& url : urls) {
+    queued_prefetches_.push_back(std::make_pair(url, batch));
+  }
+
+  StartPrefetches();
+}
+
+void HttpCacheController::GetEntryInfo(const GURL& url,
+                                       const EntryInfoCallback& callback) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  if (!url.is_valid()) {
+    callback.Run(EntryInfo());
+    return;
+  }
+
+  // This matches the key used by net::HttpCache for GET requests
+  GetBackend(base::Bind(&GetEntryInfoWithBackend,
+                        net::HttpUtil::SpecForRequest(url),
+                        callback));
+}
+
+void HttpCacheController::EvictByPrefix(const std::string& url_prefix,
+                                        const EvictCallback& callback) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  GetBackend(base::Bind(&HttpCacheController::StartEvictor,
+                        weak_factory_.GetWeakPtr(),
+                        url_prefix, callback));
+}
+
+HttpCacheController::Stats HttpCacheController::GetStats() const {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  Stats stats = stats_;
+  stats.prefetches_pending =
+      queued_prefetches_.size() + active_prefetches_.size();
+  return stats;
+}
+
+void HttpCacheController::GetSize(const SizeCallback& callback) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  GetBackend(base::Bind(&GetSizeWithBackend, callback));
+}
+
+void HttpCacheController::OnRequestCompleted(net::URLRequest* request) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  if (request->GetUserData(&kPrefetchUserDataKey)) {
+    return;
+  }
+
+  if (!request->url().SchemeIsHTTPOrHTTPS() ||
+      !request->status().is_success()) {
+    return;
+  }
+
+  if (request->was_cached()) {
+    ++stats_.hits;
+  } else {
+    ++stats_.misses;
+  }
+}
+
+} // namespace oxide
@@ -0,0 +1,168 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#ifndef _OXIDE_SHARED_BROWSER_NET_HTTP_CACHE_CONTROLLER_H_
+#define _OXIDE_SHARED_BROWSER_NET_HTTP_CACHE_CONTROLLER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/threading/thread_checker.h"
+#include "net/url_request/url_request.h"
+#include "url/gurl.h"
+
+#include "shared/common/oxide_shared_export.h"
+
+namespace disk_cache {
+class Backend;
+}
+
+namespace net {
+class URLRequestContext;
+}
+
+namespace oxide {
+
+// Provides embedders with control over the HTTP cache of a
+// URLRequestContext - prefetching URLs in to it, querying and evicting
+// entries, and reporting hit / miss statistics. This lives on the IO thread,
+// and is owned by BrowserContextIOData
+class OXIDE_SHARED_EXPORT HttpCacheController
+    : public net::URLRequest::Delegate {
+ public:
+  struct OXIDE_SHARED_EXPORT PrefetchResult {
+    PrefetchResult();
+
+    size_t succeeded;
+    size_t failed;
+  };
+
+  struct OXIDE_SHARED_EXPORT EntryInfo {
+    EntryInfo();
+
+    bool cached;
+
+    // The size of the cached response body
+    int64_t size;
+  };
+
+  struct OXIDE_SHARED_EXPORT Stats {
+    Stats();
+
+    // The number of completed HTTP(S) requests that were served from the
+    // cache (including after revalidation), and that were not. Prefetches
+    // aren't included
+    size_t hits;
+    size_t misses;
+
+    size_t prefetches_succeeded;
+    size_t prefetches_failed;
+
+    // The number of prefetches that are queued or in progress
+    size_t prefetches_pending;
+  };
+
+  typedef base::Callback<void(const PrefetchResult&)> PrefetchCallback;
+  typedef base::Callback<void(const EntryInfo&)> EntryInfoCallback;
+  typedef base::Callback<void(int)> EvictCallback;
+  typedef base::Callback<void(const Stats&)> StatsCallback;
+  typedef base::Callback<void(int64_t)> SizeCallback;
+
+  HttpCacheController(net::URLRequestContext* context);
+  ~HttpCacheController() override;
+
+  // Fetch each of |urls| in to the cache at idle priority. At most
+  // kMaxConcurrentPrefetches are in progress at once across all calls, with
+  // the remainder queued. Responses that aren't cacheable are fetched but
+  // won't be stored. |callback| is run when all of |urls| have completed
+  void Prefetch(const std::vector<GURL>& urls,
+                const PrefetchCallback& callback);
+
+  // Look up the cached response for a GET request for |url|
+  void GetEntryInfo(const GURL& url, const EntryInfoCallback& callback);
+
+  // Remove all cache entries with a URL that starts with |url_prefix|.
+  // |callback| is run with the number of entries removed
+  void EvictByPrefix(const std::string& url_prefix,
+                     const EvictCallback& callback);
+
+  Stats GetStats() const;
+
+  // Calculate the total size of all cache entries. |callback| is run with -1
+  // if the size can't be determined
+  void GetSize(const SizeCallback& callback);
+
+  // Called from the NetworkDelegate when |request| completes, for recording
+  // statistics
+  void OnRequestCompleted(net::URLRequest* request);
+
+  static const size_t kMaxConcurrentPrefetches;
+
+ private:
+  class Evictor;
+  class PrefetchBatch;
+  struct ActivePrefetch;
+
+  typedef base::Callback<void(disk_cache::Backend*)> BackendCallback;
+
+  void GetBackend(const BackendCallback& callback);
+  void OnGotBackend(const BackendCallback& callback,
+                    disk_cache::Backend** backend,
+                    int rv);
+
+  void StartEvictor(const std::string& url_prefix,
+                    const EvictCallback& callback,
+                    disk_cache::Backend* backend);
+  void OnEvictorDone(Evictor* evictor);
+
+  void StartPrefetches();
+  void ReadPrefetchBody(net::URLRequest* request);
+  void FinishPrefetch(net::URLRequest* request, bool success);
+
+  // net::URLRequest::Delegate implementation
+  void OnResponseStarted(net::URLRequest* request, int net_error) override;
+  void OnReadCompleted(net::URLRequest* request, int bytes_read) override;
+
+  base::ThreadChecker thread_checker_;
+
+  net::URLRequestContext* context_;
+
+  std::deque<std::pair<GURL, scoped_refptr<PrefetchBatch>>> queued_prefetches_;
+  std::unordered_map<net::URLRequest*,
+                     std::unique_ptr<ActivePrefetch>> active_prefetches_;
+
+  std::vector<std::unique_ptr<Evictor>> evictors_;
+
+  Stats stats_;
+
+  base::WeakPtrFactory<HttpCacheController> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(HttpCacheController);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_NET_HTTP_CACHE_CONTROLLER_H_
@@ -0,0 +1,187 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "oxide_network_callback_tracker.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/timer/timer.h"
+#include "base/trace_event/trace_event.h"
+#include "net/base/net_errors.h"
+
+namespace oxide {
+
+namespace {
+const char kTraceEventName[] = "oxide::NetworkCallbackTracker:pending";
+}
+
+struct NetworkCallbackTracker::PendingCallback {
+  uint64_t id;
+  net::CompletionCallback callback;
+  int timeout_result;
+  base::TimeTicks start_time;
+  std::unique_ptr<base::OneShotTimer> timer;
+};
+
+void NetworkCallbackTracker::OnTimeout(const net::URLRequest* request,
+                                       uint64_t id) {
+  auto it = pending_.find(request);
+  DCHECK(it != pending_.end());
+  DCHECK_EQ(it->second->id, id);
+
+  // Remove the entry before running the callback, as the request may start
+  // another callback from it. This deletes the timer that is running us,
+  // which is fine as we don't touch it afterwards
+  net::CompletionCallback callback = it->second->callback;
+  int result = it->second->timeout_result;
+  pending_.erase(it);
+
+  TRACE_EVENT_ASYNC_END1("oxide.delegate_worker", kTraceEventName, request,
+                         "result", "timed_out");
+
+  ++stats_.timed_out;
+  UMA_HISTOGRAM_BOOLEAN("Oxide.NetworkDelegate.CallbackTimedOut", true);
+
+  callback.Run(result);
+}
+
+void NetworkCallbackTracker::RecordLatency(base::TimeTicks start_time) {
+  base::TimeDelta latency = base::TimeTicks::Now() - start_time;
+
+  ++stats_.completed;
+  stats_.total_latency += latency;
+  stats_.max_latency = std::max(stats_.max_latency, latency);
+
+  UMA_HISTOGRAM_BOOLEAN("Oxide.NetworkDelegate.CallbackTimedOut", false);
+  UMA_HISTOGRAM_TIMES("Oxide.NetworkDelegate.CallbackLatency", latency);
+}
+
+NetworkCallbackTracker::Stats::Stats()
+    : completed(0),
+      timed_out(0),
+      abandoned(0) {}
+
+NetworkCallbackTracker::NetworkCallbackTracker()
+    : next_id_(0) {
+  // We're typically created on the UI thread and used on the IO thread
+  thread_checker_.DetachFromThread();
+}
+
+NetworkCallbackTracker::~NetworkCallbackTracker() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+}
+
+uint64_t NetworkCallbackTracker::Start(const net::URLRequest* request,
+                                       const net::CompletionCallback& callback,
+                                       base::TimeDelta timeout,
+                                       int timeout_result) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  DCHECK(pending_.find(request) == pending_.end())
+      << "Request already has a pending network delegate callback";
+
+  uint64_t id = next_id_++;
+
+  std::unique_ptr<PendingCallback> entry(new PendingCallback);
+  entry->id = id;
+  entry->callback = callback;
+  entry->timeout_result = timeout_result;
+  entry->start_time = base::TimeTicks::Now();
+
+  if (!timeout.is_zero()) {
+    entry->timer.reset(new base::OneShotTimer());
+    entry->timer->Start(FROM_HERE,
+                        timeout,
+                        base::Bind(&NetworkCallbackTracker::OnTimeout,
+                                   base::Unretained(this),
+                                   request, id));
+  }
+
+  pending_[request] = std::move(entry);
+
+  TRACE_EVENT_ASYNC_BEGIN0("oxide.delegate_worker", kTraceEventName, request);
+
+  return id;
+}
+
+int NetworkCallbackTracker::DidReturn(const net::URLRequest* request,
+                                      uint64_t id,
+                                      int rv) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  if (rv == net::ERR_IO_PENDING) {
+    return rv;
+  }
+
+  auto it = pending_.find(request);
+  if (it == pending_.end() || it->second->id != id) {
+    return rv;
+  }
+
+  RecordLatency(it->second->start_time);
+  pending_.erase(it);
+
+  TRACE_EVENT_ASYNC_END1("oxide.delegate_worker", kTraceEventName, request,
+                         "result", "completed");
+
+  return rv;
+}
+
+bool NetworkCallbackTracker::IsPending(const net::URLRequest* request,
+                                       uint64_t id) const {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  auto it = pending_.find(request);
+  return it != pending_.end() && it->second->id == id;
+}
+
+void NetworkCallbackTracker::Complete(const net::URLRequest* request,
+                                      uint64_t id,
+                                      int result) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  DCHECK_NE(result, net::ERR_IO_PENDING);
+
+  auto it = pending_.find(request);
+  if (it == pending_.end() || it->second->id != id) {
+    // The request was destroyed, or we timed out
+    return;
+  }
+
+  net::CompletionCallback callback = it->second->callback;
+  RecordLatency(it->second->start_time);
+  pending_.erase(it);
+
+  TRACE_EVENT_ASYNC_END1("oxide.delegate_worker", kTraceEventName, request,
+                         "result", "completed");
+
+  callback.Run(result);
+}
+
+void NetworkCallbackTracker::OnURLRequestDestroyed(
+    const net::URLRequest* request) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  if (pending_.erase(request) > 0) {
+    TRACE_EVENT_ASYNC_END1("oxide.delegate_worker", kTraceEventName, request,
+                           "result", "abandoned");
+    ++stats_.abandoned;
+  }
+}
+
+} // namespace oxide
@@ -0,0 +1,124 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_SHARED_BROWSER_NET_NETWORK_CALLBACK_TRACKER_H_
+#define _OXIDE_SHARED_BROWSER_NET_NETWORK_CALLBACK_TRACKER_H_
+
+#include <stdint.h>
+#include <memory>
+#include <unordered_map>
+
+#include "base/macros.h"
+#include "base/threading/thread_checker.h"
+#include "base/time/time.h"
+#include "net/base/completion_callback.h"
+
+#include "shared/common/oxide_shared_export.h"
+
+namespace base {
+class OneShotTimer;
+}
+
+namespace net {
+class URLRequest;
+}
+
+namespace oxide {
+
+// Tracks network delegate callbacks that are completed asynchronously by a
+// BrowserContextDelegate. Each pending callback can have a timeout, after
+// which the request continues with a fallback result rather than waiting
+// indefinitely. Callbacks for requests that have been destroyed are dropped.
+//
+// A URLRequest can only have one pending network delegate callback at a
+// time. This class must only be used on the thread it is created on
+class OXIDE_SHARED_EXPORT NetworkCallbackTracker {
+ public:
+  struct OXIDE_SHARED_EXPORT Stats {
+    Stats();
+
+    // The number of callbacks that completed before timing out, either
+    // synchronously or asynchronously
+    size_t completed;
+
+    // The number of callbacks that timed out
+    size_t timed_out;
+
+    // The number of callbacks abandoned because the request was destroyed
+    size_t abandoned;
+
+    // The total and maximum latency of completed callbacks
+    base::TimeDelta total_latency;
+    base::TimeDelta max_latency;
+  };
+
+  NetworkCallbackTracker();
+  ~NetworkCallbackTracker();
+
+  // Start tracking a callback for |request|. |callback| will be run once,
+  // either by Complete or after |timeout| with |timeout_result|. A zero
+  // |timeout| means there is no timeout. Returns an ID that identifies this
+  // callback in later calls
+  uint64_t Start(const net::URLRequest* request,
+                 const net::CompletionCallback& callback,
+                 base::TimeDelta timeout,
+                 int timeout_result);
+
+  // Notify that the delegate returned |rv| for the callback identified by
+  // |request| and |id|. If |rv| is not net::ERR_IO_PENDING, the delegate
+  // completed synchronously and the callback is no longer tracked (it isn't
+  // run). Returns |rv|
+  int DidReturn(const net::URLRequest* request, uint64_t id, int rv);
+
+  // Returns true if the callback identified by |request| and |id| is still
+  // pending. Callers should check this before writing to out-parameters
+  // owned by |request|
+  bool IsPending(const net::URLRequest* request, uint64_t id) const;
+
+  // Complete the callback identified by |request| and |id| with |result|.
+  // Does nothing if it is no longer pending
+  void Complete(const net::URLRequest* request, uint64_t id, int result);
+
+  // Drop any pending callback for |request|
+  void OnURLRequestDestroyed(const net::URLRequest* request);
+
+  size_t pending_count() const { return pending_.size(); }
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  struct PendingCallback;
+
+  void OnTimeout(const net::URLRequest* request, uint64_t id);
+
+  void RecordLatency(base::TimeTicks start_time);
+
+  base::ThreadChecker thread_checker_;
+
+  uint64_t next_id_;
+
+  std::unordered_map<const net::URLRequest*,
+                     std::unique_ptr<PendingCallback>> pending_;
+
+  Stats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(NetworkCallbackTracker);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_NET_NETWORK_CALLBACK_TRACKER_H_
@@ -0,0 +1,199 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/macros.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/time/time.h"
+#include "net/base/net_errors.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include "oxide_network_callback_tracker.h"
+
+namespace oxide {
+
+namespace {
+
+// The tracker only uses URLRequest pointers as keys, so these tests use
+// addresses in a local buffer rather than constructing real requests
+const net::URLRequest* FakeRequest(char* storage) {
+  return reinterpret_cast<const net::URLRequest*>(storage);
+}
+
+void RecordResult(std::vector<int>* results, int result) {
+  results->push_back(result);
+}
+
+}
+
+class NetworkCallbackTrackerTest : public testing::Test {
+ protected:
+  NetworkCallbackTrackerTest() {}
+
+  net::CompletionCallback MakeCallback() {
+    return base::Bind(&RecordResult, base::Unretained(&results_));
+  }
+
+  void RunFor(base::TimeDelta delay) {
+    base::RunLoop run_loop;
+    base::ThreadTaskRunnerHandle::Get()->PostDelayedTask(
+        FROM_HERE, run_loop.QuitClosure(), delay);
+    run_loop.Run();
+  }
+
+  base::MessageLoop message_loop_;
+  NetworkCallbackTracker tracker_;
+  std::vector<int> results_;
+  char requests_[4];
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(NetworkCallbackTrackerTest);
+};
+
+TEST_F(NetworkCallbackTrackerTest, SynchronousResult) {
+  const net::URLRequest* request = FakeRequest(&requests_[0]);
+
+  uint64_t id = tracker_.Start(request, MakeCallback(), base::TimeDelta(),
+                               net::OK);
+  EXPECT_TRUE(tracker_.IsPending(request, id));
+
+  EXPECT_EQ(net::ERR_ABORTED,
+            tracker_.DidReturn(request, id, net::ERR_ABORTED));
+  EXPECT_FALSE(tracker_.IsPending(request, id));
+  EXPECT_EQ(0U, tracker_.pending_count());
+
+  // The callback isn't run for synchronous results
+  EXPECT_TRUE(results_.empty());
+  EXPECT_EQ(1U, tracker_.stats().completed);
+}
+
+TEST_F(NetworkCallbackTrackerTest, AsynchronousResult) {
+  const net::URLRequest* request = FakeRequest(&requests_[0]);
+
+  uint64_t id = tracker_.Start(request, MakeCallback(), base::TimeDelta(),
+                               net::OK);
+  EXPECT_EQ(net::ERR_IO_PENDING,
+            tracker_.DidReturn(request, id, net::ERR_IO_PENDING));
+  EXPECT_TRUE(tracker_.IsPending(request, id));
+  EXPECT_EQ(1U, tracker_.pending_count());
+
+  tracker_.Complete(request, id, net::ERR_ABORTED);
+  ASSERT_EQ(1U, results_.size());
+  EXPECT_EQ(net::ERR_ABORTED, results_[0]);
+  EXPECT_FALSE(tracker_.IsPending(request, id));
+
+  // Completing twice does nothing
+  tracker_.Complete(request, id, net::OK);
+  EXPECT_EQ(1U, results_.size());
+
+  EXPECT_EQ(1U, tracker_.stats().completed);
+  EXPECT_EQ(0U, tracker_.stats().timed_out);
+  EXPECT_LE(tracker_.stats().max_latency, tracker_.stats().total_latency);
+}
+
+TEST_F(NetworkCallbackTrackerTest, RequestDestroyed) {
+  const net::URLRequest* request = FakeRequest(&requests_[0]);
+
+  uint64_t id = tracker_.Start(request, MakeCallback(),
+                               base::TimeDelta::FromMilliseconds(10),
+                               net::OK);
+  tracker_.DidReturn(request, id, net::ERR_IO_PENDING);
+
+  tracker_.OnURLRequestDestroyed(request);
+  EXPECT_FALSE(tracker_.IsPending(request, id));
+  EXPECT_EQ(1U, tracker_.stats().abandoned);
+
+  // Neither a late completion nor the timeout should run the callback
+  tracker_.Complete(request, id, net::OK);
+  RunFor(base::TimeDelta::FromMilliseconds(50));
+  EXPECT_TRUE(results_.empty());
+  EXPECT_EQ(0U, tracker_.stats().timed_out);
+}
+
+TEST_F(NetworkCallbackTrackerTest, Timeout) {
+  const net::URLRequest* request = FakeRequest(&requests_[0]);
+
+  uint64_t id = tracker_.Start(request, MakeCallback(),
+                               base::TimeDelta::FromMilliseconds(10),
+                               net::ERR_ABORTED);
+  tracker_.DidReturn(request, id, net::ERR_IO_PENDING);
+
+  RunFor(base::TimeDelta::FromMilliseconds(50));
+
+  ASSERT_EQ(1U, results_.size());
+  EXPECT_EQ(net::ERR_ABORTED, results_[0]);
+  EXPECT_FALSE(tracker_.IsPending(request, id));
+  EXPECT_EQ(1U, tracker_.stats().timed_out);
+  EXPECT_EQ(0U, tracker_.stats().completed);
+
+  // The delegate completing after the timeout is ignored
+  tracker_.Complete(request, id, net::OK);
+  EXPECT_EQ(1U, results_.size());
+}
+
+TEST_F(NetworkCallbackTrackerTest, StaleIdForSameRequest) {
+  const net::URLRequest* request = FakeRequest(&requests_[0]);
+
+  uint64_t id1 = tracker_.Start(request, MakeCallback(),
+                                base::TimeDelta::FromMilliseconds(10),
+                                net::OK);
+  tracker_.DidReturn(request, id1, net::ERR_IO_PENDING);
+  RunFor(base::TimeDelta::FromMilliseconds(50));
+  ASSERT_EQ(1U, results_.size());
+
+  // The request moves on to its next callback
+  uint64_t id2 = tracker_.Start(request, MakeCallback(), base::TimeDelta(),
+                                net::OK);
+  tracker_.DidReturn(request, id2, net::ERR_IO_PENDING);
+
+  // A late completion for the first callback mustn't complete the second
+  EXPECT_FALSE(tracker_.IsPending(request, id1));
+  tracker_.Complete(request, id1, net::ERR_ABORTED);
+  EXPECT_EQ(1U, results_.size());
+  EXPECT_TRUE(tracker_.IsPending(request, id2));
+
+  tracker_.Complete(request, id2, net::OK);
+  ASSERT_EQ(2U, results_.size());
+  EXPECT_EQ(net::OK, results_[1]);
+}
+
+TEST_F(NetworkCallbackTrackerTest, MultipleRequests) {
+  const net::URLRequest* request1 = FakeRequest(&requests_[0]);
+  const net::URLRequest* request2 = FakeRequest(&requests_[1]);
+
+  uint64_t id1 = tracker_.Start(request1, MakeCallback(), base::TimeDelta(),
+                                net::OK);
+  uint64_t id2 = tracker_.Start(request2, MakeCallback(), base::TimeDelta(),
+                                net::OK);
+  tracker_.DidReturn(request1, id1, net::ERR_IO_PENDING);
+  tracker_.DidReturn(request2, id2, net::ERR_IO_PENDING);
+  EXPECT_EQ(2U, tracker_.pending_count());
+
+  tracker_.Complete(request2, id2, net::ERR_ABORTED);
+  tracker_.Complete(request1, id1, net::OK);
+
+  ASSERT_EQ(2U, results_.size());
+  EXPECT_EQ(net::ERR_ABORTED, results_[0]);
+  EXPECT_EQ(net::OK, results_[1]);
+  EXPECT_EQ(2U, tracker_.stats().completed);
+}
+
+} // namespace oxide
@@ -0,0 +1,214 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#include "oxide_packed_archive.h"
+
+#include <utility>
+
+#include "base/files/file_path.h"
+#include "base/logging.h"
+
+namespace oxide {
+
+namespace {
+
+// See https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
+const uint32_t kEndOfCentralDirectorySignature = 0x06054b50;
+const uint32_t kCentralDirectoryHeaderSignature = 0x02014b50;
+const uint32_t kLocalFileHeaderSignature = 0x04034b50;
+
+const size_t kEndOfCentralDirectorySize = 22;
+const size_t kCentralDirectoryHeaderSize = 46;
+const size_t kLocalFileHeaderSize = 30;
+
+const size_t kMaxCommentSize = 0xffff;
+
+const uint16_t kEncryptedFlag = 1 << 0;
+const uint16_t kStoredMethod = 0;
+
+uint16_t ReadUInt16(const uint8_t* p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadUInt32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) |
+         (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+}
+
+PackedArchive::PackedArchive() = default;
+
+PackedArchive::~PackedArchive() = default;
+
+bool PackedArchive::Index() {
+  const uint8_t* data = file_.data();
+  size_t length = file_.length();
+
+  if (length < kEndOfCentralDirectorySize) {
+    return false;
+  }
+
+  // The end of central directory record is at the end of the file, followed
+  // by a variable length comment
+  size_t min_eocd_offset =
+      length > kEndOfCentralDirectorySize + kMaxCommentSize ?
+          length - kEndOfCentralDirectorySize - kMaxCommentSize : 0;
+  size_t eocd_offset = length - kEndOfCentralDirectorySize + 1;
+  bool found = false;
+  while (eocd_offset-- > min_eocd_offset) {
+    if (ReadUInt32(data + eocd_offset) == kEndOfCentralDirectorySignature) {
+      found = true;
+      break;
+    }
+  }
+
+  if (!found) {
+    return false;
+  }
+
+  const uint8_t* eocd = data + eocd_offset;
+  uint16_t entry_count = ReadUInt16(eocd + 10);
+  uint32_t cd_size = ReadUInt32(eocd + 12);
+  uint32_t cd_offset = ReadUInt32(eocd + 16);
+
+  if (entry_count == 0xffff || cd_size == 0xffffffff ||
+      cd_offset == 0xffffffff) {
+    LOG(WARNING) << "ZIP64 archives are not supported";
+    return false;
+  }
+
+  if (cd_offset > eocd_offset || cd_size > eocd_offset - cd_offset) {
+    return false;
+  }
+
+  entries_.reserve(entry_count);
+
+  size_t pos = cd_offset;
+  size_t cd_end = cd_offset + cd_size;
+
+  for (uint16_t i = 0; i < entry_count; ++i) {
+    if (cd_end - pos < kCentralDirectoryHeaderSize) {
+      return false;
+    }
+
+    const uint8_t* header = data + pos;
+    if (ReadUInt32(header) != kCentralDirectoryHeaderSignature) {
+      return false;
+    }
+
+    uint16_t flags = ReadUInt16(header + 8);
+    uint16_t method = ReadUInt16(header + 10);
+    uint32_t crc32 = ReadUInt32(header + 16);
+    uint32_t compressed_size = ReadUInt32(header + 20);
+    uint32_t uncompressed_size = ReadUInt32(header + 24);
+    uint16_t name_length = ReadUInt16(header + 28);
+    uint16_t extra_length = ReadUInt16(header + 30);
+    uint16_t comment_length = ReadUInt16(header + 32);
+    uint32_t local_header_offset = ReadUInt32(header + 42);
+
+    size_t header_size =
+        kCentralDirectoryHeaderSize + name_length + extra_length +
+        comment_length;
+    if (cd_end - pos < header_size) {
+      return false;
+    }
+
+    std::string name(
+        reinterpret_cast<const char*>(header + kCentralDirectoryHeaderSize),
+        name_length);
+    pos += header_size;
+
+    if (name.empty() || name.back() == '/') {
+      // Directory
+      continue;
+    }
+
+    if ((flags & kEncryptedFlag) || method != kStoredMethod ||
+        compressed_size != uncompressed_size ||
+        compressed_size == 0xffffffff ||
+        local_header_offset == 0xffffffff) {
+      LOG(WARNING) << "Skipping archive entry \"" << name
+                   << "\", which is not stored uncompressed";
+      continue;
+    }
+
+    // Entry data always precedes the central directory
+    if (local_header_offset > cd_offset ||
+        cd_offset - local_header_offset < kLocalFileHeaderSize) {
+      return false;
+    }
+
+    const uint8_t* local_header = data + local_header_offset;
+    if (ReadUInt32(local_header) != kLocalFileHeaderSignature) {
+      return false;
+    }
+
+    size_t data_offset =
+        local_header_offset + kLocalFileHeaderSize +
+        ReadUInt16(local_header + 26) + ReadUInt16(local_header + 28);
+    if (data_offset > cd_offset ||
+        cd_offset - data_offset < compressed_size) {
+      return false;
+    }
+
+    Entry entry;
+    entry.offset = data_offset;
+    entry.size = compressed_size;
+    entry.crc32 = crc32;
+
+    entries_.insert(std::make_pair(name, entry));
+  }
+
+  return true;
+}
+
+// static
+scoped_refptr<PackedArchive> PackedArchive::Open(const base::FilePath& path) {
+  scoped_refptr<PackedArchive> archive = new PackedArchive();
+
+  if (!archive->file_.Initialize(path)) {
+    LOG(ERROR) << "Failed to map archive " << path.value();
+    return nullptr;
+  }
+
+  if (!archive->Index()) {
+    LOG(ERROR) << "Failed to read archive " << path.value();
+    return nullptr;
+  }
+
+  return archive;
+}
+
+const PackedArchive::Entry* PackedArchive::FindEntry(
+    const std::string& path) const {
+  auto it = entries_.find(path);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+
+  return &it->second;
+}
+
+base::StringPiece PackedArchive::GetData(const Entry& entry) const {
+  return base::StringPiece(
+      reinterpret_cast<const char*>(file_.data() + entry.offset),
+      entry.size);
+}
+
+} // namespace oxide
@@ -0,0 +1,88 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#ifndef _OXIDE_SHARED_BROWSER_NET_PACKED_ARCHIVE_H_
+#define _OXIDE_SHARED_BROWSER_NET_PACKED_ARCHIVE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+#include "base/files/memory_mapped_file.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string_piece.h"
+
+#include "shared/common/oxide_shared_export.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace oxide {
+
+// A read-only archive of application resources, memory mapped from disk and
+// indexed by path. The archive is a ZIP file in which every entry is stored
+// without compression (eg, created with "zip -0"), which allows entries to be
+// served directly from the mapping. Entries that are deflated, encrypted or
+// that require ZIP64 are skipped.
+//
+// Entries can be precompressed by storing them with a ".gz" or ".br" suffix
+// alongside (or instead of) the uncompressed entry.
+//
+// Once opened, this class is immutable and can be used from any thread
+class OXIDE_SHARED_EXPORT PackedArchive
+    : public base::RefCountedThreadSafe<PackedArchive> {
+ public:
+  struct Entry {
+    size_t offset;
+    size_t size;
+    uint32_t crc32;
+  };
+
+  // Map and index the archive at |path|. This performs blocking IO. Returns
+  // nullptr if the file can't be mapped or isn't a valid archive
+  static scoped_refptr<PackedArchive> Open(const base::FilePath& path);
+
+  // Returns the entry for |path|, which is relative to the root of the
+  // archive and has no leading slash. Returns nullptr if there isn't one
+  const Entry* FindEntry(const std::string& path) const;
+
+  // Returns the contents of |entry|. The returned data is valid for the
+  // lifetime of this archive
+  base::StringPiece GetData(const Entry& entry) const;
+
+  size_t GetEntryCount() const { return entries_.size(); }
+
+ private:
+  friend class base::RefCountedThreadSafe<PackedArchive>;
+
+  PackedArchive();
+  ~PackedArchive();
+
+  bool Index();
+
+  base::MemoryMappedFile file_;
+
+  std::unordered_map<std::string, Entry> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(PackedArchive);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_NET_PACKED_ARCHIVE_H_
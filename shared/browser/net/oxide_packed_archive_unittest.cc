@@ -0,0 +1,207 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/macros.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+#include "oxide_packed_archive.h"
+#include "oxide_url_request_packed_archive_job.h"
+
+namespace oxide {
+
+namespace {
+
+void AppendUInt16(std::string* out, uint16_t value) {
+  out->push_back(static_cast<char>(value & 0xff));
+  out->push_back(static_cast<char>(value >> 8));
+}
+
+void AppendUInt32(std::string* out, uint32_t value) {
+  AppendUInt16(out, static_cast<uint16_t>(value & 0xffff));
+  AppendUInt16(out, static_cast<uint16_t>(value >> 16));
+}
+
+// Builds a minimal ZIP archive in memory. The CRC fields aren't validated by
+// PackedArchive, so each entry is given a fake CRC
+class ArchiveBuilder {
+ public:
+  ArchiveBuilder() {}
+
+  void AddEntry(const std::string& name,
+                const std::string& data,
+                uint16_t method = 0) {
+    uint32_t crc32 = static_cast<uint32_t>(entries_.size() + 1);
+    uint32_t offset = static_cast<uint32_t>(data_.size());
+
+    AppendUInt32(&data_, 0x04034b50);
+    AppendUInt16(&data_, 10); // Version needed
+    AppendUInt16(&data_, 0); // Flags
+    AppendUInt16(&data_, method);
+    AppendUInt32(&data_, 0); // Time and date
+    AppendUInt32(&data_, crc32);
+    AppendUInt32(&data_, static_cast<uint32_t>(data.size()));
+    AppendUInt32(&data_, static_cast<uint32_t>(data.size()));
+    AppendUInt16(&data_, static_cast<uint16_t>(name.size()));
+    AppendUInt16(&data_, 0); // Extra length
+    data_ += name;
+    data_ += data;
+
+    AppendUInt32(&central_directory_, 0x02014b50);
+    AppendUInt16(&central_directory_, 10); // Version made by
+    AppendUInt16(&central_directory_, 10); // Version needed
+    AppendUInt16(&central_directory_, 0); // Flags
+    AppendUInt16(&central_directory_, method);
+    AppendUInt32(&central_directory_, 0); // Time and date
+    AppendUInt32(&central_directory_, crc32);
+    AppendUInt32(&central_directory_, static_cast<uint32_t>(data.size()));
+    AppendUInt32(&central_directory_, static_cast<uint32_t>(data.size()));
+    AppendUInt16(&central_directory_, static_cast<uint16_t>(name.size()));
+    AppendUInt16(&central_directory_, 0); // Extra length
+    AppendUInt16(&central_directory_, 0); // Comment length
+    AppendUInt16(&central_directory_, 0); // Disk number
+    AppendUInt16(&central_directory_, 0); // Internal attributes
+    AppendUInt32(&central_directory_, 0); // External attributes
+    AppendUInt32(&central_directory_, offset);
+    central_directory_ += name;
+
+    entries_.push_back(name);
+  }
+
+  std::string Build() const {
+    std::string archive = data_ + central_directory_;
+    AppendUInt32(&archive, 0x06054b50);
+    AppendUInt16(&archive, 0); // Disk number
+    AppendUInt16(&archive, 0); // Central directory disk
+    AppendUInt16(&archive, static_cast<uint16_t>(entries_.size()));
+    AppendUInt16(&archive, static_cast<uint16_t>(entries_.size()));
+    AppendUInt32(&archive, static_cast<uint32_t>(central_directory_.size()));
+    AppendUInt32(&archive, static_cast<uint32_t>(data_.size()));
+    AppendUInt16(&archive, 0); // Comment length
+    return archive;
+  }
+
+ private:
+  std::string data_;
+  std::string central_directory_;
+  std::vector<std::string> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArchiveBuilder);
+};
+
+}
+
+class PackedArchiveTest : public testing::Test {
+ protected:
+  PackedArchiveTest() {}
+
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  }
+
+  scoped_refptr<PackedArchive> OpenArchive(const std::string& contents) {
+    base::FilePath path = temp_dir_.GetPath().AppendASCII("test.zip");
+    int size = static_cast<int>(contents.size());
+    EXPECT_EQ(size, base::WriteFile(path, contents.data(), size));
+    return PackedArchive::Open(path);
+  }
+
+ private:
+  base::ScopedTempDir temp_dir_;
+
+  DISALLOW_COPY_AND_ASSIGN(PackedArchiveTest);
+};
+
+TEST_F(PackedArchiveTest, FindEntry) {
+  ArchiveBuilder builder;
+  builder.AddEntry("index.html", "<html></html>");
+  builder.AddEntry("js/", "");
+  builder.AddEntry("js/app.js", "var a = 1;");
+
+  scoped_refptr<PackedArchive> archive = OpenArchive(builder.Build());
+  ASSERT_TRUE(archive.get());
+
+  EXPECT_EQ(2U, archive->GetEntryCount());
+
+  const PackedArchive::Entry* entry = archive->FindEntry("js/app.js");
+  ASSERT_TRUE(entry);
+  EXPECT_EQ("var a = 1;", archive->GetData(*entry).as_string());
+  EXPECT_EQ(3U, entry->crc32);
+
+  entry = archive->FindEntry("index.html");
+  ASSERT_TRUE(entry);
+  EXPECT_EQ("<html></html>", archive->GetData(*entry).as_string());
+
+  EXPECT_FALSE(archive->FindEntry("js/"));
+  EXPECT_FALSE(archive->FindEntry("/index.html"));
+  EXPECT_FALSE(archive->FindEntry("missing.html"));
+}
+
+TEST_F(PackedArchiveTest, SkipsCompressedEntries) {
+  ArchiveBuilder builder;
+  builder.AddEntry("stored.txt", "stored");
+  builder.AddEntry("deflated.txt", "deflated", 8);
+
+  scoped_refptr<PackedArchive> archive = OpenArchive(builder.Build());
+  ASSERT_TRUE(archive.get());
+
+  EXPECT_TRUE(archive->FindEntry("stored.txt"));
+  EXPECT_FALSE(archive->FindEntry("deflated.txt"));
+}
+
+TEST_F(PackedArchiveTest, InvalidArchive) {
+  EXPECT_FALSE(OpenArchive(std::string()).get());
+  EXPECT_FALSE(OpenArchive("not an archive").get());
+
+  ArchiveBuilder builder;
+  builder.AddEntry("index.html", "<html></html>");
+  std::string contents = builder.Build();
+
+  // Truncate the central directory
+  std::string truncated = contents.substr(0, contents.size() - 30);
+  truncated += contents.substr(contents.size() - 22);
+  EXPECT_FALSE(OpenArchive(truncated).get());
+}
+
+TEST(URLRequestPackedArchiveJobTest, GetEntryPathForURL) {
+  EXPECT_EQ("index.html",
+            URLRequestPackedArchiveJob::GetEntryPathForURL(
+                GURL("app://host/")));
+  EXPECT_EQ("index.html",
+            URLRequestPackedArchiveJob::GetEntryPathForURL(
+                GURL("app://host")));
+  EXPECT_EQ("js/app.js",
+            URLRequestPackedArchiveJob::GetEntryPathForURL(
+                GURL("app://host/js/app.js?v=1#top")));
+  EXPECT_EQ("docs/index.html",
+            URLRequestPackedArchiveJob::GetEntryPathForURL(
+                GURL("app:///docs/")));
+  EXPECT_EQ("my file.txt",
+            URLRequestPackedArchiveJob::GetEntryPathForURL(
+                GURL("app://host/my%20file.txt")));
+  EXPECT_EQ("js/app.js",
+            URLRequestPackedArchiveJob::GetEntryPathForURL(
+                GURL("https://example.com/js/app.js")));
+}
+
+} // namespace oxide
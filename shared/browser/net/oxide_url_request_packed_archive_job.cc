@@ -0,0 +1,319 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#include "oxide_url_request_packed_archive_job.h"
+
+#include <string.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "net/base/escape.h"
+#include "net/base/io_buffer.h"
+#include "net/base/mime_util.h"
+#include "net/base/net_errors.h"
+#include "net/filter/brotli_source_stream.h"
+#include "net/filter/gzip_source_stream.h"
+#include "net/filter/source_stream.h"
+#include "net/http/http_byte_range.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_response_info.h"
+#include "net/http/http_status_code.h"
+#include "net/http/http_util.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_status.h"
+#include "url/gurl.h"
+
+#include "oxide_packed_archive.h"
+
+namespace oxide {
+
+namespace {
+
+const char kDefaultMimeType[] = "application/octet-stream";
+const char kIndexFile[] = "index.html";
+
+std::string GetETagForEntry(const PackedArchive::Entry& entry) {
+  return base::StringPrintf("\"%08x-%zx\"", entry.crc32, entry.size);
+}
+
+bool MatchesETag(const std::string& if_none_match, const std::string& etag) {
+  for (const base::StringPiece& tag :
+       base::SplitStringPiece(if_none_match, ",",
+                              base::TRIM_WHITESPACE,
+                              base::SPLIT_WANT_NONEMPTY)) {
+    base::StringPiece t = tag;
+    if (t == "*") {
+      return true;
+    }
+    // If-None-Match uses weak comparison
+    if (t.starts_with("W/")) {
+      t.remove_prefix(2);
+    }
+    if (t == etag) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}
+
+void URLRequestPackedArchiveJob::StartAsync() {
+  const std::string& method = request()->method();
+  if (method != "GET" && method != "HEAD") {
+    NotifyStartError(net::URLRequestStatus(net::URLRequestStatus::FAILED,
+                                           net::ERR_METHOD_NOT_SUPPORTED));
+    return;
+  }
+
+  std::string path = GetEntryPathForURL(request()->url());
+
+  const PackedArchive::Entry* entry = nullptr;
+
+  // Ranges apply to the encoded representation, so always serve range
+  // requests from the uncompressed entry
+  if (!has_range_header_) {
+    if ((entry = archive_->FindEntry(path + ".br"))) {
+      content_encoding_ = CONTENT_ENCODING_BROTLI;
+    } else if ((entry = archive_->FindEntry(path + ".gz"))) {
+      content_encoding_ = CONTENT_ENCODING_GZIP;
+    }
+  }
+
+  if (!entry) {
+    entry = archive_->FindEntry(path);
+  }
+
+  if (!entry) {
+    NotifyStartError(net::URLRequestStatus(net::URLRequestStatus::FAILED,
+                                           net::ERR_FILE_NOT_FOUND));
+    return;
+  }
+
+  base::FilePath::StringType extension =
+      base::FilePath::FromUTF8Unsafe(path).Extension();
+  if (extension.empty() ||
+      !net::GetWellKnownMimeTypeFromExtension(extension.substr(1),
+                                              &mime_type_)) {
+    mime_type_ = kDefaultMimeType;
+  }
+
+  std::string etag = GetETagForEntry(*entry);
+  std::string headers = "ETag: " + etag + "\n";
+
+  if (!if_none_match_header_.empty() &&
+      MatchesETag(if_none_match_header_, etag)) {
+    NotifyHeadersCompleteWithStatus(net::HTTP_NOT_MODIFIED, headers);
+    return;
+  }
+
+  base::StringPiece data = archive_->GetData(*entry);
+  int status = net::HTTP_OK;
+
+  headers += "Content-Type: " + mime_type_ + "\n";
+
+  switch (content_encoding_) {
+    case CONTENT_ENCODING_NONE:
+      headers += "Accept-Ranges: bytes\n";
+      break;
+    case CONTENT_ENCODING_GZIP:
+      headers += "Content-Encoding: gzip\n";
+      break;
+    case CONTENT_ENCODING_BROTLI:
+      headers += "Content-Encoding: br\n";
+      break;
+  }
+
+  if (has_range_header_) {
+    std::vector<net::HttpByteRange> ranges;
+    // Multiple ranges aren't supported, in which case we ignore the header
+    // and return the whole entry, which is permitted by RFC 7233
+    if (net::HttpUtil::ParseRangeHeader(range_header_, &ranges) &&
+        ranges.size() == 1) {
+      net::HttpByteRange range = ranges[0];
+      if (!range.ComputeBounds(data.size())) {
+        NotifyStartError(
+            net::URLRequestStatus(net::URLRequestStatus::FAILED,
+                                  net::ERR_REQUEST_RANGE_NOT_SATISFIABLE));
+        return;
+      }
+
+      size_t first = static_cast<size_t>(range.first_byte_position());
+      size_t last = static_cast<size_t>(range.last_byte_position());
+      headers += base::StringPrintf("Content-Range: bytes %zu-%zu/%zu\n",
+                                    first, last, data.size());
+      data = data.substr(first, last - first + 1);
+      status = net::HTTP_PARTIAL_CONTENT;
+    }
+  }
+
+  if (content_encoding_ == CONTENT_ENCODING_NONE) {
+    headers += base::StringPrintf("Content-Length: %zu\n", data.size());
+  }
+
+  if (method != "HEAD") {
+    body_ = data;
+  }
+
+  NotifyHeadersCompleteWithStatus(status, headers);
+}
+
+void URLRequestPackedArchiveJob::NotifyHeadersCompleteWithStatus(
+    int status,
+    const std::string& extra_headers) {
+  std::string raw_headers =
+      base::StringPrintf("HTTP/1.1 %d %s\n",
+                         status,
+                         net::GetHttpReasonPhrase(
+                             static_cast<net::HttpStatusCode>(status)));
+  raw_headers += extra_headers;
+
+  response_headers_ =
+      new net::HttpResponseHeaders(
+          net::HttpUtil::AssembleRawHeaders(
+              raw_headers.c_str(), static_cast<int>(raw_headers.size())));
+
+  NotifyHeadersComplete();
+}
+
+void URLRequestPackedArchiveJob::SetExtraRequestHeaders(
+    const net::HttpRequestHeaders& headers) {
+  has_range_header_ =
+      headers.GetHeader(net::HttpRequestHeaders::kRange, &range_header_);
+  headers.GetHeader(net::HttpRequestHeaders::kIfNoneMatch,
+                    &if_none_match_header_);
+}
+
+void URLRequestPackedArchiveJob::Start() {
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE,
+      base::Bind(&URLRequestPackedArchiveJob::StartAsync,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void URLRequestPackedArchiveJob::Kill() {
+  weak_factory_.InvalidateWeakPtrs();
+  net::URLRequestJob::Kill();
+}
+
+int URLRequestPackedArchiveJob::ReadRawData(net::IOBuffer* buf,
+                                            int buf_size) {
+  DCHECK_GE(buf_size, 0);
+
+  size_t count = std::min(body_.size(), static_cast<size_t>(buf_size));
+  memcpy(buf->data(), body_.data(), count);
+  body_.remove_prefix(count);
+
+  return static_cast<int>(count);
+}
+
+bool URLRequestPackedArchiveJob::GetMimeType(std::string* mime_type) const {
+  if (mime_type_.empty()) {
+    return false;
+  }
+
+  *mime_type = mime_type_;
+  return true;
+}
+
+void URLRequestPackedArchiveJob::GetResponseInfo(
+    net::HttpResponseInfo* info) {
+  info->headers = response_headers_;
+}
+
+std::unique_ptr<net::SourceStream>
+URLRequestPackedArchiveJob::SetUpSourceStream() {
+  std::unique_ptr<net::SourceStream> upstream =
+      net::URLRequestJob::SetUpSourceStream();
+
+  // There's nothing to decode for HEAD requests or 304 responses
+  if (body_.empty()) {
+    return upstream;
+  }
+
+  switch (content_encoding_) {
+    case CONTENT_ENCODING_NONE:
+      return upstream;
+    case CONTENT_ENCODING_GZIP:
+      return net::GzipSourceStream::Create(std::move(upstream),
+                                           net::SourceStream::TYPE_GZIP);
+    case CONTENT_ENCODING_BROTLI:
+      return net::CreateBrotliSourceStream(std::move(upstream));
+  }
+
+  NOTREACHED();
+  return upstream;
+}
+
+URLRequestPackedArchiveJob::URLRequestPackedArchiveJob(
+    net::URLRequest* request,
+    net::NetworkDelegate* network_delegate,
+    scoped_refptr<PackedArchive> archive)
+    : net::URLRequestJob(request, network_delegate),
+      archive_(std::move(archive)),
+      has_range_header_(false),
+      content_encoding_(CONTENT_ENCODING_NONE),
+      weak_factory_(this) {
+  DCHECK(archive_.get());
+}
+
+URLRequestPackedArchiveJob::~URLRequestPackedArchiveJob() {}
+
+// static
+std::string URLRequestPackedArchiveJob::GetEntryPathForURL(const GURL& url) {
+  std::string path = url.path();
+
+  // For non-standard schemes, GURL doesn't split out the host
+  if (!url.IsStandard()) {
+    size_t end = path.find_first_of("?#");
+    if (end != std::string::npos) {
+      path.resize(end);
+    }
+    if (base::StartsWith(path, "//", base::CompareCase::SENSITIVE)) {
+      size_t host_end = path.find('/', 2);
+      path = host_end == std::string::npos ?
+          std::string() : path.substr(host_end);
+    }
+  }
+
+  path = net::UnescapeURLComponent(
+      path,
+      net::UnescapeRule::SPACES |
+      net::UnescapeRule::PATH_SEPARATORS |
+      net::UnescapeRule::URL_SPECIAL_CHARS_EXCEPT_PATH_SEPARATORS);
+
+  size_t start = path.find_first_not_of('/');
+  path = start == std::string::npos ? std::string() : path.substr(start);
+
+  if (path.empty() || path.back() == '/') {
+    path += kIndexFile;
+  }
+
+  return path;
+}
+
+} // namespace oxide
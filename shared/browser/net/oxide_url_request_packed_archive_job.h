@@ -0,0 +1,99 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#ifndef _OXIDE_SHARED_BROWSER_NET_URL_REQUEST_PACKED_ARCHIVE_JOB_H_
+#define _OXIDE_SHARED_BROWSER_NET_URL_REQUEST_PACKED_ARCHIVE_JOB_H_
+
+#include <memory>
+#include <string>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/strings/string_piece.h"
+#include "net/url_request/url_request_job.h"
+
+#include "shared/common/oxide_shared_export.h"
+
+class GURL;
+
+namespace net {
+class HttpResponseHeaders;
+}
+
+namespace oxide {
+
+class PackedArchive;
+
+// A URLRequestJob that serves entries from a PackedArchive. GET and HEAD
+// requests are supported, with single byte ranges and conditional requests
+// via If-None-Match. If the archive contains a ".br" or ".gz" variant of the
+// requested entry, it is preferred over the uncompressed entry except for
+// range requests
+class OXIDE_SHARED_EXPORT URLRequestPackedArchiveJob
+    : public net::URLRequestJob {
+ public:
+  URLRequestPackedArchiveJob(net::URLRequest* request,
+                             net::NetworkDelegate* network_delegate,
+                             scoped_refptr<PackedArchive> archive);
+  ~URLRequestPackedArchiveJob() override;
+
+  // Returns the archive entry path for |url|. The host (if any), query and
+  // fragment are ignored, and paths ending in a slash map to "index.html"
+  static std::string GetEntryPathForURL(const GURL& url);
+
+ private:
+  enum ContentEncoding {
+    CONTENT_ENCODING_NONE,
+    CONTENT_ENCODING_GZIP,
+    CONTENT_ENCODING_BROTLI
+  };
+
+  void StartAsync();
+
+  void NotifyHeadersCompleteWithStatus(int status,
+                                       const std::string& extra_headers);
+
+  // net::URLRequestJob implementation
+  void SetExtraRequestHeaders(const net::HttpRequestHeaders& headers) override;
+  void Start() override;
+  void Kill() override;
+  int ReadRawData(net::IOBuffer* buf, int buf_size) override;
+  bool GetMimeType(std::string* mime_type) const override;
+  void GetResponseInfo(net::HttpResponseInfo* info) override;
+  std::unique_ptr<net::SourceStream> SetUpSourceStream() override;
+
+  scoped_refptr<PackedArchive> archive_;
+
+  bool has_range_header_;
+  std::string range_header_;
+  std::string if_none_match_header_;
+
+  std::string mime_type_;
+  ContentEncoding content_encoding_;
+  scoped_refptr<net::HttpResponseHeaders> response_headers_;
+
+  // The remaining response body, which points in to |archive_|
+  base::StringPiece body_;
+
+  base::WeakPtrFactory<URLRequestPackedArchiveJob> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestPackedArchiveJob);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_NET_URL_REQUEST_PACKED_ARCHIVE_JOB_H_
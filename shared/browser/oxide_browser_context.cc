@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <map>
 #include <set>
 #include <utility>
 #include <vector>
@@ -32,6 +33,7 @@
 #include "base/memory/weak_ptr.h"
 #include "base/supports_user_data.h"
 #include "base/synchronization/lock.h"
+#include "base/strings/string_util.h"
 #include "base/threading/sequenced_worker_pool.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/threading/worker_pool.h"
@@ -60,6 +62,7 @@
 #include "net/url_request/url_request_job_factory_impl.h"
 
 #include "shared/browser/net/oxide_cookie_store_proxy.h"
+#include "shared/browser/net/oxide_packed_archive.h"
 #include "shared/browser/permissions/oxide_permission_manager.h"
 #include "shared/browser/permissions/oxide_temporary_saved_permission_context.h"
 #include "shared/browser/ssl/oxide_ssl_config_service.h"
@@ -77,6 +80,7 @@
 #include "oxide_url_request_context.h"
 #include "oxide_url_request_delegated_job_factory.h"
 #include "oxide_user_agent_settings.h"
+#include "spare_renderer_manager.h"
 
 namespace oxide {
 
@@ -93,6 +97,8 @@ const base::FilePath::CharType kCookiesFilename[] =
     FILE_PATH_LITERAL("cookies.sqlite");
 const base::FilePath::CharType kChannelIDFilename[] =
     FILE_PATH_LITERAL("ChannelID");
+const base::FilePath::CharType kSavedPermissionsFilename[] =
+    FILE_PATH_LITERAL("SavedPermissions");
 
 const char kDataScheme[] = "data";
 const char kFileScheme[] = "file";
@@ -123,6 +129,74 @@ void CleanupOldCacheDir(const base::FilePath& path) {
   base::DeleteFile(path, true);
 }
 
+void RunCallbackOnUIThread(const base::Closure& callback) {
+  content::BrowserThread::PostTask(content::BrowserThread::UI,
+                                   FROM_HERE,
+                                   callback);
+}
+
+template <typename T>
+void RunCallbackOnUIThreadWithResult(const base::Callback<void(T)>& callback,
+                                     T result) {
+  content::BrowserThread::PostTask(content::BrowserThread::UI,
+                                   FROM_HERE,
+                                   base::Bind(callback, result));
+}
+
+template <typename T>
+base::Callback<void(T)> WrapCallbackForUIThread(
+    const base::Callback<void(T)>& callback) {
+  return base::Bind(&RunCallbackOnUIThreadWithResult<T>, callback);
+}
+
+// Runs |task| with the HttpCacheController for |io_data|, after making sure
+// that the main request context has been created
+void RunWithHttpCacheControllerOnIOThread(
+    scoped_refptr<net::URLRequestContextGetter> getter,
+    BrowserContextIOData* io_data,
+    const base::Callback<void(HttpCacheController*)>& task) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+
+  getter->GetURLRequestContext();
+  HttpCacheController* controller = io_data->GetHttpCacheController();
+  DCHECK(controller);
+
+  task.Run(controller);
+}
+
+void PrefetchURLsOnIOThread(
+    const std::vector<GURL>& urls,
+    const HttpCacheController::PrefetchCallback& callback,
+    HttpCacheController* controller) {
+  controller->Prefetch(urls, callback);
+}
+
+void GetHttpCacheEntryInfoOnIOThread(
+    const GURL& url,
+    const HttpCacheController::EntryInfoCallback& callback,
+    HttpCacheController* controller) {
+  controller->GetEntryInfo(url, callback);
+}
+
+void EvictHttpCacheEntriesOnIOThread(
+    const std::string& url_prefix,
+    const HttpCacheController::EvictCallback& callback,
+    HttpCacheController* controller) {
+  controller->EvictByPrefix(url_prefix, callback);
+}
+
+void GetHttpCacheStatsOnIOThread(
+    const HttpCacheController::StatsCallback& callback,
+    HttpCacheController* controller) {
+  callback.Run(controller->GetStats());
+}
+
+void GetHttpCacheSizeOnIOThread(
+    const HttpCacheController::SizeCallback& callback,
+    HttpCacheController* controller) {
+  controller->GetSize(callback);
+}
+
 } // namespace
 
 class MainURLRequestContextGetter : public URLRequestContextGetter {
@@ -195,6 +269,8 @@ struct BrowserContextSharedIOData {
         session_cookie_mode(params.session_cookie_mode),
         popup_blocker_enabled(true),
         host_mapping_rules(params.host_mapping_rules),
+        persistent_permissions(params.persistent_permissions),
+        permission_lifetime(params.permission_lifetime),
         user_agent_settings(new UserAgentSettingsIOData(context)) {}
 
   mutable base::Lock lock;
@@ -209,9 +285,14 @@ struct BrowserContextSharedIOData {
 
   std::vector<std::string> host_mapping_rules;
 
+  bool persistent_permissions;
+  base::TimeDelta permission_lifetime;
+
   std::unique_ptr<UserAgentSettingsIOData> user_agent_settings;
 
   scoped_refptr<BrowserContextDelegate> delegate;
+
+  std::map<std::string, scoped_refptr<PackedArchive>> packed_archives;
 };
 
 // static
@@ -302,6 +383,17 @@ scoped_refptr<BrowserContextDelegate> BrowserContextIOData::GetDelegate() {
   return data.delegate;
 }
 
+scoped_refptr<PackedArchive> BrowserContextIOData::GetPackedArchive(
+    const std::string& scheme) const {
+  const BrowserContextSharedIOData& data = GetSharedData();
+  base::AutoLock lock(data.lock);
+  auto it = data.packed_archives.find(base::ToLowerASCII(scheme));
+  if (it == data.packed_archives.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
 net::StaticCookiePolicy::Type BrowserContextIOData::GetCookiePolicy() const {
   const BrowserContextSharedIOData& data = GetSharedData();
   base::AutoLock lock(data.lock);
@@ -498,6 +590,8 @@ URLRequestContext* BrowserContextIOData::CreateMainRequestContext(
 
   storage->set_job_factory(std::move(top_job_factory));
 
+  http_cache_controller_ = base::MakeUnique<HttpCacheController>(context);
+
   resource_context_->request_context_ = context;
   return main_request_context_.get();
 }
@@ -527,6 +621,25 @@ net::CookieStore* BrowserContextIOData::GetCookieStore() const {
   return cookie_store_owner_->store();
 }
 
+void BrowserContextIOData::FlushPendingWrites(const base::Closure& callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+
+  GetTemporarySavedPermissionContext()->Flush();
+
+  net::CookieStore* store = GetCookieStore();
+  if (!store) {
+    callback.Run();
+    return;
+  }
+
+  store->FlushStore(callback);
+}
+
+HttpCacheController* BrowserContextIOData::GetHttpCacheController() const {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+  return http_cache_controller_.get();
+}
+
 class BrowserContextImpl;
 
 class OTRBrowserContextImpl : public BrowserContext {
@@ -576,8 +689,13 @@ OTRBrowserContextImpl::OTRBrowserContextImpl(
     BrowserContextIODataImpl* original_io_data)
     : BrowserContext(new OTRBrowserContextIODataImpl(original_io_data)),
       original_context_(original) {
+  GetTemporarySavedPermissionContext()->SetDecisionLifetime(
+      GetPermissionLifetime());
+
   BrowserContextDependencyManager::GetInstance()
       ->CreateBrowserContextServices(this);
+
+  SpareRendererManager::Get(this)->Warmup();
 }
 
 BrowserContext* BrowserContextImpl::GetOffTheRecordContext() {
@@ -597,16 +715,28 @@ BrowserContextImpl::~BrowserContextImpl() {
 
 BrowserContextImpl::BrowserContextImpl(const BrowserContext::Params& params)
     : BrowserContext(new BrowserContextIODataImpl(params)) {
+  GetTemporarySavedPermissionContext()->SetDecisionLifetime(
+      params.permission_lifetime);
+
   if (!GetPath().empty()) {
     base::FilePath gpu_cache = GetPath().Append(FILE_PATH_LITERAL("GPUCache"));
     content::BrowserThread::PostTask(
         content::BrowserThread::FILE,
         FROM_HERE,
         base::Bind(&CleanupOldCacheDir, gpu_cache));
+
+    if (params.persistent_permissions) {
+      GetTemporarySavedPermissionContext()->EnablePersistence(
+          GetPath().Append(kSavedPermissionsFilename),
+          content::BrowserThread::GetTaskRunnerForThread(
+              content::BrowserThread::FILE));
+    }
   }
 
   BrowserContextDependencyManager::GetInstance()
       ->CreateBrowserContextServices(this);
+
+  SpareRendererManager::Get(this)->Warmup();
 }
 
 void BrowserContext::Deleter::operator()(BrowserContext* context) {
@@ -834,6 +964,21 @@ void BrowserContext::SetCookiePolicy(net::StaticCookiePolicy::Type policy) {
   data.cookie_policy = policy;
 }
 
+void BrowserContext::SetPackedArchive(const std::string& scheme,
+                                      scoped_refptr<PackedArchive> archive) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(URLRequestDelegatedJobFactory::CanDelegateProtocol(scheme));
+
+  BrowserContextSharedIOData& data = io_data()->GetSharedData();
+  base::AutoLock lock(data.lock);
+  std::string lscheme = base::ToLowerASCII(scheme);
+  if (archive.get()) {
+    data.packed_archives[lscheme] = std::move(archive);
+  } else {
+    data.packed_archives.erase(lscheme);
+  }
+}
+
 content::CookieStoreConfig::SessionCookieMode
 BrowserContext::GetSessionCookieMode() const {
   DCHECK(CalledOnValidThread());
@@ -845,6 +990,16 @@ const std::vector<std::string>& BrowserContext::GetHostMappingRules() const {
   return io_data()->GetSharedData().host_mapping_rules;
 }
 
+bool BrowserContext::ShouldPersistPermissions() const {
+  DCHECK(CalledOnValidThread());
+  return io_data()->GetSharedData().persistent_permissions;
+}
+
+base::TimeDelta BrowserContext::GetPermissionLifetime() const {
+  DCHECK(CalledOnValidThread());
+  return io_data()->GetSharedData().permission_lifetime;
+}
+
 content::ResourceContext* BrowserContext::GetResourceContext() {
   DCHECK(CalledOnValidThread());
   return io_data()->GetResourceContext();
@@ -854,6 +1009,10 @@ net::CookieStore* BrowserContext::GetCookieStore() const {
   return cookie_store_.get();
 }
 
+CookieStoreProxy* BrowserContext::GetCookieStoreProxy() const {
+  return cookie_store_.get();
+}
+
 TemporarySavedPermissionContext*
 BrowserContext::GetTemporarySavedPermissionContext() const {
   DCHECK(CalledOnValidThread());
@@ -865,4 +1024,70 @@ BrowserContextIOData* BrowserContext::GetIOData() const {
   return io_data_;
 }
 
+void BrowserContext::FlushPendingWrites(const base::Closure& callback) {
+  DCHECK(CalledOnValidThread());
+
+  // |io_data_| is deleted on the IO thread after this task runs
+  content::BrowserThread::PostTask(
+      content::BrowserThread::IO,
+      FROM_HERE,
+      base::Bind(&BrowserContextIOData::FlushPendingWrites,
+                 base::Unretained(io_data_),
+                 base::Bind(&RunCallbackOnUIThread, callback)));
+}
+
+void BrowserContext::RunWithHttpCacheController(
+    const base::Callback<void(HttpCacheController*)>& task) {
+  DCHECK(CalledOnValidThread());
+
+  scoped_refptr<net::URLRequestContextGetter> getter =
+      content::BrowserContext::GetDefaultStoragePartition(this)
+          ->GetURLRequestContext();
+
+  // |io_data_| is deleted on the IO thread after this task runs
+  content::BrowserThread::PostTask(
+      content::BrowserThread::IO,
+      FROM_HERE,
+      base::Bind(&RunWithHttpCacheControllerOnIOThread,
+                 getter, base::Unretained(io_data_), task));
+}
+
+void BrowserContext::PrefetchURLs(
+    const std::vector<GURL>& urls,
+    const HttpCacheController::PrefetchCallback& callback) {
+  RunWithHttpCacheController(
+      base::Bind(&PrefetchURLsOnIOThread,
+                 urls, WrapCallbackForUIThread(callback)));
+}
+
+void BrowserContext::GetHttpCacheEntryInfo(
+    const GURL& url,
+    const HttpCacheController::EntryInfoCallback& callback) {
+  RunWithHttpCacheController(
+      base::Bind(&GetHttpCacheEntryInfoOnIOThread,
+                 url, WrapCallbackForUIThread(callback)));
+}
+
+void BrowserContext::EvictHttpCacheEntries(
+    const std::string& url_prefix,
+    const HttpCacheController::EvictCallback& callback) {
+  RunWithHttpCacheController(
+      base::Bind(&EvictHttpCacheEntriesOnIOThread,
+                 url_prefix, WrapCallbackForUIThread(callback)));
+}
+
+void BrowserContext::GetHttpCacheStats(
+    const HttpCacheController::StatsCallback& callback) {
+  RunWithHttpCacheController(
+      base::Bind(&GetHttpCacheStatsOnIOThread,
+                 WrapCallbackForUIThread(callback)));
+}
+
+void BrowserContext::GetHttpCacheSize(
+    const HttpCacheController::SizeCallback& callback) {
+  RunWithHttpCacheController(
+      base::Bind(&GetHttpCacheSizeOnIOThread,
+                 WrapCallbackForUIThread(callback)));
+}
+
 } // namespace oxide
@@ -25,11 +25,13 @@
 #include "base/memory/ref_counted.h"
 #include "base/synchronization/lock.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time/time.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/content_browser_client.h"
 #include "content/public/browser/cookie_store_factory.h"
 #include "net/base/static_cookie_policy.h"
 
+#include "shared/browser/net/oxide_http_cache_controller.h"
 #include "shared/common/oxide_shared_export.h"
 
 namespace content {
@@ -61,6 +63,7 @@ class BrowserContextSharedIOData;
 class CookieStoreOwner;
 class CookieStoreProxy;
 class GeolocationPermissionContext;
+class PackedArchive;
 class PermissionManager;
 class ResourceContext;
 class SSLHostStateDelegate;
@@ -78,6 +81,10 @@ class BrowserContextIOData {
 
   scoped_refptr<BrowserContextDelegate> GetDelegate();
 
+  // Returns the PackedArchive registered for |scheme|, if there is one
+  scoped_refptr<PackedArchive> GetPackedArchive(
+      const std::string& scheme) const;
+
   net::StaticCookiePolicy::Type GetCookiePolicy() const;
   virtual content::CookieStoreConfig::SessionCookieMode GetSessionCookieMode() const = 0;
 
@@ -105,6 +112,13 @@ class BrowserContextIOData {
 
   net::CookieStore* GetCookieStore() const;
 
+  // Start writing any pending cookie changes to disk. |callback| is run on
+  // the IO thread once they have been written
+  void FlushPendingWrites(const base::Closure& callback);
+
+  // Returns null until the main request context has been created
+  HttpCacheController* GetHttpCacheController() const;
+
  protected:
   friend class BrowserContextImpl; // For GetSharedData()
 
@@ -127,6 +141,7 @@ class BrowserContextIOData {
   std::unique_ptr<net::HttpNetworkSession> http_network_session_;
 
   std::unique_ptr<URLRequestContext> main_request_context_;
+  std::unique_ptr<HttpCacheController> http_cache_controller_;
   std::unique_ptr<ResourceContext> resource_context_;
   std::unique_ptr<CookieStoreOwner> cookie_store_owner_;
 
@@ -152,13 +167,23 @@ class OXIDE_SHARED_EXPORT BrowserContext : public content::BrowserContext,
            : path(path),
              cache_path(cache_path),
              max_cache_size_hint(max_cache_size_hint),
-             session_cookie_mode(session_cookie_mode) {}
+             session_cookie_mode(session_cookie_mode),
+             persistent_permissions(false) {}
 
     base::FilePath path;
     base::FilePath cache_path;
     int max_cache_size_hint;
     content::CookieStoreConfig::SessionCookieMode session_cookie_mode;
     std::vector<std::string> host_mapping_rules;
+
+    // Whether permission decisions saved in the TemporarySavedPermissionContext
+    // are written to disk. This has no effect if |path| is empty
+    bool persistent_permissions;
+
+    // How long permission decisions saved in the
+    // TemporarySavedPermissionContext are remembered for. Zero means that they
+    // don't expire
+    base::TimeDelta permission_lifetime;
   };
 
   virtual ~BrowserContext();
@@ -215,27 +240,63 @@ class OXIDE_SHARED_EXPORT BrowserContext : public content::BrowserContext,
   net::StaticCookiePolicy::Type GetCookiePolicy() const;
   void SetCookiePolicy(net::StaticCookiePolicy::Type policy);
 
+  // Serve requests for |scheme| from |archive|, which is shared with the
+  // OTR context. Passing a null |archive| removes the existing registration.
+  // In-flight requests keep the previous archive alive until they complete
+  void SetPackedArchive(const std::string& scheme,
+                        scoped_refptr<PackedArchive> archive);
+
   content::CookieStoreConfig::SessionCookieMode GetSessionCookieMode() const;
 
   const std::vector<std::string>& GetHostMappingRules() const;
 
+  bool ShouldPersistPermissions() const;
+
+  base::TimeDelta GetPermissionLifetime() const;
+
   // from content::BrowserContext
   content::ResourceContext* GetResourceContext() override;
 
   net::CookieStore* GetCookieStore() const;
 
+  // Provides access to the batched import / export APIs, which aren't part
+  // of net::CookieStore
+  CookieStoreProxy* GetCookieStoreProxy() const;
+
   // XXX: This will be going away
   // (see the comment in oxide_temporary_saved_permission_context.h)
   TemporarySavedPermissionContext* GetTemporarySavedPermissionContext() const;
 
   BrowserContextIOData* GetIOData() const;
 
+  // Start writing any pending data for this context to disk on background
+  // threads, without waiting for the context to be destroyed. |callback| is
+  // run on the UI thread once this has completed
+  void FlushPendingWrites(const base::Closure& callback);
+
+  // Access to this context's HTTP cache via HttpCacheController. These
+  // create the main request context if it doesn't exist yet, and |callback|
+  // is run on the UI thread
+  void PrefetchURLs(const std::vector<GURL>& urls,
+                    const HttpCacheController::PrefetchCallback& callback);
+  void GetHttpCacheEntryInfo(
+      const GURL& url,
+      const HttpCacheController::EntryInfoCallback& callback);
+  void EvictHttpCacheEntries(
+      const std::string& url_prefix,
+      const HttpCacheController::EvictCallback& callback);
+  void GetHttpCacheStats(const HttpCacheController::StatsCallback& callback);
+  void GetHttpCacheSize(const HttpCacheController::SizeCallback& callback);
+
  protected:
   BrowserContext(BrowserContextIOData* io_data);
 
   BrowserContextIOData* io_data() const { return io_data_; }
 
  private:
+  void RunWithHttpCacheController(
+      const base::Callback<void(HttpCacheController*)>& task);
+
   // content::BrowserContext implementation
   std::unique_ptr<content::ZoomLevelDelegate> CreateZoomLevelDelegate(
       const base::FilePath& partition_path) override;
@@ -18,7 +18,9 @@
 #ifndef _OXIDE_SHARED_BROWSER_BROWSER_CONTEXT_DELEGATE_H_
 #define _OXIDE_SHARED_BROWSER_BROWSER_CONTEXT_DELEGATE_H_
 
+#include "base/callback_forward.h"
 #include "base/memory/ref_counted.h"
+#include "base/time/time.h"
 #include "net/base/completion_callback.h"
 #include "net/base/net_errors.h"
 
@@ -49,16 +51,29 @@ struct OXIDE_SHARED_EXPORT BrowserContextDelegateTraits {
 class BrowserContextDelegate :
     public base::RefCountedThreadSafe<BrowserContextDelegate, BrowserContextDelegateTraits> {
  public:
-  // Called on the IO thread
+  // Run on the IO thread to complete a call to OnBeforeURLRequest that
+  // returned net::ERR_IO_PENDING
+  typedef base::Callback<void(int, const GURL&)> BeforeURLRequestCallback;
+
+  // Run on the IO thread to complete a call to OnBeforeSendHeaders that
+  // returned net::ERR_IO_PENDING
+  typedef base::Callback<void(int, const net::HttpRequestHeaders&)>
+      BeforeSendHeadersCallback;
+
+  // Called on the IO thread. The delegate can return net::ERR_IO_PENDING and
+  // run |callback| later with the result and the new URL, in which case it
+  // must not access |new_url| after returning
   virtual int OnBeforeURLRequest(net::URLRequest* request,
-                                 const net::CompletionCallback& callback,
+                                 const BeforeURLRequestCallback& callback,
                                  GURL* new_url) {
     return net::OK;
   }
 
-  // Called on the IO thread
+  // Called on the IO thread. The delegate can return net::ERR_IO_PENDING and
+  // run |callback| later with the result and the modified headers, in which
+  // case it must not access |headers| after returning
   virtual int OnBeforeSendHeaders(net::URLRequest* request,
-                                  const net::CompletionCallback& callback,
+                                  const BeforeSendHeadersCallback& callback,
                                   net::HttpRequestHeaders* headers) {
     return net::OK;
   }
@@ -72,13 +87,30 @@ class BrowserContextDelegate :
     return net::OK;
   }
 
-  // Called on the IO thread
+  // Called on the IO thread. The delegate can return net::ERR_IO_PENDING and
+  // run |callback| later with the result
   virtual int OnBeforeRedirect(net::URLRequest* request,
-                               const GURL& new_location) {
+                               const GURL& new_location,
+                               const net::CompletionCallback& callback) {
     return net::OK;
   }
 
-  // Called on the IO thread
+  // Called on the IO thread. Returns how long to wait for an asynchronous
+  // network callback before continuing without it. A zero TimeDelta means
+  // wait indefinitely
+  virtual base::TimeDelta GetNetworkCallbackTimeout() {
+    return base::TimeDelta();
+  }
+
+  // Called on the IO thread. The result to continue with when a network
+  // callback times out
+  virtual int GetNetworkCallbackTimeoutResult() {
+    return net::OK;
+  }
+
+  // Called on the IO thread, or on a blocking pool thread when prefetching
+  // the legacy override at navigation start. The result is cached per origin
+  // of |url| (see RendererUserAgentSettings)
   virtual std::string GetUserAgentOverride(const GURL& url) {
     return std::string();
   }
@@ -19,11 +19,13 @@
 
 #include <list>
 
+#include "base/bind.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/render_process_host.h"
+#include "content/public/common/result_codes.h"
 
 #include "oxide_browser_context.h"
 
@@ -34,6 +36,13 @@ namespace {
 base::LazyInstance<std::list<BrowserContextDestroyer*>>::Leaky
     g_contexts_pending_deletion = LAZY_INSTANCE_INITIALIZER;
 
+base::TimeDelta g_renderer_grace_period;
+
+void OnPendingWritesFlushed(base::TimeTicks start_time) {
+  VLOG(1) << "Flushed pending writes for BrowserContext in "
+          << (base::TimeTicks::Now() - start_time).InMilliseconds() << "ms";
+}
+
 std::set<content::RenderProcessHost*> 
 GetHostsForContext(BrowserContext* context) {
   std::set<content::RenderProcessHost*> hosts;
@@ -59,7 +68,9 @@ BrowserContextDestroyer::BrowserContextDestroyer(
     uint32_t otr_contexts_pending_deletion)
     : context_(std::move(context)),
       otr_contexts_pending_deletion_(otr_contexts_pending_deletion),
-      finish_destroy_scheduled_(false) {
+      finish_destroy_scheduled_(false),
+      start_time_(base::TimeTicks::Now()),
+      killed_host_count_(0) {
   DCHECK(hosts.size() > 0 ||
          (!context->IsOffTheRecord() &&
           (otr_contexts_pending_deletion > 0 ||
@@ -79,6 +90,40 @@ void BrowserContextDestroyer::ObserveHost(content::RenderProcessHost* host) {
 
   host->AddObserver(this);
   pending_host_ids_.insert(host->GetID());
+
+  hosts_exited_time_ = base::TimeTicks();
+
+  if (g_renderer_grace_period.is_zero() || grace_period_timer_.IsRunning()) {
+    return;
+  }
+
+  grace_period_timer_.Start(
+      FROM_HERE,
+      g_renderer_grace_period,
+      base::Bind(&BrowserContextDestroyer::KillRemainingHosts,
+                 base::Unretained(this)));
+}
+
+void BrowserContextDestroyer::KillRemainingHosts() {
+  // Copy the IDs, as killing a host may result in it being removed from
+  // |pending_host_ids_|
+  std::set<int> host_ids = pending_host_ids_;
+
+  for (int id : host_ids) {
+    content::RenderProcessHost* host = content::RenderProcessHost::FromID(id);
+    if (!host) {
+      continue;
+    }
+
+    if (host->Shutdown(content::RESULT_CODE_KILLED, false)) {
+      ++killed_host_count_;
+    }
+  }
+
+  LOG_IF(WARNING, killed_host_count_ > 0)
+      << "Killed " << killed_host_count_ << " renderer process(es) that "
+      << "didn't exit within " << g_renderer_grace_period.InMilliseconds()
+      << "ms of their BrowserContext being scheduled for deletion";
 }
 
 void BrowserContextDestroyer::MaybeScheduleFinishDestroyContext(
@@ -91,6 +136,11 @@ void BrowserContextDestroyer::MaybeScheduleFinishDestroyContext(
     return;
   }
 
+  grace_period_timer_.Stop();
+  if (hosts_exited_time_.is_null()) {
+    hosts_exited_time_ = base::TimeTicks::Now();
+  }
+
   if (!context_->IsOffTheRecord() &&
       (otr_contexts_pending_deletion_ > 0 ||
            context_->HasOffTheRecordContext())) {
@@ -117,6 +167,12 @@ void BrowserContextDestroyer::FinishDestroyContext() {
 
   g_contexts_pending_deletion.Get().remove(this);
 
+  base::TimeTicks now = base::TimeTicks::Now();
+  VLOG(1) << "Deleting BrowserContext: renderers exited after "
+          << (hosts_exited_time_ - start_time_).InMilliseconds() << "ms ("
+          << killed_host_count_ << " killed), deleted after "
+          << (now - start_time_).InMilliseconds() << "ms";
+
   if (context_->IsOffTheRecord()) {
     // If this is an OTR context and its owner BrowserContext has been scheduled
     // for deletion, update the owner's BrowserContextDestroyer
@@ -159,9 +215,25 @@ void BrowserContextDestroyer::RenderProcessHostDestroyed(
   MaybeScheduleFinishDestroyContext(host);
 }
 
+// static
+void BrowserContextDestroyer::SetRendererGracePeriod(
+    base::TimeDelta grace_period) {
+  DCHECK_GE(grace_period, base::TimeDelta());
+  g_renderer_grace_period = grace_period;
+}
+
+// static
+base::TimeDelta BrowserContextDestroyer::GetRendererGracePeriod() {
+  return g_renderer_grace_period;
+}
+
 // static
 void BrowserContextDestroyer::DestroyContext(
     std::unique_ptr<BrowserContext> context) {
+  // Start writing data to disk now rather than when |context| is deleted,
+  // which may be some time later if there are renderers still using it
+  context->FlushPendingWrites(
+      base::Bind(&OnPendingWritesFlushed, base::TimeTicks::Now()));
 
   bool is_otr_context = context->IsOffTheRecord();
 
@@ -22,8 +22,12 @@
 #include <set>
 
 #include "base/macros.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "content/public/browser/render_process_host_observer.h"
 
+#include "shared/common/oxide_shared_export.h"
+
 namespace content {
 class BrowserContext;
 class RenderProcessHost;
@@ -34,9 +38,23 @@ namespace oxide {
 class BrowserContext;
 
 // A mechanism to manage BrowserContext destruction, ensuring it stays alive
-// until consumers inside Chromium no longer require it
-class BrowserContextDestroyer : public content::RenderProcessHostObserver {
+// until consumers inside Chromium no longer require it.
+//
+// Pending disk writes for a context are started as soon as it is scheduled
+// for deletion, rather than when it is finally deleted. If a renderer grace
+// period is set, RenderProcessHosts that are still alive when it expires are
+// killed, so that deletion doesn't wait indefinitely for renderers that are
+// slow to exit. The duration of each phase is logged at VLOG level 1
+class OXIDE_SHARED_EXPORT BrowserContextDestroyer
+    : public content::RenderProcessHostObserver {
  public:
+  // Set the time that RenderProcessHosts using a context that has been
+  // scheduled for deletion are given to exit before being killed. A zero
+  // delta (the default) means wait indefinitely. This affects contexts
+  // scheduled for deletion after it is called
+  static void SetRendererGracePeriod(base::TimeDelta grace_period);
+  static base::TimeDelta GetRendererGracePeriod();
+
   // Schedule |context| for deletion. If no RenderProcessHosts are using it then
   // this will result in it being deleted immediately, else deletion will be
   // happen after all RenderProcessHosts using it have gone away
@@ -61,6 +79,8 @@ class BrowserContextDestroyer : public content::RenderProcessHostObserver {
 
   void ObserveHost(content::RenderProcessHost* host);
 
+  void KillRemainingHosts();
+
   void MaybeScheduleFinishDestroyContext(
       content::RenderProcessHost* host_being_destroyed = nullptr);
   void FinishDestroyContext();
@@ -78,7 +98,14 @@ class BrowserContextDestroyer : public content::RenderProcessHostObserver {
   uint32_t otr_contexts_pending_deletion_;
 
   bool finish_destroy_scheduled_;
-  
+
+  // Used for reporting the time taken by each phase of deletion
+  base::TimeTicks start_time_;
+  base::TimeTicks hosts_exited_time_;
+  size_t killed_host_count_;
+
+  base::OneShotTimer grace_period_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(BrowserContextDestroyer);
 };
 
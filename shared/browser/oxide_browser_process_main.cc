@@ -364,6 +364,10 @@ void InitializeCommandLine(const std::string& argv0,
            process_model == PROCESS_MODEL_MULTI_PROCESS);
   }
 
+  if (IsEnvironmentOptionEnabled("ENABLE_THREADED_COMPOSITOR", env)) {
+    command_line->AppendSwitch(switches::kEnableThreadedBrowserCompositor);
+  }
+
   if (IsEnvironmentOptionEnabled("ALLOW_SANDBOX_DEBUGGING", env)) {
     command_line->AppendSwitch(switches::kAllowSandboxDebugging);
   }
@@ -60,8 +60,10 @@
 #include "oxide_quota_permission_context.h"
 #include "oxide_render_message_filter.h"
 #include "oxide_resource_dispatcher_host_delegate.h"
+#include "oxide_script_message_filter.h"
 #include "oxide_user_agent_settings.h"
 #include "oxide_web_contents_view.h"
+#include "renderer_process_pool.h"
 #include "screen.h"
 #include "shell_mode.h"
 #include "web_contents_client.h"
@@ -93,12 +95,38 @@ void ContentBrowserClient::RenderProcessWillLaunch(
   }
 
   host->AddFilter(new RenderMessageFilter(host));
+  host->AddFilter(new ScriptMessageFilter(host->GetID()));
+}
+
+bool ContentBrowserClient::MayReuseHost(
+    content::RenderProcessHost* process_host) {
+  RendererProcessPool::MayReuseHost(process_host);
+  return true;
+}
+
+bool ContentBrowserClient::IsSuitableHost(
+    content::RenderProcessHost* process_host,
+    const GURL& site_url) {
+  return RendererProcessPool::IsSuitableHost(process_host, site_url);
+}
+
+bool ContentBrowserClient::ShouldTryToUseExistingProcessHost(
+    content::BrowserContext* browser_context,
+    const GURL& url) {
+  return RendererProcessPool::ShouldTryToUseExistingProcessHost(
+      browser_context, url);
 }
 
 void ContentBrowserClient::SiteInstanceGotProcess(
     content::SiteInstance* site_instance) {
   BrowserContextDestroyer::RenderProcessHostAssignedToSiteInstance(
       site_instance->GetProcess());
+  RendererProcessPool::SiteInstanceGotProcess(site_instance);
+}
+
+void ContentBrowserClient::SiteInstanceDeleting(
+    content::SiteInstance* site_instance) {
+  RendererProcessPool::SiteInstanceDeleting(site_instance);
 }
 
 void ContentBrowserClient::AppendExtraCommandLineSwitches(
@@ -26,6 +26,7 @@
 #include "content/public/common/favicon_url.h"
 #include "url/gurl.h"
 
+#include "favicon_service.h"
 #include "oxide_web_view.h"
 #include "oxide_web_view_client.h"
 
@@ -34,7 +35,10 @@ namespace oxide {
 DEFINE_WEB_CONTENTS_USER_DATA_KEY(FaviconHelper);
 
 FaviconHelper::FaviconHelper(content::WebContents* contents)
-    : content::WebContentsObserver(contents) {}
+    : content::WebContentsObserver(contents),
+      service_(FaviconService::Get(contents->GetBrowserContext())) {
+  service_->AddObserver(this);
+}
 
 void FaviconHelper::NotifyWebViewOfChange() {
   WebView* view = WebView::FromWebContents(web_contents());
@@ -80,6 +84,16 @@ void FaviconHelper::DidUpdateFaviconURL(
     break;
   }
 
+  // If the icon is already cached, this associates it with the current page.
+  // The application might have already requested the cached icon for this
+  // page before then, so notify it again even if the icon URL didn't change
+  if (entry->GetFavicon().url.is_valid() &&
+      service_->FetchFavicon(web_contents(),
+                             entry->GetURL(),
+                             entry->GetFavicon().url)) {
+    did_change = true;
+  }
+
   if (!did_change) {
     return;
   }
@@ -87,7 +101,22 @@ void FaviconHelper::DidUpdateFaviconURL(
   NotifyWebViewOfChange();
 }
 
-FaviconHelper::~FaviconHelper() {}
+void FaviconHelper::OnFaviconCached(const GURL& page_url,
+                                    const GURL& icon_url) {
+  content::NavigationEntry* entry =
+      web_contents()->GetController().GetLastCommittedEntry();
+  if (!entry ||
+      entry->GetURL() != page_url ||
+      entry->GetFavicon().url != icon_url) {
+    return;
+  }
+
+  NotifyWebViewOfChange();
+}
+
+FaviconHelper::~FaviconHelper() {
+  service_->RemoveObserver(this);
+}
 
 const GURL& FaviconHelper::GetFaviconURL() const {
   content::NavigationEntry* entry =
@@ -22,15 +22,20 @@
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
 
+#include "shared/browser/favicon_service.h"
+
 class GURL;
 
 namespace oxide {
 
-// Simple class for managing FaviconStatus on NavigationEntry. In the future,
-// this class will take care of downloading the icon and tracking the other
-// icon types once there is a public API that supports this
+// Simple class for managing FaviconStatus on NavigationEntry. The icon is
+// downloaded and cached by FaviconService, and the WebView is notified again
+// once the icon for the current page is available from the cache. In the
+// future, this class will take care of tracking the other icon types once
+// there is a public API that supports this
 class FaviconHelper : public content::WebContentsUserData<FaviconHelper>,
-                      public content::WebContentsObserver {
+                      public content::WebContentsObserver,
+                      public FaviconService::Observer {
  public:
   ~FaviconHelper() override;
 
@@ -50,6 +55,11 @@ class FaviconHelper : public content::WebContentsUserData<FaviconHelper>,
   void DidUpdateFaviconURL(
       const std::vector<content::FaviconURL>& candidates) override;
 
+  // FaviconService::Observer implementation
+  void OnFaviconCached(const GURL& page_url, const GURL& icon_url) override;
+
+  FaviconService* service_;
+
   DISALLOW_COPY_AND_ASSIGN(FaviconHelper);
 };
 
@@ -18,7 +18,6 @@
 #include "oxide_http_user_agent_settings.h"
 
 #include "content/public/common/content_client.h"
-#include "net/http/http_util.h"
 
 #include "oxide_browser_context.h"
 #include "oxide_user_agent_settings.h"
@@ -29,16 +28,7 @@ HttpUserAgentSettings::HttpUserAgentSettings(BrowserContextIOData* context) :
     context_(context) {}
 
 std::string HttpUserAgentSettings::GetAcceptLanguage() const {
-  std::string new_accept_lang_setting =
-      context_->GetUserAgentSettings()->GetAcceptLangs();
-  if (new_accept_lang_setting != http_accept_language_setting_) {
-    http_accept_language_setting_ = new_accept_lang_setting;
-    http_accept_language_ =
-        net::HttpUtil::GenerateAcceptLanguageHeader(
-          http_accept_language_setting_);
-  }
-
-  return http_accept_language_;
+  return context_->GetUserAgentSettings()->GetAcceptLanguageHeader();
 }
 
 std::string HttpUserAgentSettings::GetUserAgent() const {
@@ -36,9 +36,6 @@ class HttpUserAgentSettings final : public net::HttpUserAgentSettings {
  private:
   BrowserContextIOData* context_;
 
-  mutable std::string http_accept_language_setting_;
-  mutable std::string http_accept_language_;
-
   DISALLOW_COPY_AND_ASSIGN(HttpUserAgentSettings);
 };
 
@@ -17,11 +17,14 @@
 
 #include "oxide_network_delegate.h"
 
+#include "base/bind.h"
 #include "base/memory/ref_counted.h"
 #include "net/base/net_errors.h"
 #include "net/http/http_request_headers.h"
 #include "net/url_request/url_request.h"
 
+#include "shared/browser/net/oxide_http_cache_controller.h"
+
 #include "oxide_browser_context.h"
 #include "oxide_browser_context_delegate.h"
 #include "oxide_user_agent_settings.h"
@@ -32,6 +35,35 @@ namespace {
 const char kDoNotTrackHeaderName[] = "DNT";
 }
 
+void NetworkDelegate::BeforeURLRequestDone(const net::URLRequest* request,
+                                           uint64_t id,
+                                           GURL* new_url,
+                                           int result,
+                                           const GURL& url) {
+  // |new_url| is owned by |request|, so it's only valid if the callback is
+  // still pending
+  if (!callbacks_.IsPending(request, id)) {
+    return;
+  }
+
+  *new_url = url;
+  callbacks_.Complete(request, id, result);
+}
+
+void NetworkDelegate::BeforeSendHeadersDone(
+    const net::URLRequest* request,
+    uint64_t id,
+    net::HttpRequestHeaders* headers,
+    int result,
+    const net::HttpRequestHeaders& new_headers) {
+  if (!callbacks_.IsPending(request, id)) {
+    return;
+  }
+
+  *headers = new_headers;
+  callbacks_.Complete(request, id, result);
+}
+
 int NetworkDelegate::OnBeforeURLRequest(
     net::URLRequest* request,
     const net::CompletionCallback& callback,
@@ -47,7 +79,19 @@ int NetworkDelegate::OnBeforeURLRequest(
         kDoNotTrackHeaderName, "1", true);
   }
 
-  return delegate->OnBeforeURLRequest(request, callback, new_url);
+  uint64_t id =
+      callbacks_.Start(request,
+                       callback,
+                       delegate->GetNetworkCallbackTimeout(),
+                       delegate->GetNetworkCallbackTimeoutResult());
+  int rv = delegate->OnBeforeURLRequest(
+      request,
+      base::Bind(&NetworkDelegate::BeforeURLRequestDone,
+                 weak_ptr_factory_.GetWeakPtr(),
+                 request, id, new_url),
+      new_url);
+
+  return callbacks_.DidReturn(request, id, rv);
 }
 
 int NetworkDelegate::OnBeforeStartTransaction(
@@ -59,7 +103,19 @@ int NetworkDelegate::OnBeforeStartTransaction(
     return net::OK;
   }
 
-  return delegate->OnBeforeSendHeaders(request, callback, headers);
+  uint64_t id =
+      callbacks_.Start(request,
+                       callback,
+                       delegate->GetNetworkCallbackTimeout(),
+                       delegate->GetNetworkCallbackTimeoutResult());
+  int rv = delegate->OnBeforeSendHeaders(
+      request,
+      base::Bind(&NetworkDelegate::BeforeSendHeadersDone,
+                 weak_ptr_factory_.GetWeakPtr(),
+                 request, id, headers),
+      headers);
+
+  return callbacks_.DidReturn(request, id, rv);
 }
 
 void NetworkDelegate::OnBeforeSendHeaders(
@@ -106,9 +162,20 @@ void NetworkDelegate::OnNetworkBytesReceived(net::URLRequest* request,
 void NetworkDelegate::OnNetworkBytesSent(net::URLRequest* request,
                                          int64_t bytes_sent) {}
 
-void NetworkDelegate::OnCompleted(net::URLRequest* request, bool started) {}
+void NetworkDelegate::OnCompleted(net::URLRequest* request, bool started) {
+  if (!started) {
+    return;
+  }
+
+  HttpCacheController* cache_controller = context_->GetHttpCacheController();
+  if (cache_controller) {
+    cache_controller->OnRequestCompleted(request);
+  }
+}
 
-void NetworkDelegate::OnURLRequestDestroyed(net::URLRequest* request) {}
+void NetworkDelegate::OnURLRequestDestroyed(net::URLRequest* request) {
+  callbacks_.OnURLRequestDestroyed(request);
+}
 
 void NetworkDelegate::OnPACScriptError(int line_number,
                                        const base::string16& error) {}
@@ -162,7 +229,11 @@ bool NetworkDelegate::OnCancelURLRequestWithPolicyViolatingReferrerHeader(
   return true;
 }
 
-NetworkDelegate::NetworkDelegate(BrowserContextIOData* context) :
-    context_(context) {}
+NetworkDelegate::NetworkDelegate(BrowserContextIOData* context)
+    : context_(context),
+      weak_ptr_factory_(this) {}
+
+NetworkDelegate::~NetworkDelegate() {}
+
 
 } // namespace oxide
@@ -18,9 +18,14 @@
 #ifndef _OXIDE_SHARED_BROWSER_NETWORK_DELEGATE_H_
 #define _OXIDE_SHARED_BROWSER_NETWORK_DELEGATE_H_
 
+#include <stdint.h>
+
 #include "base/macros.h"
+#include "base/memory/weak_ptr.h"
 #include "net/base/network_delegate.h"
 
+#include "shared/browser/net/oxide_network_callback_tracker.h"
+
 namespace oxide {
 
 class BrowserContextIOData;
@@ -28,8 +33,21 @@ class BrowserContextIOData;
 class NetworkDelegate final : public net::NetworkDelegate {
  public:
   NetworkDelegate(BrowserContextIOData* context);
+  ~NetworkDelegate() override;
 
  private:
+  void BeforeURLRequestDone(const net::URLRequest* request,
+                            uint64_t id,
+                            GURL* new_url,
+                            int result,
+                            const GURL& url);
+  void BeforeSendHeadersDone(const net::URLRequest* request,
+                             uint64_t id,
+                             net::HttpRequestHeaders* headers,
+                             int result,
+                             const net::HttpRequestHeaders& new_headers);
+
+  // net::NetworkDelegate implementation
   int OnBeforeURLRequest(net::URLRequest* request,
                          const net::CompletionCallback& callback,
                          GURL* new_url) final;
@@ -99,6 +117,13 @@ class NetworkDelegate final : public net::NetworkDelegate {
 
   BrowserContextIOData* context_;
 
+  // Tracks calls in to BrowserContextDelegate that are completed
+  // asynchronously, so that they can time out and so that results for
+  // destroyed requests are dropped
+  NetworkCallbackTracker callbacks_;
+
+  base::WeakPtrFactory<NetworkDelegate> weak_ptr_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(NetworkDelegate);
 };
 
@@ -17,7 +17,10 @@
 
 #include "oxide_redirection_intercept_throttle.h"
 
+#include "base/bind.h"
 #include "base/memory/ref_counted.h"
+#include "base/metrics/histogram_macros.h"
+#include "net/base/net_errors.h"
 #include "net/url_request/redirect_info.h"
 
 #include "oxide_browser_context.h"
@@ -25,6 +28,39 @@
 
 namespace oxide {
 
+void RedirectionInterceptThrottle::OnBeforeRedirectDone(int result) {
+  if (defer_start_time_.is_null()) {
+    // We already timed out
+    return;
+  }
+
+  timeout_timer_.Stop();
+
+  UMA_HISTOGRAM_TIMES("Oxide.NetworkDelegate.RedirectCallbackLatency",
+                      base::TimeTicks::Now() - defer_start_time_);
+  defer_start_time_ = base::TimeTicks();
+
+  ContinueWithResult(result);
+}
+
+void RedirectionInterceptThrottle::OnBeforeRedirectTimeout(int result) {
+  UMA_HISTOGRAM_BOOLEAN("Oxide.NetworkDelegate.RedirectCallbackTimedOut",
+                        true);
+  defer_start_time_ = base::TimeTicks();
+
+  ContinueWithResult(result);
+}
+
+void RedirectionInterceptThrottle::ContinueWithResult(int result) {
+  if (result == net::OK) {
+    Resume();
+  } else if (result == net::ERR_ABORTED) {
+    CancelAndIgnore();
+  } else {
+    CancelWithError(result);
+  }
+}
+
 void RedirectionInterceptThrottle::WillRedirectRequest(
     const net::RedirectInfo& redirect_info,
     bool* defer) {
@@ -39,8 +75,28 @@ void RedirectionInterceptThrottle::WillRedirectRequest(
     return;
   }
 
-  int rv = delegate->OnBeforeRedirect(request_, redirect_info.new_url);
-  if (rv == net::ERR_ABORTED) {
+  // Invalidate callbacks from any previous redirect
+  weak_ptr_factory_.InvalidateWeakPtrs();
+  timeout_timer_.Stop();
+
+  int rv = delegate->OnBeforeRedirect(
+      request_,
+      redirect_info.new_url,
+      base::Bind(&RedirectionInterceptThrottle::OnBeforeRedirectDone,
+                 weak_ptr_factory_.GetWeakPtr()));
+  if (rv == net::ERR_IO_PENDING) {
+    *defer = true;
+    defer_start_time_ = base::TimeTicks::Now();
+
+    base::TimeDelta timeout = delegate->GetNetworkCallbackTimeout();
+    if (!timeout.is_zero()) {
+      timeout_timer_.Start(
+          FROM_HERE, timeout,
+          base::Bind(&RedirectionInterceptThrottle::OnBeforeRedirectTimeout,
+                     weak_ptr_factory_.GetWeakPtr(),
+                     delegate->GetNetworkCallbackTimeoutResult()));
+    }
+  } else if (rv == net::ERR_ABORTED) {
     CancelAndIgnore();
   } else if (rv != net::OK) {
     CancelWithError(rv);
@@ -55,7 +111,8 @@ RedirectionInterceptThrottle::RedirectionInterceptThrottle(
     net::URLRequest* request,
     content::ResourceContext* resource_context)
     : request_(request),
-      resource_context_(resource_context) {}
+      resource_context_(resource_context),
+      weak_ptr_factory_(this) {}
 
 RedirectionInterceptThrottle::~RedirectionInterceptThrottle() {}
 
@@ -19,6 +19,9 @@
 #define _OXIDE_SHARED_BROWSER_REDIRECTION_INTERCEPT_THROTTLE_H_
 
 #include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "content/public/browser/resource_throttle.h"
 
 namespace content {
@@ -38,6 +41,11 @@ class RedirectionInterceptThrottle : public content::ResourceThrottle {
   ~RedirectionInterceptThrottle() override;
 
  private:
+  void OnBeforeRedirectDone(int result);
+  void OnBeforeRedirectTimeout(int result);
+
+  void ContinueWithResult(int result);
+
   // content::ResourceThrottle implementation
   void WillRedirectRequest(const net::RedirectInfo& redirect_info,
                            bool* defer) override;
@@ -46,6 +54,12 @@ class RedirectionInterceptThrottle : public content::ResourceThrottle {
   net::URLRequest* request_;
   content::ResourceContext* resource_context_;
 
+  // Used when the delegate handles a redirect asynchronously
+  base::TimeTicks defer_start_time_;
+  base::OneShotTimer timeout_timer_;
+
+  base::WeakPtrFactory<RedirectionInterceptThrottle> weak_ptr_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(RedirectionInterceptThrottle);
 };
 
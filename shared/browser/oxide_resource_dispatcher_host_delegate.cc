@@ -26,6 +26,7 @@
 #include "base/strings/utf_string_conversions.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/resource_dispatcher_host.h"
 #include "content/public/browser/resource_context.h"
@@ -244,6 +245,86 @@ net::CookieStore* ResourceDispatcherHostDelegate::GetCookieStoreForContext(
       : nullptr;
 }
 
+void ResourceDispatcherHostDelegate::PrefetchLegacyUserAgentOverride(
+    net::URLRequest* request,
+    content::ResourceContext* resource_context) {
+  GURL origin = request->url().GetOrigin();
+  if (!origin.is_valid()) {
+    return;
+  }
+
+  BrowserContextIOData* io_data =
+      BrowserContextIOData::FromResourceContext(resource_context);
+  if (!io_data) {
+    return;
+  }
+
+  int generation = 0;
+  if (!io_data->GetUserAgentSettings()->ShouldPrefetchLegacyUserAgentOverride(
+          origin, &generation)) {
+    return;
+  }
+
+  scoped_refptr<BrowserContextDelegate> delegate(io_data->GetDelegate());
+  if (!delegate.get()) {
+    return;
+  }
+
+  const content::ResourceRequestInfo* info =
+      content::ResourceRequestInfo::ForRequest(request);
+  if (!info) {
+    return;
+  }
+
+  // Strip username / password / fragment identifier, as the renderer does
+  GURL::Replacements rep;
+  rep.ClearUsername();
+  rep.ClearPassword();
+  rep.ClearRef();
+
+  // The delegate may block whilst it calls in to the application, so don't
+  // run it on the IO thread
+  content::BrowserThread::PostBlockingPoolTask(
+      FROM_HERE,
+      base::Bind(&ResourceDispatcherHostDelegate::FetchLegacyUserAgentOverride,
+                 delegate,
+                 info->GetChildID(),
+                 generation,
+                 request->url().ReplaceComponents(rep)));
+}
+
+// static
+void ResourceDispatcherHostDelegate::FetchLegacyUserAgentOverride(
+    scoped_refptr<BrowserContextDelegate> delegate,
+    int render_process_id,
+    int generation,
+    const GURL& url) {
+  std::string user_agent = delegate->GetUserAgentOverride(url);
+
+  content::BrowserThread::PostTask(
+      content::BrowserThread::UI,
+      FROM_HERE,
+      base::Bind(
+          &ResourceDispatcherHostDelegate::DidFetchLegacyUserAgentOverride,
+          render_process_id, generation, url.GetOrigin(), user_agent));
+}
+
+// static
+void ResourceDispatcherHostDelegate::DidFetchLegacyUserAgentOverride(
+    int render_process_id,
+    int generation,
+    const GURL& origin,
+    const std::string& user_agent) {
+  content::RenderProcessHost* host =
+      content::RenderProcessHost::FromID(render_process_id);
+  if (!host) {
+    return;
+  }
+
+  UserAgentSettings::Get(host->GetBrowserContext())
+      ->LegacyUserAgentOverrideFetched(generation, origin, user_agent);
+}
+
 void ResourceDispatcherHostDelegate::RequestBeginning(
     net::URLRequest* request,
     content::ResourceContext* resource_context,
@@ -257,6 +338,11 @@ void ResourceDispatcherHostDelegate::RequestBeginning(
     throttles->push_back(
         base::MakeUnique<NavigationInterceptResourceThrottle>(request));
   }
+
+  if (resource_type == content::RESOURCE_TYPE_MAIN_FRAME ||
+      resource_type == content::RESOURCE_TYPE_SUB_FRAME) {
+    PrefetchLegacyUserAgentOverride(request, resource_context);
+  }
 }
 
 bool ResourceDispatcherHostDelegate::HandleExternalProtocol(
@@ -20,6 +20,7 @@
 
 #include "base/callback.h"
 #include "base/macros.h"
+#include "base/memory/ref_counted.h"
 #include "base/strings/string16.h"
 #include "content/public/browser/resource_dispatcher_host_delegate.h"
 
@@ -36,6 +37,7 @@ class CookieStore;
 
 namespace oxide {
 
+class BrowserContextDelegate;
 class ResourceDispatcherHostLoginDelegate;
 
 class ResourceDispatcherHostDelegate
@@ -73,6 +75,23 @@ class ResourceDispatcherHostDelegate
   net::CookieStore* GetCookieStoreForContext(
       content::ResourceContext* resource_context);
 
+  // Starts a lookup of the legacy user agent override for the origin of
+  // |request|, so that renderers don't need to request it synchronously
+  void PrefetchLegacyUserAgentOverride(
+      net::URLRequest* request,
+      content::ResourceContext* resource_context);
+
+  static void FetchLegacyUserAgentOverride(
+      scoped_refptr<BrowserContextDelegate> delegate,
+      int render_process_id,
+      int generation,
+      const GURL& url);
+
+  static void DidFetchLegacyUserAgentOverride(int render_process_id,
+                                              int generation,
+                                              const GURL& origin,
+                                              const std::string& user_agent);
+
   // content::ResourceDispatcherHostDelegate implementation
   void RequestBeginning(
       net::URLRequest* request,
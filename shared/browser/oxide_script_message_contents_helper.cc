@@ -17,11 +17,14 @@
 
 #include "oxide_script_message_contents_helper.h"
 
+#include <string>
 #include <tuple>
-#include <vector>
 
+#include "base/bind.h"
+#include "base/callback_helpers.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
+#include "base/trace_event/trace_event.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/render_process_host.h"
 #include "ipc/ipc_message.h"
@@ -31,8 +34,11 @@
 #include "shared/common/oxide_messages.h"
 #include "shared/common/oxide_script_message_handler.h"
 #include "shared/common/oxide_script_message_request.h"
+#include "shared/common/oxide_script_message_worker.h"
 
+#include "oxide_script_message_filter.h"
 #include "oxide_script_message_impl_browser.h"
+#include "oxide_script_message_impl_worker.h"
 #include "oxide_script_message_request_impl_browser.h"
 #include "oxide_script_message_target.h"
 #include "oxide_web_frame.h"
@@ -42,32 +48,22 @@ namespace oxide {
 
 namespace {
 
-bool TryDispatchMessageToTarget(ScriptMessageTarget* target,
-                                ScriptMessageImplBrowser* message) {
-  for (size_t i = 0; i < target->GetScriptMessageHandlerCount(); ++i) {
-    const ScriptMessageHandler* handler =
-        target->GetScriptMessageHandlerAt(i);
-
-    if (!handler->IsValid()) {
-      continue;
-    }
-
-    if (handler->msg_id() != message->msg_id()) {
-      continue;
-    }
+const ScriptMessageHandler* FindHandlerForMessage(WebFrame* frame,
+                                                  const std::string& msg_id,
+                                                  const GURL& context) {
+  WebView* view = frame->GetView();
+  DCHECK(view);
 
-    const std::vector<GURL>& contexts = handler->contexts();
-
-    for (std::vector<GURL>::const_iterator it = contexts.begin();
-         it != contexts.end(); ++it) {
-      if ((*it) == message->context()) {
-        handler->OnReceiveMessage(message);
-        return true;
-      }
+  for (WebFrame* target = frame; target; target = target->parent()) {
+    DCHECK_EQ(target->GetView(), view);
+    const ScriptMessageHandler* handler =
+        target->FindScriptMessageHandler(msg_id, context);
+    if (handler) {
+      return handler;
     }
   }
 
-  return false;
+  return view->FindScriptMessageHandler(msg_id, context);
 }
 
 void ReturnError(content::RenderFrameHost* render_frame_host,
@@ -84,6 +80,16 @@ void ReturnError(content::RenderFrameHost* render_frame_host,
       new OxideMsg_SendMessage(render_frame_host->GetRoutingID(), params));
 }
 
+void DidDispatchMessage(int render_process_id, int render_frame_id) {
+  scoped_refptr<ScriptMessageFilter> filter =
+      ScriptMessageFilter::FromRenderProcessID(render_process_id);
+  if (!filter) {
+    return;
+  }
+
+  filter->DidDispatchMessageOnUIThread(render_frame_id);
+}
+
 } // namespace
 
 DEFINE_WEB_CONTENTS_USER_DATA_KEY(ScriptMessageContentsHelper);
@@ -95,6 +101,9 @@ ScriptMessageContentsHelper::ScriptMessageContentsHelper(
 void ScriptMessageContentsHelper::OnReceiveScriptMessage(
     const IPC::Message& message,
     content::RenderFrameHost* render_frame_host) {
+  TRACE_EVENT0("oxide.script_messages",
+               "oxide::ScriptMessageContentsHelper::OnReceiveScriptMessage");
+
   OxideHostMsg_SendMessage::Param p;
   if (!OxideHostMsg_SendMessage::Read(&message, &p)) {
     render_frame_host->GetProcess()->ShutdownForBadMessage(
@@ -106,6 +115,16 @@ void ScriptMessageContentsHelper::OnReceiveScriptMessage(
 
   bool is_reply = params.type == ScriptMessageParams::TYPE_REPLY;
 
+  // ScriptMessageFilter holds back later messages from this frame until this
+  // one has been dispatched, however we return
+  base::ScopedClosureRunner dispatched;
+  if (!is_reply) {
+    dispatched.ReplaceClosure(
+        base::Bind(&DidDispatchMessage,
+                   render_frame_host->GetProcess()->GetID(),
+                   render_frame_host->GetRoutingID()));
+  }
+
   WebFrame* frame = WebFrame::FromRenderFrameHost(render_frame_host);
   if (!frame) {
     ReturnError(render_frame_host,
@@ -115,47 +134,82 @@ void ScriptMessageContentsHelper::OnReceiveScriptMessage(
   }
 
   if (!is_reply) {
-    scoped_refptr<ScriptMessageImplBrowser> message(
-        new ScriptMessageImplBrowser(frame,
-                                     params.serial,
-                                     params.context,
-                                     params.msg_id,
-                                     &params.wrapped_payload));
-    WebFrame* target = frame;
-    WebView* view = frame->GetView();
-    if (!view) {
+    if (!frame->GetView()) {
       ReturnError(render_frame_host,
                   ScriptMessageParams::ERROR_NO_HANDLER,
                   params);
       return;
     }
 
-    while (target) {
-      DCHECK_EQ(target->GetView(), view);
-      if (TryDispatchMessageToTarget(target, message.get())) {
-        break;
-      }
+    // Read this before resolving the handler, so that a route recorded below
+    // is treated as stale if the configuration changes in between
+    int generation = ScriptMessageHandler::GetConfigurationGeneration();
 
-      target = target->parent();
+    const ScriptMessageHandler* handler =
+        FindHandlerForMessage(frame, params.msg_id, params.context);
+    if (!handler) {
+      ReturnError(render_frame_host,
+                  ScriptMessageParams::ERROR_NO_HANDLER,
+                  params);
+      return;
     }
 
-    if (!target && !TryDispatchMessageToTarget(view, message.get())) {
-      message->Error(ScriptMessageParams::ERROR_NO_HANDLER);
+    scoped_refptr<ScriptMessage> message;
+    if (handler->worker()) {
+      // Replies from workers can be sent from any thread, so they go via the
+      // render process' ScriptMessageFilter rather than the RenderFrameHost
+      scoped_refptr<ScriptMessageFilter> filter =
+          ScriptMessageFilter::FromRenderProcessID(
+              render_frame_host->GetProcess()->GetID());
+      if (!filter) {
+        ReturnError(render_frame_host,
+                    ScriptMessageParams::ERROR_NO_HANDLER,
+                    params);
+        return;
+      }
+
+      // Subsequent messages on this route are dispatched to the worker
+      // directly from the IO thread
+      filter->AddRoute(render_frame_host->GetRoutingID(),
+                       params.msg_id,
+                       params.context,
+                       handler->worker(),
+                       generation);
+      message = new ScriptMessageImplWorker(filter.get(),
+                                            render_frame_host->GetRoutingID(),
+                                            params.serial,
+                                            params.context,
+                                            params.msg_id,
+                                            &params.wrapped_payload);
+    } else {
+      message = new ScriptMessageImplBrowser(frame,
+                                             params.serial,
+                                             params.context,
+                                             params.msg_id,
+                                             &params.wrapped_payload);
     }
 
+    handler->OnReceiveMessage(message.get());
     return;
   }
 
-  for (WebFrame::ScriptMessageRequestVector::const_iterator it =
-        frame->current_script_message_requests().begin();
-       it != frame->current_script_message_requests().end(); ++it) {
-    ScriptMessageRequestImplBrowser* request = *it;
-    if (request->serial() == params.serial &&
-        request->IsWaitingForResponse()) {
-      request->OnReceiveResponse(&params.wrapped_payload, params.error);
-      return;
-    }
+  ScriptMessageRequestImplBrowser* request =
+      frame->FindScriptMessageRequest(params.serial);
+  if (request && request->IsWaitingForResponse()) {
+    request->OnReceiveResponse(&params.wrapped_payload, params.error);
+  }
+}
+
+void ScriptMessageContentsHelper::RenderFrameDeleted(
+    content::RenderFrameHost* render_frame_host) {
+  scoped_refptr<ScriptMessageFilter> filter =
+      ScriptMessageFilter::FromRenderProcessID(
+          render_frame_host->GetProcess()->GetID());
+  if (!filter) {
+    return;
   }
+
+  filter->RemoveRoutesForFrame(render_frame_host->GetRoutingID());
 }
 
 bool ScriptMessageContentsHelper::OnMessageReceived(
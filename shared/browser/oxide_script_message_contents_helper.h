@@ -39,6 +39,7 @@ class ScriptMessageContentsHelper
                               content::RenderFrameHost* render_frame_observer);
 
   // content::WebContentsObserver implementation
+  void RenderFrameDeleted(content::RenderFrameHost* render_frame_host) override;
   bool OnMessageReceived(const IPC::Message& message,
                          content::RenderFrameHost* render_frame_host) override;
 
@@ -0,0 +1,307 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "oxide_script_message_filter.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/trace_event/trace_event.h"
+#include "content/public/browser/browser_thread.h"
+#include "ipc/ipc_message.h"
+#include "url/gurl.h"
+
+#include "shared/common/oxide_messages.h"
+#include "shared/common/oxide_script_message_handler.h"
+#include "shared/common/oxide_script_message_worker.h"
+
+#include "oxide_script_message_impl_worker.h"
+
+namespace oxide {
+
+namespace {
+
+base::LazyInstance<base::Lock>::Leaky g_filters_lock =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Maps a render process ID to its filter. Filters remove themselves when the
+// channel goes away. The map holds a strong reference so that
+// FromRenderProcessID never hands out a filter that is being destroyed
+using FilterMap = std::map<int, scoped_refptr<ScriptMessageFilter>>;
+base::LazyInstance<FilterMap>::Leaky g_filters = LAZY_INSTANCE_INITIALIZER;
+
+}
+
+ScriptMessageFilter::~ScriptMessageFilter() {}
+
+scoped_refptr<ScriptMessageWorker> ScriptMessageFilter::RouteMessage(
+    int render_frame_id,
+    const std::string& msg_id,
+    const GURL& context) {
+  base::AutoLock lock(routes_lock_);
+
+  if (base::subtle::NoBarrier_Load(&untracked_) ||
+      drain_state_ == DrainState::WAITING_FOR_IO) {
+    // The last route was removed after the IO thread checked |untracked_|,
+    // or this message is ahead of the drain marker. Either way, the UI
+    // thread won't expect to be told when it has been dispatched
+    return nullptr;
+  }
+
+  auto pending = ui_thread_messages_.find(render_frame_id);
+  if (pending != ui_thread_messages_.end()) {
+    // Dispatching this now could overtake an earlier message that is still
+    // queued for the UI thread
+    ++pending->second;
+    return nullptr;
+  }
+
+  auto it = routes_.find(std::make_tuple(render_frame_id,
+                                         msg_id,
+                                         context.spec()));
+  if (it != routes_.end() &&
+      it->second.generation !=
+          ScriptMessageHandler::GetConfigurationGeneration()) {
+    // Handlers have changed since this route was resolved. Let the UI thread
+    // route the next message
+    routes_.erase(it);
+    it = routes_.end();
+  }
+
+  if (it == routes_.end() || drain_state_ == DrainState::WAITING_FOR_UI) {
+    ui_thread_messages_[render_frame_id] = 1;
+    return nullptr;
+  }
+
+  return it->second.worker;
+}
+
+void ScriptMessageFilter::UpdateUntrackedLocked() {
+  routes_lock_.AssertAcquired();
+
+  if (!routes_.empty() ||
+      !ui_thread_messages_.empty() ||
+      drain_state_ != DrainState::NONE) {
+    return;
+  }
+
+  base::subtle::Release_Store(&untracked_, 1);
+}
+
+void ScriptMessageFilter::OnDrainMarkerOnIOThread() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+
+  base::AutoLock lock(routes_lock_);
+  if (drain_state_ != DrainState::WAITING_FOR_IO) {
+    // The channel was closed
+    return;
+  }
+
+  // Every message that was passed to the UI thread untracked has been posted
+  // ahead of this
+  drain_state_ = DrainState::WAITING_FOR_UI;
+  content::BrowserThread::PostTask(
+      content::BrowserThread::UI,
+      FROM_HERE,
+      base::Bind(&ScriptMessageFilter::OnDrainMarkerOnUIThread, this));
+}
+
+void ScriptMessageFilter::OnDrainMarkerOnUIThread() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  base::AutoLock lock(routes_lock_);
+  if (drain_state_ != DrainState::WAITING_FOR_UI) {
+    return;
+  }
+
+  drain_state_ = DrainState::NONE;
+  UpdateUntrackedLocked();
+}
+
+void ScriptMessageFilter::Unregister() {
+  // Make sure that the last reference isn't dropped with the lock held
+  scoped_refptr<ScriptMessageFilter> self;
+
+  base::AutoLock lock(g_filters_lock.Get());
+
+  auto it = g_filters.Get().find(render_process_id_);
+  if (it != g_filters.Get().end() && it->second == this) {
+    self = std::move(it->second);
+    g_filters.Get().erase(it);
+  }
+}
+
+void ScriptMessageFilter::OnFilterRemoved() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+
+  Unregister();
+
+  base::AutoLock lock(routes_lock_);
+  routes_.clear();
+  ui_thread_messages_.clear();
+  drain_state_ = DrainState::NONE;
+  UpdateUntrackedLocked();
+}
+
+bool ScriptMessageFilter::OnMessageReceived(const IPC::Message& message) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::IO);
+
+  if (message.type() != OxideHostMsg_SendMessage::ID) {
+    return false;
+  }
+
+  if (base::subtle::Acquire_Load(&untracked_)) {
+    // There are no routes for this process, so leave the message for the UI
+    // thread without deserializing it here
+    return false;
+  }
+
+  // Malformed messages are left for the UI thread, which will kill the
+  // renderer
+  OxideHostMsg_SendMessage::Param p;
+  if (!OxideHostMsg_SendMessage::Read(&message, &p)) {
+    return false;
+  }
+
+  ScriptMessageParams& params = std::get<0>(p);
+  if (params.type != ScriptMessageParams::TYPE_MESSAGE) {
+    return false;
+  }
+
+  TRACE_EVENT1("oxide.script_messages",
+               "oxide::ScriptMessageFilter::OnMessageReceived",
+               "msg_id", params.msg_id);
+
+  scoped_refptr<ScriptMessageWorker> worker =
+      RouteMessage(message.routing_id(), params.msg_id, params.context);
+  if (!worker) {
+    return false;
+  }
+
+  worker->OnReceiveMessage(
+      make_scoped_refptr(new ScriptMessageImplWorker(this,
+                                                     message.routing_id(),
+                                                     params.serial,
+                                                     params.context,
+                                                     params.msg_id,
+                                                     &params.wrapped_payload)));
+  return true;
+}
+
+ScriptMessageFilter::ScriptMessageFilter(int render_process_id)
+    : content::BrowserMessageFilter(OxideMsgStart),
+      render_process_id_(render_process_id),
+      drain_state_(DrainState::NONE),
+      untracked_(1) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  base::AutoLock lock(g_filters_lock.Get());
+  // This replaces the entry for a previous channel to the same
+  // RenderProcessHost
+  g_filters.Get()[render_process_id_] = this;
+}
+
+// static
+scoped_refptr<ScriptMessageFilter> ScriptMessageFilter::FromRenderProcessID(
+    int render_process_id) {
+  base::AutoLock lock(g_filters_lock.Get());
+
+  auto it = g_filters.Get().find(render_process_id);
+  if (it == g_filters.Get().end()) {
+    return nullptr;
+  }
+
+  return it->second;
+}
+
+void ScriptMessageFilter::AddRoute(int render_frame_id,
+                                   const std::string& msg_id,
+                                   const GURL& context,
+                                   ScriptMessageWorker* worker,
+                                   int generation) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  DCHECK(worker);
+
+  Route route;
+  route.worker = worker;
+  route.generation = generation;
+
+  base::AutoLock lock(routes_lock_);
+  routes_[std::make_tuple(render_frame_id, msg_id, context.spec())] =
+      std::move(route);
+
+  if (!base::subtle::NoBarrier_Load(&untracked_)) {
+    return;
+  }
+
+  // Messages that the IO thread has already passed on untracked could still
+  // be queued behind the one that this route was resolved for. Don't use any
+  // routes until they've been dispatched
+  base::subtle::Release_Store(&untracked_, 0);
+  drain_state_ = DrainState::WAITING_FOR_IO;
+  content::BrowserThread::PostTask(
+      content::BrowserThread::IO,
+      FROM_HERE,
+      base::Bind(&ScriptMessageFilter::OnDrainMarkerOnIOThread, this));
+}
+
+void ScriptMessageFilter::RemoveRoutesForFrame(int render_frame_id) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  base::AutoLock lock(routes_lock_);
+
+  auto it = routes_.lower_bound(
+      std::make_tuple(render_frame_id, std::string(), std::string()));
+  while (it != routes_.end() && std::get<0>(it->first) == render_frame_id) {
+    it = routes_.erase(it);
+  }
+
+  // Messages still queued for a deleted frame are dropped without being
+  // dispatched
+  ui_thread_messages_.erase(render_frame_id);
+
+  UpdateUntrackedLocked();
+}
+
+void ScriptMessageFilter::DidDispatchMessageOnUIThread(int render_frame_id) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  base::AutoLock lock(routes_lock_);
+
+  if (drain_state_ != DrainState::NONE) {
+    // Until the drain marker arrives back on the UI thread, every message
+    // dispatched here is one that was passed on untracked
+    return;
+  }
+
+  auto it = ui_thread_messages_.find(render_frame_id);
+  if (it == ui_thread_messages_.end()) {
+    // The frame was deleted, the message was passed on untracked, or it
+    // arrived before this filter was installed
+    return;
+  }
+
+  DCHECK_GT(it->second, 0);
+  if (--it->second == 0) {
+    ui_thread_messages_.erase(it);
+    UpdateUntrackedLocked();
+  }
+}
+
+} // namespace oxide
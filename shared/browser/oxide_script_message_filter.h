@@ -0,0 +1,153 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_SHARED_BROWSER_SCRIPT_MESSAGE_FILTER_H_
+#define _OXIDE_SHARED_BROWSER_SCRIPT_MESSAGE_FILTER_H_
+
+#include <map>
+#include <string>
+#include <tuple>
+
+#include "base/atomicops.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "content/public/browser/browser_message_filter.h"
+
+class GURL;
+
+namespace oxide {
+
+class ScriptMessageWorker;
+
+// Delivers script messages from a render process directly to
+// ScriptMessageWorkers on the IO thread, bypassing the UI thread.
+//
+// The first message for a given frame, message ID and context is always
+// routed on the UI thread by ScriptMessageContentsHelper, which has access to
+// the frame tree and the handlers attached to it. If that resolves to a
+// handler with a worker, the helper records the route here. Subsequent
+// messages are then dispatched from the IO thread for as long as the handler
+// configuration doesn't change (see
+// ScriptMessageHandler::GetConfigurationGeneration).
+//
+// To preserve the order of messages from a frame, a message is only
+// dispatched from the IO thread if every earlier message from that frame
+// that was passed to the UI thread has been dispatched there. Otherwise it
+// is passed to the UI thread too.
+//
+// Tracking this has a cost, so whilst a render process has no routes, its
+// messages are passed to the UI thread without being deserialized or counted.
+// When the first route is added, it isn't used until every message that was
+// passed on untracked has been dispatched. This is detected by bouncing a
+// marker task from the UI thread via the IO thread and back to the UI thread,
+// which arrives after all of those messages
+class ScriptMessageFilter : public content::BrowserMessageFilter {
+ public:
+  ScriptMessageFilter(int render_process_id);
+
+  // Returns the filter for the render process with the specified ID, or
+  // null if there isn't one. Can be called on any thread
+  static scoped_refptr<ScriptMessageFilter> FromRenderProcessID(
+      int render_process_id);
+
+  // Record that messages with |msg_id| from |context| in the frame with
+  // |render_frame_id| are handled by |worker|. |generation| is the value of
+  // ScriptMessageHandler::GetConfigurationGeneration() from before the route
+  // was resolved
+  void AddRoute(int render_frame_id,
+                const std::string& msg_id,
+                const GURL& context,
+                ScriptMessageWorker* worker,
+                int generation);
+
+  // Remove all routes for the frame with |render_frame_id|
+  void RemoveRoutesForFrame(int render_frame_id);
+
+  // Called on the UI thread when a message from the frame with
+  // |render_frame_id| that this filter passed to the UI thread has been
+  // dispatched
+  void DidDispatchMessageOnUIThread(int render_frame_id);
+
+ private:
+  ~ScriptMessageFilter() override;
+
+  // Returns the worker that should receive a message, or null if the message
+  // should be passed to the UI thread. In the latter case, the message is
+  // counted until DidDispatchMessageOnUIThread is called for it
+  scoped_refptr<ScriptMessageWorker> RouteMessage(int render_frame_id,
+                                                  const std::string& msg_id,
+                                                  const GURL& context);
+
+  void Unregister();
+
+  // Set |untracked_| if there's nothing to track
+  void UpdateUntrackedLocked();
+
+  void OnDrainMarkerOnIOThread();
+  void OnDrainMarkerOnUIThread();
+
+  // content::BrowserMessageFilter implementation
+  void OnFilterRemoved() override;
+  bool OnMessageReceived(const IPC::Message& message) override;
+
+  int render_process_id_;
+
+  struct Route {
+    scoped_refptr<ScriptMessageWorker> worker;
+    int generation;
+  };
+
+  // Keyed by (render frame ID, message ID, context spec)
+  using RouteKey = std::tuple<int, std::string, std::string>;
+
+  base::Lock routes_lock_;
+  std::map<RouteKey, Route> routes_;
+
+  // The number of messages from each frame that have been passed to the UI
+  // thread but not dispatched yet. Frames with no such messages have no
+  // entry. Guarded by |routes_lock_|
+  std::map<int, int> ui_thread_messages_;
+
+  enum class DrainState {
+    // Not draining
+    NONE,
+
+    // The first route has been added, and the marker hasn't reached the IO
+    // thread yet. Messages are still passed to the UI thread untracked
+    WAITING_FOR_IO,
+
+    // The marker has passed the IO thread, and is on its way back to the UI
+    // thread. Messages are counted, but routes aren't used yet
+    WAITING_FOR_UI
+  };
+
+  // Guarded by |routes_lock_|
+  DrainState drain_state_;
+
+  // Non-zero whilst there are no routes, no counted messages and no drain in
+  // progress, in which case messages are passed straight to the UI thread.
+  // Only written with |routes_lock_| held, so that it's consistent with the
+  // state it summarizes, but read on the IO thread without it
+  base::subtle::Atomic32 untracked_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScriptMessageFilter);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_SCRIPT_MESSAGE_FILTER_H_
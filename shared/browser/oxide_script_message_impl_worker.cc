@@ -0,0 +1,46 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "oxide_script_message_impl_worker.h"
+
+#include "shared/common/oxide_messages.h"
+
+#include "oxide_script_message_filter.h"
+
+namespace oxide {
+
+ScriptMessageImplWorker::~ScriptMessageImplWorker() {}
+
+void ScriptMessageImplWorker::DoSendResponse(
+    const ScriptMessageParams& params) {
+  // BrowserMessageFilter::Send is safe to call from any thread, and just
+  // drops the message if the channel has gone away
+  filter_->Send(new OxideMsg_SendMessage(render_frame_id_, params));
+}
+
+ScriptMessageImplWorker::ScriptMessageImplWorker(
+    ScriptMessageFilter* filter,
+    int render_frame_id,
+    int serial,
+    const GURL& context,
+    const std::string& msg_id,
+    base::ListValue* wrapped_payload)
+    : ScriptMessage(serial, context, msg_id, wrapped_payload),
+      filter_(filter),
+      render_frame_id_(render_frame_id) {}
+
+} // namespace oxide
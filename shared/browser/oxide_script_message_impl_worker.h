@@ -0,0 +1,66 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_SHARED_BROWSER_SCRIPT_MESSAGE_IMPL_WORKER_H_
+#define _OXIDE_SHARED_BROWSER_SCRIPT_MESSAGE_IMPL_WORKER_H_
+
+#include <string>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+
+#include "shared/common/oxide_script_message.h"
+#include "shared/common/oxide_shared_export.h"
+
+class GURL;
+
+namespace base {
+class ListValue;
+}
+
+namespace oxide {
+
+class ScriptMessageFilter;
+
+// A ScriptMessage that is delivered to a ScriptMessageWorker. Unlike
+// ScriptMessageImplBrowser, it isn't tied to a WebFrame and can be responded
+// to from any thread - responses are sent via the ScriptMessageFilter for the
+// source frame's render process
+class OXIDE_SHARED_EXPORT ScriptMessageImplWorker : public ScriptMessage {
+ public:
+  ScriptMessageImplWorker(ScriptMessageFilter* filter,
+                          int render_frame_id,
+                          int serial,
+                          const GURL& context,
+                          const std::string& msg_id,
+                          base::ListValue* wrapped_payload);
+
+ private:
+  ~ScriptMessageImplWorker() override;
+
+  // ScriptMessage implementation
+  void DoSendResponse(const ScriptMessageParams& params) override;
+
+  scoped_refptr<ScriptMessageFilter> filter_;
+  int render_frame_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScriptMessageImplWorker);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_SCRIPT_MESSAGE_IMPL_WORKER_H_
@@ -0,0 +1,80 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "oxide_script_message_target.h"
+
+#include <vector>
+
+#include "url/gurl.h"
+
+#include "shared/common/oxide_script_message_handler.h"
+
+namespace oxide {
+
+void ScriptMessageTarget::RebuildScriptMessageHandlerTable() const {
+  script_message_handler_table_.clear();
+
+  for (size_t i = 0; i < GetScriptMessageHandlerCount(); ++i) {
+    const ScriptMessageHandler* handler = GetScriptMessageHandlerAt(i);
+    if (!handler->IsValid()) {
+      continue;
+    }
+
+    ContextHandlerMap& handlers =
+        script_message_handler_table_[handler->msg_id()];
+    for (const auto& context : handler->contexts()) {
+      // The first handler for a context wins, which matches the order in
+      // which handlers were previously scanned
+      handlers.insert(
+          std::make_pair(context.possible_invalid_spec(), handler));
+    }
+  }
+
+  script_message_handler_table_generation_ =
+      ScriptMessageHandler::GetConfigurationGeneration();
+  script_message_handler_table_valid_ = true;
+}
+
+ScriptMessageTarget::ScriptMessageTarget()
+    : script_message_handler_table_generation_(0),
+      script_message_handler_table_valid_(false) {}
+
+ScriptMessageTarget::~ScriptMessageTarget() {}
+
+const ScriptMessageHandler* ScriptMessageTarget::FindScriptMessageHandler(
+    const std::string& msg_id,
+    const GURL& context) const {
+  if (!script_message_handler_table_valid_ ||
+      script_message_handler_table_generation_ !=
+          ScriptMessageHandler::GetConfigurationGeneration()) {
+    RebuildScriptMessageHandlerTable();
+  }
+
+  auto handlers = script_message_handler_table_.find(msg_id);
+  if (handlers == script_message_handler_table_.end()) {
+    return nullptr;
+  }
+
+  auto it = handlers->second.find(context.possible_invalid_spec());
+  if (it == handlers->second.end()) {
+    return nullptr;
+  }
+
+  return it->second;
+}
+
+} // namespace oxide
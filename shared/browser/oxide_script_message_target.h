@@ -18,17 +18,49 @@
 #ifndef _OXIDE_SHARED_BROWSER_SCRIPT_MESSAGE_TARGET_H_
 #define _OXIDE_SHARED_BROWSER_SCRIPT_MESSAGE_TARGET_H_
 
+#include <string>
+#include <unordered_map>
+
+#include "shared/common/oxide_shared_export.h"
+
+class GURL;
+
 namespace oxide {
 
 class ScriptMessageHandler;
 
-class ScriptMessageTarget {
+class OXIDE_SHARED_EXPORT ScriptMessageTarget {
  public:
-  virtual ~ScriptMessageTarget() {}
+  ScriptMessageTarget();
+  virtual ~ScriptMessageTarget();
 
   virtual size_t GetScriptMessageHandlerCount() const = 0;
   virtual const ScriptMessageHandler* GetScriptMessageHandlerAt(
       size_t index) const = 0;
+
+  // Returns the first valid handler that accepts messages with |msg_id| from
+  // |context|, or null if there isn't one. This uses a hash table keyed by
+  // message ID and context, which is rebuilt when the handler configuration
+  // changes (see ScriptMessageHandler::GetConfigurationGeneration)
+  const ScriptMessageHandler* FindScriptMessageHandler(
+      const std::string& msg_id,
+      const GURL& context) const;
+
+ private:
+  void RebuildScriptMessageHandlerTable() const;
+
+  // Maps a context spec to the handler for it
+  using ContextHandlerMap =
+      std::unordered_map<std::string, const ScriptMessageHandler*>;
+
+  // Maps a message ID to the handlers for it
+  mutable std::unordered_map<std::string, ContextHandlerMap>
+      script_message_handler_table_;
+
+  // The configuration generation that |script_message_handler_table_| was
+  // built for
+  mutable int script_message_handler_table_generation_;
+  mutable bool script_message_handler_table_valid_;
 };
 
 } // namespace oxide
@@ -0,0 +1,136 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/macros.h"
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+#include "shared/common/oxide_script_message_handler.h"
+
+#include "oxide_script_message_target.h"
+
+namespace oxide {
+
+namespace {
+
+bool HandleMessage(ScriptMessage* message,
+                   std::unique_ptr<base::Value>* error_payload) {
+  return true;
+}
+
+class TestScriptMessageTarget : public ScriptMessageTarget {
+ public:
+  TestScriptMessageTarget() {}
+
+  void AddHandler(const std::string& msg_id,
+                  const std::vector<GURL>& contexts) {
+    std::unique_ptr<ScriptMessageHandler> handler(new ScriptMessageHandler());
+    handler->set_msg_id(msg_id);
+    handler->set_contexts(contexts);
+    handler->SetCallback(base::Bind(&HandleMessage));
+
+    handlers_.push_back(std::move(handler));
+    ScriptMessageHandler::ConfigurationChanged();
+  }
+
+  // The linear scan that FindScriptMessageHandler replaces
+  const ScriptMessageHandler* FindScriptMessageHandlerSlow(
+      const std::string& msg_id,
+      const GURL& context) const {
+    for (const auto& handler : handlers_) {
+      if (!handler->IsValid() || handler->msg_id() != msg_id) {
+        continue;
+      }
+      for (const auto& handler_context : handler->contexts()) {
+        if (handler_context == context) {
+          return handler.get();
+        }
+      }
+    }
+
+    return nullptr;
+  }
+
+  // ScriptMessageTarget implementation
+  size_t GetScriptMessageHandlerCount() const override {
+    return handlers_.size();
+  }
+  const ScriptMessageHandler* GetScriptMessageHandlerAt(
+      size_t index) const override {
+    return handlers_[index].get();
+  }
+
+ private:
+  std::vector<std::unique_ptr<ScriptMessageHandler>> handlers_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestScriptMessageTarget);
+};
+
+}
+
+// Compares routing lookups through the indexed table with the linear scan
+// over every handler and context that it replaced
+TEST(ScriptMessageTargetPerfTest, Lookup) {
+  const int kHandlerCount = 64;
+  const int kContextsPerHandler = 4;
+  const int kIterations = 100000;
+
+  TestScriptMessageTarget target;
+  std::vector<std::pair<std::string, GURL>> keys;
+
+  for (int i = 0; i < kHandlerCount; ++i) {
+    std::string msg_id = base::StringPrintf("MESSAGE_%d", i);
+    std::vector<GURL> contexts;
+    for (int j = 0; j < kContextsPerHandler; ++j) {
+      contexts.push_back(
+          GURL(base::StringPrintf("oxide://test/%d/%d", i, j)));
+      keys.push_back(std::make_pair(msg_id, contexts.back()));
+    }
+    target.AddHandler(msg_id, contexts);
+  }
+
+  base::ElapsedTimer slow_timer;
+  for (int i = 0; i < kIterations; ++i) {
+    const auto& key = keys[i % keys.size()];
+    ASSERT_TRUE(target.FindScriptMessageHandlerSlow(key.first, key.second));
+  }
+  base::TimeDelta slow_time = slow_timer.Elapsed();
+
+  base::ElapsedTimer fast_timer;
+  for (int i = 0; i < kIterations; ++i) {
+    const auto& key = keys[i % keys.size()];
+    ASSERT_TRUE(target.FindScriptMessageHandler(key.first, key.second));
+  }
+  base::TimeDelta fast_time = fast_timer.Elapsed();
+
+  perf_test::PrintResult(
+      "script_message_lookup", "", "linear_scan",
+      slow_time.InMicrosecondsF() * 1000 / kIterations, "ns/lookup", true);
+  perf_test::PrintResult(
+      "script_message_lookup", "", "hash_table",
+      fast_time.InMicrosecondsF() * 1000 / kIterations, "ns/lookup", true);
+}
+
+} // namespace oxide
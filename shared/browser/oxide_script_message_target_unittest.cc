@@ -0,0 +1,123 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/ptr_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+#include "shared/common/oxide_script_message_handler.h"
+
+#include "oxide_script_message_target.h"
+
+namespace oxide {
+
+namespace {
+
+bool HandleMessage(ScriptMessage* message,
+                   std::unique_ptr<base::Value>* error_payload) {
+  return true;
+}
+
+class TestScriptMessageTarget : public ScriptMessageTarget {
+ public:
+  TestScriptMessageTarget() {}
+
+  ScriptMessageHandler* AddHandler(const std::string& msg_id,
+                                   const std::vector<GURL>& contexts) {
+    std::unique_ptr<ScriptMessageHandler> handler(new ScriptMessageHandler());
+    handler->set_msg_id(msg_id);
+    handler->set_contexts(contexts);
+    handler->SetCallback(base::Bind(&HandleMessage));
+
+    handlers_.push_back(std::move(handler));
+    ScriptMessageHandler::ConfigurationChanged();
+
+    return handlers_.back().get();
+  }
+
+  void RemoveHandler(ScriptMessageHandler* handler) {
+    for (auto it = handlers_.begin(); it != handlers_.end(); ++it) {
+      if (it->get() == handler) {
+        handlers_.erase(it);
+        return;
+      }
+    }
+  }
+
+  // ScriptMessageTarget implementation
+  size_t GetScriptMessageHandlerCount() const override {
+    return handlers_.size();
+  }
+  const ScriptMessageHandler* GetScriptMessageHandlerAt(
+      size_t index) const override {
+    return handlers_[index].get();
+  }
+
+ private:
+  std::vector<std::unique_ptr<ScriptMessageHandler>> handlers_;
+};
+
+}
+
+TEST(ScriptMessageTargetTest, FindsFirstValidHandler) {
+  TestScriptMessageTarget target;
+
+  GURL context1("oxide://test/1");
+  GURL context2("oxide://test/2");
+
+  ScriptMessageHandler* invalid = target.AddHandler("TEST", {context1});
+  invalid->SetCallback(ScriptMessageHandler::HandlerCallback());
+
+  ScriptMessageHandler* first = target.AddHandler("TEST", {context1});
+  target.AddHandler("TEST", {context1, context2});
+  ScriptMessageHandler* other = target.AddHandler("OTHER", {context2});
+
+  EXPECT_EQ(first, target.FindScriptMessageHandler("TEST", context1));
+  EXPECT_EQ(target.GetScriptMessageHandlerAt(2),
+            target.FindScriptMessageHandler("TEST", context2));
+  EXPECT_EQ(other, target.FindScriptMessageHandler("OTHER", context2));
+  EXPECT_EQ(nullptr, target.FindScriptMessageHandler("OTHER", context1));
+  EXPECT_EQ(nullptr, target.FindScriptMessageHandler("FOO", context1));
+}
+
+TEST(ScriptMessageTargetTest, HandlerChangesInvalidateTable) {
+  TestScriptMessageTarget target;
+
+  GURL context1("oxide://test/1");
+  GURL context2("oxide://test/2");
+
+  ScriptMessageHandler* handler = target.AddHandler("TEST", {context1});
+  EXPECT_EQ(handler, target.FindScriptMessageHandler("TEST", context1));
+
+  handler->set_contexts({context2});
+  EXPECT_EQ(nullptr, target.FindScriptMessageHandler("TEST", context1));
+  EXPECT_EQ(handler, target.FindScriptMessageHandler("TEST", context2));
+
+  handler->set_msg_id("OTHER");
+  EXPECT_EQ(nullptr, target.FindScriptMessageHandler("TEST", context2));
+  EXPECT_EQ(handler, target.FindScriptMessageHandler("OTHER", context2));
+
+  target.RemoveHandler(handler);
+  EXPECT_EQ(nullptr, target.FindScriptMessageHandler("OTHER", context2));
+}
+
+} // namespace oxide
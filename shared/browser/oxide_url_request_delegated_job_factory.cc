@@ -27,6 +27,9 @@
 #include "net/url_request/url_request_error_job.h"
 #include "url/gurl.h"
 
+#include "shared/browser/net/oxide_packed_archive.h"
+#include "shared/browser/net/oxide_url_request_packed_archive_job.h"
+
 #include "oxide_browser_context.h"
 #include "oxide_browser_context_delegate.h"
 #include "oxide_url_request_delegated_job.h"
@@ -69,6 +72,12 @@ URLRequestDelegatedJobFactory::MaybeCreateJobWithProtocolHandler(
 
   DCHECK(CanDelegateProtocol(scheme));
 
+  scoped_refptr<PackedArchive> archive = context_->GetPackedArchive(scheme);
+  if (archive.get()) {
+    return new URLRequestPackedArchiveJob(request, network_delegate,
+                                          std::move(archive));
+  }
+
   scoped_refptr<BrowserContextDelegate> delegate(context_->GetDelegate());
   if (!delegate.get()) {
     return nullptr;
@@ -108,6 +117,10 @@ bool URLRequestDelegatedJobFactory::IsHandledProtocol(
     return false;
   }
 
+  if (context_->GetPackedArchive(scheme).get()) {
+    return true;
+  }
+
   scoped_refptr<BrowserContextDelegate> delegate(context_->GetDelegate());
   if (!delegate.get()) {
     return false;
@@ -127,6 +140,10 @@ bool URLRequestDelegatedJobFactory::IsHandledURL(const GURL& url) const {
     return false;
   }
 
+  if (context_->GetPackedArchive(scheme).get()) {
+    return true;
+  }
+
   scoped_refptr<BrowserContextDelegate> delegate(context_->GetDelegate());
   if (!delegate.get()) {
     return false;
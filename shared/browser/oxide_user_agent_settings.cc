@@ -19,6 +19,7 @@
 
 #include <libintl.h>
 
+#include "base/bind.h"
 #include "base/logging.h"
 #include "base/memory/singleton.h"
 #include "base/strings/stringprintf.h"
@@ -28,6 +29,7 @@
 #include "content/public/browser/render_process_host.h"
 #include "content/public/browser/resource_context.h"
 #include "content/public/common/user_agent.h"
+#include "net/http/http_util.h"
 
 #include "shared/common/chrome_version.h"
 #include "shared/common/oxide_messages.h"
@@ -40,6 +42,13 @@ namespace oxide {
 
 namespace {
 const char kDefaultAcceptLanguage[] = "en-us,en";
+
+// Upper bound on the number of origins for which legacy override results
+// are cached. The cache is discarded when this is reached
+const size_t kMaxLegacyUserAgentOverrideCacheSize = 256;
+
+void ReleaseSnapshot(scoped_refptr<const UserAgentSettingsSnapshot> snapshot) {}
+
 }
 
 class UserAgentSettingsFactory : public BrowserContextKeyedServiceFactory {
@@ -96,35 +105,91 @@ UserAgentSettings* UserAgentSettingsFactory::GetForContext(
       GetInstance()->GetServiceForBrowserContext(context, true));
 }
 
+UserAgentSettingsSnapshot::UserAgentSettingsSnapshot()
+    : popup_blocker_enabled(true),
+      do_not_track(false) {}
+
+UserAgentSettingsSnapshot::UserAgentSettingsSnapshot(
+    const UserAgentSettingsSnapshot& other)
+    : user_agent(other.user_agent),
+      accept_langs(other.accept_langs),
+      accept_language_header(other.accept_language_header),
+      popup_blocker_enabled(other.popup_blocker_enabled),
+      do_not_track(other.do_not_track) {}
+
+UserAgentSettingsSnapshot::~UserAgentSettingsSnapshot() {}
+
 void UserAgentSettingsIOData::SetUserAgentOverrides(
     const std::vector<UserAgentOverrideSet::Entry>& overrides) {
   user_agent_override_set_.SetOverrides(overrides);
 }
 
+scoped_refptr<UserAgentSettingsSnapshot>
+UserAgentSettingsIOData::CopySnapshot() const {
+  return make_scoped_refptr(
+      new UserAgentSettingsSnapshot(*current_snapshot_));
+}
+
+void UserAgentSettingsIOData::PublishSnapshot(
+    scoped_refptr<const UserAgentSettingsSnapshot> snapshot) {
+  scoped_refptr<const UserAgentSettingsSnapshot> old =
+      std::move(current_snapshot_);
+  current_snapshot_ = std::move(snapshot);
+  base::subtle::Release_Store(
+      &snapshot_,
+      reinterpret_cast<base::subtle::AtomicWord>(current_snapshot_.get()));
+
+  if (!old.get()) {
+    return;
+  }
+
+  // Readers on the IO thread may still be using |old| in the task that is
+  // currently running. If there's no IO thread, it's released immediately
+  content::BrowserThread::PostTask(
+      content::BrowserThread::IO,
+      FROM_HERE,
+      base::Bind(&ReleaseSnapshot, base::Passed(&old)));
+}
+
 UserAgentSettingsIOData::UserAgentSettingsIOData(BrowserContextIOData* context)
     : context_(context),
-      popup_blocker_enabled_(true),
-      do_not_track_(false) {
+      snapshot_(0),
+      legacy_user_agent_override_enabled_(false),
+      legacy_user_agent_override_generation_(0) {
+  scoped_refptr<UserAgentSettingsSnapshot> snapshot =
+      new UserAgentSettingsSnapshot();
+
   // TRANSLATORS: AcceptLanguage is a special token that should not be
   // translated as such. The expected value is a comma-separated list of
   // language codes in order of decreasing preference (e.g. "es-ES,es,en,*").
   // See https://www.w3.org/Protocols/rfc2616/rfc2616-sec14.html#sec14.4.
-  accept_langs_ = dgettext(OXIDE_GETTEXT_DOMAIN, "AcceptLanguage");
-  if (accept_langs_ == "AcceptLanguage") {
-    accept_langs_ = kDefaultAcceptLanguage;
+  snapshot->accept_langs = dgettext(OXIDE_GETTEXT_DOMAIN, "AcceptLanguage");
+  if (snapshot->accept_langs == "AcceptLanguage") {
+    snapshot->accept_langs = kDefaultAcceptLanguage;
   }
+  snapshot->accept_language_header =
+      net::HttpUtil::GenerateAcceptLanguageHeader(snapshot->accept_langs);
+
+  PublishSnapshot(std::move(snapshot));
 }
 
 UserAgentSettingsIOData::~UserAgentSettingsIOData() {}
 
-std::string UserAgentSettingsIOData::GetUserAgent() const {
-  base::AutoLock lock(lock_);
-  return user_agent_;
+const UserAgentSettingsSnapshot* UserAgentSettingsIOData::GetSnapshot() const {
+  return reinterpret_cast<const UserAgentSettingsSnapshot*>(
+      base::subtle::Acquire_Load(&snapshot_));
 }
 
-std::string UserAgentSettingsIOData::GetAcceptLangs() const {
-  base::AutoLock lock(lock_);
-  return accept_langs_;
+const std::string& UserAgentSettingsIOData::GetUserAgent() const {
+  return GetSnapshot()->user_agent;
+}
+
+const std::string& UserAgentSettingsIOData::GetAcceptLangs() const {
+  return GetSnapshot()->accept_langs;
+}
+
+const std::string& UserAgentSettingsIOData::GetAcceptLanguageHeader() const {
+  return GetSnapshot()->accept_language_header;
 }
 
 std::string UserAgentSettingsIOData::GetUserAgentForURL(const GURL& url) {
@@ -142,23 +207,45 @@ std::string UserAgentSettingsIOData::GetUserAgentOverrideForURL(
 }
 
 bool UserAgentSettingsIOData::IsPopupBlockerEnabled() const {
-  base::AutoLock lock(lock_);
-  return popup_blocker_enabled_;
+  return GetSnapshot()->popup_blocker_enabled;
 }
 
 bool UserAgentSettingsIOData::GetDoNotTrack() const {
+  return GetSnapshot()->do_not_track;
+}
+
+bool UserAgentSettingsIOData::ShouldPrefetchLegacyUserAgentOverride(
+    const GURL& origin,
+    int* generation) {
   base::AutoLock lock(lock_);
-  return do_not_track_;
+  if (!legacy_user_agent_override_enabled_) {
+    return false;
+  }
+
+  if (legacy_user_agent_override_prefetches_.size() >=
+      kMaxLegacyUserAgentOverrideCacheSize) {
+    legacy_user_agent_override_prefetches_.clear();
+  }
+
+  if (!legacy_user_agent_override_prefetches_.insert(origin).second) {
+    return false;
+  }
+
+  *generation = legacy_user_agent_override_generation_;
+  return true;
 }
 
 UserAgentSettings::UserAgentSettings(BrowserContext* context)
     : context_(context),
       product_(base::StringPrintf("Chrome/%s", CHROME_VERSION_STRING)),
       user_agent_string_is_default_(true),
-      legacy_user_agent_override_enabled_(false) {
+      legacy_user_agent_override_enabled_(false),
+      legacy_user_agent_override_generation_(0) {
   UserAgentSettingsIOData* io_data =
       context_->GetIOData()->GetUserAgentSettings();
-  io_data->user_agent_ = content::BuildUserAgentFromProduct(product_);
+  scoped_refptr<UserAgentSettingsSnapshot> snapshot = io_data->CopySnapshot();
+  snapshot->user_agent = content::BuildUserAgentFromProduct(product_);
+  io_data->PublishSnapshot(std::move(snapshot));
 }
 
 UserAgentSettings::~UserAgentSettings() {}
@@ -194,7 +281,19 @@ void UserAgentSettings::UpdateLegacyUserAgentOverrideEnabledForHost(
     content::RenderProcessHost* host) {
   host->Send(
       new OxideMsg_SetLegacyUserAgentOverrideEnabled(
-        legacy_user_agent_override_enabled_));
+        legacy_user_agent_override_enabled_,
+        legacy_user_agent_override_generation_));
+}
+
+void UserAgentSettings::UpdateLegacyUserAgentOverrideCacheForHost(
+    content::RenderProcessHost* host) {
+  for (const auto& entry : legacy_user_agent_override_cache_) {
+    host->Send(
+        new OxideMsg_CacheLegacyUserAgentOverride(
+          legacy_user_agent_override_generation_,
+          entry.first,
+          entry.second));
+  }
 }
 
 void UserAgentSettings::AddObserver(UserAgentSettingsObserver* observer) {
@@ -220,7 +319,8 @@ BrowserContextKeyedServiceFactory* UserAgentSettings::GetFactory() {
 std::string UserAgentSettings::GetUserAgent() const {
   DCHECK(CalledOnValidThread());
 
-  return context_->GetIOData()->GetUserAgentSettings()->user_agent_;
+  return context_->GetIOData()->GetUserAgentSettings()
+      ->current_snapshot_->user_agent;
 }
 
 void UserAgentSettings::SetUserAgent(const std::string& user_agent) {
@@ -229,10 +329,12 @@ void UserAgentSettings::SetUserAgent(const std::string& user_agent) {
   {
     UserAgentSettingsIOData* io_data =
         context_->GetIOData()->GetUserAgentSettings();
-    base::AutoLock lock(io_data->lock_);
-    io_data->user_agent_ = user_agent.empty() ?
+    scoped_refptr<UserAgentSettingsSnapshot> snapshot =
+        io_data->CopySnapshot();
+    snapshot->user_agent = user_agent.empty() ?
         content::BuildUserAgentFromProduct(product_) :
         user_agent;
+    io_data->PublishSnapshot(std::move(snapshot));
   }
 
   user_agent_string_is_default_ = user_agent.empty();
@@ -262,7 +364,8 @@ void UserAgentSettings::SetProduct(const std::string& product) {
 std::string UserAgentSettings::GetAcceptLangs() const {
   DCHECK(CalledOnValidThread());
 
-  return context_->GetIOData()->GetUserAgentSettings()->accept_langs_;
+  return context_->GetIOData()->GetUserAgentSettings()
+      ->current_snapshot_->accept_langs;
 }
 
 void UserAgentSettings::SetAcceptLangs(const std::string& accept_langs) {
@@ -270,8 +373,11 @@ void UserAgentSettings::SetAcceptLangs(const std::string& accept_langs) {
 
   UserAgentSettingsIOData* io_data =
       context_->GetIOData()->GetUserAgentSettings();
-  base::AutoLock lock(io_data->lock_);
-  io_data->accept_langs_ = accept_langs;
+  scoped_refptr<UserAgentSettingsSnapshot> snapshot = io_data->CopySnapshot();
+  snapshot->accept_langs = accept_langs;
+  snapshot->accept_language_header =
+      net::HttpUtil::GenerateAcceptLanguageHeader(accept_langs);
+  io_data->PublishSnapshot(std::move(snapshot));
 
   for (auto& observer : observers_) {
     observer.NotifyAcceptLanguagesChanged();
@@ -320,14 +426,25 @@ void UserAgentSettings::RenderProcessCreated(
   UpdateUserAgentForHost(process);
   UpdateUserAgentOverridesForHost(process);
   UpdateLegacyUserAgentOverrideEnabledForHost(process);
+  UpdateLegacyUserAgentOverrideCacheForHost(process);
 }
 
 void UserAgentSettings::SetLegacyUserAgentOverrideEnabled(bool enabled) {
-  if (enabled == legacy_user_agent_override_enabled_) {
-    return;
-  }
+  DCHECK(CalledOnValidThread());
 
   legacy_user_agent_override_enabled_ = enabled;
+  ++legacy_user_agent_override_generation_;
+  legacy_user_agent_override_cache_.clear();
+
+  {
+    UserAgentSettingsIOData* io_data =
+        context_->GetIOData()->GetUserAgentSettings();
+    base::AutoLock lock(io_data->lock_);
+    io_data->legacy_user_agent_override_enabled_ = enabled;
+    io_data->legacy_user_agent_override_generation_ =
+        legacy_user_agent_override_generation_;
+    io_data->legacy_user_agent_override_prefetches_.clear();
+  }
 
   std::set<content::RenderProcessHost*> hosts = GetHostSet();
   for (auto host : hosts) {
@@ -335,10 +452,37 @@ void UserAgentSettings::SetLegacyUserAgentOverrideEnabled(bool enabled) {
   }
 }
 
+void UserAgentSettings::LegacyUserAgentOverrideFetched(
+    int generation,
+    const GURL& origin,
+    const std::string& user_agent) {
+  DCHECK(CalledOnValidThread());
+
+  if (generation != legacy_user_agent_override_generation_ ||
+      !legacy_user_agent_override_enabled_) {
+    return;
+  }
+
+  if (legacy_user_agent_override_cache_.size() >=
+      kMaxLegacyUserAgentOverrideCacheSize) {
+    legacy_user_agent_override_cache_.clear();
+  }
+  legacy_user_agent_override_cache_[origin] = user_agent;
+
+  HostSet hosts = GetHostSet();
+  for (auto host : hosts) {
+    host->Send(
+        new OxideMsg_CacheLegacyUserAgentOverride(generation,
+                                                  origin,
+                                                  user_agent));
+  }
+}
+
 bool UserAgentSettings::IsPopupBlockerEnabled() const {
   DCHECK(CalledOnValidThread());
 
-  return context_->GetIOData()->GetUserAgentSettings()->popup_blocker_enabled_;
+  return context_->GetIOData()->GetUserAgentSettings()
+      ->current_snapshot_->popup_blocker_enabled;
 }
 
 void UserAgentSettings::SetIsPopupBlockerEnabled(bool enabled) {
@@ -346,8 +490,9 @@ void UserAgentSettings::SetIsPopupBlockerEnabled(bool enabled) {
 
   UserAgentSettingsIOData* io_data =
       context_->GetIOData()->GetUserAgentSettings();
-  base::AutoLock lock(io_data->lock_);
-  io_data->popup_blocker_enabled_ = enabled;
+  scoped_refptr<UserAgentSettingsSnapshot> snapshot = io_data->CopySnapshot();
+  snapshot->popup_blocker_enabled = enabled;
+  io_data->PublishSnapshot(std::move(snapshot));
 
   for (auto& observer : observers_) {
     observer.NotifyPopupBlockerEnabledChanged();
@@ -357,7 +502,8 @@ void UserAgentSettings::SetIsPopupBlockerEnabled(bool enabled) {
 bool UserAgentSettings::GetDoNotTrack() const {
   DCHECK(CalledOnValidThread());
 
-  return context_->GetIOData()->GetUserAgentSettings()->do_not_track_;
+  return context_->GetIOData()->GetUserAgentSettings()
+      ->current_snapshot_->do_not_track;
 }
 
 void UserAgentSettings::SetDoNotTrack(bool dnt) {
@@ -365,8 +511,9 @@ void UserAgentSettings::SetDoNotTrack(bool dnt) {
 
   UserAgentSettingsIOData* io_data =
       context_->GetIOData()->GetUserAgentSettings();
-  base::AutoLock lock(io_data->lock_);
-  io_data->do_not_track_ = dnt;
+  scoped_refptr<UserAgentSettingsSnapshot> snapshot = io_data->CopySnapshot();
+  snapshot->do_not_track = dnt;
+  io_data->PublishSnapshot(std::move(snapshot));
 
   for (auto& observer : observers_) {
     observer.NotifyDoNotTrackChanged();
@@ -18,16 +18,20 @@
 #ifndef _OXIDE_SHARED_BROWSER_USER_AGENT_SETTINGS_H_
 #define _OXIDE_SHARED_BROWSER_USER_AGENT_SETTINGS_H_
 
+#include <map>
 #include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/atomicops.h"
 #include "base/macros.h"
+#include "base/memory/ref_counted.h"
 #include "base/observer_list.h"
 #include "base/synchronization/lock.h"
 #include "base/threading/non_thread_safe.h"
 #include "components/keyed_service/core/keyed_service.h"
+#include "url/gurl.h"
 
 #include "shared/common/oxide_shared_export.h"
 #include "shared/common/oxide_user_agent_override_set.h"
@@ -47,6 +51,31 @@ class UserAgentSettings;
 class UserAgentSettingsFactory;
 class UserAgentSettingsObserver;
 
+// Immutable snapshot of the settings in UserAgentSettingsIOData that are
+// consulted on the IO thread for every request. A new snapshot is published
+// by UserAgentSettings whenever one of these changes
+class UserAgentSettingsSnapshot
+    : public base::RefCountedThreadSafe<UserAgentSettingsSnapshot> {
+ public:
+  UserAgentSettingsSnapshot();
+  UserAgentSettingsSnapshot(const UserAgentSettingsSnapshot& other);
+
+  std::string user_agent;
+
+  std::string accept_langs;
+
+  // The HTTP Accept-Language header generated from |accept_langs|
+  std::string accept_language_header;
+
+  bool popup_blocker_enabled;
+
+  bool do_not_track;
+
+ private:
+  friend class base::RefCountedThreadSafe<UserAgentSettingsSnapshot>;
+  ~UserAgentSettingsSnapshot();
+};
+
 // IO thread part of UserAgentSettings (see below) - accessed from
 // BrowserContextIOData
 class UserAgentSettingsIOData {
@@ -54,12 +83,20 @@ class UserAgentSettingsIOData {
   UserAgentSettingsIOData(BrowserContextIOData* context);
   ~UserAgentSettingsIOData();
 
+  // Get the current settings snapshot. This doesn't take a lock. The returned
+  // snapshot is guaranteed to remain valid until the current task on the IO
+  // thread completes - callers that need it for longer must take a reference
+  const UserAgentSettingsSnapshot* GetSnapshot() const;
+
   // Get the default user agent string
-  std::string GetUserAgent() const;
+  const std::string& GetUserAgent() const;
 
   // Get the comma-separated list of languages for the HTTP Accept-Language
   // header
-  std::string GetAcceptLangs() const;
+  const std::string& GetAcceptLangs() const;
+
+  // Get the value of the HTTP Accept-Language header
+  const std::string& GetAcceptLanguageHeader() const;
 
   // Get the user agent string for the specified |url|. If no override exists,
   // this will return the same as GetUserAgent
@@ -72,28 +109,49 @@ class UserAgentSettingsIOData {
 
   bool GetDoNotTrack() const;
 
+  // Returns true if the legacy user agent override for |origin| should be
+  // fetched from BrowserContextDelegate and pushed to renderers. This
+  // returns false if the legacy override mechanism is disabled or if |origin|
+  // has already been fetched. On success, |generation| is set to the current
+  // cache generation, which must be passed back to
+  // UserAgentSettings::LegacyUserAgentOverrideFetched
+  bool ShouldPrefetchLegacyUserAgentOverride(const GURL& origin,
+                                             int* generation);
+
  private:
   friend class UserAgentSettings;
 
   void SetUserAgentOverrides(
       const std::vector<UserAgentOverrideSet::Entry>& overrides);
 
-  BrowserContextIOData* context_;
+  // Return a mutable copy of the current snapshot. Must be called on the
+  // UI thread
+  scoped_refptr<UserAgentSettingsSnapshot> CopySnapshot() const;
 
-  // Used to protect user_agent_, accept_langs_, popup_blocker_enabled_ and
-  // do_not_track_ when being modified on the UI thread
-  mutable base::Lock lock_;
+  // Make |snapshot| visible to readers. Must be called on the UI thread.
+  // The previous snapshot is released from a task on the IO thread, which
+  // can't run until readers on that thread have finished with it
+  void PublishSnapshot(scoped_refptr<const UserAgentSettingsSnapshot> snapshot);
 
-  std::string user_agent_;
+  BrowserContextIOData* context_;
 
-  std::string accept_langs_;
+  // The snapshot returned by GetSnapshot, stored as a raw pointer so that it
+  // can be read with a single atomic load
+  base::subtle::AtomicWord snapshot_;
 
-  bool popup_blocker_enabled_;
+  // Keeps |snapshot_| alive. Only accessed on the UI thread
+  scoped_refptr<const UserAgentSettingsSnapshot> current_snapshot_;
 
-  bool do_not_track_;
+  // Used to protect the legacy override state when being modified on the
+  // UI thread
+  mutable base::Lock lock_;
 
   UserAgentOverrideSet user_agent_override_set_;
 
+  bool legacy_user_agent_override_enabled_;
+  int legacy_user_agent_override_generation_;
+  std::set<GURL> legacy_user_agent_override_prefetches_;
+
   DISALLOW_COPY_AND_ASSIGN(UserAgentSettingsIOData);
 };
 
@@ -146,10 +204,21 @@ class OXIDE_SHARED_EXPORT UserAgentSettings : public KeyedService,
   void RenderProcessCreated(content::RenderProcessHost* process);
 
   // Whether to enable the legacy user agent override mechanism, which
-  // works by proxying lookups from the renderer to BrowserContextDelegate
-  // via synchronous IPC
+  // works by proxying lookups from the renderer to BrowserContextDelegate.
+  // Results are cached per-origin in the renderer, and synchronous IPC is
+  // only used on a cache miss. Calling this discards all cached results,
+  // even if |enabled| hasn't changed, so it should also be called when the
+  // delegate that provides overrides changes
   void SetLegacyUserAgentOverrideEnabled(bool enabled);
 
+  // Called with the result of a legacy user agent override lookup for
+  // |origin| that was started at navigation start. The result is cached and
+  // pushed to all renderers, unless the cache has been invalidated since the
+  // lookup started
+  void LegacyUserAgentOverrideFetched(int generation,
+                                      const GURL& origin,
+                                      const std::string& user_agent);
+
   // Get and set whether the popup blocker is enabled
   bool IsPopupBlockerEnabled() const;
   void SetIsPopupBlockerEnabled(bool enabled);
@@ -171,6 +240,8 @@ class OXIDE_SHARED_EXPORT UserAgentSettings : public KeyedService,
   void UpdateUserAgentOverridesForHost(content::RenderProcessHost* host);
   void UpdateLegacyUserAgentOverrideEnabledForHost(
       content::RenderProcessHost* host);
+  void UpdateLegacyUserAgentOverrideCacheForHost(
+      content::RenderProcessHost* host);
 
   void AddObserver(UserAgentSettingsObserver* observer);
   void RemoveObserver(UserAgentSettingsObserver* observer);
@@ -189,6 +260,14 @@ class OXIDE_SHARED_EXPORT UserAgentSettings : public KeyedService,
 
   bool legacy_user_agent_override_enabled_;
 
+  // Incremented every time the legacy override cache is invalidated, so that
+  // results from lookups that were in flight can be discarded
+  int legacy_user_agent_override_generation_;
+
+  // Results of legacy override lookups for the current generation, keyed by
+  // origin. These are sent to new renderers
+  std::map<GURL, std::string> legacy_user_agent_override_cache_;
+
   DISALLOW_COPY_AND_ASSIGN(UserAgentSettings);
 };
 
@@ -67,6 +67,7 @@
 #include "oxide_fullscreen_helper.h"
 #include "oxide_render_widget_host_view.h"
 #include "oxide_web_contents_view_client.h"
+#include "renderer_process_pool.h"
 #include "screen.h"
 #include "web_contents_client.h"
 #include "web_popup_menu_host.h"
@@ -1143,6 +1144,7 @@ void WebContentsView::SetClient(WebContentsViewClient* client) {
   VisibilityChanged();
   FocusChanged();
   ScreenChanged();
+  TopLevelWindowChanged();
   TopLevelWindowBoundsChanged();
 
   // Update client from view
@@ -1361,6 +1363,27 @@ CompositorFrameHandle* WebContentsView::GetCompositorFrameHandle() const {
   return current_compositor_frame_.get();
 }
 
+void WebContentsView::GetRetainedCompositorFrameUsage(size_t* count,
+                                                      size_t* bytes) const {
+  *count = 0;
+  *bytes = 0;
+
+  auto add_frame = [count, bytes](CompositorFrameHandle* handle) {
+    CompositorFrameData* data = handle->data();
+    ++(*count);
+    // This is an estimate. Both GL and software frames are backed by a 32bpp
+    // buffer, but the real allocation may be larger
+    *bytes += static_cast<size_t>(data->rect_in_pixels.size().GetArea()) * 4;
+  };
+
+  if (current_compositor_frame_) {
+    add_frame(current_compositor_frame_.get());
+  }
+  for (const auto& frame : previous_compositor_frames_) {
+    add_frame(frame.get());
+  }
+}
+
 void WebContentsView::DidCommitCompositorFrame() {
   DCHECK(!compositor_ack_callbacks_.empty());
 
@@ -1410,6 +1433,7 @@ void WebContentsView::VisibilityChanged() {
 
   if (visible) {
     web_contents()->WasShown();
+    RendererProcessPool::HostWasUsed(web_contents()->GetRenderProcessHost());
   } else {
     web_contents()->WasHidden();
   }
@@ -1464,6 +1488,11 @@ void WebContentsView::ScreenChanged() {
   content::RenderWidgetHostImpl::From(rwh)->NotifyScreenInfoChanged();
 }
 
+void WebContentsView::TopLevelWindowChanged() {
+  compositor_->SetTopLevelWindowKey(
+      client_ ? client_->GetTopLevelWindowKey() : nullptr);
+}
+
 void WebContentsView::TopLevelWindowBoundsChanged() {
   if (!touch_editing_menu_controller_) {
     return;
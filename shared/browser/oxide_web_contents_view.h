@@ -139,6 +139,13 @@ class OXIDE_SHARED_EXPORT WebContentsView
   CompositorFrameHandle* GetCompositorFrameHandle() const;
   void DidCommitCompositorFrame();
 
+  // Returns the number of compositor frames retained by this view (the
+  // current frame and any frames that the toolkit hasn't released yet), and
+  // an estimate of the size of their backing buffers in bytes. The estimate
+  // assumes a 32bpp buffer of exactly the frame size, and doesn't account for
+  // allocation padding or driver overhead
+  void GetRetainedCompositorFrameUsage(size_t* count, size_t* bytes) const;
+
   using SwapCompositorFrameSubscription =
       base::CallbackList<void(const CompositorFrameData*,
                               const cc::CompositorFrameMetadata&)>::Subscription;
@@ -153,6 +160,7 @@ class OXIDE_SHARED_EXPORT WebContentsView
   void FocusChanged();
   void ScreenChanged();
   void TopLevelWindowBoundsChanged();
+  void TopLevelWindowChanged();
 
   // XXX(chrisccoulson): This will probably be removed, please don't use it
   //  See https://launchpad.net/bugs/1665722
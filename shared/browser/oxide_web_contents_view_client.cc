@@ -32,6 +32,10 @@ WebContentsViewClient::~WebContentsViewClient() {
   DCHECK(!view_);
 }
 
+const void* WebContentsViewClient::GetTopLevelWindowKey() const {
+  return nullptr;
+}
+
 void WebContentsViewClient::UpdateCursor(const content::WebCursor& cursor) {}
 
 std::unique_ptr<WebPopupMenu> WebContentsViewClient::CreatePopupMenu(
@@ -65,6 +65,11 @@ class OXIDE_SHARED_EXPORT WebContentsViewClient {
   // The top-level window's bounds in screen coordinates
   virtual gfx::Rect GetTopLevelWindowBounds() const = 0;
 
+  // An opaque key identifying the top-level window, or null if the view isn't
+  // in a window. This is used to synchronize compositing with the window
+  // (see CompositorFrameClock)
+  virtual const void* GetTopLevelWindowKey() const;
+
   virtual void SwapCompositorFrame() = 0;
   virtual void EvictCurrentFrame() = 0;
 
@@ -105,9 +105,8 @@ WebFrame::~WebFrame() {
   RemoveMappingForRenderFrameHost(render_frame_host_);
   frame_tree_->WebFrameRemoved(this);
 
-  for (auto it = current_script_message_requests_.begin();
-       it != current_script_message_requests_.end(); ++it) {
-    ScriptMessageRequestImplBrowser* request = *it;
+  for (const auto& entry : current_script_message_requests_) {
+    ScriptMessageRequestImplBrowser* request = entry.second;
     if (!request) {
       continue;
     }
@@ -197,7 +196,7 @@ std::unique_ptr<ScriptMessageRequestImplBrowser> WebFrame::SendMessage(
     return nullptr;
   }
 
-  current_script_message_requests_.push_back(request.get());
+  current_script_message_requests_[request->serial()] = request.get();
 
   return std::move(request);
 }
@@ -220,19 +219,27 @@ bool WebFrame::SendMessageNoReply(const GURL& context,
       new OxideMsg_SendMessage(render_frame_host_->GetRoutingID(), params));
 }
 
+ScriptMessageRequestImplBrowser* WebFrame::FindScriptMessageRequest(
+    int serial) const {
+  auto it = current_script_message_requests_.find(serial);
+  if (it == current_script_message_requests_.end()) {
+    return nullptr;
+  }
+
+  return it->second;
+}
+
 void WebFrame::RemoveScriptMessageRequest(
     ScriptMessageRequestImplBrowser* req) {
-  ScriptMessageRequestVector::iterator it =
-      std::find(current_script_message_requests_.begin(),
-                current_script_message_requests_.end(),
-                req);
+  auto it = current_script_message_requests_.find(req->serial());
   DCHECK(it != current_script_message_requests_.end());
+  DCHECK_EQ(it->second, req);
 
   if (!destroying_) {
     current_script_message_requests_.erase(it);
   } else {
-    // Don't mutate the vector if we're in the destructor
-    *it = nullptr;
+    // Don't mutate the map if we're in the destructor
+    it->second = nullptr;
   }
 }
 
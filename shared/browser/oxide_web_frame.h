@@ -19,6 +19,7 @@
 #define _OXIDE_SHARED_BROWSER_WEB_FRAME_H_
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "base/macros.h"
@@ -49,8 +50,6 @@ class WebView;
 class OXIDE_SHARED_EXPORT WebFrame : public ScriptMessageTarget {
  public:
   typedef std::vector<WebFrame*> ChildVector;
-  typedef std::vector<ScriptMessageRequestImplBrowser*>
-      ScriptMessageRequestVector;
 
   WebFrame(WebFrameTree* tree, content::RenderFrameHost* render_frame_host);
 
@@ -104,10 +103,9 @@ class OXIDE_SHARED_EXPORT WebFrame : public ScriptMessageTarget {
                           const std::string& msg_id,
                           std::unique_ptr<base::Value> value);
 
-  // Return the pending ScriptMessageRequests for this frame
-  const ScriptMessageRequestVector& current_script_message_requests() const {
-    return current_script_message_requests_;
-  }
+  // Return the pending ScriptMessageRequest for this frame with |serial|, or
+  // null if there isn't one
+  ScriptMessageRequestImplBrowser* FindScriptMessageRequest(int serial) const;
 
   // Remove |req| from the list of pending ScriptMessageRequests for this frame
   void RemoveScriptMessageRequest(ScriptMessageRequestImplBrowser* req);
@@ -133,8 +131,10 @@ class OXIDE_SHARED_EXPORT WebFrame : public ScriptMessageTarget {
   WebFrame* parent_;
   ChildVector child_frames_;
 
+  // The pending ScriptMessageRequests for this frame, keyed by serial
   // XXX(chrisccoulson): This should be on another object keyed off RFH
-  ScriptMessageRequestVector current_script_message_requests_;
+  std::unordered_map<int, ScriptMessageRequestImplBrowser*>
+      current_script_message_requests_;
 
   // The message serial that will be used for the next outgoing script message
   int next_message_serial_;
@@ -91,6 +91,7 @@
 #include "oxide_web_frame_tree.h"
 #include "oxide_web_frame.h"
 #include "oxide_web_view_client.h"
+#include "spare_renderer_manager.h"
 #include "web_contents_client.h"
 #include "web_contents_helper.h"
 #include "web_process_status_monitor.h"
@@ -846,6 +847,8 @@ WebView::WebView(const CommonParams& common_params,
   content_params.initial_size =
       gfx::ToEnclosingRect(common_params.view_client->GetBounds()).size();
   content_params.initially_hidden = !common_params.view_client->IsVisible();
+  content_params.site_instance =
+      SpareRendererManager::Get(context)->TakeSpareSiteInstance();
 
   WebContentsUniquePtr contents =
       WebContentsHelper::CreateWebContents(content_params);
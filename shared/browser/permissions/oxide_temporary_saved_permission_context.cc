@@ -17,53 +17,678 @@
 
 #include "oxide_temporary_saved_permission_context.h"
 
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "base/atomicops.h"
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/values.h"
+#include "content/public/browser/browser_thread.h"
+
 namespace oxide {
 
-TemporarySavedPermissionContext::TemporarySavedPermissionContext() {}
+namespace {
+
+// Changes are written to disk at most once per this interval
+const int kCommitIntervalSeconds = 2;
+
+const int kCurrentVersion = 1;
+
+const char kVersionKey[] = "version";
+const char kPermissionsKey[] = "permissions";
+const char kTypeKey[] = "type";
+const char kPrimaryKey[] = "primary";
+const char kSecondaryKey[] = "secondary";
+const char kStatusKey[] = "status";
+const char kExpiresKey[] = "expires";
+
+// These are used in the on-disk format, so must not be changed
+const char* const kTypeNames[] = {
+  "geolocation",
+  "media-device-mic",
+  "media-device-camera",
+  "notifications"
+};
+
+static_assert(arraysize(kTypeNames) == NUM_PERMISSION_TYPES,
+              "kTypeNames must have an entry for every permission type");
+
+const char kStatusAllowed[] = "allowed";
+const char kStatusDenied[] = "denied";
+
+bool TypeFromName(const std::string& name,
+                  TemporarySavedPermissionType* type) {
+  for (int i = PERMISSION_TYPES_START; i < NUM_PERMISSION_TYPES; ++i) {
+    if (name == kTypeNames[i]) {
+      *type = static_cast<TemporarySavedPermissionType>(i);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// Decisions are keyed on origins rather than full URLs, so that lookups
+// don't depend on the path or query of the requesting page
+std::string NormalizeURL(const GURL& url) {
+  return url.GetOrigin().spec();
+}
+
+}
+
+class TemporarySavedPermissionContext::Core
+    : public base::RefCountedThreadSafe<Core> {
+ public:
+  Core();
+
+  void EnablePersistence(
+      const base::FilePath& path,
+      scoped_refptr<base::SequencedTaskRunner> file_task_runner);
+  void Flush();
+
+  void SetDecisionLifetime(base::TimeDelta lifetime);
+
+  TemporarySavedPermissionStatus GetPermissionStatus(
+      TemporarySavedPermissionType type,
+      const GURL& primary_url,
+      const GURL& secondary_url);
+
+  void SetPermissionStatus(TemporarySavedPermissionType type,
+                           const GURL& primary_url,
+                           const GURL& secondary_url,
+                           TemporarySavedPermissionStatus status);
+
+  void ClearForType(TemporarySavedPermissionType type);
+  void ClearForOrigin(const GURL& origin);
+  void Clear();
+
+ private:
+  friend class base::RefCountedThreadSafe<Core>;
+  ~Core();
+
+  typedef std::pair<std::string, std::string> Key;
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      std::hash<std::string> hasher;
+      return hasher(key.first) * 31 + hasher(key.second);
+    }
+  };
+
+  struct Entry {
+    TemporarySavedPermissionStatus status;
+    base::Time expiry;
 
-TemporarySavedPermissionContext::~TemporarySavedPermissionContext() {}
+    bool HasExpired(base::Time now) const {
+      return !expiry.is_null() && expiry <= now;
+    }
+  };
+
+  typedef std::unordered_map<Key, Entry, KeyHash> Map;
+  typedef std::unordered_set<Key, KeyHash> KeySet;
+
+  // An immutable set of decisions. Lookups read the current snapshot without
+  // taking |lock_|, and changes are made by publishing a modified copy
+  struct Snapshot : public base::RefCountedThreadSafe<Snapshot> {
+    Map maps[NUM_PERMISSION_TYPES];
+
+   private:
+    friend class base::RefCountedThreadSafe<Snapshot>;
+    ~Snapshot() {}
+  };
+
+  static void ReleaseSnapshotOnIOThread(
+      scoped_refptr<const Snapshot> snapshot);
+  static void ReleaseSnapshotOnUIThread(
+      scoped_refptr<const Snapshot> snapshot);
+
+  const Snapshot* GetSnapshot() const;
+
+  // Return a mutable copy of the current snapshot, without any expired
+  // decisions. Must be called with |lock_| held
+  scoped_refptr<Snapshot> CopySnapshotLocked() const;
+
+  // Make |snapshot| visible to readers. Must be called with |lock_| held
+  void PublishSnapshotLocked(scoped_refptr<const Snapshot> snapshot);
+
+  // Whether persistence is enabled and the data on disk hasn't been loaded
+  // yet. Must be called with |lock_| held
+  bool IsLoadPendingLocked() const;
+
+  // Schedules a write to disk. Must be called with |lock_| held
+  void ScheduleCommitLocked();
+
+  // These run on |file_task_runner_|
+  void Load(const base::FilePath& path);
+  void Commit();
+
+  static std::unique_ptr<base::DictionaryValue> Serialize(
+      const Snapshot& snapshot);
+  void MergeLoadedDataLocked(const base::DictionaryValue& data);
+
+  // The snapshot returned by GetSnapshot, stored as a raw pointer so that it
+  // can be read with a single atomic load
+  base::subtle::AtomicWord snapshot_;
+
+  // Protects everything below. It's only taken when decisions are changed,
+  // loaded or written to disk
+  mutable base::Lock lock_;
+
+  // Keeps |snapshot_| alive. This is shared with Commit(), which serializes
+  // it without holding |lock_|
+  scoped_refptr<const Snapshot> current_snapshot_;
+
+  // How long new decisions are remembered for. Zero means that they don't
+  // expire
+  base::TimeDelta lifetime_;
+
+  // Resets and clears that happened before loading completed, which need to
+  // be applied to the loaded data
+  KeySet keys_reset_before_load_[NUM_PERMISSION_TYPES];
+  bool types_cleared_before_load_[NUM_PERMISSION_TYPES];
+  std::set<std::string> origins_cleared_before_load_;
+
+  // Only set when persistence is enabled
+  base::FilePath path_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  bool loaded_;
+  bool commit_pending_;
+
+  DISALLOW_COPY_AND_ASSIGN(Core);
+};
+
+// static
+void TemporarySavedPermissionContext::Core::ReleaseSnapshotOnIOThread(
+    scoped_refptr<const Snapshot> snapshot) {}
+
+// static
+void TemporarySavedPermissionContext::Core::ReleaseSnapshotOnUIThread(
+    scoped_refptr<const Snapshot> snapshot) {
+  // Readers that were running on the UI thread when |snapshot| was replaced
+  // have finished with it now. Readers on the IO thread are done once the
+  // task that is currently running there has completed. If there's no IO
+  // thread, |snapshot| is released immediately
+  content::BrowserThread::PostTask(
+      content::BrowserThread::IO,
+      FROM_HERE,
+      base::Bind(&ReleaseSnapshotOnIOThread, base::Passed(&snapshot)));
+}
+
+TemporarySavedPermissionContext::Core::Core()
+    : snapshot_(0),
+      loaded_(false),
+      commit_pending_(false) {
+  for (int i = PERMISSION_TYPES_START; i < NUM_PERMISSION_TYPES; ++i) {
+    types_cleared_before_load_[i] = false;
+  }
+
+  base::AutoLock lock(lock_);
+  PublishSnapshotLocked(make_scoped_refptr(new Snapshot()));
+}
+
+TemporarySavedPermissionContext::Core::~Core() {}
+
+const TemporarySavedPermissionContext::Core::Snapshot*
+TemporarySavedPermissionContext::Core::GetSnapshot() const {
+  return reinterpret_cast<const Snapshot*>(
+      base::subtle::Acquire_Load(&snapshot_));
+}
+
+scoped_refptr<TemporarySavedPermissionContext::Core::Snapshot>
+TemporarySavedPermissionContext::Core::CopySnapshotLocked() const {
+  lock_.AssertAcquired();
+
+  base::Time now = base::Time::Now();
+
+  scoped_refptr<Snapshot> snapshot = new Snapshot();
+  for (int i = PERMISSION_TYPES_START; i < NUM_PERMISSION_TYPES; ++i) {
+    for (const auto& it : current_snapshot_->maps[i]) {
+      if (!it.second.HasExpired(now)) {
+        snapshot->maps[i].insert(it);
+      }
+    }
+  }
+
+  return snapshot;
+}
+
+void TemporarySavedPermissionContext::Core::PublishSnapshotLocked(
+    scoped_refptr<const Snapshot> snapshot) {
+  lock_.AssertAcquired();
+
+  scoped_refptr<const Snapshot> old = std::move(current_snapshot_);
+  current_snapshot_ = std::move(snapshot);
+  base::subtle::Release_Store(
+      &snapshot_,
+      reinterpret_cast<base::subtle::AtomicWord>(current_snapshot_.get()));
+
+  if (!old.get()) {
+    return;
+  }
+
+  // Lookups happen on the UI and IO threads, and may still be using |old|
+  // in the task that is currently running on either of them. If there's no
+  // UI thread, |old| is released immediately
+  content::BrowserThread::PostTask(
+      content::BrowserThread::UI,
+      FROM_HERE,
+      base::Bind(&ReleaseSnapshotOnUIThread, base::Passed(&old)));
+}
+
+bool TemporarySavedPermissionContext::Core::IsLoadPendingLocked() const {
+  lock_.AssertAcquired();
+  return file_task_runner_ && !loaded_;
+}
+
+void TemporarySavedPermissionContext::Core::ScheduleCommitLocked() {
+  lock_.AssertAcquired();
+
+  if (!file_task_runner_ || commit_pending_) {
+    return;
+  }
+
+  commit_pending_ = true;
+  file_task_runner_->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&Core::Commit, this),
+      base::TimeDelta::FromSeconds(kCommitIntervalSeconds));
+}
+
+void TemporarySavedPermissionContext::Core::Load(const base::FilePath& path) {
+  DCHECK(file_task_runner_->RunsTasksOnCurrentThread());
+
+  std::string contents;
+  std::unique_ptr<base::Value> value;
+  if (base::ReadFileToString(path, &contents)) {
+    value = base::JSONReader::Read(contents);
+  }
+
+  base::AutoLock lock(lock_);
+  loaded_ = true;
+
+  base::DictionaryValue* data = nullptr;
+  if (value && value->GetAsDictionary(&data)) {
+    MergeLoadedDataLocked(*data);
+  }
+
+  for (int i = PERMISSION_TYPES_START; i < NUM_PERMISSION_TYPES; ++i) {
+    keys_reset_before_load_[i].clear();
+    types_cleared_before_load_[i] = false;
+  }
+  origins_cleared_before_load_.clear();
+}
+
+void TemporarySavedPermissionContext::Core::MergeLoadedDataLocked(
+    const base::DictionaryValue& data) {
+  lock_.AssertAcquired();
+
+  int version = 0;
+  if (!data.GetInteger(kVersionKey, &version) || version != kCurrentVersion) {
+    return;
+  }
+
+  const base::ListValue* permissions = nullptr;
+  if (!data.GetList(kPermissionsKey, &permissions)) {
+    return;
+  }
+
+  base::Time now = base::Time::Now();
+  bool dropped_expired = false;
+
+  scoped_refptr<Snapshot> snapshot = CopySnapshotLocked();
+
+  for (const auto& value : *permissions) {
+    const base::DictionaryValue* entry = nullptr;
+    if (!value->GetAsDictionary(&entry)) {
+      continue;
+    }
+
+    std::string type_name;
+    std::string primary;
+    std::string secondary;
+    std::string status;
+    if (!entry->GetString(kTypeKey, &type_name) ||
+        !entry->GetString(kPrimaryKey, &primary) ||
+        !entry->GetString(kSecondaryKey, &secondary) ||
+        !entry->GetString(kStatusKey, &status)) {
+      continue;
+    }
+
+    TemporarySavedPermissionType type;
+    if (!TypeFromName(type_name, &type)) {
+      continue;
+    }
+
+    Entry e;
+    if (status == kStatusAllowed) {
+      e.status = TEMPORARY_SAVED_PERMISSION_STATUS_ALLOWED;
+    } else if (status == kStatusDenied) {
+      e.status = TEMPORARY_SAVED_PERMISSION_STATUS_DENIED;
+    } else {
+      continue;
+    }
+
+    std::string expires;
+    int64_t expires_internal = 0;
+    if (entry->GetString(kExpiresKey, &expires) &&
+        base::StringToInt64(expires, &expires_internal)) {
+      e.expiry = base::Time::FromInternalValue(expires_internal);
+    }
+
+    if (e.HasExpired(now)) {
+      dropped_expired = true;
+      continue;
+    }
+
+    Key key(primary, secondary);
+    if (types_cleared_before_load_[type] ||
+        keys_reset_before_load_[type].count(key) > 0 ||
+        origins_cleared_before_load_.count(primary) > 0 ||
+        origins_cleared_before_load_.count(secondary) > 0) {
+      continue;
+    }
+
+    // Don't overwrite decisions made since startup
+    snapshot->maps[type].insert(std::make_pair(key, e));
+  }
+
+  PublishSnapshotLocked(std::move(snapshot));
+
+  if (dropped_expired) {
+    ScheduleCommitLocked();
+  }
+}
+
+// static
+std::unique_ptr<base::DictionaryValue>
+TemporarySavedPermissionContext::Core::Serialize(const Snapshot& snapshot) {
+  base::Time now = base::Time::Now();
+
+  std::unique_ptr<base::ListValue> permissions(new base::ListValue());
+
+  for (int i = PERMISSION_TYPES_START; i < NUM_PERMISSION_TYPES; ++i) {
+    for (const auto& it : snapshot.maps[i]) {
+      if (it.second.HasExpired(now)) {
+        continue;
+      }
+
+      std::unique_ptr<base::DictionaryValue> entry(
+          new base::DictionaryValue());
+      entry->SetString(kTypeKey, kTypeNames[i]);
+      entry->SetString(kPrimaryKey, it.first.first);
+      entry->SetString(kSecondaryKey, it.first.second);
+      entry->SetString(
+          kStatusKey,
+          it.second.status == TEMPORARY_SAVED_PERMISSION_STATUS_ALLOWED ?
+              kStatusAllowed : kStatusDenied);
+      if (!it.second.expiry.is_null()) {
+        entry->SetString(
+            kExpiresKey,
+            base::Int64ToString(it.second.expiry.ToInternalValue()));
+      }
+      permissions->Append(std::move(entry));
+    }
+  }
+
+  std::unique_ptr<base::DictionaryValue> data(new base::DictionaryValue());
+  data->SetInteger(kVersionKey, kCurrentVersion);
+  data->Set(kPermissionsKey, std::move(permissions));
+
+  return data;
+}
+
+void TemporarySavedPermissionContext::Core::Commit() {
+  DCHECK(file_task_runner_->RunsTasksOnCurrentThread());
+
+  scoped_refptr<const Snapshot> snapshot;
+  {
+    base::AutoLock lock(lock_);
+    if (!commit_pending_) {
+      // Flush() got here first
+      return;
+    }
+    commit_pending_ = false;
+
+    if (!loaded_) {
+      // Load() is always posted before any commit, so this shouldn't happen
+      NOTREACHED();
+      return;
+    }
+
+    snapshot = current_snapshot_;
+  }
+
+  std::unique_ptr<base::DictionaryValue> data = Serialize(*snapshot);
+
+  std::string output;
+  if (!base::JSONWriter::Write(*data, &output)) {
+    LOG(ERROR) << "Failed to serialize saved permissions";
+    return;
+  }
+
+  if (!base::ImportantFileWriter::WriteFileAtomically(path_, output)) {
+    LOG(ERROR) << "Failed to write saved permissions to " << path_.value();
+  }
+}
+
+void TemporarySavedPermissionContext::Core::EnablePersistence(
+    const base::FilePath& path,
+    scoped_refptr<base::SequencedTaskRunner> file_task_runner) {
+  DCHECK(!path.empty());
+  DCHECK(file_task_runner);
+
+  base::AutoLock lock(lock_);
+  DCHECK(!file_task_runner_) << "Persistence is already enabled";
+
+  path_ = path;
+  file_task_runner_ = file_task_runner;
+
+  file_task_runner_->PostTask(FROM_HERE,
+                              base::Bind(&Core::Load, this, path));
+
+  bool has_entries = false;
+  for (int i = PERMISSION_TYPES_START; i < NUM_PERMISSION_TYPES; ++i) {
+    has_entries |= !current_snapshot_->maps[i].empty();
+  }
+  if (has_entries) {
+    ScheduleCommitLocked();
+  }
+}
+
+void TemporarySavedPermissionContext::Core::Flush() {
+  base::AutoLock lock(lock_);
+  if (!commit_pending_) {
+    return;
+  }
+
+  file_task_runner_->PostTask(FROM_HERE, base::Bind(&Core::Commit, this));
+}
+
+void TemporarySavedPermissionContext::Core::SetDecisionLifetime(
+    base::TimeDelta lifetime) {
+  DCHECK_GE(lifetime, base::TimeDelta());
+
+  base::AutoLock lock(lock_);
+  lifetime_ = lifetime;
+}
 
 TemporarySavedPermissionStatus
-TemporarySavedPermissionContext::GetPermissionStatus(
+TemporarySavedPermissionContext::Core::GetPermissionStatus(
     TemporarySavedPermissionType type,
     const GURL& primary_url,
     const GURL& secondary_url) {
-  Key key = std::make_pair(primary_url, secondary_url);
+  Key key(NormalizeURL(primary_url), NormalizeURL(secondary_url));
 
-  base::AutoLock lock(lock_);
-
-  Map& map = maps_[type];
-  const auto& it = map.find(key);
-  if (it == map.end()) {
+  // Expired decisions are left in place here, as removing them would
+  // require taking |lock_|. They're dropped the next time that a snapshot
+  // is copied, and they aren't written to disk
+  const Map& map = GetSnapshot()->maps[type];
+  auto it = map.find(key);
+  if (it == map.end() || it->second.HasExpired(base::Time::Now())) {
     return TEMPORARY_SAVED_PERMISSION_STATUS_ASK;
   }
 
-  return it->second;
+  return it->second.status;
 }
 
-void TemporarySavedPermissionContext::SetPermissionStatus(
+void TemporarySavedPermissionContext::Core::SetPermissionStatus(
     TemporarySavedPermissionType type,
     const GURL& primary_url,
     const GURL& secondary_url,
     TemporarySavedPermissionStatus status) {
-  Key key = std::make_pair(primary_url, secondary_url);
+  Key key(NormalizeURL(primary_url), NormalizeURL(secondary_url));
 
   base::AutoLock lock(lock_);
 
-  Map& map = maps_[type];
-  if (status == TEMPORARY_SAVED_PERMISSION_STATUS_ASK) {
-    map.erase(key);
+  if (IsLoadPendingLocked()) {
+    // Make sure that a decision loaded from disk doesn't override this one.
+    // Allow and deny are handled by not overwriting existing entries when
+    // merging the loaded data
+    if (status == TEMPORARY_SAVED_PERMISSION_STATUS_ASK) {
+      keys_reset_before_load_[type].insert(key);
+    } else {
+      keys_reset_before_load_[type].erase(key);
+    }
+  }
+
+  if (status == TEMPORARY_SAVED_PERMISSION_STATUS_ASK &&
+      current_snapshot_->maps[type].count(key) == 0) {
     return;
   }
 
-  map[key] = status;
+  scoped_refptr<Snapshot> snapshot = CopySnapshotLocked();
+
+  if (status == TEMPORARY_SAVED_PERMISSION_STATUS_ASK) {
+    snapshot->maps[type].erase(key);
+  } else {
+    Entry& entry = snapshot->maps[type][key];
+    entry.status = status;
+    entry.expiry = lifetime_.is_zero() ?
+        base::Time() : base::Time::Now() + lifetime_;
+  }
+
+  PublishSnapshotLocked(std::move(snapshot));
+  ScheduleCommitLocked();
 }
 
-void TemporarySavedPermissionContext::Clear() {
+void TemporarySavedPermissionContext::Core::ClearForType(
+    TemporarySavedPermissionType type) {
+  base::AutoLock lock(lock_);
+
+  if (IsLoadPendingLocked()) {
+    types_cleared_before_load_[type] = true;
+  }
+
+  scoped_refptr<Snapshot> snapshot = CopySnapshotLocked();
+  snapshot->maps[type].clear();
+
+  PublishSnapshotLocked(std::move(snapshot));
+  ScheduleCommitLocked();
+}
+
+void TemporarySavedPermissionContext::Core::ClearForOrigin(
+    const GURL& origin) {
+  std::string normalized = NormalizeURL(origin);
+
   base::AutoLock lock(lock_);
+
+  if (IsLoadPendingLocked()) {
+    origins_cleared_before_load_.insert(normalized);
+  }
+
+  scoped_refptr<Snapshot> snapshot = CopySnapshotLocked();
   for (int i = PERMISSION_TYPES_START; i < NUM_PERMISSION_TYPES; ++i) {
-    maps_[i].clear();
+    Map& map = snapshot->maps[i];
+    for (auto it = map.begin(); it != map.end();) {
+      if (it->first.first == normalized || it->first.second == normalized) {
+        it = map.erase(it);
+      } else {
+        ++it;
+      }
+    }
   }
+
+  PublishSnapshotLocked(std::move(snapshot));
+  ScheduleCommitLocked();
+}
+
+void TemporarySavedPermissionContext::Core::Clear() {
+  base::AutoLock lock(lock_);
+
+  if (IsLoadPendingLocked()) {
+    for (int i = PERMISSION_TYPES_START; i < NUM_PERMISSION_TYPES; ++i) {
+      types_cleared_before_load_[i] = true;
+    }
+  }
+
+  PublishSnapshotLocked(make_scoped_refptr(new Snapshot()));
+  ScheduleCommitLocked();
+}
+
+TemporarySavedPermissionContext::TemporarySavedPermissionContext()
+    : core_(new Core()) {}
+
+TemporarySavedPermissionContext::~TemporarySavedPermissionContext() {
+  // |core_| is kept alive by the task until the write has completed
+  core_->Flush();
+}
+
+void TemporarySavedPermissionContext::EnablePersistence(
+    const base::FilePath& path,
+    scoped_refptr<base::SequencedTaskRunner> file_task_runner) {
+  core_->EnablePersistence(path, file_task_runner);
+}
+
+void TemporarySavedPermissionContext::Flush() {
+  core_->Flush();
+}
+
+void TemporarySavedPermissionContext::SetDecisionLifetime(
+    base::TimeDelta lifetime) {
+  core_->SetDecisionLifetime(lifetime);
+}
+
+TemporarySavedPermissionStatus
+TemporarySavedPermissionContext::GetPermissionStatus(
+    TemporarySavedPermissionType type,
+    const GURL& primary_url,
+    const GURL& secondary_url) {
+  return core_->GetPermissionStatus(type, primary_url, secondary_url);
+}
+
+void TemporarySavedPermissionContext::SetPermissionStatus(
+    TemporarySavedPermissionType type,
+    const GURL& primary_url,
+    const GURL& secondary_url,
+    TemporarySavedPermissionStatus status) {
+  core_->SetPermissionStatus(type, primary_url, secondary_url, status);
+}
+
+void TemporarySavedPermissionContext::ClearForType(
+    TemporarySavedPermissionType type) {
+  core_->ClearForType(type);
+}
+
+void TemporarySavedPermissionContext::ClearForOrigin(const GURL& origin) {
+  core_->ClearForOrigin(origin);
+}
+
+void TemporarySavedPermissionContext::Clear() {
+  core_->Clear();
 }
 
 } // namespace oxide
@@ -18,17 +18,16 @@
 #ifndef _OXIDE_SHARED_BROWSER_PERMISSIONS_TEMPORARY_SAVED_PERMISSION_CONTEXT_H_
 #define _OXIDE_SHARED_BROWSER_PERMISSIONS_TEMPORARY_SAVED_PERMISSION_CONTEXT_H_
 
-#include <map>
-#include <utility>
-
 #include "base/macros.h"
-#include "base/synchronization/lock.h"
+#include "base/memory/ref_counted.h"
+#include "base/time/time.h"
 #include "url/gurl.h"
 
 #include "shared/common/oxide_shared_export.h"
 
-namespace content {
-class BrowserContext;
+namespace base {
+class FilePath;
+class SequencedTaskRunner;
 }
 
 namespace oxide {
@@ -51,18 +50,42 @@ enum TemporarySavedPermissionType {
 };
 
 // This is a per-BrowserContext object for storing permission request
-// decisions for the rest of a browsing session.
-// XXX: This class is only here temporarily (hence the name
-//  "TemporarySavedPermissionContext") and will be removed in favour of content
-//  settings in the future, which will be used for permanent and session
-//  persistence of permission request decisions (as well as other stuff).
-//  Please don't add new features to this class, other than expanding
-//  TemporarySavedPermissionType
+// decisions. Decisions are keyed on the origins of the primary and secondary
+// URLs. By default, decisions only last for the rest of a browsing session.
+// If the embedder opts in (see BrowserContext::Params::persistent_permissions),
+// EnablePersistence() is called and decisions are also written to disk and
+// loaded asynchronously the next time the BrowserContext is created.
+// Lookups can be made from the UI and IO threads, and never block on
+// changes made from another thread.
+// XXX: This class will be removed in favour of content settings in the future
+//  (hence the name "TemporarySavedPermissionContext"). Expiry and optional
+//  persistence were added as a stop-gap until then, because content settings
+//  aren't available to us yet. Please don't add any other features to this
+//  class, other than expanding TemporarySavedPermissionType
 class OXIDE_SHARED_EXPORT TemporarySavedPermissionContext {
  public:
   TemporarySavedPermissionContext();
   ~TemporarySavedPermissionContext();
 
+  // Load decisions from |path| and save future changes back to it. File IO
+  // is performed on |file_task_runner|. Decisions set, reset or cleared
+  // after this is called but before loading has completed take precedence
+  // over those loaded from disk. This should be called before the context
+  // is used
+  void EnablePersistence(
+      const base::FilePath& path,
+      scoped_refptr<base::SequencedTaskRunner> file_task_runner);
+
+  // Start writing any pending changes to disk immediately, rather than
+  // waiting for the next scheduled write. This is also done automatically
+  // when this object is destroyed
+  void Flush();
+
+  // Decisions saved after this is called are forgotten after |lifetime|.
+  // Zero means that decisions are kept until they are cleared, which is the
+  // default
+  void SetDecisionLifetime(base::TimeDelta lifetime);
+
   TemporarySavedPermissionStatus GetPermissionStatus(
       TemporarySavedPermissionType type,
       const GURL& primary_url,
@@ -73,15 +96,18 @@ class OXIDE_SHARED_EXPORT TemporarySavedPermissionContext {
                            const GURL& secondary_url,
                            TemporarySavedPermissionStatus status);
 
-  void Clear();
+  // Clear all decisions for |type|
+  void ClearForType(TemporarySavedPermissionType type);
 
- private:
-  base::Lock lock_;
+  // Clear all decisions where |origin| is either the primary or secondary
+  // origin
+  void ClearForOrigin(const GURL& origin);
 
-  typedef std::pair<GURL, GURL> Key;
-  typedef std::map<Key, TemporarySavedPermissionStatus> Map;
+  void Clear();
 
-  Map maps_[NUM_PERMISSION_TYPES];
+ private:
+  class Core;
+  scoped_refptr<Core> core_;
 
   DISALLOW_COPY_AND_ASSIGN(TemporarySavedPermissionContext);
 };
@@ -0,0 +1,256 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <memory>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/ptr_util.h"
+#include "base/test/test_simple_task_runner.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+#include "oxide_temporary_saved_permission_context.h"
+
+namespace oxide {
+
+class TemporarySavedPermissionContextTest : public testing::Test {
+ public:
+  TemporarySavedPermissionContextTest() = default;
+
+ protected:
+  TemporarySavedPermissionContext* context() const { return context_.get(); }
+
+  void ResetContext() {
+    context_ = base::MakeUnique<TemporarySavedPermissionContext>();
+  }
+
+ private:
+  void SetUp() override { ResetContext(); }
+
+  std::unique_ptr<TemporarySavedPermissionContext> context_;
+};
+
+TEST_F(TemporarySavedPermissionContextTest, KeyedOnOrigin) {
+  context()->SetPermissionStatus(
+      TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION,
+      GURL("https://www.google.com/foo?bar"),
+      GURL("https://www.example.com/baz"),
+      TEMPORARY_SAVED_PERMISSION_STATUS_ALLOWED);
+
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_ALLOWED,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION,
+                GURL("https://www.google.com/"),
+                GURL("https://www.example.com/")));
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_ASK,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION,
+                GURL("http://www.google.com/"),
+                GURL("https://www.example.com/")));
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_ASK,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_NOTIFICATIONS,
+                GURL("https://www.google.com/"),
+                GURL("https://www.example.com/")));
+
+  context()->SetPermissionStatus(
+      TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION,
+      GURL("https://www.google.com/"),
+      GURL("https://www.example.com/"),
+      TEMPORARY_SAVED_PERMISSION_STATUS_ASK);
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_ASK,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION,
+                GURL("https://www.google.com/"),
+                GURL("https://www.example.com/")));
+}
+
+TEST_F(TemporarySavedPermissionContextTest, Expiry) {
+  context()->SetDecisionLifetime(base::TimeDelta::FromDays(1));
+  context()->SetPermissionStatus(
+      TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION,
+      GURL("https://www.google.com/"),
+      GURL("https://www.google.com/"),
+      TEMPORARY_SAVED_PERMISSION_STATUS_DENIED);
+
+  context()->SetDecisionLifetime(base::TimeDelta::FromMilliseconds(1));
+  context()->SetPermissionStatus(
+      TEMPORARY_SAVED_PERMISSION_TYPE_NOTIFICATIONS,
+      GURL("https://www.google.com/"),
+      GURL("https://www.google.com/"),
+      TEMPORARY_SAVED_PERMISSION_STATUS_DENIED);
+  base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(2));
+
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_DENIED,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION,
+                GURL("https://www.google.com/"),
+                GURL("https://www.google.com/")));
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_ASK,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_NOTIFICATIONS,
+                GURL("https://www.google.com/"),
+                GURL("https://www.google.com/")));
+
+  // A lifetime of zero means that decisions are kept until cleared
+  context()->SetDecisionLifetime(base::TimeDelta());
+  context()->SetPermissionStatus(
+      TEMPORARY_SAVED_PERMISSION_TYPE_NOTIFICATIONS,
+      GURL("https://www.google.com/"),
+      GURL("https://www.google.com/"),
+      TEMPORARY_SAVED_PERMISSION_STATUS_ALLOWED);
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_ALLOWED,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_NOTIFICATIONS,
+                GURL("https://www.google.com/"),
+                GURL("https://www.google.com/")));
+}
+
+TEST_F(TemporarySavedPermissionContextTest, BulkClear) {
+  const GURL google("https://www.google.com/");
+  const GURL example("https://www.example.com/");
+
+  for (int i = PERMISSION_TYPES_START; i < NUM_PERMISSION_TYPES; ++i) {
+    TemporarySavedPermissionType type =
+        static_cast<TemporarySavedPermissionType>(i);
+    context()->SetPermissionStatus(type, google, google,
+                                   TEMPORARY_SAVED_PERMISSION_STATUS_ALLOWED);
+    context()->SetPermissionStatus(type, example, google,
+                                   TEMPORARY_SAVED_PERMISSION_STATUS_ALLOWED);
+  }
+
+  context()->ClearForType(TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION);
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_ASK,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION, google, google));
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_ALLOWED,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_NOTIFICATIONS, google, google));
+
+  context()->ClearForOrigin(GURL("https://www.example.com/foo"));
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_ASK,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_NOTIFICATIONS, example, google));
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_ALLOWED,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_NOTIFICATIONS, google, google));
+
+  context()->Clear();
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_ASK,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_NOTIFICATIONS, google, google));
+}
+
+TEST_F(TemporarySavedPermissionContextTest, Persistence) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.GetPath().Append("SavedPermissions");
+
+  scoped_refptr<base::TestSimpleTaskRunner> task_runner(
+      new base::TestSimpleTaskRunner());
+
+  context()->EnablePersistence(path, task_runner);
+  context()->SetPermissionStatus(
+      TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION,
+      GURL("https://www.google.com/"),
+      GURL("https://www.example.com/"),
+      TEMPORARY_SAVED_PERMISSION_STATUS_ALLOWED);
+  task_runner->RunPendingTasks();
+  EXPECT_TRUE(base::PathExists(path));
+
+  ResetContext();
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_ASK,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION,
+                GURL("https://www.google.com/"),
+                GURL("https://www.example.com/")));
+
+  context()->EnablePersistence(path, task_runner);
+  task_runner->RunPendingTasks();
+
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_ALLOWED,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION,
+                GURL("https://www.google.com/"),
+                GURL("https://www.example.com/")));
+}
+
+TEST_F(TemporarySavedPermissionContextTest, ResetBeforeLoad) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.GetPath().Append("SavedPermissions");
+
+  scoped_refptr<base::TestSimpleTaskRunner> task_runner(
+      new base::TestSimpleTaskRunner());
+
+  context()->EnablePersistence(path, task_runner);
+  context()->SetPermissionStatus(
+      TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION,
+      GURL("https://www.google.com/"),
+      GURL("https://www.example.com/"),
+      TEMPORARY_SAVED_PERMISSION_STATUS_ALLOWED);
+  task_runner->RunPendingTasks();
+
+  // Reset the decision before the saved decisions have been loaded
+  ResetContext();
+  context()->EnablePersistence(path, task_runner);
+  context()->SetPermissionStatus(
+      TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION,
+      GURL("https://www.google.com/"),
+      GURL("https://www.example.com/"),
+      TEMPORARY_SAVED_PERMISSION_STATUS_ASK);
+  task_runner->RunPendingTasks();
+
+  EXPECT_EQ(TEMPORARY_SAVED_PERMISSION_STATUS_ASK,
+            context()->GetPermissionStatus(
+                TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION,
+                GURL("https://www.google.com/"),
+                GURL("https://www.example.com/")));
+}
+
+TEST_F(TemporarySavedPermissionContextTest, FlushOnDestruction) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.GetPath().Append("SavedPermissions");
+
+  scoped_refptr<base::TestSimpleTaskRunner> task_runner(
+      new base::TestSimpleTaskRunner());
+
+  context()->EnablePersistence(path, task_runner);
+  context()->SetPermissionStatus(
+      TEMPORARY_SAVED_PERMISSION_TYPE_GEOLOCATION,
+      GURL("https://www.google.com/"),
+      GURL("https://www.example.com/"),
+      TEMPORARY_SAVED_PERMISSION_STATUS_ALLOWED);
+
+  // The load and a delayed commit are pending
+  EXPECT_EQ(2U, task_runner->NumPendingTasks());
+
+  ResetContext();
+
+  // Destroying the context should have posted a commit that doesn't wait for
+  // the delayed one
+  EXPECT_EQ(3U, task_runner->NumPendingTasks());
+
+  task_runner->RunPendingTasks();
+  EXPECT_TRUE(base::PathExists(path));
+}
+
+} // namespace oxide
@@ -0,0 +1,318 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#include "renderer_process_pool.h"
+
+#include <set>
+
+#include "base/bind.h"
+#include "base/lazy_instance.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/supports_user_data.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/time/time.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/site_instance.h"
+#include "content/public/common/child_process_host.h"
+#include "url/gurl.h"
+
+namespace oxide {
+
+namespace {
+
+size_t g_max_process_count_per_context = 0;
+
+int kHostDataKey;
+
+// Tracks the SiteInstances assigned to a RenderProcessHost, and when it was
+// last used
+class HostData : public base::SupportsUserData::Data {
+ public:
+  HostData() {}
+  ~HostData() override {}
+
+  static HostData* Get(content::RenderProcessHost* host, bool create) {
+    HostData* data = static_cast<HostData*>(host->GetUserData(&kHostDataKey));
+    if (!data && create) {
+      data = new HostData();
+      host->SetUserData(&kHostDataKey, data);
+    }
+    return data;
+  }
+
+  // The site of a SiteInstance can be set after it is assigned a process,
+  // so we track the SiteInstances rather than their sites
+  std::set<content::SiteInstance*> site_instances;
+
+  base::TimeTicks last_used;
+
+  bool HasSite(const GURL& site_url) const {
+    for (auto* site_instance : site_instances) {
+      if (site_instance->GetSiteURL() == site_url) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HostData);
+};
+
+// The host chosen by ShouldTryToUseExistingProcessHost, which content is
+// about to look for with GetExistingProcessHost. That makes a single pass
+// over every host, calling MayReuseHost for each one and then IsSuitableHost
+// for those in the right BrowserContext. The choice is only applied to the
+// IsSuitableHost call that immediately follows MayReuseHost for the same
+// host, so that IsSuitableHost checks made for other reasons (eg, deciding
+// whether a navigation needs a process swap) are unaffected. It is cleared
+// as soon as the pass is complete
+struct PendingPick {
+  PendingPick()
+      : context(nullptr),
+        host_id(content::ChildProcessHost::kInvalidUniqueID),
+        hosts_remaining(0),
+        current_host_id(content::ChildProcessHost::kInvalidUniqueID) {}
+
+  content::BrowserContext* context;
+  int host_id;
+  GURL site_url;
+
+  // The number of hosts that GetExistingProcessHost has still to visit
+  size_t hosts_remaining;
+
+  // The host that GetExistingProcessHost is currently visiting
+  int current_host_id;
+};
+
+base::LazyInstance<PendingPick>::Leaky g_pending_pick =
+    LAZY_INSTANCE_INITIALIZER;
+
+void ClearPendingPick() {
+  g_pending_pick.Get() = PendingPick();
+}
+
+size_t CountAllHosts() {
+  size_t count = 0;
+  for (content::RenderProcessHost::iterator it =
+          content::RenderProcessHost::AllHostsIterator();
+       !it.IsAtEnd(); it.Advance()) {
+    ++count;
+  }
+
+  return count;
+}
+
+size_t CountHostsForContext(content::BrowserContext* context) {
+  size_t count = 0;
+  for (content::RenderProcessHost::iterator it =
+          content::RenderProcessHost::AllHostsIterator();
+       !it.IsAtEnd(); it.Advance()) {
+    if (it.GetCurrentValue()->GetBrowserContext() == context) {
+      ++count;
+    }
+  }
+
+  return count;
+}
+
+content::RenderProcessHost* PickHost(content::BrowserContext* context,
+                                     const GURL& site_url) {
+  content::RenderProcessHost* same_site = nullptr;
+  base::TimeTicks same_site_last_used;
+  content::RenderProcessHost* lru = nullptr;
+  base::TimeTicks lru_last_used;
+
+  for (content::RenderProcessHost::iterator it =
+          content::RenderProcessHost::AllHostsIterator();
+       !it.IsAtEnd(); it.Advance()) {
+    content::RenderProcessHost* host = it.GetCurrentValue();
+    if (host->GetBrowserContext() != context) {
+      continue;
+    }
+
+    HostData* data = HostData::Get(host, false);
+    base::TimeTicks last_used = data ? data->last_used : base::TimeTicks();
+
+    if (data && !site_url.is_empty() && data->HasSite(site_url) &&
+        (!same_site || last_used > same_site_last_used)) {
+      same_site = host;
+      same_site_last_used = last_used;
+    }
+
+    if (!lru || last_used < lru_last_used) {
+      lru = host;
+      lru_last_used = last_used;
+    }
+  }
+
+  return same_site ? same_site : lru;
+}
+
+}
+
+// static
+void RendererProcessPool::SetMaxProcessCountPerContext(size_t count) {
+  g_max_process_count_per_context = count;
+}
+
+// static
+size_t RendererProcessPool::GetMaxProcessCountPerContext() {
+  return g_max_process_count_per_context;
+}
+
+// static
+std::vector<GURL> RendererProcessPool::GetSitesForHost(
+    content::RenderProcessHost* host) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  HostData* data = HostData::Get(host, false);
+  if (!data) {
+    return std::vector<GURL>();
+  }
+
+  std::set<GURL> sites;
+  for (auto* site_instance : data->site_instances) {
+    if (!site_instance->GetSiteURL().is_empty()) {
+      sites.insert(site_instance->GetSiteURL());
+    }
+  }
+
+  return std::vector<GURL>(sites.begin(), sites.end());
+}
+
+// static
+void RendererProcessPool::HostWasUsed(content::RenderProcessHost* host) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  HostData::Get(host, true)->last_used = base::TimeTicks::Now();
+}
+
+// static
+bool RendererProcessPool::ShouldTryToUseExistingProcessHost(
+    content::BrowserContext* context,
+    const GURL& site_url) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  if (g_max_process_count_per_context == 0 ||
+      content::RenderProcessHost::run_renderer_in_process()) {
+    return false;
+  }
+
+  if (CountHostsForContext(context) < g_max_process_count_per_context) {
+    return false;
+  }
+
+  content::RenderProcessHost* host = PickHost(context, site_url);
+  if (!host) {
+    return false;
+  }
+
+  PendingPick& pick = g_pending_pick.Get();
+  pick = PendingPick();
+  pick.context = context;
+  pick.host_id = host->GetID();
+  pick.site_url = site_url;
+  pick.hosts_remaining = CountAllHosts();
+
+  // The pick is normally consumed synchronously by content. Make sure it
+  // doesn't outlive the current task if nothing ends up using it (eg,
+  // SpareRendererManager only asks whether a process would be reused)
+  base::ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+                                                base::Bind(&ClearPendingPick));
+
+  return true;
+}
+
+// static
+void RendererProcessPool::MayReuseHost(content::RenderProcessHost* host) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  PendingPick& pick = g_pending_pick.Get();
+  if (pick.host_id == content::ChildProcessHost::kInvalidUniqueID) {
+    return;
+  }
+
+  if (pick.hosts_remaining > 0) {
+    --pick.hosts_remaining;
+  }
+
+  if (host->GetBrowserContext() == pick.context) {
+    pick.current_host_id = host->GetID();
+    return;
+  }
+
+  // content won't call IsSuitableHost for a host from another context
+  pick.current_host_id = content::ChildProcessHost::kInvalidUniqueID;
+  if (pick.hosts_remaining == 0) {
+    ClearPendingPick();
+  }
+}
+
+// static
+bool RendererProcessPool::IsSuitableHost(content::RenderProcessHost* host,
+                                         const GURL& site_url) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  PendingPick& pick = g_pending_pick.Get();
+  if (pick.host_id == content::ChildProcessHost::kInvalidUniqueID ||
+      pick.current_host_id != host->GetID() ||
+      pick.site_url != site_url) {
+    return true;
+  }
+
+  bool suitable = host->GetID() == pick.host_id;
+
+  pick.current_host_id = content::ChildProcessHost::kInvalidUniqueID;
+  if (pick.hosts_remaining == 0) {
+    ClearPendingPick();
+  }
+
+  return suitable;
+}
+
+// static
+void RendererProcessPool::SiteInstanceGotProcess(
+    content::SiteInstance* site_instance) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  ClearPendingPick();
+
+  HostData* data = HostData::Get(site_instance->GetProcess(), true);
+  data->site_instances.insert(site_instance);
+  data->last_used = base::TimeTicks::Now();
+}
+
+// static
+void RendererProcessPool::SiteInstanceDeleting(
+    content::SiteInstance* site_instance) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  // GetProcess() would create a process here
+  if (!site_instance->HasProcess()) {
+    return;
+  }
+
+  HostData* data = HostData::Get(site_instance->GetProcess(), false);
+  if (!data) {
+    return;
+  }
+
+  data->site_instances.erase(site_instance);
+}
+
+} // namespace oxide
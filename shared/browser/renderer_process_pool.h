@@ -0,0 +1,77 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#ifndef _OXIDE_SHARED_BROWSER_RENDERER_PROCESS_POOL_H_
+#define _OXIDE_SHARED_BROWSER_RENDERER_PROCESS_POOL_H_
+
+#include <stddef.h>
+#include <vector>
+
+#include "base/macros.h"
+
+#include "shared/common/oxide_shared_export.h"
+
+class GURL;
+
+namespace content {
+class BrowserContext;
+class RenderProcessHost;
+class SiteInstance;
+}
+
+namespace oxide {
+
+// Enforces a maximum number of renderer processes per BrowserContext. Once
+// the limit is reached, new SiteInstances are placed in an existing process
+// from the same context - preferring the most recently used process that
+// already hosts the same site, and otherwise the least recently used process.
+//
+// This works on top of content's process model, via the ContentBrowserClient
+// process assignment hooks. Like content's global limit, it isn't a hard
+// limit - content will still create a new process if the chosen one isn't
+// suitable for the site (eg, because it has different bindings).
+//
+// This must only be used on the UI thread
+class OXIDE_SHARED_EXPORT RendererProcessPool {
+ public:
+  // Set the maximum number of renderer processes for each BrowserContext. 0
+  // (the default) means no limit
+  static void SetMaxProcessCountPerContext(size_t count);
+  static size_t GetMaxProcessCountPerContext();
+
+  // Return the sites currently assigned to |host|, for diagnostics
+  static std::vector<GURL> GetSitesForHost(content::RenderProcessHost* host);
+
+  // Notify that |host| is being used by a visible WebView
+  static void HostWasUsed(content::RenderProcessHost* host);
+
+  // Called from ContentBrowserClient
+  static bool ShouldTryToUseExistingProcessHost(
+      content::BrowserContext* context,
+      const GURL& site_url);
+  static void MayReuseHost(content::RenderProcessHost* host);
+  static bool IsSuitableHost(content::RenderProcessHost* host,
+                             const GURL& site_url);
+  static void SiteInstanceGotProcess(content::SiteInstance* site_instance);
+  static void SiteInstanceDeleting(content::SiteInstance* site_instance);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(RendererProcessPool);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_RENDERER_PROCESS_POOL_H_
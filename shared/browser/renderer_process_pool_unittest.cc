@@ -0,0 +1,223 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#include <memory>
+
+#include "base/memory/ptr_util.h"
+#include "base/memory/ref_counted.h"
+#include "base/run_loop.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/site_instance.h"
+#include "content/public/test/test_browser_context.h"
+#include "content/public/test/test_renderer_host.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+#include "shared/test/test_browser_thread_bundle.h"
+
+#include "renderer_process_pool.h"
+
+namespace oxide {
+
+class RendererProcessPoolTest : public testing::Test {
+ protected:
+  void SetUp() override;
+  void TearDown() override;
+
+  content::BrowserContext* browser_context() const {
+    return browser_context_.get();
+  }
+
+  // Creates a SiteInstance for |url| with a new process
+  scoped_refptr<content::SiteInstance> CreateSiteInstance(const GURL& url);
+
+  GURL GetSite(const GURL& url) const;
+
+  // Calls IsSuitableHost the way that content's GetExistingProcessHost does
+  bool IsSuitableHostDuringLookup(content::RenderProcessHost* host,
+                                  const GURL& site_url);
+
+ private:
+  std::unique_ptr<TestBrowserThreadBundle> browser_thread_bundle_;
+  std::unique_ptr<content::RenderViewHostTestEnabler> rvh_test_enabler_;
+  std::unique_ptr<content::TestBrowserContext> browser_context_;
+};
+
+void RendererProcessPoolTest::SetUp() {
+  browser_thread_bundle_ = base::MakeUnique<TestBrowserThreadBundle>();
+  rvh_test_enabler_ = base::MakeUnique<content::RenderViewHostTestEnabler>();
+  browser_context_ = base::MakeUnique<content::TestBrowserContext>();
+}
+
+void RendererProcessPoolTest::TearDown() {
+  RendererProcessPool::SetMaxProcessCountPerContext(0);
+
+  base::RunLoop().RunUntilIdle();
+
+  rvh_test_enabler_.reset();
+
+  content::BrowserThread::DeleteSoon(content::BrowserThread::UI,
+                                     FROM_HERE,
+                                     browser_context_.release());
+  browser_thread_bundle_.reset();
+}
+
+scoped_refptr<content::SiteInstance>
+RendererProcessPoolTest::CreateSiteInstance(const GURL& url) {
+  scoped_refptr<content::SiteInstance> instance =
+      content::SiteInstance::CreateForURL(browser_context(), url);
+  instance->GetProcess()->Init();
+  return instance;
+}
+
+GURL RendererProcessPoolTest::GetSite(const GURL& url) const {
+  return content::SiteInstance::GetSiteForURL(browser_context_.get(), url);
+}
+
+bool RendererProcessPoolTest::IsSuitableHostDuringLookup(
+    content::RenderProcessHost* host,
+    const GURL& site_url) {
+  RendererProcessPool::MayReuseHost(host);
+  return RendererProcessPool::IsSuitableHost(host, site_url);
+}
+
+TEST_F(RendererProcessPoolTest, NoLimitByDefault) {
+  scoped_refptr<content::SiteInstance> a =
+      CreateSiteInstance(GURL("https://a.com/"));
+  scoped_refptr<content::SiteInstance> b =
+      CreateSiteInstance(GURL("https://b.com/"));
+
+  EXPECT_EQ(0U, RendererProcessPool::GetMaxProcessCountPerContext());
+  EXPECT_FALSE(RendererProcessPool::ShouldTryToUseExistingProcessHost(
+      browser_context(), GetSite(GURL("https://c.com/"))));
+}
+
+TEST_F(RendererProcessPoolTest, BelowLimit) {
+  scoped_refptr<content::SiteInstance> a =
+      CreateSiteInstance(GURL("https://a.com/"));
+  scoped_refptr<content::SiteInstance> b =
+      CreateSiteInstance(GURL("https://b.com/"));
+
+  RendererProcessPool::SetMaxProcessCountPerContext(3);
+  EXPECT_FALSE(RendererProcessPool::ShouldTryToUseExistingProcessHost(
+      browser_context(), GetSite(GURL("https://c.com/"))));
+}
+
+TEST_F(RendererProcessPoolTest, ReusesLeastRecentlyUsedProcess) {
+  scoped_refptr<content::SiteInstance> a =
+      CreateSiteInstance(GURL("https://a.com/"));
+  scoped_refptr<content::SiteInstance> b =
+      CreateSiteInstance(GURL("https://b.com/"));
+  ASSERT_NE(a->GetProcess(), b->GetProcess());
+
+  // |b|'s process has never been used
+  RendererProcessPool::HostWasUsed(a->GetProcess());
+
+  RendererProcessPool::SetMaxProcessCountPerContext(2);
+
+  GURL site = GetSite(GURL("https://c.com/"));
+  EXPECT_TRUE(RendererProcessPool::ShouldTryToUseExistingProcessHost(
+      browser_context(), site));
+  EXPECT_FALSE(IsSuitableHostDuringLookup(a->GetProcess(), site));
+  EXPECT_TRUE(IsSuitableHostDuringLookup(b->GetProcess(), site));
+
+  // The choice doesn't outlive the current task
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(IsSuitableHostDuringLookup(a->GetProcess(), site));
+}
+
+TEST_F(RendererProcessPoolTest, ChoiceOnlyAppliesToLookup) {
+  scoped_refptr<content::SiteInstance> a =
+      CreateSiteInstance(GURL("https://a.com/"));
+  scoped_refptr<content::SiteInstance> b =
+      CreateSiteInstance(GURL("https://b.com/"));
+  ASSERT_NE(a->GetProcess(), b->GetProcess());
+
+  RendererProcessPool::HostWasUsed(a->GetProcess());
+
+  RendererProcessPool::SetMaxProcessCountPerContext(2);
+
+  GURL site = GetSite(GURL("https://c.com/"));
+  EXPECT_TRUE(RendererProcessPool::ShouldTryToUseExistingProcessHost(
+      browser_context(), site));
+
+  // Checks made outside of GetExistingProcessHost (eg, for process swaps)
+  // aren't affected by the choice
+  EXPECT_TRUE(RendererProcessPool::IsSuitableHost(a->GetProcess(), site));
+
+  // Visit every host, as GetExistingProcessHost does
+  size_t visited = 0;
+  for (content::RenderProcessHost::iterator it =
+          content::RenderProcessHost::AllHostsIterator();
+       !it.IsAtEnd(); it.Advance()) {
+    content::RenderProcessHost* host = it.GetCurrentValue();
+    EXPECT_EQ(host == b->GetProcess(),
+              IsSuitableHostDuringLookup(host, site));
+    ++visited;
+  }
+  EXPECT_EQ(2U, visited);
+
+  // The choice is cleared as soon as the lookup has finished
+  RendererProcessPool::MayReuseHost(a->GetProcess());
+  EXPECT_TRUE(RendererProcessPool::IsSuitableHost(a->GetProcess(), site));
+}
+
+TEST_F(RendererProcessPoolTest, PrefersSameSiteProcess) {
+  scoped_refptr<content::SiteInstance> a =
+      CreateSiteInstance(GURL("https://a.com/"));
+  scoped_refptr<content::SiteInstance> b =
+      CreateSiteInstance(GURL("https://b.com/"));
+  ASSERT_NE(a->GetProcess(), b->GetProcess());
+
+  // |b|'s process is the least recently used, but |a|'s hosts the site
+  RendererProcessPool::SiteInstanceGotProcess(a.get());
+
+  RendererProcessPool::SetMaxProcessCountPerContext(2);
+
+  GURL site = GetSite(GURL("https://a.com/foo"));
+  EXPECT_TRUE(RendererProcessPool::ShouldTryToUseExistingProcessHost(
+      browser_context(), site));
+  EXPECT_TRUE(IsSuitableHostDuringLookup(a->GetProcess(), site));
+
+  // Assigning a process consumes the choice
+  scoped_refptr<content::SiteInstance> c =
+      content::SiteInstance::CreateForURL(browser_context(),
+                                          GURL("https://a.com/bar"));
+  RendererProcessPool::SiteInstanceGotProcess(c.get());
+  EXPECT_TRUE(IsSuitableHostDuringLookup(b->GetProcess(), site));
+
+  RendererProcessPool::SiteInstanceDeleting(c.get());
+}
+
+TEST_F(RendererProcessPoolTest, SitesForHost) {
+  scoped_refptr<content::SiteInstance> a =
+      CreateSiteInstance(GURL("https://a.com/"));
+  content::RenderProcessHost* host = a->GetProcess();
+
+  EXPECT_TRUE(RendererProcessPool::GetSitesForHost(host).empty());
+
+  RendererProcessPool::SiteInstanceGotProcess(a.get());
+
+  std::vector<GURL> sites = RendererProcessPool::GetSitesForHost(host);
+  ASSERT_EQ(1U, sites.size());
+  EXPECT_EQ(GetSite(GURL("https://a.com/")), sites[0]);
+
+  RendererProcessPool::SiteInstanceDeleting(a.get());
+  EXPECT_TRUE(RendererProcessPool::GetSitesForHost(host).empty());
+}
+
+} // namespace oxide
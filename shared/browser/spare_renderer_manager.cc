@@ -0,0 +1,230 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "spare_renderer_manager.h"
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/memory/singleton.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/time/time.h"
+#include "components/keyed_service/content/browser_context_dependency_manager.h"
+#include "components/keyed_service/content/browser_context_keyed_service_factory.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/site_instance.h"
+#include "url/gurl.h"
+
+#include "oxide_browser_context.h"
+
+namespace oxide {
+
+namespace {
+
+bool g_enabled = false;
+
+// The delay before launching a replacement after the spare renderer has been
+// claimed, so that we don't compete with the WebView that claimed it whilst
+// it is loading
+const int kRewarmDelayMs = 3000;
+
+void WarmupContext(BrowserContext* context) {
+  SpareRendererManager::Get(context)->Warmup();
+}
+
+}
+
+class SpareRendererManagerFactory : public BrowserContextKeyedServiceFactory {
+ public:
+  static SpareRendererManagerFactory* GetInstance();
+  static SpareRendererManager* GetForContext(content::BrowserContext* context);
+
+ private:
+  friend struct base::DefaultSingletonTraits<SpareRendererManagerFactory>;
+
+  SpareRendererManagerFactory();
+  ~SpareRendererManagerFactory() override;
+
+  // BrowserContextKeyedServiceFactory implementation
+  KeyedService* BuildServiceInstanceFor(
+      content::BrowserContext* context) const override;
+  content::BrowserContext* GetBrowserContextToUse(
+      content::BrowserContext* context) const override;
+
+  DISALLOW_COPY_AND_ASSIGN(SpareRendererManagerFactory);
+};
+
+SpareRendererManagerFactory::SpareRendererManagerFactory()
+    : BrowserContextKeyedServiceFactory(
+        "SpareRendererManager",
+        BrowserContextDependencyManager::GetInstance()) {}
+
+SpareRendererManagerFactory::~SpareRendererManagerFactory() {}
+
+KeyedService* SpareRendererManagerFactory::BuildServiceInstanceFor(
+    content::BrowserContext* context) const {
+  return new SpareRendererManager(context);
+}
+
+content::BrowserContext* SpareRendererManagerFactory::GetBrowserContextToUse(
+    content::BrowserContext* context) const {
+  // Off the record contexts get their own spare renderer, as processes
+  // can't be shared between contexts
+  return context;
+}
+
+// static
+SpareRendererManagerFactory* SpareRendererManagerFactory::GetInstance() {
+  return base::Singleton<SpareRendererManagerFactory>::get();
+}
+
+// static
+SpareRendererManager* SpareRendererManagerFactory::GetForContext(
+    content::BrowserContext* context) {
+  return static_cast<SpareRendererManager*>(
+      GetInstance()->GetServiceForBrowserContext(context, true));
+}
+
+SpareRendererManager::SpareRendererManager(content::BrowserContext* context)
+    : context_(context),
+      shutting_down_(false),
+      spare_host_(nullptr),
+      weak_ptr_factory_(this) {}
+
+SpareRendererManager::~SpareRendererManager() {
+  DCHECK(!spare_host_);
+}
+
+void SpareRendererManager::ReleaseSpare() {
+  if (spare_host_) {
+    spare_host_->RemoveObserver(this);
+    spare_host_ = nullptr;
+  }
+  spare_site_instance_ = nullptr;
+}
+
+void SpareRendererManager::ScheduleWarmup() {
+  base::ThreadTaskRunnerHandle::Get()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&SpareRendererManager::Warmup,
+                 weak_ptr_factory_.GetWeakPtr()),
+      base::TimeDelta::FromMilliseconds(kRewarmDelayMs));
+}
+
+void SpareRendererManager::Shutdown() {
+  shutting_down_ = true;
+  weak_ptr_factory_.InvalidateWeakPtrs();
+
+  content::RenderProcessHost* host = spare_host_;
+  ReleaseSpare();
+
+  // Nothing is using this process, so it's always safe to shut it down. This
+  // ensures that it doesn't delay BrowserContextDestroyer
+  if (host) {
+    host->FastShutdownIfPossible();
+  }
+}
+
+void SpareRendererManager::RenderProcessExited(
+    content::RenderProcessHost* host,
+    base::TerminationStatus status,
+    int exit_code) {
+  DCHECK_EQ(host, spare_host_);
+  ReleaseSpare();
+  ScheduleWarmup();
+}
+
+void SpareRendererManager::RenderProcessHostDestroyed(
+    content::RenderProcessHost* host) {
+  DCHECK_EQ(host, spare_host_);
+  ReleaseSpare();
+}
+
+// static
+SpareRendererManager* SpareRendererManager::Get(
+    content::BrowserContext* context) {
+  return SpareRendererManagerFactory::GetForContext(context);
+}
+
+// static
+void SpareRendererManager::SetEnabled(bool enabled) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  if (enabled == g_enabled) {
+    return;
+  }
+
+  g_enabled = enabled;
+
+  if (enabled) {
+    BrowserContext::ForEach(base::Bind(&WarmupContext));
+  }
+}
+
+// static
+bool SpareRendererManager::IsEnabled() {
+  return g_enabled;
+}
+
+void SpareRendererManager::Warmup() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  if (!g_enabled || shutting_down_ || spare_site_instance_) {
+    return;
+  }
+
+  if (content::RenderProcessHost::run_renderer_in_process()) {
+    return;
+  }
+
+  // Don't launch a new process if the next WebView is going to share an
+  // existing one anyway
+  if (content::RenderProcessHost::ShouldTryToUseExistingProcessHost(
+          context_, GURL())) {
+    return;
+  }
+
+  spare_site_instance_ = content::SiteInstance::Create(context_);
+  spare_host_ = spare_site_instance_->GetProcess();
+  if (!spare_host_->Init()) {
+    LOG(WARNING) << "Failed to launch spare renderer process";
+    spare_host_ = nullptr;
+    spare_site_instance_ = nullptr;
+    return;
+  }
+
+  spare_host_->AddObserver(this);
+}
+
+scoped_refptr<content::SiteInstance>
+SpareRendererManager::TakeSpareSiteInstance() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  if (!spare_site_instance_) {
+    return nullptr;
+  }
+
+  scoped_refptr<content::SiteInstance> site_instance = spare_site_instance_;
+  ReleaseSpare();
+
+  ScheduleWarmup();
+
+  return site_instance;
+}
+
+} // namespace oxide
@@ -0,0 +1,97 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_SHARED_BROWSER_SPARE_RENDERER_MANAGER_H_
+#define _OXIDE_SHARED_BROWSER_SPARE_RENDERER_MANAGER_H_
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "components/keyed_service/core/keyed_service.h"
+#include "content/public/browser/render_process_host_observer.h"
+
+#include "shared/common/oxide_shared_export.h"
+
+namespace content {
+class BrowserContext;
+class RenderProcessHost;
+class SiteInstance;
+}
+
+namespace oxide {
+
+class SpareRendererManagerFactory;
+
+// A per-BrowserContext class that keeps a launched but unused renderer process
+// ready, so that the next WebView created in the context doesn't have to wait
+// for a process launch before it can start loading. The spare process is
+// owned by a SiteInstance with no site, which is assigned a site by the first
+// navigation in the WebView that claims it
+class OXIDE_SHARED_EXPORT SpareRendererManager
+    : public KeyedService,
+      public content::RenderProcessHostObserver {
+ public:
+  static SpareRendererManager* Get(content::BrowserContext* context);
+
+  // Enable or disable spare renderers for all BrowserContexts. This is
+  // disabled by default
+  static void SetEnabled(bool enabled);
+  static bool IsEnabled();
+
+  // Launch a spare renderer if there isn't already one. This does nothing if
+  // spare renderers are disabled, we are running in single process mode, or
+  // the renderer process limit has been reached
+  void Warmup();
+
+  // Return the SiteInstance hosting the spare renderer, or null if there
+  // isn't one. The caller takes ownership of the spare renderer, and a new
+  // one will be launched later on
+  scoped_refptr<content::SiteInstance> TakeSpareSiteInstance();
+
+ private:
+  friend class SpareRendererManagerFactory;
+
+  SpareRendererManager(content::BrowserContext* context);
+  ~SpareRendererManager() override;
+
+  void ReleaseSpare();
+  void ScheduleWarmup();
+
+  // KeyedService implementation
+  void Shutdown() override;
+
+  // content::RenderProcessHostObserver implementation
+  void RenderProcessExited(content::RenderProcessHost* host,
+                           base::TerminationStatus status,
+                           int exit_code) override;
+  void RenderProcessHostDestroyed(content::RenderProcessHost* host) override;
+
+  content::BrowserContext* context_;
+
+  bool shutting_down_;
+
+  scoped_refptr<content::SiteInstance> spare_site_instance_;
+  content::RenderProcessHost* spare_host_;
+
+  base::WeakPtrFactory<SpareRendererManager> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpareRendererManager);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_SPARE_RENDERER_MANAGER_H_
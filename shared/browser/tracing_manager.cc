@@ -0,0 +1,102 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "tracing_manager.h"
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/memory/singleton.h"
+#include "base/trace_event/trace_config.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/tracing_controller.h"
+
+namespace oxide {
+
+void TracingManager::OnTraceFileWritten(const base::Closure& callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  DCHECK(writing_);
+
+  writing_ = false;
+
+  if (!callback.is_null()) {
+    callback.Run();
+  }
+}
+
+TracingManager::TracingManager()
+    : recording_(false),
+      writing_(false) {}
+
+TracingManager::~TracingManager() {}
+
+// static
+TracingManager* TracingManager::GetInstance() {
+  return base::Singleton<TracingManager,
+                         base::LeakySingletonTraits<TracingManager>>::get();
+}
+
+bool TracingManager::StartTracing(const std::string& categories) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  if (IsTracing()) {
+    return false;
+  }
+
+  base::trace_event::TraceConfig config(
+      categories,
+      base::trace_event::RECORD_UNTIL_FULL);
+  if (!content::TracingController::GetInstance()->StartTracing(
+          config,
+          content::TracingController::StartTracingDoneCallback())) {
+    return false;
+  }
+
+  recording_ = true;
+  return true;
+}
+
+bool TracingManager::StopTracing(const base::FilePath& path,
+                                 const base::Closure& callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  if (!recording_) {
+    return false;
+  }
+
+  // The file sink runs our callback on the UI thread once the data from
+  // all processes has been written. This is a leaky singleton, so
+  // base::Unretained is safe
+  scoped_refptr<content::TracingController::TraceDataSink> sink =
+      content::TracingController::CreateFileSink(
+          path,
+          base::Bind(&TracingManager::OnTraceFileWritten,
+                     base::Unretained(this), callback));
+  if (!content::TracingController::GetInstance()->StopTracing(sink)) {
+    return false;
+  }
+
+  recording_ = false;
+  writing_ = true;
+  return true;
+}
+
+bool TracingManager::IsTracing() const {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  return recording_ || writing_;
+}
+
+} // namespace oxide
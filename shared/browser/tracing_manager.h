@@ -0,0 +1,82 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_SHARED_BROWSER_TRACING_MANAGER_H_
+#define _OXIDE_SHARED_BROWSER_TRACING_MANAGER_H_
+
+#include <string>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+
+#include "shared/common/oxide_shared_export.h"
+
+namespace base {
+template <typename Type> struct DefaultSingletonTraits;
+}
+
+namespace oxide {
+
+// Allows the embedder to record a performance trace from the browser,
+// renderer and GPU processes, using Chromium's TRACE_EVENT instrumentation.
+// In addition to Chromium's categories, Oxide records events in the
+// following categories:
+//  - oxide.delegate_worker: Calls in to the application's network and user
+//    agent override delegates
+//  - oxide.frame_delivery: Compositor frames being handed to the toolkit
+//    until they are committed
+//  - oxide.script_messages: Script messages received in the browser and
+//    renderer processes
+//  - oxide.user_scripts: User script injection in the renderer
+//
+// This must only be used on the UI thread
+class OXIDE_SHARED_EXPORT TracingManager {
+ public:
+  static TracingManager* GetInstance();
+
+  // Start recording a trace. |categories| is a Chromium category filter
+  // string (eg, "oxide.*,cc,-ipc"). An empty string selects the default
+  // categories. Returns false if a trace is already being recorded or
+  // written out
+  bool StartTracing(const std::string& categories);
+
+  // Stop recording, and write the trace to |path| in Chrome's JSON trace
+  // format. |callback| is run once the trace has been written. Returns false
+  // if there is no trace being recorded
+  bool StopTracing(const base::FilePath& path, const base::Closure& callback);
+
+  // Whether a trace is being recorded or written out
+  bool IsTracing() const;
+
+ private:
+  friend struct base::DefaultSingletonTraits<TracingManager>;
+
+  TracingManager();
+  ~TracingManager();
+
+  void OnTraceFileWritten(const base::Closure& callback);
+
+  bool recording_;
+  bool writing_;
+
+  DISALLOW_COPY_AND_ASSIGN(TracingManager);
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_BROWSER_TRACING_MANAGER_H_
@@ -25,6 +25,8 @@ const char kFormFactorTablet[] = "tablet";
 const char kFormFactorPhone[] = "phone";
 const char kIncognito[] = "incognito";
 const char kEnableMediaHubAudio[] = "enable-media-hub-audio";
+const char kEnableThreadedBrowserCompositor[] =
+    "enable-threaded-browser-compositor";
 const char kMediaHubFixedSessionDomains[] = "media-hub-fixed-session-domains";
 const char kSharedMemoryOverridePath[] = "shared-memory-override-path";
 
@@ -26,6 +26,7 @@ extern const char kFormFactorTablet[];
 extern const char kFormFactorPhone[];
 extern const char kIncognito[];
 extern const char kEnableMediaHubAudio[];
+extern const char kEnableThreadedBrowserCompositor[];
 extern const char kMediaHubFixedSessionDomains[];
 extern const char kSharedMemoryOverridePath[];
 
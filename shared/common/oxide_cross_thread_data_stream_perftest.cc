@@ -0,0 +1,188 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <algorithm>
+#include <string>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread.h"
+#include "base/timer/elapsed_timer.h"
+#include "net/base/io_buffer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+#include "oxide_cross_thread_data_stream.h"
+
+namespace oxide {
+
+namespace {
+
+const int kTotalBytes = 32 * 1024 * 1024;
+
+struct CrossThreadDataStreamPerfTestRow {
+  CrossThreadDataStreamPerfTestRow(int buffer_size,
+                                   int write_size,
+                                   int read_size)
+      : buffer_size(buffer_size),
+        write_size(write_size),
+        read_size(read_size) {}
+
+  int buffer_size;
+  int write_size;
+  int read_size;
+};
+
+// Writes |total_bytes| to a stream in |write_size| chunks on the thread that
+// it is created on, writing more each time the reader consumes some data
+class StreamWriter : public base::RefCountedThreadSafe<StreamWriter> {
+ public:
+  StreamWriter(CrossThreadDataStream* stream, int write_size, int total_bytes)
+      : stream_(stream),
+        buffer_(new net::IOBuffer(write_size)),
+        write_size_(write_size),
+        remaining_(total_bytes) {
+    memset(buffer_->data(), 'a', write_size);
+  }
+
+  void Start() {
+    stream_->SetDidReadCallback(base::Bind(&StreamWriter::Write, this));
+    Write();
+  }
+
+  void Stop() {
+    stream_->SetDidReadCallback(base::Closure());
+    stream_ = nullptr;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<StreamWriter>;
+  ~StreamWriter() {}
+
+  void Write() {
+    while (remaining_ > 0) {
+      int size = std::min(write_size_, remaining_);
+      int written = stream_->Write(buffer_.get(), size, size == remaining_);
+      if (written == 0) {
+        return;
+      }
+      remaining_ -= written;
+    }
+  }
+
+  scoped_refptr<CrossThreadDataStream> stream_;
+  scoped_refptr<net::IOBuffer> buffer_;
+  int write_size_;
+  int remaining_;
+
+  DISALLOW_COPY_AND_ASSIGN(StreamWriter);
+};
+
+}
+
+class CrossThreadDataStreamPerfTest
+    : public testing::TestWithParam<CrossThreadDataStreamPerfTestRow> {
+ public:
+  CrossThreadDataStreamPerfTest()
+      : bytes_read_(0) {}
+
+ protected:
+  void OnDataAvailable();
+
+  base::MessageLoop message_loop_;
+
+  scoped_refptr<CrossThreadDataStream> stream_;
+  scoped_refptr<net::IOBuffer> read_buffer_;
+  int bytes_read_;
+
+  base::Closure quit_closure_;
+};
+
+void CrossThreadDataStreamPerfTest::OnDataAvailable() {
+  while (true) {
+    int read = stream_->Read(read_buffer_.get(), GetParam().read_size);
+    if (read == 0) {
+      break;
+    }
+    bytes_read_ += read;
+  }
+
+  if (stream_->IsEOF()) {
+    quit_closure_.Run();
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Buffers,
+    CrossThreadDataStreamPerfTest,
+    testing::Values(
+        CrossThreadDataStreamPerfTestRow(4096, 1024, 1024),
+        CrossThreadDataStreamPerfTestRow(65536, 4096, 4096),
+        CrossThreadDataStreamPerfTestRow(65536, 4096, 32768),
+        CrossThreadDataStreamPerfTestRow(65536, 32768, 4096),
+        CrossThreadDataStreamPerfTestRow(1024 * 1024, 65536, 65536)));
+
+TEST_P(CrossThreadDataStreamPerfTest, Throughput) {
+  const auto& params = GetParam();
+
+  base::Thread write_thread("StreamWriterThread");
+  ASSERT_TRUE(write_thread.Start());
+
+  stream_ = new CrossThreadDataStream();
+  ASSERT_TRUE(stream_->Initialize(params.buffer_size));
+
+  read_buffer_ = new net::IOBuffer(params.read_size);
+
+  base::RunLoop run_loop;
+  quit_closure_ = run_loop.QuitClosure();
+
+  stream_->SetDataAvailableCallback(
+      base::Bind(&CrossThreadDataStreamPerfTest::OnDataAvailable,
+                 base::Unretained(this)));
+
+  scoped_refptr<StreamWriter> writer =
+      new StreamWriter(stream_.get(), params.write_size, kTotalBytes);
+
+  base::ElapsedTimer timer;
+  write_thread.task_runner()->PostTask(
+      FROM_HERE,
+      base::Bind(&StreamWriter::Start, writer));
+  run_loop.Run();
+  base::TimeDelta elapsed = timer.Elapsed();
+
+  write_thread.task_runner()->PostTask(
+      FROM_HERE,
+      base::Bind(&StreamWriter::Stop, writer));
+  write_thread.Stop();
+
+  EXPECT_EQ(kTotalBytes, bytes_read_);
+
+  perf_test::PrintResult(
+      "cross_thread_data_stream",
+      base::StringPrintf("_%d_buffer", params.buffer_size),
+      base::StringPrintf("%d_write_%d_read",
+                         params.write_size, params.read_size),
+      (kTotalBytes / (1024.0 * 1024.0)) / elapsed.InSecondsF(),
+      "MB/s", true);
+}
+
+} // namespace oxide
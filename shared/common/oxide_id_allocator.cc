@@ -17,21 +17,75 @@
 
 #include "oxide_id_allocator.h"
 
+#include <algorithm>
 #include <limits>
-#include <utility>
 
 #include "base/logging.h"
 
 namespace oxide {
 
+namespace {
+
+const int kBitsPerWord = 64;
+const uint64_t kFullWord = std::numeric_limits<uint64_t>::max();
+
+// ID's below this are tracked in the bitmaps, which are at most 8KB at this
+// size. Anything higher goes in to IdAllocator::sparse_used_
+const int kMaxDenseWords = 1024;
+const int kDenseIdLimit = kMaxDenseWords * kBitsPerWord;
+
+uint64_t BitForIndex(size_t index) {
+  return uint64_t(1) << (index % kBitsPerWord);
+}
+
+// Returns the index of the lowest clear bit in |word|, which must not be full
+int FindFirstZero(uint64_t word) {
+  DCHECK_NE(word, kFullWord);
+  return __builtin_ctzll(~word);
+}
+
+}
+
 bool IdAllocator::IsValidId(int id) const {
   return id > kInvalidId && id <= max_id_;
 }
 
+bool IdAllocator::IsUsed(int id) const {
+  if (id >= kDenseIdLimit) {
+    return sparse_used_.find(id) != sparse_used_.end();
+  }
+
+  size_t word = id / kBitsPerWord;
+  if (word >= used_.size()) {
+    return false;
+  }
+
+  return (used_[word] & BitForIndex(id)) != 0;
+}
+
+void IdAllocator::SetUsed(int id) {
+  if (id >= kDenseIdLimit) {
+    sparse_used_.insert(id);
+    return;
+  }
+
+  size_t word = id / kBitsPerWord;
+  if (word >= used_.size()) {
+    used_.resize(word + 1, 0);
+    full_.resize((used_.size() + kBitsPerWord - 1) / kBitsPerWord, 0);
+  }
+
+  used_[word] |= BitForIndex(id);
+  if (used_[word] == kFullWord) {
+    full_[word / kBitsPerWord] |= BitForIndex(word);
+  }
+}
+
 IdAllocator::IdAllocator(size_t max_id)
     : max_id_(static_cast<int>(std::min(
                   max_id,
-                  static_cast<size_t>(std::numeric_limits<int>::max())))) {
+                  static_cast<size_t>(std::numeric_limits<int>::max())))),
+      first_non_full_hint_(0) {
   if (max_id_ == 0) {
     max_id_ = std::numeric_limits<int>::max();
   }
@@ -40,64 +94,65 @@ IdAllocator::IdAllocator(size_t max_id)
 IdAllocator::~IdAllocator() {}
 
 int IdAllocator::AllocateId() {
-  int id = kInvalidId;
-  if (!free_ids_.empty()) {
-    // Reuse a free'd ID if we have one
-    id = *free_ids_.begin();
-  } else if (!used_ids_.empty()) {
-    // We have no free ID's. Find the last allocated ID
-    int last_id = *used_ids_.rbegin();
-    DCHECK(IsValidId(last_id));
-    if (last_id == max_id_) {
-      // The last allocated ID was our maximum. Search for an ID that
-      // has never been allocated
-      int x = 0;
-      for (std::set<int>::iterator it = used_ids_.begin();
-           it != used_ids_.end(); ++it) {
-        if (*it != x) {
-          id = x;
-          break;
-        }
-        ++x;
-      }
-    } else {
-      // Use the next ID
-      id = last_id + 1;
+  // Find the first word of |used_| with a free ID. If every word is full,
+  // the next ID is the first one beyond the end of the bitmap
+  size_t word = used_.size();
+  for (size_t i = first_non_full_hint_; i < full_.size(); ++i) {
+    if (full_[i] != kFullWord) {
+      word = std::min(word, i * kBitsPerWord + FindFirstZero(full_[i]));
+      first_non_full_hint_ = i;
+      break;
+    }
+  }
+
+  int64_t id = int64_t(word) * kBitsPerWord;
+  if (word < used_.size()) {
+    id += FindFirstZero(used_[word]);
+  } else if (id >= kDenseIdLimit) {
+    // Every ID in the bitmaps is in use. Find the first gap in the sparse
+    // ID's
+    DCHECK_EQ(id, kDenseIdLimit);
+    for (auto it = sparse_used_.begin();
+         it != sparse_used_.end() && *it == id; ++it) {
+      ++id;
     }
-  } else {
-    // Use 0 for the first ID
-    id = 0;
   }
 
-  if (id == kInvalidId) {
+  if (id > max_id_) {
     // There are no more ID's available
     return kInvalidId;
   }
 
-  bool res = MarkAsUsed(id);
-  DCHECK(res);
+  SetUsed(static_cast<int>(id));
 
-  return id;
+  return static_cast<int>(id);
 }
 
 void IdAllocator::FreeId(int id) {
-  if (!IsValidId(id)) {
+  if (!IsValidId(id) || !IsUsed(id)) {
     return;
   }
 
-  if (used_ids_.erase(id) > 0) {
-    free_ids_.insert(id);
+  if (id >= kDenseIdLimit) {
+    sparse_used_.erase(id);
+    return;
   }
+
+  size_t word = id / kBitsPerWord;
+  used_[word] &= ~BitForIndex(id);
+  full_[word / kBitsPerWord] &= ~BitForIndex(word);
+
+  first_non_full_hint_ =
+      std::min(first_non_full_hint_, word / kBitsPerWord);
 }
 
 bool IdAllocator::MarkAsUsed(int id) {
-  if (!IsValidId(id)) {
+  if (!IsValidId(id) || IsUsed(id)) {
     return false;
   }
 
-  free_ids_.erase(id);
-  std::pair<std::set<int>::iterator, bool> res = used_ids_.insert(id);
-  return res.second;
+  SetUsed(id);
+  return true;
 }
 
 } // namespace oxide
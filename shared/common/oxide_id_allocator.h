@@ -18,7 +18,10 @@
 #ifndef _OXIDE_SHARED_BASE_ID_ALLOCATOR_H_
 #define _OXIDE_SHARED_BASE_ID_ALLOCATOR_H_
 
+#include <stddef.h>
+#include <stdint.h>
 #include <set>
+#include <vector>
 
 #include "base/compiler_specific.h"
 #include "base/macros.h"
@@ -29,6 +32,17 @@ namespace oxide {
 
 static const int kInvalidId = -1;
 
+// Allocates integer ID's between 0 and |max_id| inclusive. AllocateId always
+// returns the lowest unused ID.
+//
+// Used ID's are tracked in a bitmap, with a second bitmap that records which
+// words of the first are full. Allocation scans for the first non-full word
+// starting from a hint that FreeId keeps up to date, so allocation and
+// freeing are O(1) amortized. The bitmaps grow to cover the highest ID used
+// so far, up to a fixed limit. ID's beyond that limit only appear if a caller
+// marks a large ID as used or allocates a very large number of ID's, and are
+// tracked in an ordered set instead so that the memory used stays
+// proportional to the number of ID's in use
 class OXIDE_SHARED_EXPORT IdAllocator final {
  public:
   IdAllocator(size_t max_id = 0);
@@ -41,9 +55,22 @@ class OXIDE_SHARED_EXPORT IdAllocator final {
  private:
   bool IsValidId(int id) const;
 
+  bool IsUsed(int id) const;
+  void SetUsed(int id);
+
   int max_id_;
-  std::set<int> used_ids_;
-  std::set<int> free_ids_;
+
+  // Bit n of word w is set if ID (w * 64 + n) is in use
+  std::vector<uint64_t> used_;
+
+  // Bit n of word w is set if word (w * 64 + n) of |used_| is full
+  std::vector<uint64_t> full_;
+
+  // The index of the first word of |full_| that might have a clear bit
+  size_t first_non_full_hint_;
+
+  // Used ID's that are too large to be tracked in |used_|
+  std::set<int> sparse_used_;
 
   DISALLOW_COPY_AND_ASSIGN(IdAllocator);
 };
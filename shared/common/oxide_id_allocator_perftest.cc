@@ -0,0 +1,95 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <string>
+
+#include "base/macros.h"
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+#include "oxide_id_allocator.h"
+
+namespace oxide {
+
+class IdAllocatorPerfTest : public testing::TestWithParam<int> {
+ protected:
+  std::string modifier() const {
+    return base::StringPrintf("_%d", GetParam());
+  }
+
+  void PrintResult(const std::string& trace,
+                   base::TimeDelta elapsed,
+                   int operations) {
+    perf_test::PrintResult(
+        "id_allocator", modifier(), trace,
+        elapsed.InMicrosecondsF() * 1000 / operations, "ns/op", true);
+  }
+};
+
+INSTANTIATE_TEST_CASE_P(LiveIds,
+                        IdAllocatorPerfTest,
+                        testing::Values(100, 1000, 10000));
+
+// Allocates |GetParam()| ID's from an empty allocator
+TEST_P(IdAllocatorPerfTest, Allocate) {
+  IdAllocator allocator;
+
+  base::ElapsedTimer timer;
+  for (int i = 0; i < GetParam(); ++i) {
+    ASSERT_NE(kInvalidId, allocator.AllocateId());
+  }
+
+  PrintResult("allocate", timer.Elapsed(), GetParam());
+}
+
+// Repeatedly frees and reallocates ID's with |GetParam()| ID's live, which is
+// the steady state for routing and frame ID's
+TEST_P(IdAllocatorPerfTest, Churn) {
+  const int kIterations = 100000;
+
+  IdAllocator allocator;
+  for (int i = 0; i < GetParam(); ++i) {
+    ASSERT_EQ(i, allocator.AllocateId());
+  }
+
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    int id = (i * 7919) % GetParam();
+    allocator.FreeId(id);
+    ASSERT_EQ(id, allocator.AllocateId());
+  }
+
+  PrintResult("churn", timer.Elapsed(), kIterations);
+}
+
+// Allocates ID's once the highest ID has been handed out, which forces the
+// allocator to search for one that has never been used
+TEST_P(IdAllocatorPerfTest, AllocateAfterWrap) {
+  IdAllocator allocator(GetParam() * 2);
+  ASSERT_TRUE(allocator.MarkAsUsed(GetParam() * 2));
+
+  base::ElapsedTimer timer;
+  for (int i = 0; i < GetParam(); ++i) {
+    ASSERT_EQ(i, allocator.AllocateId());
+  }
+
+  PrintResult("allocate_after_wrap", timer.Elapsed(), GetParam());
+}
+
+} // namespace oxide
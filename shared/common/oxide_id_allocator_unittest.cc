@@ -0,0 +1,190 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <limits>
+#include <set>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include "oxide_id_allocator.h"
+
+namespace oxide {
+
+TEST(IdAllocatorTest, AllocateSequential) {
+  IdAllocator allocator;
+  for (int i = 0; i < 200; ++i) {
+    EXPECT_EQ(i, allocator.AllocateId());
+  }
+}
+
+TEST(IdAllocatorTest, ReuseLowestFreeId) {
+  IdAllocator allocator;
+  for (int i = 0; i < 200; ++i) {
+    ASSERT_EQ(i, allocator.AllocateId());
+  }
+
+  allocator.FreeId(150);
+  allocator.FreeId(3);
+  allocator.FreeId(64);
+
+  EXPECT_EQ(3, allocator.AllocateId());
+  EXPECT_EQ(64, allocator.AllocateId());
+  EXPECT_EQ(150, allocator.AllocateId());
+  EXPECT_EQ(200, allocator.AllocateId());
+}
+
+TEST(IdAllocatorTest, FreeUnusedId) {
+  IdAllocator allocator;
+  EXPECT_EQ(0, allocator.AllocateId());
+
+  // Freeing ID's that were never allocated, or are invalid, is a no-op
+  allocator.FreeId(1);
+  allocator.FreeId(1000);
+  allocator.FreeId(kInvalidId);
+
+  EXPECT_EQ(1, allocator.AllocateId());
+
+  allocator.FreeId(0);
+  allocator.FreeId(0);
+  EXPECT_EQ(0, allocator.AllocateId());
+  EXPECT_EQ(2, allocator.AllocateId());
+}
+
+TEST(IdAllocatorTest, MaxId) {
+  IdAllocator allocator(3);
+  EXPECT_EQ(0, allocator.AllocateId());
+  EXPECT_EQ(1, allocator.AllocateId());
+  EXPECT_EQ(2, allocator.AllocateId());
+  EXPECT_EQ(3, allocator.AllocateId());
+  EXPECT_EQ(kInvalidId, allocator.AllocateId());
+
+  allocator.FreeId(1);
+  EXPECT_EQ(1, allocator.AllocateId());
+  EXPECT_EQ(kInvalidId, allocator.AllocateId());
+}
+
+TEST(IdAllocatorTest, MaxIdAtWordBoundary) {
+  IdAllocator allocator(127);
+  for (int i = 0; i <= 127; ++i) {
+    ASSERT_EQ(i, allocator.AllocateId());
+  }
+  EXPECT_EQ(kInvalidId, allocator.AllocateId());
+
+  allocator.FreeId(127);
+  EXPECT_EQ(127, allocator.AllocateId());
+  EXPECT_EQ(kInvalidId, allocator.AllocateId());
+}
+
+TEST(IdAllocatorTest, MarkAsUsed) {
+  IdAllocator allocator(1000);
+
+  EXPECT_TRUE(allocator.MarkAsUsed(0));
+  EXPECT_TRUE(allocator.MarkAsUsed(2));
+  EXPECT_TRUE(allocator.MarkAsUsed(1000));
+
+  EXPECT_FALSE(allocator.MarkAsUsed(2));
+  EXPECT_FALSE(allocator.MarkAsUsed(kInvalidId));
+  EXPECT_FALSE(allocator.MarkAsUsed(1001));
+
+  EXPECT_EQ(1, allocator.AllocateId());
+  EXPECT_EQ(3, allocator.AllocateId());
+
+  allocator.FreeId(2);
+  EXPECT_TRUE(allocator.MarkAsUsed(2));
+  EXPECT_EQ(4, allocator.AllocateId());
+}
+
+TEST(IdAllocatorTest, AllocateAfterMaxIdMarkedAsUsed) {
+  IdAllocator allocator(100);
+  EXPECT_TRUE(allocator.MarkAsUsed(100));
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(i, allocator.AllocateId());
+  }
+
+  EXPECT_EQ(kInvalidId, allocator.AllocateId());
+}
+
+TEST(IdAllocatorTest, MarkLargeIdAsUsed) {
+  // Marking an ID near the top of the range shouldn't size the bitmaps to
+  // cover it
+  IdAllocator allocator;
+  EXPECT_TRUE(allocator.MarkAsUsed(std::numeric_limits<int>::max() - 1));
+  EXPECT_FALSE(allocator.MarkAsUsed(std::numeric_limits<int>::max() - 1));
+
+  EXPECT_EQ(0, allocator.AllocateId());
+
+  allocator.FreeId(std::numeric_limits<int>::max() - 1);
+  EXPECT_TRUE(allocator.MarkAsUsed(std::numeric_limits<int>::max() - 1));
+}
+
+TEST(IdAllocatorTest, AllocateBeyondDenseRange) {
+  const int kDenseIds = 65536;
+
+  IdAllocator allocator;
+  for (int i = 0; i < kDenseIds; ++i) {
+    ASSERT_EQ(i, allocator.AllocateId());
+  }
+
+  EXPECT_TRUE(allocator.MarkAsUsed(kDenseIds + 1));
+
+  EXPECT_EQ(kDenseIds, allocator.AllocateId());
+  EXPECT_EQ(kDenseIds + 2, allocator.AllocateId());
+
+  allocator.FreeId(kDenseIds);
+  allocator.FreeId(10);
+  EXPECT_EQ(10, allocator.AllocateId());
+  EXPECT_EQ(kDenseIds, allocator.AllocateId());
+  EXPECT_EQ(kDenseIds + 3, allocator.AllocateId());
+}
+
+TEST(IdAllocatorTest, MaxIdBeyondDenseRange) {
+  const int kDenseIds = 65536;
+
+  IdAllocator allocator(kDenseIds);
+  for (int i = 0; i <= kDenseIds; ++i) {
+    ASSERT_EQ(i, allocator.AllocateId());
+  }
+  EXPECT_EQ(kInvalidId, allocator.AllocateId());
+
+  allocator.FreeId(kDenseIds);
+  EXPECT_EQ(kDenseIds, allocator.AllocateId());
+  EXPECT_EQ(kInvalidId, allocator.AllocateId());
+}
+
+TEST(IdAllocatorTest, Churn) {
+  IdAllocator allocator(4095);
+  for (int i = 0; i < 4096; ++i) {
+    ASSERT_EQ(i, allocator.AllocateId());
+  }
+  EXPECT_EQ(kInvalidId, allocator.AllocateId());
+
+  // Free a scattered set of ID's, and check that they are reallocated lowest
+  // first
+  std::set<int> freed;
+  for (int i = 0; i < 4096; i += 37) {
+    allocator.FreeId(i);
+    freed.insert(i);
+  }
+
+  for (int expected : freed) {
+    EXPECT_EQ(expected, allocator.AllocateId());
+  }
+  EXPECT_EQ(kInvalidId, allocator.AllocateId());
+}
+
+} // namespace oxide
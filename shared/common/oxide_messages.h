@@ -60,8 +60,14 @@ IPC_MESSAGE_ROUTED3(OxideMsg_UpdateBrowserControlsState,
 IPC_MESSAGE_CONTROL1(OxideMsg_UpdateUserAgentOverrides,
                      std::vector<oxide::UserAgentOverrideSet::Entry>)
 
-IPC_MESSAGE_CONTROL1(OxideMsg_SetLegacyUserAgentOverrideEnabled,
-                     bool)
+IPC_MESSAGE_CONTROL2(OxideMsg_SetLegacyUserAgentOverrideEnabled,
+                     bool /* enabled */,
+                     int /* generation */)
+
+IPC_MESSAGE_CONTROL3(OxideMsg_CacheLegacyUserAgentOverride,
+                     int /* generation */,
+                     GURL /* origin */,
+                     std::string /* user_agent */)
 
 IPC_MESSAGE_ROUTED1(OxideHostMsg_SendMessage,
                     oxide::ScriptMessageParams)
@@ -19,26 +19,61 @@
 
 #include <utility>
 
+#include "base/atomicops.h"
 #include "base/logging.h"
 #include "base/values.h"
 
 #include "oxide_script_message.h"
 #include "oxide_script_message_request.h"
+#include "oxide_script_message_worker.h"
 
 namespace oxide {
 
+namespace {
+base::subtle::Atomic32 g_configuration_generation = 0;
+}
+
 ScriptMessageHandler::ScriptMessageHandler() {}
 
+ScriptMessageHandler::~ScriptMessageHandler() {
+  // Routing tables might still reference us
+  ConfigurationChanged();
+}
+
+void ScriptMessageHandler::set_msg_id(const std::string& id) {
+  msg_id_ = id;
+  ConfigurationChanged();
+}
+
+void ScriptMessageHandler::set_contexts(const std::vector<GURL>& contexts) {
+  contexts_ = contexts;
+  ConfigurationChanged();
+}
+
 bool ScriptMessageHandler::IsValid() const {
-  return !msg_id().empty() && contexts().size() > 0 && !callback_.is_null();
+  return !msg_id().empty() && contexts().size() > 0 &&
+         (!callback_.is_null() || worker_);
 }
 
 void ScriptMessageHandler::SetCallback(const HandlerCallback& callback) {
   callback_ = callback;
+  ConfigurationChanged();
+}
+
+void ScriptMessageHandler::SetWorker(
+    scoped_refptr<ScriptMessageWorker> worker) {
+  worker_ = std::move(worker);
+  ConfigurationChanged();
 }
 
 void ScriptMessageHandler::OnReceiveMessage(ScriptMessage* message) const {
   DCHECK_EQ(message->msg_id(), msg_id());
+
+  if (worker_) {
+    worker_->OnReceiveMessage(make_scoped_refptr(message));
+    return;
+  }
+
   DCHECK(!callback_.is_null());
 
   std::unique_ptr<base::Value> error_payload;
@@ -50,4 +85,14 @@ void ScriptMessageHandler::OnReceiveMessage(ScriptMessage* message) const {
   }
 }
 
+// static
+int ScriptMessageHandler::GetConfigurationGeneration() {
+  return base::subtle::Acquire_Load(&g_configuration_generation);
+}
+
+// static
+void ScriptMessageHandler::ConfigurationChanged() {
+  base::subtle::Barrier_AtomicIncrement(&g_configuration_generation, 1);
+}
+
 } // namespace oxide
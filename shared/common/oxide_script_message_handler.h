@@ -24,6 +24,7 @@
 
 #include "base/callback.h"
 #include "base/macros.h"
+#include "base/memory/ref_counted.h"
 #include "url/gurl.h"
 
 #include "shared/common/oxide_shared_export.h"
@@ -35,6 +36,7 @@ class Value;
 namespace oxide {
 
 class ScriptMessage;
+class ScriptMessageWorker;
 
 class OXIDE_SHARED_EXPORT ScriptMessageHandler final {
  public:
@@ -42,31 +44,43 @@ class OXIDE_SHARED_EXPORT ScriptMessageHandler final {
       HandlerCallback;
 
   ScriptMessageHandler();
+  ~ScriptMessageHandler();
 
   std::string msg_id() const {
     return msg_id_;
   }
-  void set_msg_id(const std::string& id) {
-    msg_id_ = id;
-  }
+  void set_msg_id(const std::string& id);
 
   const std::vector<GURL>& contexts() const {
     return contexts_;
   }
-  void set_contexts(const std::vector<GURL>& contexts) {
-    contexts_ = contexts;
-  }
+  void set_contexts(const std::vector<GURL>& contexts);
 
   bool IsValid() const;
 
   void SetCallback(const HandlerCallback& callback);
 
+  // Deliver messages to |worker| instead of running the callback on the UI
+  // thread. A worker takes precedence over a callback
+  void SetWorker(scoped_refptr<ScriptMessageWorker> worker);
+  ScriptMessageWorker* worker() const { return worker_.get(); }
+
   void OnReceiveMessage(ScriptMessage* message) const;
 
+  // Returns a counter that changes whenever the configuration of any handler
+  // changes, including when handlers are destroyed or when the embedder
+  // notifies that the set of handlers attached to something has changed.
+  // This is used to invalidate cached routing tables
+  static int GetConfigurationGeneration();
+
+  // Notify that the set of handlers attached to something has changed
+  static void ConfigurationChanged();
+
  private:
   std::string msg_id_;
   std::vector<GURL> contexts_;
   HandlerCallback callback_;
+  scoped_refptr<ScriptMessageWorker> worker_;
 
   DISALLOW_COPY_AND_ASSIGN(ScriptMessageHandler);
 };
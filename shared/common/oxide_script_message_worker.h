@@ -0,0 +1,47 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef _OXIDE_SHARED_COMMON_SCRIPT_MESSAGE_WORKER_H_
+#define _OXIDE_SHARED_COMMON_SCRIPT_MESSAGE_WORKER_H_
+
+#include "base/memory/ref_counted.h"
+
+namespace oxide {
+
+class ScriptMessage;
+
+// A ScriptMessageWorker receives messages for a ScriptMessageHandler on a
+// thread of its choosing rather than on the UI thread. Once a route from a
+// frame to a worker has been established, incoming messages are delivered
+// from the IO thread without passing through the UI thread (see
+// ScriptMessageFilter)
+class ScriptMessageWorker
+    : public base::RefCountedThreadSafe<ScriptMessageWorker> {
+ public:
+  // Called on the UI or IO thread. Implementations must be thread-safe and
+  // should hand |message| off to their own thread. If |message| is dropped
+  // without a response, an error is returned to the sender
+  virtual void OnReceiveMessage(scoped_refptr<ScriptMessage> message) = 0;
+
+ protected:
+  friend class base::RefCountedThreadSafe<ScriptMessageWorker>;
+  virtual ~ScriptMessageWorker() {}
+};
+
+} // namespace oxide
+
+#endif // _OXIDE_SHARED_COMMON_SCRIPT_MESSAGE_WORKER_H_
@@ -0,0 +1,106 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+#include "oxide_user_agent_override_set.h"
+
+namespace oxide {
+
+namespace {
+
+const int kIterations = 2000;
+
+struct UserAgentOverrideSetPerfTestRow {
+  UserAgentOverrideSetPerfTestRow(size_t override_count,
+                                  size_t host_count)
+      : override_count(override_count),
+        host_count(host_count) {}
+
+  // The number of overrides in the set
+  size_t override_count;
+
+  // The number of distinct hosts that lookups are spread across. Lookups for
+  // hosts beyond |override_count| don't match any override
+  size_t host_count;
+};
+
+std::string MakePattern(size_t i) {
+  return base::StringPrintf("^https?://(www\\.)?host%zu\\.example\\.com/", i);
+}
+
+GURL MakeURL(size_t i) {
+  return GURL(base::StringPrintf("https://www.host%zu.example.com/path/%zu",
+                                 i, i));
+}
+
+}
+
+class UserAgentOverrideSetPerfTest
+    : public testing::TestWithParam<UserAgentOverrideSetPerfTestRow> {};
+
+INSTANTIATE_TEST_CASE_P(
+    Overrides,
+    UserAgentOverrideSetPerfTest,
+    testing::Values(
+        UserAgentOverrideSetPerfTestRow(10, 1),
+        UserAgentOverrideSetPerfTestRow(10, 4),
+        UserAgentOverrideSetPerfTestRow(100, 4),
+        UserAgentOverrideSetPerfTestRow(100, 50),
+        UserAgentOverrideSetPerfTestRow(100, 200),
+        UserAgentOverrideSetPerfTestRow(1000, 8)));
+
+TEST_P(UserAgentOverrideSetPerfTest, GetOverrideForURL) {
+  const auto& params = GetParam();
+
+  std::vector<UserAgentOverrideSet::Entry> overrides;
+  for (size_t i = 0; i < params.override_count; ++i) {
+    overrides.push_back(
+        std::make_pair(MakePattern(i),
+                       base::StringPrintf("Override %zu", i)));
+  }
+
+  std::vector<GURL> urls;
+  for (size_t i = 0; i < params.host_count; ++i) {
+    urls.push_back(MakeURL(i));
+  }
+
+  UserAgentOverrideSet set;
+  set.SetOverrides(overrides);
+
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    size_t index = i % urls.size();
+    std::string ua = set.GetOverrideForURL(urls[index]);
+    ASSERT_EQ(index < params.override_count, !ua.empty());
+  }
+
+  perf_test::PrintResult(
+      "ua_override_lookup",
+      base::StringPrintf("_%zu_overrides", params.override_count),
+      base::StringPrintf("%zu_hosts", params.host_count),
+      timer.Elapsed().InMicrosecondsF() / kIterations, "us/lookup", true);
+}
+
+} // namespace oxide
@@ -0,0 +1,137 @@
+// vim:expandtab:shiftwidth=2:tabstop=2:
+// Copyright (C) 2017 Canonical Ltd.
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "extensions/common/url_pattern.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+#include "oxide_user_script.h"
+
+namespace oxide {
+
+namespace {
+
+const int kIterations = 10000;
+
+struct UserScriptPerfTestRow {
+  UserScriptPerfTestRow(size_t pattern_count,
+                        size_t glob_count)
+      : pattern_count(pattern_count),
+        glob_count(glob_count) {}
+
+  // The number of include and exclude URL patterns
+  size_t pattern_count;
+
+  // The number of include and exclude globs
+  size_t glob_count;
+};
+
+}
+
+class UserScriptPerfTest
+    : public testing::TestWithParam<UserScriptPerfTestRow> {
+ protected:
+  void SetUp() override;
+
+  const UserScript& script() const { return script_; }
+  const std::vector<GURL>& urls() const { return urls_; }
+
+ private:
+  UserScript script_;
+  std::vector<GURL> urls_;
+};
+
+void UserScriptPerfTest::SetUp() {
+  const auto& params = GetParam();
+  const int kValidSchemes = URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS;
+
+  for (size_t i = 0; i < params.pattern_count; ++i) {
+    URLPattern include(kValidSchemes);
+    ASSERT_EQ(URLPattern::PARSE_SUCCESS,
+              include.Parse(
+                  base::StringPrintf("*://*.site%zu.example.com/*", i)));
+    script_.add_include_url_pattern(include);
+
+    URLPattern exclude(kValidSchemes);
+    ASSERT_EQ(URLPattern::PARSE_SUCCESS,
+              exclude.Parse(
+                  base::StringPrintf("*://*.site%zu.example.com/private/*",
+                                     i)));
+    script_.add_exclude_url_pattern(exclude);
+  }
+
+  for (size_t i = 0; i < params.glob_count; ++i) {
+    script_.add_include_glob(
+        base::StringPrintf("http*://*.example.com/*/page%zu*", i));
+    script_.add_exclude_glob(
+        base::StringPrintf("*://*.example.com/*/page%zu?nomatch*", i));
+  }
+
+  // A mix of URLs that match, URLs that are excluded and URLs that don't
+  // match any include pattern
+  for (size_t i = 0; i < 16; ++i) {
+    size_t site = (i * 31) % std::max(params.pattern_count, size_t(1));
+    size_t page = (i * 17) % std::max(params.glob_count, size_t(1));
+    urls_.push_back(
+        GURL(base::StringPrintf("https://www.site%zu.example.com/a/page%zu",
+                                site, page)));
+    urls_.push_back(
+        GURL(base::StringPrintf(
+            "https://www.site%zu.example.com/private/page%zu", site, page)));
+    urls_.push_back(
+        GURL(base::StringPrintf("https://www.other%zu.example.org/", i)));
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Patterns,
+    UserScriptPerfTest,
+    testing::Values(
+        UserScriptPerfTestRow(1, 0),
+        UserScriptPerfTestRow(10, 0),
+        UserScriptPerfTestRow(100, 0),
+        UserScriptPerfTestRow(1, 10),
+        UserScriptPerfTestRow(10, 100)));
+
+TEST_P(UserScriptPerfTest, MatchesURL) {
+  size_t matches = 0;
+
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    if (script().MatchesURL(urls()[i % urls().size()])) {
+      ++matches;
+    }
+  }
+  base::TimeDelta elapsed = timer.Elapsed();
+
+  EXPECT_GT(matches, 0U);
+
+  perf_test::PrintResult(
+      "user_script_matches_url",
+      base::StringPrintf("_%zu_patterns", GetParam().pattern_count),
+      base::StringPrintf("%zu_globs", GetParam().glob_count),
+      elapsed.InMicrosecondsF() * 1000 / kIterations, "ns/match", true);
+}
+
+} // namespace oxide
@@ -17,10 +17,15 @@
 
 #include "oxide_isolated_world_map.h"
 
-#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "third_party/WebKit/public/platform/WebSecurityOrigin.h"
+#include "third_party/WebKit/public/platform/WebString.h"
+#include "third_party/WebKit/public/web/WebLocalFrame.h"
 
 #include "shared/common/oxide_constants.h"
 
@@ -28,12 +33,63 @@ namespace oxide {
 
 namespace {
 
-int g_next_isolated_world_id = 1;
+const char kIsolatedWorldCSP[] = "script-src 'self'";
 
-typedef std::map<GURL, int> WorldIDMap;
-typedef WorldIDMap::iterator WorldIDMapIterator;
-base::LazyInstance<WorldIDMap>::Leaky g_isolated_world_map =
-    LAZY_INSTANCE_INITIALIZER;
+struct World {
+  GURL url;
+  blink::WebSecurityOrigin security_origin;
+  bool initialized;
+};
+
+class Registry {
+ public:
+  Registry()
+      : main_world_url_(kMainWorldContextUrl),
+        csp_(blink::WebString::fromUTF8(kIsolatedWorldCSP)) {}
+
+  const GURL& main_world_url() const { return main_world_url_; }
+  const blink::WebString& csp() const { return csp_; }
+
+  int GetOrCreateID(const GURL& url) {
+    auto it = ids_.find(url.spec());
+    if (it != ids_.end()) {
+      return it->second;
+    }
+
+    World world;
+    world.url = url;
+    world.security_origin =
+        blink::WebSecurityOrigin::createFromString(
+            blink::WebString::fromUTF8(url.spec()));
+    world.initialized = false;
+    worlds_.push_back(world);
+
+    // World IDs start at 1, as 0 is reserved for the main world
+    int id = static_cast<int>(worlds_.size());
+    ids_[url.spec()] = id;
+
+    return id;
+  }
+
+  World* GetWorld(int id) {
+    if (id < 1 || static_cast<size_t>(id) > worlds_.size()) {
+      return nullptr;
+    }
+
+    return &worlds_[id - 1];
+  }
+
+ private:
+  GURL main_world_url_;
+  blink::WebString csp_;
+
+  std::unordered_map<std::string, int> ids_;
+  std::vector<World> worlds_;
+
+  DISALLOW_COPY_AND_ASSIGN(Registry);
+};
+
+base::LazyInstance<Registry>::Leaky g_registry = LAZY_INSTANCE_INITIALIZER;
 
 } // namespace
 
@@ -41,34 +97,42 @@ base::LazyInstance<WorldIDMap>::Leaky g_isolated_world_map =
 int IsolatedWorldMap::IDFromURL(const GURL& url) {
   CHECK(url.is_valid());
 
-  if (url == GURL(kMainWorldContextUrl))
+  Registry& registry = g_registry.Get();
+  if (url == registry.main_world_url())
     return kMainWorldId;
 
-  WorldIDMapIterator it = g_isolated_world_map.Get().find(url);
-  if (it != g_isolated_world_map.Get().end()) {
-    return it->second;
-  }
-
-  int new_id = g_next_isolated_world_id++;
-  g_isolated_world_map.Get()[url] = new_id;
-
-  return new_id;
+  return registry.GetOrCreateID(url);
 }
 
 // static
 GURL IsolatedWorldMap::URLFromID(int id) {
+  Registry& registry = g_registry.Get();
   if (id == kMainWorldId)
-    return GURL(kMainWorldContextUrl);
+    return registry.main_world_url();
 
-  for (WorldIDMapIterator it = g_isolated_world_map.Get().begin();
-       it != g_isolated_world_map.Get().end(); ++it) {
-    if (it->second == id) {
-      return it->first;
-    }
+  World* world = registry.GetWorld(id);
+  if (!world) {
+    DCHECK(0) << "Invalid world ID";
+    return GURL();
   }
 
-  DCHECK(0) << "Invalid world ID";
-  return GURL();
+  return world->url;
+}
+
+// static
+void IsolatedWorldMap::InitializeWorld(int id, blink::WebLocalFrame* frame) {
+  Registry& registry = g_registry.Get();
+
+  World* world = registry.GetWorld(id);
+  DCHECK(world) << "Invalid world ID";
+  if (!world || world->initialized) {
+    return;
+  }
+
+  frame->setIsolatedWorldSecurityOrigin(id, world->security_origin);
+  frame->setIsolatedWorldContentSecurityPolicy(id, registry.csp());
+
+  world->initialized = true;
 }
 
 } // namespace oxide
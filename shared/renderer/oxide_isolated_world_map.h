@@ -21,13 +21,27 @@
 #include "base/macros.h"
 #include "url/gurl.h"
 
+namespace blink {
+class WebLocalFrame;
+}
+
 namespace oxide {
 
+// Registry of isolated worlds, keyed by context URL. The security origin and
+// content security policy for each world are computed once when the world is
+// registered, and both lookup directions are constant time
 class IsolatedWorldMap final {
  public:
+  // Returns the ID of the world for |url|, registering a new world if this
+  // URL hasn't been seen before
   static int IDFromURL(const GURL& url);
   static GURL URLFromID(int id);
 
+  // Applies the security origin and content security policy of world |id|.
+  // Blink stores these per process rather than per frame, so this only calls
+  // in to |frame| the first time it is called for each world
+  static void InitializeWorld(int id, blink::WebLocalFrame* frame);
+
  private:
   DISALLOW_IMPLICIT_CONSTRUCTORS(IsolatedWorldMap);
 };
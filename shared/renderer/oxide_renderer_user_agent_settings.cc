@@ -17,6 +17,7 @@
 
 #include "oxide_renderer_user_agent_settings.h"
 
+#include "base/metrics/histogram_macros.h"
 #include "content/public/renderer/render_thread.h"
 #include "ipc/ipc_message_macros.h"
 #include "url/gurl.h"
@@ -27,8 +28,16 @@
 
 namespace oxide {
 
+namespace {
+
+// Should match the limit in UserAgentSettings
+const size_t kMaxLegacyOverrideCacheSize = 256;
+
+}
+
 RendererUserAgentSettings::RendererUserAgentSettings()
-    : legacy_override_enabled_(false) {}
+    : legacy_override_enabled_(false),
+      legacy_override_generation_(0) {}
 
 std::string
 RendererUserAgentSettings::GetLegacyUserAgentOverrideForURLFromBrowser(
@@ -44,16 +53,39 @@ RendererUserAgentSettings::GetLegacyUserAgentOverrideForURLFromBrowser(
   rep.ClearRef();
 
   GURL u = url.ReplaceComponents(rep);
+  GURL origin = u.GetOrigin();
+
+  auto it = legacy_override_cache_.find(origin);
+  bool cached = it != legacy_override_cache_.end();
+  UMA_HISTOGRAM_BOOLEAN("Oxide.UserAgentOverride.LegacySyncIPCAvoided",
+                        cached);
+  if (cached) {
+    return it->second;
+  }
 
   std::string user_agent;
   content::RenderThread::Get()->Send(
-      new OxideHostMsg_GetUserAgentOverride(
-          url.ReplaceComponents(rep),
-          &user_agent));
+      new OxideHostMsg_GetUserAgentOverride(u, &user_agent));
+
+  CacheLegacyUserAgentOverride(origin, user_agent);
 
   return user_agent;
 }
 
+void RendererUserAgentSettings::CacheLegacyUserAgentOverride(
+    const GURL& origin,
+    const std::string& user_agent) {
+  if (!origin.is_valid()) {
+    return;
+  }
+
+  if (legacy_override_cache_.size() >= kMaxLegacyOverrideCacheSize) {
+    legacy_override_cache_.clear();
+  }
+
+  legacy_override_cache_[origin] = user_agent;
+}
+
 void RendererUserAgentSettings::OnSetUserAgent(const std::string& user_agent) {
   SetUserAgent(user_agent);
 }
@@ -64,8 +96,23 @@ void RendererUserAgentSettings::OnUpdateUserAgentOverrides(
 }
 
 void RendererUserAgentSettings::OnSetLegacyUserAgentOverrideEnabled(
-    bool enabled) {
+    bool enabled,
+    int generation) {
   legacy_override_enabled_ = enabled;
+  legacy_override_generation_ = generation;
+  legacy_override_cache_.clear();
+}
+
+void RendererUserAgentSettings::OnCacheLegacyUserAgentOverride(
+    int generation,
+    const GURL& origin,
+    const std::string& user_agent) {
+  if (!legacy_override_enabled_ ||
+      generation != legacy_override_generation_) {
+    return;
+  }
+
+  CacheLegacyUserAgentOverride(origin, user_agent);
 }
 
 bool RendererUserAgentSettings::OnControlMessageReceived(
@@ -77,6 +124,8 @@ bool RendererUserAgentSettings::OnControlMessageReceived(
                         OnUpdateUserAgentOverrides)
     IPC_MESSAGE_HANDLER(OxideMsg_SetLegacyUserAgentOverrideEnabled,
                         OnSetLegacyUserAgentOverrideEnabled)
+    IPC_MESSAGE_HANDLER(OxideMsg_CacheLegacyUserAgentOverride,
+                        OnCacheLegacyUserAgentOverride)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
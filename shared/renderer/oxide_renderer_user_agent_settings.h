@@ -18,15 +18,15 @@
 #ifndef _OXIDE_SHARED_RENDERER_USER_AGENT_SETTINGS_H_
 #define _OXIDE_SHARED_RENDERER_USER_AGENT_SETTINGS_H_
 
+#include <map>
 #include <string>
 
 #include "base/macros.h"
 #include "content/public/renderer/render_thread_observer.h"
+#include "url/gurl.h"
 
 #include "shared/common/oxide_user_agent_override_set.h"
 
-class GURL;
-
 namespace oxide {
 
 class ContentRendererClient;
@@ -47,13 +47,25 @@ class RendererUserAgentSettings : public content::RenderThreadObserver {
   void OnSetUserAgent(const std::string& user_agent);
   void OnUpdateUserAgentOverrides(
       const std::vector<UserAgentOverrideSet::Entry>& overrides);
-  void OnSetLegacyUserAgentOverrideEnabled(bool enabled);
+  void OnSetLegacyUserAgentOverrideEnabled(bool enabled, int generation);
+  void OnCacheLegacyUserAgentOverride(int generation,
+                                      const GURL& origin,
+                                      const std::string& user_agent);
+
+  void CacheLegacyUserAgentOverride(const GURL& origin,
+                                    const std::string& user_agent);
 
   // content::RenderThreadObserver implementation
   bool OnControlMessageReceived(const IPC::Message& message) override;
 
   bool legacy_override_enabled_;
 
+  // Results from the legacy override mechanism, keyed by origin. These are
+  // either pushed from the browser or populated by synchronous lookups, and
+  // are discarded whenever the browser starts a new generation
+  int legacy_override_generation_;
+  std::map<GURL, std::string> legacy_override_cache_;
+
   UserAgentOverrideSet overrides_;
 
   DISALLOW_COPY_AND_ASSIGN(RendererUserAgentSettings);
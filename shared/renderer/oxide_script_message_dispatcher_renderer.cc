@@ -23,6 +23,7 @@
 
 #include "base/lazy_instance.h"
 #include "base/memory/ref_counted.h"
+#include "base/trace_event/trace_event.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_thread.h"
 #include "content/public/renderer/render_view.h"
@@ -55,6 +56,9 @@ base::LazyInstance<ScriptMessageDispatcherMap>::Leaky g_dispatcher_map =
 
 void ScriptMessageDispatcherRenderer::OnReceiveMessage(
     const IPC::Message& message) {
+  TRACE_EVENT0("oxide.script_messages",
+               "oxide::ScriptMessageDispatcherRenderer::OnReceiveMessage");
+
   OxideHostMsg_SendMessage::Param p;
   if (!OxideHostMsg_SendMessage::Read(&message, &p)) {
     LOG(ERROR) << "Failed to serialize message";
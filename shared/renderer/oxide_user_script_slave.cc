@@ -25,9 +25,9 @@
 #include "base/logging.h"
 #include "base/pickle.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/trace_event/trace_event.h"
 #include "content/public/renderer/render_thread.h"
 #include "ipc/ipc_message_macros.h"
-#include "third_party/WebKit/public/platform/WebSecurityOrigin.h"
 #include "third_party/WebKit/public/platform/WebString.h"
 #include "third_party/WebKit/public/platform/WebURLRequest.h"
 #include "third_party/WebKit/public/web/WebDataSource.h"
@@ -50,7 +50,6 @@ namespace {
 
 UserScriptSlave* g_instance;
 
-const char kIsolatedWorldCSP[] = "script-src 'self'";
 const char kUserScriptHead[] = "(function (unsafeWindow) {\n";
 const char kUserScriptTail[] = "\n})(window);";
 
@@ -62,21 +61,6 @@ UserScriptSlave::~UserScriptSlave() {
   g_instance = nullptr;
 }
 
-// static
-int UserScriptSlave::GetIsolatedWorldID(const GURL& url,
-                                        blink::WebLocalFrame* frame) {
-  int id = IsolatedWorldMap::IDFromURL(url);
-
-  frame->setIsolatedWorldSecurityOrigin(
-      id,
-      blink::WebSecurityOrigin::createFromString(
-          blink::WebString::fromUTF8(url.spec())));
-  frame->setIsolatedWorldContentSecurityPolicy(
-      id, blink::WebString::fromUTF8(kIsolatedWorldCSP));
-
-  return id;
-}
-
 void UserScriptSlave::OnUpdateUserScripts(base::SharedMemoryHandle handle) {
   user_scripts_.clear();
 
@@ -97,10 +81,22 @@ void UserScriptSlave::OnUpdateUserScripts(base::SharedMemoryHandle handle) {
   uint64_t num_scripts = 0;
   CHECK(iter.ReadUInt64(&num_scripts));
   for (; num_scripts > 0; --num_scripts) {
-    linked_ptr<UserScript> script(new UserScript());
-    user_scripts_.push_back(script);
+    ScriptEntry entry;
+    entry.script.reset(new UserScript());
+    entry.script->Unpickle(&iter);
+
+    // Scripts without a context are never injected. Don't fall back to
+    // any world for these, as that would grant them access to something
+    // the embedder didn't ask for
+    if (!entry.script->context().is_valid()) {
+      continue;
+    }
+
+    // Registering the world here means its security origin is computed once,
+    // rather than on every injection
+    entry.world_id = IsolatedWorldMap::IDFromURL(entry.script->context());
 
-    script->Unpickle(&iter);
+    user_scripts_.push_back(entry);
   }
 }
 
@@ -205,6 +201,9 @@ UserScriptSlave::UserScriptSlave()
 
 void UserScriptSlave::InjectScripts(blink::WebLocalFrame* frame,
                                     UserScript::RunLocation location) {
+  TRACE_EVENT1("oxide.user_scripts", "oxide::UserScriptSlave::InjectScripts",
+               "location", static_cast<int>(location));
+
   blink::WebDataSource* data_source = frame->provisionalDataSource() ?
       frame->provisionalDataSource() : frame->dataSource();
   CHECK(data_source);
@@ -215,9 +214,9 @@ void UserScriptSlave::InjectScripts(blink::WebLocalFrame* frame,
 
   for (Vector::iterator it = user_scripts_.begin();
        it != user_scripts_.end(); ++it) {
-    linked_ptr<UserScript>& script = *it;
+    const linked_ptr<UserScript>& script = it->script;
 
-    if (script->content().empty() || !script->context().is_valid()) {
+    if (script->content().empty()) {
       continue;
     }
 
@@ -250,7 +249,7 @@ void UserScriptSlave::InjectScripts(blink::WebLocalFrame* frame,
 
     blink::WebScriptSource source(blink::WebString::fromUTF8(content));
 
-    if (script->context() == GURL(kMainWorldContextUrl)) {
+    if (it->world_id == kMainWorldId) {
       if (script->emulate_greasemonkey()) {
         InjectGreaseMonkeyScriptInMainWorld(frame, source);
       } else {
@@ -259,8 +258,8 @@ void UserScriptSlave::InjectScripts(blink::WebLocalFrame* frame,
       continue;
     }
 
-    int id = GetIsolatedWorldID(script->context(), frame);
-    frame->executeScriptInIsolatedWorld(id, &source, 1, 0);
+    IsolatedWorldMap::InitializeWorld(it->world_id, frame);
+    frame->executeScriptInIsolatedWorld(it->world_id, &source, 1, 0);
   }
 }
 
@@ -27,8 +27,6 @@
 
 #include "shared/common/oxide_user_script.h"
 
-class GURL;
-
 namespace blink {
 class WebLocalFrame;
 class WebScriptSource;
@@ -48,12 +46,17 @@ class UserScriptSlave final : public content::RenderThreadObserver {
                      UserScript::RunLocation location);
 
  private:
-  typedef std::vector<linked_ptr<UserScript> > Vector;
+  struct ScriptEntry {
+    linked_ptr<UserScript> script;
+
+    // The ID of the world that |script| runs in, resolved when the scripts
+    // are updated. This is kMainWorldId for main world scripts
+    int world_id;
+  };
+  typedef std::vector<ScriptEntry> Vector;
 
   ~UserScriptSlave();
 
-  static int GetIsolatedWorldID(const GURL& url,
-                                blink::WebLocalFrame* frame);
   void OnUpdateUserScripts(base::SharedMemoryHandle handle);
 
   void InjectGreaseMonkeyScriptInMainWorld(